@@ -11,43 +11,105 @@ pub fn build(b: *std.Build) void {
     // Requires glslc (Vulkan SDK) or glslangValidator
     const shader_step = b.step("shaders", "Compile GLSL shaders to SPIR-V");
 
+    // Install shaders step (separate from main build). The library embeds
+    // its SPIR-V; installed files are only for NVVK_SHADER_DIR overrides.
+    const install_shaders_step = b.step("install-shaders", "Install compiled shaders");
+    install_shaders_step.dependOn(shader_step);
+
+    // SPIR-V embedded into libnvvk (shader_library.zig). Disable to build
+    // without glslc; pipelines then need an override directory.
+    const embed_shaders = b.option(bool, "embed-shaders", "Embed compiled SPIR-V in libnvvk (requires glslc)") orelse true;
+    var shader_build = ShaderBuild{
+        .b = b,
+        .compile_step = shader_step,
+        .install_step = install_shaders_step,
+        .embedded = if (embed_shaders) b.addWriteFiles() else null,
+    };
+
     const shaders = [_][]const u8{
         "forward_warp",
         "backward_warp",
         "linear_blend",
         "confidence_blend",
         "occlusion_fill",
+        "extrapolate_warp",
+        "scene_stats",
+        "scene_stats_finalize",
+        "tile_classify",
+        "tile_copy",
+        "mv_upsample",
+        "luma_downsample",
+        "mv_ingest",
+        "splat_forward",
+        "splat_resolve",
+        "pullpush_pull",
+        "pullpush_push",
     };
 
-    for (shaders) |shader_name| {
-        const glsl_path = b.fmt("shaders/{s}.comp", .{shader_name});
-        const spv_path = b.fmt("shaders/{s}.spv", .{shader_name});
-
-        // Compile GLSL to SPIR-V using glslc
-        const compile_cmd = b.addSystemCommand(&.{"glslc"});
-        compile_cmd.addArgs(&.{
-            "-O",
-            "--target-env=vulkan1.2",
-            "-o",
-            spv_path,
-        });
-        compile_cmd.addFileArg(b.path(glsl_path));
+    // Half-precision variants of the synthesis kernels (shader_variants.zig)
+    const fp16_shaders = [_][]const u8{
+        "forward_warp",
+        "backward_warp",
+        "linear_blend",
+        "confidence_blend",
+        "occlusion_fill",
+    };
 
-        shader_step.dependOn(&compile_cmd.step);
-    }
+    // Shaders writing frames, built per output format (output_format.zig).
+    // rgba8 is the default build above.
+    const frame_writers = [_][]const u8{
+        "forward_warp",
+        "backward_warp",
+        "linear_blend",
+        "confidence_blend",
+        "occlusion_fill",
+        "extrapolate_warp",
+        "tile_copy",
+        "splat_resolve",
+        "pullpush_push",
+    };
+    // Synthesis kernels the tile classifier dispatches per tile list
+    // (shaders/tiles.glsl), built as "<name>_tiled[_fp16][format]". The
+    // full-frame builds do not declare the tile list buffer.
+    const tiled_shaders = fp16_shaders;
+    // Tiled-only shaders whose full-frame build serves another purpose
+    // (tile_copy: passthrough of gated batches), fp32 only
+    const tiled_fp32_shaders = [_][]const u8{"tile_copy"};
+    const output_formats = [_]struct { suffix: []const u8, qualifier: []const u8 }{
+        .{ .suffix = "_rgb10a2", .qualifier = "rgb10_a2" },
+        .{ .suffix = "_rgba16f", .qualifier = "rgba16f" },
+    };
 
-    // Install shaders step (separate from main build)
-    const install_shaders_step = b.step("install-shaders", "Install compiled shaders");
-    install_shaders_step.dependOn(shader_step);
     for (shaders) |shader_name| {
-        const spv_path = b.fmt("shaders/{s}.spv", .{shader_name});
-        const install_file = b.addInstallFile(
-            b.path(spv_path),
-            b.fmt("share/nvvk/shaders/{s}.spv", .{shader_name}),
-        );
-        install_file.step.dependOn(shader_step);
-        install_shaders_step.dependOn(&install_file.step);
+        shader_build.add(shader_name, shader_name, &.{});
+    }
+    for (fp16_shaders) |shader_name| {
+        shader_build.add(shader_name, b.fmt("{s}_fp16", .{shader_name}), &.{"-DSYNTH_FP16"});
     }
+    for (tiled_shaders) |shader_name| {
+        shader_build.add(shader_name, b.fmt("{s}_tiled", .{shader_name}), &.{"-DTILED"});
+        shader_build.add(shader_name, b.fmt("{s}_tiled_fp16", .{shader_name}), &.{ "-DTILED", "-DSYNTH_FP16" });
+    }
+    for (tiled_fp32_shaders) |shader_name| {
+        shader_build.add(shader_name, b.fmt("{s}_tiled", .{shader_name}), &.{"-DTILED"});
+    }
+    for (output_formats) |format| {
+        const define = b.fmt("-DOUTPUT_FORMAT={s}", .{format.qualifier});
+        for (frame_writers) |shader_name| {
+            shader_build.add(shader_name, b.fmt("{s}{s}", .{ shader_name, format.suffix }), &.{define});
+        }
+        for (fp16_shaders) |shader_name| {
+            shader_build.add(shader_name, b.fmt("{s}_fp16{s}", .{ shader_name, format.suffix }), &.{ "-DSYNTH_FP16", define });
+        }
+        for (tiled_shaders) |shader_name| {
+            shader_build.add(shader_name, b.fmt("{s}_tiled{s}", .{ shader_name, format.suffix }), &.{ "-DTILED", define });
+            shader_build.add(shader_name, b.fmt("{s}_tiled_fp16{s}", .{ shader_name, format.suffix }), &.{ "-DTILED", "-DSYNTH_FP16", define });
+        }
+        for (tiled_fp32_shaders) |shader_name| {
+            shader_build.add(shader_name, b.fmt("{s}_tiled{s}", .{ shader_name, format.suffix }), &.{ "-DTILED", define });
+        }
+    }
+    const shaders_mod = shader_build.module();
 
     // Build option for static vs shared library
     const linkage = b.option(std.builtin.LinkMode, "linkage", "Library linkage (static or dynamic)") orelse .dynamic;
@@ -71,6 +133,7 @@ pub fn build(b: *std.Build) void {
         .link_libc = true, // Required for DlDynLib
         .imports = &.{
             .{ .name = "nvsync", .module = nvsync_mod },
+            .{ .name = "nvvk_shaders", .module = shaders_mod },
         },
     });
 
@@ -101,6 +164,7 @@ pub fn build(b: *std.Build) void {
     b.installFile("include/nvvk.h", "include/nvvk.h");
     b.installFile("include/nvvk_low_latency.h", "include/nvvk_low_latency.h");
     b.installFile("include/nvvk_diagnostics.h", "include/nvvk_diagnostics.h");
+    b.installFile("include/nvvk_frame_generation.h", "include/nvvk_frame_generation.h");
 
     // =========================================================================
     // CLI tool for testing/demos
@@ -129,6 +193,31 @@ pub fn build(b: *std.Build) void {
         run_cmd.addArgs(args);
     }
 
+    // =========================================================================
+    // Synthesis shader benchmark (headless, runs on lavapipe)
+    // =========================================================================
+    // Run with: zig build bench [-- <shader dir | -> <width> <height>]
+    const bench_exe = b.addExecutable(.{
+        .name = "nvvk-bench",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("src/bench.zig"),
+            .target = target,
+            .optimize = optimize,
+            .link_libc = true,
+            .imports = &.{
+                .{ .name = "nvvk", .module = nvvk_mod },
+            },
+        }),
+    });
+    bench_exe.linkSystemLibrary("vulkan");
+
+    const bench_step = b.step("bench", "Time synthesis shader variants");
+    const bench_cmd = b.addRunArtifact(bench_exe);
+    bench_step.dependOn(&bench_cmd.step);
+    if (b.args) |args| {
+        bench_cmd.addArgs(args);
+    }
+
     // =========================================================================
     // Tests
     // =========================================================================
@@ -138,6 +227,9 @@ pub fn build(b: *std.Build) void {
             .target = target,
             .optimize = optimize,
             .link_libc = true,
+            .imports = &.{
+                .{ .name = "nvvk_shaders", .module = shaders_mod },
+            },
         }),
     });
     mod_tests.linkSystemLibrary("vulkan");
@@ -158,6 +250,9 @@ pub fn build(b: *std.Build) void {
             .target = target,
             .optimize = optimize,
             .link_libc = true,
+            .imports = &.{
+                .{ .name = "nvvk_shaders", .module = shaders_mod },
+            },
         }),
     });
     const install_docs = b.addInstallDirectory(.{
@@ -167,3 +262,70 @@ pub fn build(b: *std.Build) void {
     });
     docs_step.dependOn(&install_docs.step);
 }
+
+/// Shader compilation: every shader is compiled with glslc, installed to
+/// share/nvvk/shaders and, if embedding, copied next to a generated
+/// module that @embedFile's it (imported as "nvvk_shaders")
+const ShaderBuild = struct {
+    b: *std.Build,
+    compile_step: *std.Build.Step,
+    install_step: *std.Build.Step,
+    embedded: ?*std.Build.Step.WriteFile,
+    outputs: std.ArrayList([]const u8) = .empty,
+
+    /// Compile shaders/{source}.comp to {output}.spv
+    fn add(self: *ShaderBuild, source: []const u8, output: []const u8, defines: []const []const u8) void {
+        const b = self.b;
+        const spv_name = b.fmt("{s}.spv", .{output});
+
+        // Compile GLSL to SPIR-V using glslc
+        const compile_cmd = b.addSystemCommand(&.{"glslc"});
+        compile_cmd.addArgs(&.{
+            "-O",
+            "--target-env=vulkan1.2",
+        });
+        compile_cmd.addArgs(defines);
+        compile_cmd.addArg("-o");
+        const spv = compile_cmd.addOutputFileArg(spv_name);
+        compile_cmd.addFileArg(b.path(b.fmt("shaders/{s}.comp", .{source})));
+        self.compile_step.dependOn(&compile_cmd.step);
+
+        const install_file = b.addInstallFile(spv, b.fmt("share/nvvk/shaders/{s}", .{spv_name}));
+        self.install_step.dependOn(&install_file.step);
+
+        if (self.embedded) |files| {
+            _ = files.addCopyFile(spv, spv_name);
+            self.outputs.append(b.allocator, output) catch @panic("OOM");
+        }
+    }
+
+    /// Module with the embedded SPIR-V table (empty without embedding)
+    fn module(self: *ShaderBuild) *std.Build.Module {
+        const b = self.b;
+        var source: std.ArrayList(u8) = .empty;
+        source.appendSlice(b.allocator,
+            \\//! Generated by build.zig: compiled SPIR-V embedded in libnvvk
+            \\
+            \\pub const File = struct { name: []const u8, spirv: []const u32 };
+            \\
+            \\fn words(comptime bytes: []align(4) const u8) []const u32 {
+            \\    return @as([*]const u32, @ptrCast(bytes.ptr))[0 .. bytes.len / 4];
+            \\}
+            \\
+            \\
+        ) catch @panic("OOM");
+        for (self.outputs.items) |output| {
+            source.appendSlice(b.allocator, b.fmt("const {s} align(4) = @embedFile(\"{s}.spv\").*;\n", .{ output, output })) catch @panic("OOM");
+        }
+        source.appendSlice(b.allocator, "\npub const files = [_]File{\n") catch @panic("OOM");
+        for (self.outputs.items) |output| {
+            source.appendSlice(b.allocator, b.fmt("    .{{ .name = \"{s}.spv\", .spirv = words(&{s}) }},\n", .{ output, output })) catch @panic("OOM");
+        }
+        source.appendSlice(b.allocator, "};\n") catch @panic("OOM");
+
+        const files = self.embedded orelse b.addWriteFiles();
+        return b.createModule(.{
+            .root_source_file = files.add("embedded_shaders.zig", source.items),
+        });
+    }
+};
@@ -20,6 +20,7 @@ extern "C" {
 #endif
 
 #include "nvvk.h"
+#include <stddef.h>
 
 /* Frame generation quality modes */
 typedef enum NvvkFrameGenMode {
@@ -29,15 +30,119 @@ typedef enum NvvkFrameGenMode {
     NVVK_FRAME_GEN_QUALITY = 3,     /* Full pipeline, ~3ms */
 } NvvkFrameGenMode;
 
-/* Frame generation statistics */
+/* Generated frame placement policy */
+typedef enum NvvkFrameGenStrategy {
+    NVVK_FRAME_GEN_INTERPOLATE = 0,     /* Between previous and current frame */
+    NVVK_FRAME_GEN_EXTRAPOLATE = 1,     /* Past current frame, no added hold */
+    NVVK_FRAME_GEN_LATENCY_BUDGET = 2,  /* Interpolate while within budget */
+} NvvkFrameGenStrategy;
+
+/* GPU stages timed with timestamp queries */
+typedef enum NvvkGpuStage {
+    NVVK_GPU_STAGE_FLOW = 0,            /* Optical flow (or engine motion ingest) */
+    NVVK_GPU_STAGE_MV_RESOLVE = 1,      /* Motion vector ring slot resolve */
+    NVVK_GPU_STAGE_SYNTHESIS = 2,       /* Whole synthesis batch */
+    NVVK_GPU_STAGE_FORWARD_WARP = 3,    /* Forward warps or splats of the batch */
+    NVVK_GPU_STAGE_BACKWARD_WARP = 4,   /* Backward warps of the batch */
+    NVVK_GPU_STAGE_BLEND = 5,           /* Blends of the batch */
+    NVVK_GPU_STAGE_OCCLUSION_FILL = 6,  /* Occlusion or pull-push fills */
+    NVVK_GPU_STAGE_COUNT = 7,
+} NvvkGpuStage;
+
+/* Synthesis shaders, each bound through its own descriptor set */
+typedef enum NvvkSynthesisPass {
+    NVVK_SYNTHESIS_PASS_FORWARD_WARP = 0,
+    NVVK_SYNTHESIS_PASS_BACKWARD_WARP = 1,
+    NVVK_SYNTHESIS_PASS_LINEAR_BLEND = 2,
+    NVVK_SYNTHESIS_PASS_CONFIDENCE_BLEND = 3,
+    NVVK_SYNTHESIS_PASS_OCCLUSION_FILL = 4,
+    NVVK_SYNTHESIS_PASS_EXTRAPOLATE_WARP = 5,
+    NVVK_SYNTHESIS_PASS_TILE_COPY = 6,
+    NVVK_SYNTHESIS_PASS_COUNT = 7,
+} NvvkSynthesisPass;
+
+/*
+ * Set 0 bindings of each synthesis pass, for callers writing their own
+ * descriptor sets. S = combined image sampler, I = storage image (GENERAL),
+ * B = storage buffer, U = uniform buffer. prev/curr are the previous and
+ * current frame (both the current one when extrapolating; swapped in the
+ * alternate sets).
+ *
+ *   FORWARD_WARP      0 S prev             1 S forward motion
+ *                     2 I warp scratch     8 B tile lists
+ *                     9 U constants (5)
+ *   BACKWARD_WARP     0 S curr             1 S backward motion (1)
+ *                     2 I backward warped  8 B tile lists
+ *                     9 U constants (5)
+ *   LINEAR_BLEND      0 S warp scratch     1 S curr
+ *                     2 I output           3 S tile confidence (2)
+ *                     8 B tile lists       9 U constants (5)
+ *   CONFIDENCE_BLEND  0 S warp scratch     1 S backward warped
+ *                     2 S cost (3)         3 S backward cost (4)
+ *                     4 I filled output in quality mode, else output
+ *                     5 S tile confidence (2)
+ *                     8 B tile lists       9 U constants (5)
+ *   OCCLUSION_FILL    0 S filled output    1 S curr
+ *                     2 S cost (3)         3 I output
+ *                     8 B tile lists       9 U constants (5)
+ *   EXTRAPOLATE_WARP  0 S curr             1 S forward motion
+ *                     2 S cost (3)         3 I output
+ *                     9 U constants (5)
+ *   TILE_COPY         0 S prev             1 S curr
+ *                     2 I output           8 B tile lists
+ *                     9 U constants (5)
+ *
+ * (1) Forward motion without backward flow
+ * (2) The current frame when no tile confidence image is set
+ * (3) Forward motion without a cost map
+ * (4) The cost map (or (3)) without a backward cost map
+ * (5) The constants buffer (nvvk_frame_gen_set_constants_buffer) at
+ *     offset NVVK_SYNTHESIS_CONSTANTS_STRIDE * (slot *
+ *     NVVK_SYNTHESIS_PASS_COUNT + pass), range 16, where slot is the
+ *     output target's batch slot
+ *
+ * Binding 8 (tile list buffer) is only read by the tiled pipelines and
+ * may stay unwritten without tile classification. Frames, motion and
+ * cost maps are sampled in the layout the caller keeps them in; warp
+ * scratch, backward warped and filled output are always in GENERAL.
+ */
+
+/*
+ * Frame generation statistics. The layout never changes; the multiplier,
+ * batch count and GPU stage times are in NvvkFrameGenStatsEx.
+ */
 typedef struct NvvkFrameGenStats {
     uint64_t generated_frames;       /* Total frames generated */
     uint64_t skipped_frames;         /* Frames skipped (scene change, etc.) */
     uint64_t avg_gen_time_us;        /* Average generation time in microseconds */
-    float confidence;                /* Current confidence score (0.0-1.0) */
+    float confidence;                /* Flow confidence of last frame (0.0-1.0) */
     bool scene_change_detected;      /* Scene change detected in last frame */
 } NvvkFrameGenStats;
 
+/*
+ * Further statistics (nvvk_frame_gen_get_stats_ex). Set struct_size to
+ * sizeof(NvvkFrameGenStatsEx); only fields within it are written, and new
+ * fields are only ever appended.
+ */
+typedef struct NvvkFrameGenStatsEx {
+    uint32_t struct_size;
+    uint32_t frame_multiplier;       /* Presented frames per real frame (2-4) */
+    uint32_t last_batch_count;       /* Frames generated for the last real frame */
+    uint32_t _padding;
+    /*
+     * GPU times in nanoseconds, indexed by NvvkGpuStage. Timestamps are
+     * read back without stalling, a few frames late; all zero until GPU
+     * timing is enabled and the first timed frame has completed.
+     */
+    uint64_t gpu_stage_ns[NVVK_GPU_STAGE_COUNT];      /* Newest timed frame */
+    uint64_t gpu_stage_avg_ns[NVVK_GPU_STAGE_COUNT];  /* Rolling mean */
+    uint64_t gpu_stage_max_ns[NVVK_GPU_STAGE_COUNT];  /* Rolling maximum */
+    uint64_t gpu_flow_overlap_ns;    /* Flow overlapping the previous synthesis */
+} NvvkFrameGenStatsEx;
+
+/* Most frames generated per real frame (4x) */
+#define NVVK_MAX_GENERATED_FRAMES 3
+
 /* Generated frame result */
 typedef struct NvvkGeneratedFrame {
     uint64_t image_view;             /* VkImageView handle */
@@ -46,8 +151,30 @@ typedef struct NvvkGeneratedFrame {
     uint64_t generation_time_us;     /* Generation time in microseconds */
     uint64_t frame_id;               /* Frame ID (matches Reflex present ID) */
     bool should_present;             /* Whether this frame should be presented */
+    bool extrapolated;               /* Present after the real frame, not before */
+    uint8_t batch_index;             /* Position within the batch */
+    uint8_t _padding;
+    float interpolation_factor;      /* Temporal position k/N */
 } NvvkGeneratedFrame;
 
+/* Frames generated for one real frame, filled in place by the push calls */
+typedef struct NvvkGeneratedFrames {
+    uint32_t count;                  /* Valid entries of frames */
+    uint32_t _padding;
+    NvvkGeneratedFrame frames[NVVK_MAX_GENERATED_FRAMES];
+    uint64_t done_semaphore;         /* Async push: VkSemaphore (timeline) */
+    uint64_t done_value;             /* Async push: value signalled on completion */
+} NvvkGeneratedFrames;
+
+/* Queues for nvvk_frame_gen_init2 */
+typedef struct NvvkFrameGenQueues {
+    uint32_t graphics_family;        /* The game's graphics (present) queue family */
+    uint32_t compute_family;         /* Async compute queue family */
+    uint32_t compute_index;          /* Queue index within compute_family */
+    int32_t flow_family;             /* Optical flow queue family, -1 = compute */
+    uint32_t flow_index;             /* Queue index within flow_family */
+} NvvkFrameGenQueues;
+
 /* Opaque frame generation context handle */
 typedef struct NvvkFrameGenContext* nvvk_frame_gen_ctx_t;
 
@@ -70,6 +197,38 @@ nvvk_frame_gen_ctx_t nvvk_frame_gen_init(
     NvvkFrameGenMode mode
 );
 
+/*
+ * Initialize frame generation context with a device dispatch table.
+ *
+ * Unlike nvvk_frame_gen_init, the context loads its device functions with
+ * get_device_proc_addr and can record and submit GPU work.
+ *
+ * Parameters:
+ *   device - VkDevice handle
+ *   get_device_proc_addr - vkGetDeviceProcAddr
+ *   width, height - Frame size in pixels
+ *   mode - Quality mode
+ *   queues - Queues for nvvk_frame_gen_push_frame_async (NULL = only
+ *            nvvk_frame_gen_push_frame, into the caller's command buffers).
+ *            The queues must have been requested at device creation.
+ *   swapchain_format, swapchain_color_space - As for
+ *            nvvk_frame_gen_set_swapchain_format (0 = RGBA8). HDR formats
+ *            are stored and nvvk_frame_gen_create_pipelines builds for them.
+ *
+ * Returns:
+ *   Context handle on success, NULL on failure
+ */
+nvvk_frame_gen_ctx_t nvvk_frame_gen_init2(
+    NvvkDevice device,
+    PFN_vkGetDeviceProcAddr get_device_proc_addr,
+    uint32_t width,
+    uint32_t height,
+    NvvkFrameGenMode mode,
+    const NvvkFrameGenQueues* queues,
+    uint32_t swapchain_format,
+    uint32_t swapchain_color_space
+);
+
 /*
  * Destroy frame generation context.
  */
@@ -85,11 +244,258 @@ void nvvk_frame_gen_set_enabled(nvvk_frame_gen_ctx_t ctx, bool enabled);
  */
 void nvvk_frame_gen_set_mode(nvvk_frame_gen_ctx_t ctx, NvvkFrameGenMode mode);
 
+/*
+ * Set interpolation vs. extrapolation policy.
+ *
+ * Interpolation holds each real frame back by half a frame interval.
+ * Extrapolation predicts past the latest real frame and adds only the
+ * generation time. With NVVK_FRAME_GEN_LATENCY_BUDGET, interpolation is
+ * used while its added latency fits latency_budget_us.
+ */
+void nvvk_frame_gen_set_strategy(
+    nvvk_frame_gen_ctx_t ctx,
+    NvvkFrameGenStrategy strategy,
+    uint64_t latency_budget_us
+);
+
+/*
+ * Set presented frames per real frame (2 = 2x, 3 = 3x, 4 = 4x).
+ *
+ * Motion estimation runs once per real frame and is shared by all
+ * multiplier - 1 generated frames, which are placed at factors k/N.
+ *
+ * Returns:
+ *   NVVK_SUCCESS, or NVVK_ERROR_NOT_SUPPORTED for multipliers outside 2-4
+ */
+NvvkResult nvvk_frame_gen_set_multiplier(nvvk_frame_gen_ctx_t ctx, uint32_t multiplier);
+
+/*
+ * Write generated frames in the swapchain's format (VkFormat) and color
+ * space (VkColorSpaceKHR). Call after (re)creating the swapchain.
+ *
+ * Supported: 8-bit UNORM/SRGB, A2B10G10R10/A2R10G10B10 in sRGB or HDR10
+ * (ST 2084), and R16G16B16A16_SFLOAT scRGB. Pipelines for a format are
+ * created on first use.
+ *
+ * Returns:
+ *   NVVK_SUCCESS, NVVK_ERROR_NOT_SUPPORTED for other formats, or
+ *   NVVK_ERROR_OUT_OF_MEMORY / NVVK_ERROR_DEVICE_LOST when creating the
+ *   format's pipelines fails
+ */
+NvvkResult nvvk_frame_gen_set_swapchain_format(
+    nvvk_frame_gen_ctx_t ctx,
+    uint32_t format,
+    uint32_t color_space
+);
+
+/*
+ * Set the output image of a batch slot (0 to NVVK_MAX_GENERATED_FRAMES - 1).
+ *
+ * Images stay owned by the caller and must be created in the storage
+ * format of the swapchain format. descriptor_sets holds one set per
+ * NvvkSynthesisPass, indexed by pass, written for that shader's layout;
+ * it may be NULL when the context binds through push descriptors or a
+ * descriptor buffer.
+ */
+NvvkResult nvvk_frame_gen_set_output_target(
+    nvvk_frame_gen_ctx_t ctx,
+    uint32_t slot,
+    uint64_t image,
+    uint64_t image_view,
+    const uint64_t* descriptor_sets
+);
+
+/*
+ * Like nvvk_frame_gen_set_output_target, with a second set per pass in
+ * alternate_descriptor_sets bound on odd frames, written with the input
+ * frames swapped (the history alternates between two images). Sets are
+ * then never rewritten while a batch may still use them, and recorded
+ * batches can be replayed. Either array may be NULL; 0 entries are absent.
+ */
+NvvkResult nvvk_frame_gen_set_output_target2(
+    nvvk_frame_gen_ctx_t ctx,
+    uint32_t slot,
+    uint64_t image,
+    uint64_t image_view,
+    const uint64_t* descriptor_sets,
+    const uint64_t* alternate_descriptor_sets
+);
+
+/*
+ * Bind the synthesis passes through push descriptors (VK_KHR_push_descriptor,
+ * enabled at device creation) instead of caller-owned descriptor sets: no
+ * pool, no sets, nothing to rewrite as the history rotates. sampler is
+ * used for every sampled input; input_layout is the VkImageLayout of the
+ * frames, motion vectors and cost map while synthesis reads them.
+ *
+ * Call before nvvk_frame_gen_create_set_layout and
+ * nvvk_frame_gen_create_pipelines, which then create push layouts.
+ *
+ * Returns:
+ *   NVVK_SUCCESS, or NVVK_ERROR_NOT_SUPPORTED without the extension or
+ *   once pipelines exist
+ */
+NvvkResult nvvk_frame_gen_use_push_descriptors(
+    nvvk_frame_gen_ctx_t ctx,
+    uint64_t sampler,
+    uint32_t input_layout
+);
+
+/*
+ * Create the descriptor set layout of a synthesis pass (NvvkSynthesisPass)
+ * in *set_layout. The caller owns it; the pass's pipeline layout holds it
+ * as set 0 and no push constant range.
+ *
+ * Returns:
+ *   NVVK_SUCCESS, or NVVK_ERROR_NOT_SUPPORTED without nvvk_frame_gen_init2
+ */
+NvvkResult nvvk_frame_gen_create_set_layout(
+    nvvk_frame_gen_ctx_t ctx,
+    uint32_t pass,
+    uint64_t* set_layout
+);
+
+/*
+ * Create the synthesis pipelines from the shaders embedded in libnvvk.
+ * pass_layouts holds NVVK_SYNTHESIS_PASS_COUNT pipeline layouts indexed
+ * by NvvkSynthesisPass (0 = pass unused); they stay owned by the caller.
+ */
+NvvkResult nvvk_frame_gen_create_pipelines(
+    nvvk_frame_gen_ctx_t ctx,
+    const uint64_t* pass_layouts
+);
+
+/* Optical flow output images (0 = absent; forward is required) */
+typedef struct NvvkMotionVectorImages {
+    uint64_t forward;                /* R16G16_S10_5_NV, GENERAL layout */
+    uint64_t forward_view;
+    uint64_t forward_memory;
+    uint64_t backward;               /* Quality mode */
+    uint64_t backward_view;
+    uint64_t cost;                   /* R8_UINT; balanced and quality */
+    uint64_t cost_view;
+    uint64_t backward_cost;          /* R8_UINT; with backward flow */
+    uint64_t backward_cost_view;
+    uint32_t width;                  /* Frame width / 4 (4x4 grid) */
+    uint32_t height;                 /* Frame height / 4 */
+} NvvkMotionVectorImages;
+
+/*
+ * Set the caller-owned images optical flow writes and synthesis reads.
+ */
+NvvkResult nvvk_frame_gen_set_motion_vectors(
+    nvvk_frame_gen_ctx_t ctx,
+    const NvvkMotionVectorImages* images
+);
+
+/* Intermediate images of the synthesis passes (0 = absent) */
+typedef struct NvvkSynthesisImages {
+    uint64_t warp_scratch;           /* Required */
+    uint64_t warp_scratch_view;
+    uint64_t backward_warped;        /* Balanced and quality */
+    uint64_t backward_warped_view;
+    uint64_t filled_output;          /* Quality */
+    uint64_t filled_output_view;
+} NvvkSynthesisImages;
+
+/*
+ * Set the caller-owned intermediate images of the synthesis passes, at
+ * the frame size in the storage format of the swapchain format.
+ */
+NvvkResult nvvk_frame_gen_set_synthesis_images(
+    nvvk_frame_gen_ctx_t ctx,
+    const NvvkSynthesisImages* images
+);
+
+/* Distance between the constants blocks of the synthesis passes */
+#define NVVK_SYNTHESIS_CONSTANTS_STRIDE 256
+
+/* Size of the synthesis constants buffer */
+#define NVVK_SYNTHESIS_CONSTANTS_SIZE 5412
+
+/*
+ * Set the caller-owned buffer the synthesis passes read their per-frame
+ * values (interpolation factors, quality parameters) and scene change
+ * gates from. It needs UNIFORM_BUFFER, INDIRECT_BUFFER and TRANSFER_DST
+ * usage (plus SHADER_DEVICE_ADDRESS with a descriptor buffer) and
+ * NVVK_SYNTHESIS_CONSTANTS_SIZE bytes of device-local memory. Each frame
+ * rewrites it ahead of its batch, so all frames must be submitted to the
+ * same queue. Synthesis records no passes until it is set.
+ */
+NvvkResult nvvk_frame_gen_set_constants_buffer(
+    nvvk_frame_gen_ctx_t ctx,
+    uint64_t buffer
+);
+
+/*
+ * Create the optical flow session for pushed frames of image_format
+ * (VkFormat). Call after nvvk_frame_gen_set_motion_vectors.
+ *
+ * Returns:
+ *   NVVK_SUCCESS, or NVVK_ERROR_NOT_SUPPORTED without nvvk_frame_gen_init2
+ *   or VK_NV_optical_flow
+ */
+NvvkResult nvvk_frame_gen_create_flow_session(
+    nvvk_frame_gen_ctx_t ctx,
+    uint32_t image_format
+);
+
+/*
+ * Push a rendered frame and record optical flow and the synthesis of its
+ * generated frames into cmd. Submit cmd before presenting them.
+ *
+ * result is filled in place; result->count is 0 while the frame history
+ * warms up or generation is disabled.
+ *
+ * Returns:
+ *   NVVK_SUCCESS, NVVK_ERROR_NOT_SUPPORTED when the context cannot reach
+ *   the GPU (nvvk_frame_gen_init) or lacks the flow session or output
+ *   targets
+ */
+NvvkResult nvvk_frame_gen_push_frame(
+    nvvk_frame_gen_ctx_t ctx,
+    NvvkCommandBuffer cmd,
+    uint64_t image,
+    uint64_t image_view,
+    uint32_t width,
+    uint32_t height,
+    NvvkGeneratedFrames* result
+);
+
+/*
+ * Push a rendered frame and submit its frame generation on the queues of
+ * nvvk_frame_gen_init2, without a command buffer of the caller's.
+ *
+ * rendered_semaphore (timeline) reaches rendered_value once the frame is
+ * complete; the frame is in layout (VkImageLayout). Present the real frame
+ * and its generated frames after waiting for result->done_value on
+ * result->done_semaphore.
+ */
+NvvkResult nvvk_frame_gen_push_frame_async(
+    nvvk_frame_gen_ctx_t ctx,
+    uint64_t image,
+    uint64_t image_view,
+    uint32_t width,
+    uint32_t height,
+    uint32_t layout,
+    uint64_t rendered_semaphore,
+    uint64_t rendered_value,
+    NvvkGeneratedFrames* result
+);
+
 /*
  * Get frame generation statistics.
  */
 void nvvk_frame_gen_get_stats(nvvk_frame_gen_ctx_t ctx, NvvkFrameGenStats* stats);
 
+/*
+ * Get the statistics of NvvkFrameGenStatsEx, up to stats->struct_size.
+ *
+ * Returns:
+ *   NVVK_SUCCESS, or NVVK_ERROR_NOT_SUPPORTED if struct_size is too small
+ */
+NvvkResult nvvk_frame_gen_get_stats_ex(nvvk_frame_gen_ctx_t ctx, NvvkFrameGenStatsEx* stats);
+
 /*
  * Get latency compensation in microseconds.
  *
@@ -108,17 +514,46 @@ uint64_t nvvk_frame_gen_get_current_frame_id(nvvk_frame_gen_ctx_t ctx);
  */
 const char* nvvk_get_optical_flow_extension_name(void);
 
+/*
+ * Get the SPIR-V of a shader embedded in libnvvk, by file name as built
+ * (e.g. "linear_blend.spv", "forward_warp_fp16_rgb10a2.spv"). Pass it to
+ * vkCreateShaderModule; no shader files need to be installed.
+ *
+ * Returns:
+ *   Pointer to the code (valid for the library's lifetime) with its size
+ *   in bytes in *size_bytes, or NULL if no such shader is embedded
+ */
+const uint32_t* nvvk_get_shader_spirv(const char* name, size_t* size_bytes);
+
 /*
  * Example usage in DXVK:
  *
  *   // Initialize
- *   nvvk_frame_gen_ctx_t fg = nvvk_frame_gen_init(
- *       device, 1920, 1080, NVVK_FRAME_GEN_PERFORMANCE);
+ *   nvvk_frame_gen_ctx_t fg = nvvk_frame_gen_init2(
+ *       device, vkGetDeviceProcAddr, 1920, 1080,
+ *       NVVK_FRAME_GEN_PERFORMANCE, NULL, swapchain_format, color_space);
+ *   // Without VK_KHR_push_descriptor: per-parity descriptor sets below
+ *   bool push = nvvk_frame_gen_use_push_descriptors(
+ *       fg, sampler, VK_IMAGE_LAYOUT_GENERAL) == NVVK_SUCCESS;
+ *   for (uint32_t pass = 0; pass < NVVK_SYNTHESIS_PASS_COUNT; pass++)
+ *       nvvk_frame_gen_create_set_layout(fg, pass, &set_layouts[pass]);
+ *   // ... create pass_layouts from set_layouts
+ *   nvvk_frame_gen_create_pipelines(fg, pass_layouts);
+ *   nvvk_frame_gen_set_motion_vectors(fg, &mv_images);
+ *   nvvk_frame_gen_set_synthesis_images(fg, &scratch_images);
+ *   nvvk_frame_gen_set_constants_buffer(fg, constants_buffer);
+ *   nvvk_frame_gen_create_flow_session(fg, frame_format);
+ *   if (push)
+ *       nvvk_frame_gen_set_output_target(fg, 0, out_image, out_view, NULL);
+ *   else  // ... write out_sets and odd_sets per the binding table
+ *       nvvk_frame_gen_set_output_target2(fg, 0, out_image, out_view,
+ *                                         out_sets, odd_sets);
  *
  *   // In render loop, after rendering real frame:
- *   // 1. Push frame to history
- *   // 2. Generate intermediate frame if we have enough history
- *   // 3. Present: real -> generated -> real -> generated...
+ *   NvvkGeneratedFrames generated;
+ *   nvvk_frame_gen_push_frame(fg, cmd, image, view, 1920, 1080, &generated);
+ *   // Submit cmd, then present generated.frames[0..count) that
+ *   // should_present, before (or, if extrapolated, after) the real frame
  *
  *   // Cleanup
  *   nvvk_frame_gen_destroy(fg);
@@ -0,0 +1,68 @@
+/*
+ * Output Format and Transfer Function
+ *
+ * Shaders writing frames are built once per output format (see
+ * output_format.zig): OUTPUT_FORMAT is the storage format qualifier,
+ * rgba8 by default, rgb10_a2 for 10-bit / HDR10 and rgba16f for scRGB.
+ *
+ * TRANSFER (specialization constant 3) is the encoding of stored color.
+ * Shaders that mix colors decode to linear first and encode the result:
+ *   0: none  - mix code values as stored (8-bit SDR, scRGB is linear)
+ *   1: sRGB  - piecewise sRGB curve
+ *   2: PQ    - SMPTE ST 2084 (HDR10), linear 1.0 = 10000 nits
+ * The constant folds the branches away.
+ */
+
+#ifndef OUTPUT_FORMAT
+#define OUTPUT_FORMAT rgba8
+#endif
+
+layout(constant_id = 3) const uint TRANSFER = 0u;
+
+const uint TRANSFER_NONE = 0u;
+const uint TRANSFER_SRGB = 1u;
+const uint TRANSFER_PQ = 2u;
+
+// ST 2084 constants
+const float PQ_M1 = 0.1593017578125;
+const float PQ_M2 = 78.84375;
+const float PQ_C1 = 0.8359375;
+const float PQ_C2 = 18.8515625;
+const float PQ_C3 = 18.6875;
+
+vec3 toLinear(vec3 c) {
+    if (TRANSFER == TRANSFER_SRGB) {
+        vec3 lo = c / 12.92;
+        vec3 hi = pow((c + 0.055) / 1.055, vec3(2.4));
+        return mix(hi, lo, lessThanEqual(c, vec3(0.04045)));
+    }
+    if (TRANSFER == TRANSFER_PQ) {
+        vec3 p = pow(clamp(c, 0.0, 1.0), vec3(1.0 / PQ_M2));
+        return pow(max(p - PQ_C1, 0.0) / (PQ_C2 - PQ_C3 * p), vec3(1.0 / PQ_M1));
+    }
+    return c;
+}
+
+vec3 fromLinear(vec3 c) {
+    if (TRANSFER == TRANSFER_SRGB) {
+        vec3 lo = c * 12.92;
+        vec3 hi = 1.055 * pow(max(c, 0.0), vec3(1.0 / 2.4)) - 0.055;
+        return mix(hi, lo, lessThanEqual(c, vec3(0.0031308)));
+    }
+    if (TRANSFER == TRANSFER_PQ) {
+        vec3 y = pow(clamp(c, 0.0, 1.0), vec3(PQ_M1));
+        return pow((PQ_C1 + PQ_C2 * y) / (1.0 + PQ_C3 * y), vec3(PQ_M2));
+    }
+    return c;
+}
+
+// Sample a frame as linear color (decode in fp32, PQ needs the range)
+vec4 sampleLinear(sampler2D frame, vec2 uv) {
+    vec4 c = texture(frame, uv);
+    return vec4(toLinear(c.rgb), c.a);
+}
+
+// Encode linear color for storing
+vec4 encodeColor(vec4 c) {
+    return vec4(fromLinear(c.rgb), c.a);
+}
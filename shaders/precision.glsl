@@ -0,0 +1,25 @@
+/*
+ * Precision and Workgroup Shape for Synthesis Kernels
+ *
+ * Synthesis kernels are compiled twice: as-is (fp32) and with
+ * -DSYNTH_FP16, where color math uses half precision (packed on hardware
+ * with fp16 ALUs). Texture coordinates and motion stay fp32.
+ *
+ * The workgroup shape comes from specialization constants 1 and 2
+ * (default 16x16, see shader_variants.zig). Tiled pipelines must keep
+ * 16x16, one workgroup per tile.
+ *
+ * Include before any declaration (it may enable an extension).
+ */
+
+#ifdef SYNTH_FP16
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+#define real float16_t
+#define real4 f16vec4
+#else
+#define real float
+#define real4 vec4
+#endif
+
+layout(local_size_x = 16, local_size_y = 16) in;
+layout(local_size_x_id = 1, local_size_y_id = 2) in;
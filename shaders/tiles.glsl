@@ -0,0 +1,44 @@
+/*
+ * Tile List Support for Synthesis Kernels
+ *
+ * tile_classify.comp bins 16x16 pixel tiles into static / simple-warp /
+ * occlusion-fill lists. A synthesis kernel specialized with TILE_CLASS = 1
+ * or 2 runs one workgroup per tile of that list (dispatched indirectly from
+ * the list header); TILE_CLASS = 0 runs it over the full frame.
+ *
+ * Layout matches tile_classify.TileListHeader. Only the tiled variants
+ * (built with -DTILED, "<name>_tiled*.spv") declare the list buffer at
+ * binding 8; full-frame variants leave it out, so binding 8 only has to
+ * be bound when the classifier runs.
+ */
+
+const uint TILE_CLASS_STATIC = 0u;
+const uint TILE_CLASS_SIMPLE = 1u;
+const uint TILE_CLASS_FILL = 2u;
+const int TILE_SIZE = 16;
+
+layout(constant_id = 0) const uint TILE_CLASS = 0u;
+
+#ifdef TILED
+layout(std430, set = 0, binding = 8) readonly buffer TileLists {
+    uvec4 tileDispatch[3]; // (groups, 1, 1, list capacity) per class
+    uint tiles[];          // Per-class lists of packed (x | y << 16)
+} tileLists;
+
+// Tile coordinate of the current workgroup in list `tileClass`
+ivec2 listTile(uint tileClass) {
+    uint capacity = tileLists.tileDispatch[tileClass].w;
+    uint packed = tileLists.tiles[tileClass * capacity + gl_WorkGroupID.x];
+    return ivec2(packed & 0xFFFFu, packed >> 16);
+}
+#endif
+
+// Pixel handled by this invocation
+ivec2 synthesisPixel() {
+#ifdef TILED
+    if (TILE_CLASS != TILE_CLASS_STATIC) {
+        return listTile(TILE_CLASS) * TILE_SIZE + ivec2(gl_LocalInvocationID.xy);
+    }
+#endif
+    return ivec2(gl_GlobalInvocationID.xy);
+}
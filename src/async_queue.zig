@@ -0,0 +1,506 @@
+//! Async Compute Queues
+//!
+//! By default frame generation is recorded into the game's command buffer,
+//! so it runs behind the game's graphics work on the same queue. With
+//! AsyncQueues nvvk owns command pools on an async compute queue (and on the
+//! optical flow queue family when optical flow cannot run on it) and submits
+//! frame generation itself. It then overlaps the rendering of the next real
+//! frame instead of adding to it.
+//!
+//! Synchronization with the game is by timeline semaphore values:
+//!   - submit waits on the game's value for "frame N rendered"
+//!   - the returned value signals "frame N generated"; the present of the
+//!     real frame and its generated frames waits on it
+//!
+//! Frames and output targets with VK_SHARING_MODE_EXCLUSIVE change queue
+//! family ownership between graphics and compute. nvvk records its half of
+//! each transfer (acquire of the frame, release of frame and outputs); the
+//! game records the matching halves with recordReleaseToCompute and
+//! recordAcquireFromCompute. Images the optical flow queue reads (frames,
+//! luma copies, ring slots) must use VK_SHARING_MODE_CONCURRENT instead;
+//! CONCURRENT images (OwnedImage.concurrent) never change ownership.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const mv_ring = @import("mv_ring.zig");
+const test_stubs = @import("test_stubs.zig");
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Command buffers that can be pending at once
+pub const frames_in_flight = 2;
+
+/// Queue families and queues frame generation runs on
+pub const QueueConfig = struct {
+    /// The game's graphics (present) queue family
+    graphics_family: u32,
+    /// Async compute queue family and queue
+    compute_family: u32,
+    compute_index: u32 = 0,
+    /// Optical flow queue family (VK_QUEUE_OPTICAL_FLOW_BIT_NV) and queue;
+    /// null when the compute queue also supports optical flow
+    flow_family: ?u32 = null,
+    flow_index: u32 = 0,
+
+    /// Check if images change ownership between graphics and compute
+    pub fn transfersOwnership(self: QueueConfig) bool {
+        return self.graphics_family != self.compute_family;
+    }
+};
+
+/// Image changing queue family ownership, kept in its layout
+pub const OwnedImage = struct {
+    image: vk.VkImage,
+    layout: u32,
+    /// Created with VK_SHARING_MODE_CONCURRENT: no transfer is recorded
+    concurrent: bool = false,
+};
+
+/// Command buffers of one frame, in the recording state
+pub const AsyncFrame = struct {
+    /// Frame number; the frame's completion value on the timeline
+    number: u64,
+    compute_cmd: vk.VkCommandBuffer,
+    /// Optical flow command buffer (null = record flow into compute_cmd)
+    flow_cmd: ?vk.VkCommandBuffer,
+};
+
+/// nvvk-owned queues, command buffers and completion timeline
+pub const AsyncQueues = struct {
+    dispatch: *const vk.DeviceDispatch,
+    config: QueueConfig,
+
+    compute_queue: vk.VkQueue,
+    compute_pool: vk.VkCommandPool,
+    compute_cmds: [frames_in_flight]vk.VkCommandBuffer,
+
+    flow_queue: ?vk.VkQueue = null,
+    flow_pool: ?vk.VkCommandPool = null,
+    flow_cmds: [frames_in_flight]?vk.VkCommandBuffer = .{null} ** frames_in_flight,
+
+    // Value N once frame N's generation completed
+    timeline: vk.VkSemaphore,
+    // Frames submitted so far. A frame that failed to record is recorded
+    // again under the same number.
+    submitted: u64 = 0,
+
+    pub fn init(dispatch: *const vk.DeviceDispatch, config: QueueConfig) !AsyncQueues {
+        if (!dispatch.hasQueueSubmission() or !dispatch.hasTimelineSemaphores()) return vk.VulkanError.FunctionNotFound;
+        const d = dispatch;
+
+        var compute_queue: vk.VkQueue = undefined;
+        d.vkGetDeviceQueue.?(d.device, config.compute_family, config.compute_index, &compute_queue);
+        var compute_pool: vk.VkCommandPool = undefined;
+        try vk.check(d.vkCreateCommandPool.?(d.device, &.{ .queueFamilyIndex = config.compute_family }, null, &compute_pool));
+        errdefer d.vkDestroyCommandPool.?(d.device, compute_pool, null);
+
+        var queues = AsyncQueues{
+            .dispatch = dispatch,
+            .config = config,
+            .compute_queue = compute_queue,
+            .compute_pool = compute_pool,
+            .compute_cmds = undefined,
+            .timeline = undefined,
+        };
+        try vk.check(d.vkAllocateCommandBuffers.?(d.device, &.{
+            .commandPool = compute_pool,
+            .commandBufferCount = frames_in_flight,
+        }, &queues.compute_cmds));
+
+        if (config.flow_family) |family| {
+            var flow_queue: vk.VkQueue = undefined;
+            d.vkGetDeviceQueue.?(d.device, family, config.flow_index, &flow_queue);
+            var flow_pool: vk.VkCommandPool = undefined;
+            try vk.check(d.vkCreateCommandPool.?(d.device, &.{ .queueFamilyIndex = family }, null, &flow_pool));
+            errdefer d.vkDestroyCommandPool.?(d.device, flow_pool, null);
+            var flow_cmds: [frames_in_flight]vk.VkCommandBuffer = undefined;
+            try vk.check(d.vkAllocateCommandBuffers.?(d.device, &.{
+                .commandPool = flow_pool,
+                .commandBufferCount = frames_in_flight,
+            }, &flow_cmds));
+            queues.flow_queue = flow_queue;
+            queues.flow_pool = flow_pool;
+            for (&queues.flow_cmds, flow_cmds) |*slot, cmd| slot.* = cmd;
+        }
+        errdefer if (queues.flow_pool) |pool| d.vkDestroyCommandPool.?(d.device, pool, null);
+
+        const type_info = vk.VkSemaphoreTypeCreateInfo{};
+        try vk.check(d.vkCreateSemaphore.?(d.device, &.{ .pNext = &type_info }, null, &queues.timeline));
+        return queues;
+    }
+
+    /// Destroy pools and the timeline. Wait for the last frame first.
+    pub fn deinit(self: *AsyncQueues) void {
+        const d = self.dispatch;
+        d.vkDestroySemaphore.?(d.device, self.timeline, null);
+        if (self.flow_pool) |pool| d.vkDestroyCommandPool.?(d.device, pool, null);
+        d.vkDestroyCommandPool.?(d.device, self.compute_pool, null);
+    }
+
+    /// Start recording the next frame. Blocks only while the GPU is
+    /// frames_in_flight frames behind, when its command buffers are still
+    /// pending.
+    pub fn beginFrame(self: *AsyncQueues) !AsyncFrame {
+        const d = self.dispatch;
+        const number = self.submitted + 1;
+        if (number > frames_in_flight) {
+            const semaphores = [_]vk.VkSemaphore{self.timeline};
+            const values = [_]u64{number - frames_in_flight};
+            try vk.check(d.vkWaitSemaphores.?(d.device, &.{
+                .semaphoreCount = 1,
+                .pSemaphores = &semaphores,
+                .pValues = &values,
+            }, std.math.maxInt(u64)));
+        }
+
+        const slot: usize = @intCast(number % frames_in_flight);
+        const compute_cmd = self.compute_cmds[slot];
+        try beginCommandBuffer(d, compute_cmd);
+        const flow_cmd = self.flow_cmds[slot];
+        if (flow_cmd) |cmd| try beginCommandBuffer(d, cmd);
+
+        return .{ .number = number, .compute_cmd = compute_cmd, .flow_cmd = flow_cmd };
+    }
+
+    /// Acquire images the game released with recordReleaseToCompute
+    pub fn acquireFromGraphics(self: *const AsyncQueues, cmd: vk.VkCommandBuffer, images: []const OwnedImage) void {
+        if (!self.config.transfersOwnership()) return;
+        self.recordTransfer(cmd, images, self.config.graphics_family, self.config.compute_family, false);
+    }
+
+    /// Release images back to the game (recordAcquireFromCompute)
+    pub fn releaseToGraphics(self: *const AsyncQueues, cmd: vk.VkCommandBuffer, images: []const OwnedImage) void {
+        if (!self.config.transfersOwnership()) return;
+        self.recordTransfer(cmd, images, self.config.compute_family, self.config.graphics_family, true);
+    }
+
+    /// Game side: release a rendered frame to the compute queue. Record at
+    /// the end of the frame's last graphics command buffer.
+    pub fn recordReleaseToCompute(self: *const AsyncQueues, game_cmd: vk.VkCommandBuffer, images: []const OwnedImage) void {
+        if (!self.config.transfersOwnership()) return;
+        self.recordTransfer(game_cmd, images, self.config.graphics_family, self.config.compute_family, true);
+    }
+
+    /// Game side: take the real frame and generated frames back before
+    /// presenting them. Record in a graphics command buffer that waits on
+    /// the value returned by submit.
+    pub fn recordAcquireFromCompute(self: *const AsyncQueues, game_cmd: vk.VkCommandBuffer, images: []const OwnedImage) void {
+        if (!self.config.transfersOwnership()) return;
+        self.recordTransfer(game_cmd, images, self.config.compute_family, self.config.graphics_family, false);
+    }
+
+    /// End and submit a frame's command buffers.
+    ///
+    /// `rendered` is the game's value for the real frame being complete.
+    /// `flow` carries the motion vector ring values when optical flow was
+    /// recorded into flow_cmd; `output_wait` is the output ring's pending
+    /// release. Returns the value signalled once the frame is generated.
+    pub fn submit(
+        self: *AsyncQueues,
+        frame: AsyncFrame,
+        rendered: mv_ring.TimelineValue,
+        flow: ?mv_ring.FrameSync,
+        output_wait: ?mv_ring.TimelineValue,
+    ) !mv_ring.TimelineValue {
+        const d = self.dispatch;
+        try vk.check(d.vkEndCommandBuffer.?(frame.compute_cmd));
+        if (frame.flow_cmd) |flow_cmd| {
+            try vk.check(d.vkEndCommandBuffer.?(flow_cmd));
+            // Nothing recorded for optical flow (history still filling)
+            if (flow) |sync| {
+                var waits = TimelineList{};
+                waits.add(rendered);
+                if (sync.flow.wait) |w| waits.add(w);
+                var signals = TimelineList{};
+                signals.add(sync.flow.signal);
+                try self.submitOne(self.flow_queue.?, flow_cmd, &waits, &signals);
+            }
+        }
+
+        var waits = TimelineList{};
+        waits.add(rendered);
+        if (flow) |sync| {
+            if (sync.synthesis.wait) |w| waits.add(w);
+        }
+        if (output_wait) |w| waits.add(w);
+        const done = mv_ring.TimelineValue{ .semaphore = self.timeline, .value = frame.number };
+        var signals = TimelineList{};
+        signals.add(done);
+        if (flow) |sync| signals.add(sync.synthesis.signal);
+        try self.submitOne(self.compute_queue, frame.compute_cmd, &waits, &signals);
+        self.submitted = frame.number;
+        return done;
+    }
+
+    /// Submit a frame that failed to record in place of submit: whatever
+    /// was recorded is discarded and only the round trip of `images`
+    /// (acquired from and released back to graphics) runs. The frame's
+    /// value and the ring values of `flow` are still signalled, so later
+    /// waits on them complete. The game takes the images back after
+    /// waiting on the frame's value (frame.number on the timeline).
+    pub fn submitReleaseOnly(
+        self: *AsyncQueues,
+        frame: AsyncFrame,
+        rendered: mv_ring.TimelineValue,
+        flow: ?mv_ring.FrameSync,
+        images: []const OwnedImage,
+    ) !void {
+        const d = self.dispatch;
+        if (frame.flow_cmd) |flow_cmd| try vk.check(d.vkResetCommandBuffer.?(flow_cmd, 0));
+        try beginCommandBuffer(d, frame.compute_cmd);
+        self.acquireFromGraphics(frame.compute_cmd, images);
+        self.releaseToGraphics(frame.compute_cmd, images);
+        try vk.check(d.vkEndCommandBuffer.?(frame.compute_cmd));
+
+        var waits = TimelineList{};
+        waits.add(rendered);
+        var signals = TimelineList{};
+        signals.add(.{ .semaphore = self.timeline, .value = frame.number });
+        if (flow) |sync| {
+            if (sync.synthesis.wait) |w| waits.add(w);
+            signals.add(sync.flow.signal);
+            signals.add(sync.synthesis.signal);
+        }
+        try self.submitOne(self.compute_queue, frame.compute_cmd, &waits, &signals);
+        self.submitted = frame.number;
+    }
+
+    /// Frames whose generation the GPU has completed
+    pub fn completedFrames(self: *const AsyncQueues) !u64 {
+        var value: u64 = 0;
+        try vk.check(self.dispatch.vkGetSemaphoreCounterValue.?(self.dispatch.device, self.timeline, &value));
+        return value;
+    }
+
+    fn submitOne(self: *const AsyncQueues, queue: vk.VkQueue, cmd: vk.VkCommandBuffer, waits: *const TimelineList, signals: *const TimelineList) !void {
+        const stages = [_]vk.VkPipelineStageFlags{vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT} ** TimelineList.capacity;
+        const timeline_info = vk.VkTimelineSemaphoreSubmitInfo{
+            .waitSemaphoreValueCount = waits.count,
+            .pWaitSemaphoreValues = &waits.values,
+            .signalSemaphoreValueCount = signals.count,
+            .pSignalSemaphoreValues = &signals.values,
+        };
+        const cmds = [_]vk.VkCommandBuffer{cmd};
+        const info = [_]vk.VkSubmitInfo{.{
+            .pNext = &timeline_info,
+            .waitSemaphoreCount = waits.count,
+            .pWaitSemaphores = &waits.semaphores,
+            .pWaitDstStageMask = &stages,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &cmds,
+            .signalSemaphoreCount = signals.count,
+            .pSignalSemaphores = &signals.semaphores,
+        }};
+        try vk.check(self.dispatch.vkQueueSubmit.?(queue, 1, &info, null));
+    }
+
+    fn recordTransfer(self: *const AsyncQueues, cmd: vk.VkCommandBuffer, images: []const OwnedImage, src_family: u32, dst_family: u32, release: bool) void {
+        var barriers: [max_transfer_images]vk.VkImageMemoryBarrier = undefined;
+        var count: usize = 0;
+        for (images) |owned| {
+            if (owned.concurrent) continue;
+            if (count == max_transfer_images) break;
+            barriers[count] = .{
+                // Availability on release, visibility on acquire
+                .srcAccessMask = if (release) vk.VK_ACCESS_MEMORY_WRITE_BIT else 0,
+                .dstAccessMask = if (release) 0 else vk.VK_ACCESS_MEMORY_READ_BIT | vk.VK_ACCESS_MEMORY_WRITE_BIT,
+                .oldLayout = owned.layout,
+                .newLayout = owned.layout,
+                .srcQueueFamilyIndex = src_family,
+                .dstQueueFamilyIndex = dst_family,
+                .image = owned.image,
+            };
+            count += 1;
+        }
+        if (count == 0) return;
+        self.dispatch.cmdImageBarriers(
+            cmd,
+            if (release) vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT else vk.VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            if (release) vk.VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT else vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            .{},
+            barriers[0..count],
+        );
+    }
+};
+
+/// Most images in one ownership transfer: the real frame and a full batch
+pub const max_transfer_images = 4;
+
+/// Semaphores and values of one side of a submission
+const TimelineList = struct {
+    const capacity = 3;
+    semaphores: [capacity]vk.VkSemaphore = undefined,
+    values: [capacity]u64 = undefined,
+    count: u32 = 0,
+
+    fn add(self: *TimelineList, value: mv_ring.TimelineValue) void {
+        self.semaphores[self.count] = value.semaphore;
+        self.values[self.count] = value.value;
+        self.count += 1;
+    }
+};
+
+fn beginCommandBuffer(d: *const vk.DeviceDispatch, cmd: vk.VkCommandBuffer) !void {
+    try vk.check(d.vkResetCommandBuffer.?(cmd, 0));
+    try vk.check(d.vkBeginCommandBuffer.?(cmd, &.{}));
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+var stub_submits: [4]struct { queue: usize, waits: u32, signals: u32, last_signal: u64 } = undefined;
+var stub_submit_count: usize = 0;
+var stub_waited: u64 = 0;
+var stub_barriers: u32 = 0;
+
+fn stubGetDeviceQueue(_: vk.VkDevice, family: u32, _: u32, queue: *vk.VkQueue) callconv(.c) void {
+    queue.* = @ptrFromInt(0x100 + family);
+}
+
+fn stubCreateCommandPool(_: vk.VkDevice, info: *const vk.VkCommandPoolCreateInfo, _: ?*const vk.VkAllocationCallbacks, pool: *vk.VkCommandPool) callconv(.c) vk.VkResult {
+    pool.* = @ptrFromInt(0x200 + info.queueFamilyIndex);
+    return .success;
+}
+
+fn stubDestroyCommandPool(_: vk.VkDevice, _: vk.VkCommandPool, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {}
+
+fn stubAllocateCommandBuffers(_: vk.VkDevice, info: *const vk.VkCommandBufferAllocateInfo, cmds: [*]vk.VkCommandBuffer) callconv(.c) vk.VkResult {
+    for (0..info.commandBufferCount) |i| cmds[i] = @ptrFromInt(@intFromPtr(info.commandPool) * 0x10 + i);
+    return .success;
+}
+
+fn stubResetCommandBuffer(_: vk.VkCommandBuffer, _: u32) callconv(.c) vk.VkResult {
+    return .success;
+}
+
+fn stubBeginCommandBuffer(_: vk.VkCommandBuffer, _: *const vk.VkCommandBufferBeginInfo) callconv(.c) vk.VkResult {
+    return .success;
+}
+
+fn stubEndCommandBuffer(_: vk.VkCommandBuffer) callconv(.c) vk.VkResult {
+    return .success;
+}
+
+fn stubQueueSubmit(queue: vk.VkQueue, _: u32, info: [*]const vk.VkSubmitInfo, _: ?vk.VkFence) callconv(.c) vk.VkResult {
+    const timeline: *const vk.VkTimelineSemaphoreSubmitInfo = @ptrCast(@alignCast(info[0].pNext.?));
+    stub_submits[stub_submit_count] = .{
+        .queue = @intFromPtr(queue),
+        .waits = info[0].waitSemaphoreCount,
+        .signals = info[0].signalSemaphoreCount,
+        .last_signal = timeline.pSignalSemaphoreValues.?[timeline.signalSemaphoreValueCount - 1],
+    };
+    stub_submit_count += 1;
+    return .success;
+}
+
+fn stubWaitSemaphores(_: vk.VkDevice, info: *const vk.VkSemaphoreWaitInfo, _: u64) callconv(.c) vk.VkResult {
+    stub_waited = info.pValues[0];
+    return .success;
+}
+
+fn stubPipelineBarrier(_: vk.VkCommandBuffer, _: vk.VkPipelineStageFlags, _: vk.VkPipelineStageFlags, _: u32, _: u32, _: ?[*]const vk.VkMemoryBarrier, _: u32, _: ?*const anyopaque, image_count: u32, _: ?*const anyopaque) callconv(.c) void {
+    stub_barriers += image_count;
+}
+
+const stub_dispatch = vk.DeviceDispatch{
+    .device = test_stubs.device,
+    .vkGetDeviceQueue = stubGetDeviceQueue,
+    .vkCreateCommandPool = stubCreateCommandPool,
+    .vkDestroyCommandPool = stubDestroyCommandPool,
+    .vkAllocateCommandBuffers = stubAllocateCommandBuffers,
+    .vkResetCommandBuffer = stubResetCommandBuffer,
+    .vkBeginCommandBuffer = stubBeginCommandBuffer,
+    .vkEndCommandBuffer = stubEndCommandBuffer,
+    .vkQueueSubmit = stubQueueSubmit,
+    .vkWaitSemaphores = stubWaitSemaphores,
+    .vkCreateSemaphore = test_stubs.createSemaphore,
+    .vkDestroySemaphore = test_stubs.destroySemaphore,
+    .vkGetSemaphoreCounterValue = test_stubs.counterValue,
+    .vkCmdPipelineBarrier = stubPipelineBarrier,
+};
+
+test "AsyncQueues submits flow and synthesis with timeline values" {
+    var queues = try AsyncQueues.init(&stub_dispatch, .{ .graphics_family = 0, .compute_family = 2, .flow_family = 5 });
+    defer queues.deinit();
+    try std.testing.expectEqual(@as(vk.VkQueue, @ptrFromInt(0x105)), queues.flow_queue.?);
+
+    const game = mv_ring.TimelineValue{ .semaphore = @ptrFromInt(0x400), .value = 10 };
+    const ring = mv_ring.FrameSync{
+        .flow = .{ .signal = .{ .semaphore = @ptrFromInt(0x500), .value = 1 } },
+        .synthesis = .{
+            .wait = .{ .semaphore = @ptrFromInt(0x500), .value = 1 },
+            .signal = .{ .semaphore = @ptrFromInt(0x501), .value = 1 },
+        },
+    };
+
+    stub_submit_count = 0;
+    stub_waited = 0;
+    const frame = try queues.beginFrame();
+    try std.testing.expect(frame.flow_cmd != null);
+    const done = try queues.submit(frame, game, ring, null);
+    try std.testing.expectEqual(@as(u64, 1), done.value);
+    try std.testing.expectEqual(@as(usize, 2), stub_submit_count);
+    // Flow: waits for the game, signals the ring
+    try std.testing.expectEqual(@as(usize, 0x105), stub_submits[0].queue);
+    try std.testing.expectEqual(@as(u32, 1), stub_submits[0].waits);
+    // Synthesis: waits for the game and flow, signals completion and the ring
+    try std.testing.expectEqual(@as(usize, 0x102), stub_submits[1].queue);
+    try std.testing.expectEqual(@as(u32, 2), stub_submits[1].waits);
+    try std.testing.expectEqual(@as(u32, 2), stub_submits[1].signals);
+
+    // Command buffers are reused frames_in_flight frames later
+    _ = try queues.submit(try queues.beginFrame(), game, null, null);
+    try std.testing.expectEqual(@as(u64, 0), stub_waited);
+    const third = try queues.beginFrame();
+    try std.testing.expectEqual(@as(u64, 1), stub_waited);
+    try std.testing.expectEqual(frame.compute_cmd, third.compute_cmd);
+}
+
+test "AsyncQueues ownership transfers" {
+    var same = try AsyncQueues.init(&stub_dispatch, .{ .graphics_family = 0, .compute_family = 0 });
+    defer same.deinit();
+    try std.testing.expect(same.flow_queue == null);
+
+    const images = [_]OwnedImage{.{ .image = @ptrFromInt(0x10), .layout = vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }};
+    stub_barriers = 0;
+    same.acquireFromGraphics(@ptrFromInt(0x20), &images);
+    try std.testing.expectEqual(@as(u32, 0), stub_barriers);
+
+    var split = try AsyncQueues.init(&stub_dispatch, .{ .graphics_family = 0, .compute_family = 2 });
+    defer split.deinit();
+    split.recordReleaseToCompute(@ptrFromInt(0x20), &images);
+    split.acquireFromGraphics(@ptrFromInt(0x21), &images);
+    try std.testing.expectEqual(@as(u32, 2), stub_barriers);
+
+    // CONCURRENT images are left out
+    const mixed = [_]OwnedImage{
+        .{ .image = @ptrFromInt(0x10), .layout = vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, .concurrent = true },
+        .{ .image = @ptrFromInt(0x11), .layout = vk.VK_IMAGE_LAYOUT_GENERAL },
+    };
+    stub_barriers = 0;
+    split.releaseToGraphics(@ptrFromInt(0x22), &mixed);
+    try std.testing.expectEqual(@as(u32, 1), stub_barriers);
+    split.releaseToGraphics(@ptrFromInt(0x22), mixed[0..1]);
+    try std.testing.expectEqual(@as(u32, 1), stub_barriers);
+}
+
+test "AsyncQueues release-only submission after a failed recording" {
+    var queues = try AsyncQueues.init(&stub_dispatch, .{ .graphics_family = 0, .compute_family = 2 });
+    defer queues.deinit();
+    const game = mv_ring.TimelineValue{ .semaphore = @ptrFromInt(0x400), .value = 10 };
+    const images = [_]OwnedImage{.{ .image = @ptrFromInt(0x10), .layout = vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }};
+
+    stub_submit_count = 0;
+    stub_barriers = 0;
+    const frame = try queues.beginFrame();
+    try queues.submitReleaseOnly(frame, game, null, &images);
+    // Acquire and release of the frame, signalling the frame's value
+    try std.testing.expectEqual(@as(u32, 2), stub_barriers);
+    try std.testing.expectEqual(@as(usize, 1), stub_submit_count);
+    try std.testing.expectEqual(frame.number, stub_submits[0].last_signal);
+    try std.testing.expectEqual(frame.number, queues.submitted);
+    try std.testing.expectEqual(@as(u64, 2), (try queues.beginFrame()).number);
+}
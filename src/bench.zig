@@ -0,0 +1,1073 @@
+//! nvvk-bench - Synthesis Shader Variant Benchmark
+//!
+//! Headless: creates its own instance and device, binds mid-gray frames
+//! and times every synthesis shader in every variant (precision x
+//! workgroup shape, see shader_variants.zig). Runs on any Vulkan 1.2
+//! device, lavapipe included, so variant regressions show up in CI:
+//!
+//!   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json zig build bench
+//!
+//! Usage: nvvk-bench [shader dir | -] [width] [height] [device index]
+//!
+//! SPIR-V comes from the library's embedded copy ("-", the default) or a
+//! directory of .spv files (shader_library.zig). The startup section
+//! times what the first generated frame waits for: SPIR-V lookup and
+//! pipeline creation of every synthesis shader in the heuristic variant,
+//! embedded vs read from the directory.
+//!
+//! Each measurement submits `dispatches_per_submit` back-to-back dispatches
+//! (with barriers, as in a real frame) and takes the wall-clock time of
+//! submit + fence wait. That includes submission overhead, which the
+//! per-dispatch average amortizes.
+//!
+//! The recording section times the CPU side of a 4x batch in the heuristic
+//! variant: recording it into the frame's command buffer, as pushFrame
+//! does by default, vs replaying a secondary buffer recorded once
+//! (synthesis_replay.zig).
+
+const std = @import("std");
+const nvvk = @import("nvvk");
+const vk = nvvk.vulkan;
+const shader_variants = nvvk.shader_variants;
+const shader_library = nvvk.shader_library;
+const frame_synthesis = nvvk.frame_synthesis;
+const synthesis_constants = nvvk.synthesis_constants;
+
+const warmup_submits = 2;
+const measured_submits = 5;
+const dispatches_per_submit = 20;
+const recorded_batches = 1000;
+
+// =============================================================================
+// Headless Vulkan Bindings (instance and resource creation)
+// =============================================================================
+
+const VkFence = *opaque {};
+const VkCommandPool = *opaque {};
+
+const VK_API_VERSION_1_2: u32 = (1 << 22) | (2 << 12);
+const VK_QUEUE_COMPUTE_BIT: u32 = 0x2;
+const VK_FORMAT_R8G8B8A8_UNORM: u32 = 37;
+const VK_IMAGE_USAGE_TRANSFER_DST_BIT: u32 = 0x2;
+const VK_IMAGE_USAGE_SAMPLED_BIT: u32 = 0x4;
+const VK_IMAGE_USAGE_STORAGE_BIT: u32 = 0x8;
+const VK_BUFFER_USAGE_TRANSFER_DST_BIT: u32 = 0x2;
+const VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT: u32 = 0x10;
+const VK_BUFFER_USAGE_STORAGE_BUFFER_BIT: u32 = 0x20;
+const VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT: u32 = 0x100;
+const VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT: u32 = 0x1;
+const VK_IMAGE_LAYOUT_UNDEFINED: u32 = 0;
+const VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL: u32 = 7;
+const VK_FILTER_LINEAR: u32 = 1;
+const VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE: u32 = 2;
+
+const VkApplicationInfo = extern struct {
+    sType: u32 = 0,
+    pNext: ?*const anyopaque = null,
+    pApplicationName: ?[*:0]const u8 = "nvvk-bench",
+    applicationVersion: u32 = 0,
+    pEngineName: ?[*:0]const u8 = "nvvk",
+    engineVersion: u32 = 0,
+    apiVersion: u32 = VK_API_VERSION_1_2,
+};
+
+const VkInstanceCreateInfo = extern struct {
+    sType: u32 = 1,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    pApplicationInfo: ?*const VkApplicationInfo = null,
+    enabledLayerCount: u32 = 0,
+    ppEnabledLayerNames: ?[*]const [*:0]const u8 = null,
+    enabledExtensionCount: u32 = 0,
+    ppEnabledExtensionNames: ?[*]const [*:0]const u8 = null,
+};
+
+const VkQueueFamilyProperties = extern struct {
+    queueFlags: u32,
+    queueCount: u32,
+    timestampValidBits: u32,
+    minImageTransferGranularity: vk.VkExtent3D,
+};
+
+const VkDeviceQueueCreateInfo = extern struct {
+    sType: u32 = 2,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    queueFamilyIndex: u32,
+    queueCount: u32 = 1,
+    pQueuePriorities: [*]const f32,
+};
+
+const VkDeviceCreateInfo = extern struct {
+    sType: u32 = 3,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    queueCreateInfoCount: u32 = 1,
+    pQueueCreateInfos: [*]const VkDeviceQueueCreateInfo,
+    enabledLayerCount: u32 = 0,
+    ppEnabledLayerNames: ?[*]const [*:0]const u8 = null,
+    enabledExtensionCount: u32 = 0,
+    ppEnabledExtensionNames: ?[*]const [*:0]const u8 = null,
+    pEnabledFeatures: ?*const anyopaque = null,
+};
+
+const VkSubmitInfo = extern struct {
+    sType: u32 = 4,
+    pNext: ?*const anyopaque = null,
+    waitSemaphoreCount: u32 = 0,
+    pWaitSemaphores: ?*const anyopaque = null,
+    pWaitDstStageMask: ?*const u32 = null,
+    commandBufferCount: u32 = 1,
+    pCommandBuffers: [*]const vk.VkCommandBuffer,
+    signalSemaphoreCount: u32 = 0,
+    pSignalSemaphores: ?*const anyopaque = null,
+};
+
+const VkMemoryAllocateInfo = extern struct {
+    sType: u32 = 5,
+    pNext: ?*const anyopaque = null,
+    allocationSize: vk.VkDeviceSize,
+    memoryTypeIndex: u32,
+};
+
+const VkFenceCreateInfo = extern struct {
+    sType: u32 = 8,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+};
+
+const VkBufferCreateInfo = extern struct {
+    sType: u32 = 12,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    size: vk.VkDeviceSize,
+    usage: u32,
+    sharingMode: u32 = 0,
+    queueFamilyIndexCount: u32 = 0,
+    pQueueFamilyIndices: ?[*]const u32 = null,
+};
+
+const VkImageCreateInfo = extern struct {
+    sType: u32 = 14,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    imageType: u32 = 1, // 2D
+    format: u32 = VK_FORMAT_R8G8B8A8_UNORM,
+    extent: vk.VkExtent3D,
+    mipLevels: u32 = 1,
+    arrayLayers: u32 = 1,
+    samples: u32 = 1,
+    tiling: u32 = 0, // optimal
+    usage: u32,
+    sharingMode: u32 = 0,
+    queueFamilyIndexCount: u32 = 0,
+    pQueueFamilyIndices: ?[*]const u32 = null,
+    initialLayout: u32 = VK_IMAGE_LAYOUT_UNDEFINED,
+};
+
+const VkImageSubresourceRange = extern struct {
+    aspectMask: u32 = vk.VK_IMAGE_ASPECT_COLOR_BIT,
+    baseMipLevel: u32 = 0,
+    levelCount: u32 = 1,
+    baseArrayLayer: u32 = 0,
+    layerCount: u32 = 1,
+};
+
+const VkImageViewCreateInfo = extern struct {
+    sType: u32 = 15,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    image: vk.VkImage,
+    viewType: u32 = 1, // 2D
+    format: u32 = VK_FORMAT_R8G8B8A8_UNORM,
+    components: [4]u32 = .{ 0, 0, 0, 0 }, // identity
+    subresourceRange: VkImageSubresourceRange = .{},
+};
+
+const VkPipelineLayoutCreateInfo = extern struct {
+    sType: u32 = 30,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    setLayoutCount: u32 = 1,
+    pSetLayouts: [*]const vk.VkDescriptorSetLayout,
+    pushConstantRangeCount: u32 = 0,
+    pPushConstantRanges: ?*const anyopaque = null,
+};
+
+const VkSamplerCreateInfo = extern struct {
+    sType: u32 = 31,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    magFilter: u32 = VK_FILTER_LINEAR,
+    minFilter: u32 = VK_FILTER_LINEAR,
+    mipmapMode: u32 = 0,
+    addressModeU: u32 = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+    addressModeV: u32 = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+    addressModeW: u32 = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+    mipLodBias: f32 = 0,
+    anisotropyEnable: vk.VkBool32 = vk.VK_FALSE,
+    maxAnisotropy: f32 = 1,
+    compareEnable: vk.VkBool32 = vk.VK_FALSE,
+    compareOp: u32 = 0,
+    minLod: f32 = 0,
+    maxLod: f32 = 0,
+    borderColor: u32 = 0,
+    unnormalizedCoordinates: vk.VkBool32 = vk.VK_FALSE,
+};
+
+const VkDescriptorPoolSize = extern struct {
+    type: u32,
+    descriptorCount: u32,
+};
+
+const VkDescriptorPoolCreateInfo = extern struct {
+    sType: u32 = 33,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    maxSets: u32,
+    poolSizeCount: u32,
+    pPoolSizes: [*]const VkDescriptorPoolSize,
+};
+
+const VkDescriptorSetAllocateInfo = extern struct {
+    sType: u32 = 34,
+    pNext: ?*const anyopaque = null,
+    descriptorPool: vk.VkDescriptorPool,
+    descriptorSetCount: u32 = 1,
+    pSetLayouts: [*]const vk.VkDescriptorSetLayout,
+};
+
+const VkDescriptorImageInfo = extern struct {
+    sampler: ?vk.VkSampler,
+    imageView: vk.VkImageView,
+    imageLayout: u32 = vk.VK_IMAGE_LAYOUT_GENERAL,
+};
+
+const VkDescriptorBufferInfo = extern struct {
+    buffer: vk.VkBuffer,
+    offset: vk.VkDeviceSize = 0,
+    range: vk.VkDeviceSize = ~@as(vk.VkDeviceSize, 0), // VK_WHOLE_SIZE
+};
+
+const VkWriteDescriptorSet = extern struct {
+    sType: u32 = 35,
+    pNext: ?*const anyopaque = null,
+    dstSet: vk.VkDescriptorSet,
+    dstBinding: u32,
+    dstArrayElement: u32 = 0,
+    descriptorCount: u32 = 1,
+    descriptorType: u32,
+    pImageInfo: ?*const VkDescriptorImageInfo = null,
+    pBufferInfo: ?*const VkDescriptorBufferInfo = null,
+    pTexelBufferView: ?*const anyopaque = null,
+};
+
+const VkCommandPoolCreateInfo = extern struct {
+    sType: u32 = 39,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0x2, // reset command buffer
+    queueFamilyIndex: u32,
+};
+
+const VkCommandBufferAllocateInfo = extern struct {
+    sType: u32 = 40,
+    pNext: ?*const anyopaque = null,
+    commandPool: VkCommandPool,
+    level: u32 = 0, // primary
+    commandBufferCount: u32 = 1,
+};
+
+const VkCommandBufferBeginInfo = extern struct {
+    sType: u32 = 42,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0x1, // one time submit
+    pInheritanceInfo: ?*const anyopaque = null,
+};
+
+const VkImageMemoryBarrier = extern struct {
+    sType: u32 = 45,
+    pNext: ?*const anyopaque = null,
+    srcAccessMask: vk.VkAccessFlags = 0,
+    dstAccessMask: vk.VkAccessFlags,
+    oldLayout: u32,
+    newLayout: u32,
+    srcQueueFamilyIndex: u32 = ~@as(u32, 0), // VK_QUEUE_FAMILY_IGNORED
+    dstQueueFamilyIndex: u32 = ~@as(u32, 0),
+    image: vk.VkImage,
+    subresourceRange: VkImageSubresourceRange = .{},
+};
+
+const VkMemoryRequirements = extern struct {
+    size: vk.VkDeviceSize,
+    alignment: vk.VkDeviceSize,
+    memoryTypeBits: u32,
+};
+
+const VkPhysicalDeviceMemoryProperties = extern struct {
+    memoryTypeCount: u32,
+    memoryTypes: [32]extern struct { propertyFlags: u32, heapIndex: u32 },
+    memoryHeapCount: u32,
+    memoryHeaps: [16]extern struct { size: vk.VkDeviceSize, flags: u32 },
+};
+
+const VkClearColorValue = extern struct {
+    float32: [4]f32,
+};
+
+/// Instance-level functions
+const InstanceFns = struct {
+    vkDestroyInstance: *const fn (vk.VkInstance, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkEnumeratePhysicalDevices: *const fn (vk.VkInstance, *u32, ?[*]vk.VkPhysicalDevice) callconv(.c) vk.VkResult,
+    vkGetPhysicalDeviceProperties: vk.PFN_vkGetPhysicalDeviceProperties,
+    vkGetPhysicalDeviceFeatures2: vk.PFN_vkGetPhysicalDeviceFeatures2,
+    vkGetPhysicalDeviceQueueFamilyProperties: *const fn (vk.VkPhysicalDevice, *u32, ?[*]VkQueueFamilyProperties) callconv(.c) void,
+    vkGetPhysicalDeviceMemoryProperties: *const fn (vk.VkPhysicalDevice, *VkPhysicalDeviceMemoryProperties) callconv(.c) void,
+    vkCreateDevice: *const fn (vk.VkPhysicalDevice, *const VkDeviceCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkDevice) callconv(.c) vk.VkResult,
+    vkGetDeviceProcAddr: vk.PFN_vkGetDeviceProcAddr,
+};
+
+/// Device-level functions not in vk.DeviceDispatch
+const DeviceFns = struct {
+    vkDestroyDevice: *const fn (vk.VkDevice, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkDeviceWaitIdle: *const fn (vk.VkDevice) callconv(.c) vk.VkResult,
+    vkGetDeviceQueue: *const fn (vk.VkDevice, u32, u32, *vk.VkQueue) callconv(.c) void,
+    vkCreateImage: *const fn (vk.VkDevice, *const VkImageCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkImage) callconv(.c) vk.VkResult,
+    vkDestroyImage: *const fn (vk.VkDevice, vk.VkImage, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkGetImageMemoryRequirements: *const fn (vk.VkDevice, vk.VkImage, *VkMemoryRequirements) callconv(.c) void,
+    vkBindImageMemory: *const fn (vk.VkDevice, vk.VkImage, vk.VkDeviceMemory, vk.VkDeviceSize) callconv(.c) vk.VkResult,
+    vkCreateBuffer: *const fn (vk.VkDevice, *const VkBufferCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkBuffer) callconv(.c) vk.VkResult,
+    vkDestroyBuffer: *const fn (vk.VkDevice, vk.VkBuffer, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkGetBufferMemoryRequirements: *const fn (vk.VkDevice, vk.VkBuffer, *VkMemoryRequirements) callconv(.c) void,
+    vkBindBufferMemory: *const fn (vk.VkDevice, vk.VkBuffer, vk.VkDeviceMemory, vk.VkDeviceSize) callconv(.c) vk.VkResult,
+    vkAllocateMemory: *const fn (vk.VkDevice, *const VkMemoryAllocateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkDeviceMemory) callconv(.c) vk.VkResult,
+    vkFreeMemory: *const fn (vk.VkDevice, vk.VkDeviceMemory, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkCreateImageView: *const fn (vk.VkDevice, *const VkImageViewCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkImageView) callconv(.c) vk.VkResult,
+    vkDestroyImageView: *const fn (vk.VkDevice, vk.VkImageView, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkCreateSampler: *const fn (vk.VkDevice, *const VkSamplerCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkSampler) callconv(.c) vk.VkResult,
+    vkDestroySampler: *const fn (vk.VkDevice, vk.VkSampler, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkCreateDescriptorSetLayout: *const fn (vk.VkDevice, *const vk.VkDescriptorSetLayoutCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkDescriptorSetLayout) callconv(.c) vk.VkResult,
+    vkDestroyDescriptorSetLayout: *const fn (vk.VkDevice, vk.VkDescriptorSetLayout, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkCreatePipelineLayout: *const fn (vk.VkDevice, *const VkPipelineLayoutCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkPipelineLayout) callconv(.c) vk.VkResult,
+    vkDestroyPipelineLayout: *const fn (vk.VkDevice, vk.VkPipelineLayout, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkCreateDescriptorPool: *const fn (vk.VkDevice, *const VkDescriptorPoolCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkDescriptorPool) callconv(.c) vk.VkResult,
+    vkDestroyDescriptorPool: *const fn (vk.VkDevice, vk.VkDescriptorPool, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkAllocateDescriptorSets: *const fn (vk.VkDevice, *const VkDescriptorSetAllocateInfo, *vk.VkDescriptorSet) callconv(.c) vk.VkResult,
+    vkUpdateDescriptorSets: *const fn (vk.VkDevice, u32, [*]const VkWriteDescriptorSet, u32, ?*const anyopaque) callconv(.c) void,
+    vkCreateCommandPool: *const fn (vk.VkDevice, *const VkCommandPoolCreateInfo, ?*const vk.VkAllocationCallbacks, *VkCommandPool) callconv(.c) vk.VkResult,
+    vkDestroyCommandPool: *const fn (vk.VkDevice, VkCommandPool, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkAllocateCommandBuffers: *const fn (vk.VkDevice, *const VkCommandBufferAllocateInfo, *vk.VkCommandBuffer) callconv(.c) vk.VkResult,
+    vkBeginCommandBuffer: *const fn (vk.VkCommandBuffer, *const VkCommandBufferBeginInfo) callconv(.c) vk.VkResult,
+    vkEndCommandBuffer: *const fn (vk.VkCommandBuffer) callconv(.c) vk.VkResult,
+    vkCmdClearColorImage: *const fn (vk.VkCommandBuffer, vk.VkImage, u32, *const VkClearColorValue, u32, [*]const VkImageSubresourceRange) callconv(.c) void,
+    vkQueueSubmit: *const fn (vk.VkQueue, u32, [*]const VkSubmitInfo, ?VkFence) callconv(.c) vk.VkResult,
+    vkCreateFence: *const fn (vk.VkDevice, *const VkFenceCreateInfo, ?*const vk.VkAllocationCallbacks, *VkFence) callconv(.c) vk.VkResult,
+    vkDestroyFence: *const fn (vk.VkDevice, VkFence, ?*const vk.VkAllocationCallbacks) callconv(.c) void,
+    vkWaitForFences: *const fn (vk.VkDevice, u32, [*]const VkFence, vk.VkBool32, u64) callconv(.c) vk.VkResult,
+    vkResetFences: *const fn (vk.VkDevice, u32, [*]const VkFence) callconv(.c) vk.VkResult,
+};
+
+const InstanceLookup = struct {
+    loader: *const vk.Loader,
+    instance: vk.VkInstance,
+
+    fn lookup(self: InstanceLookup, name: [*:0]const u8) ?*const fn () callconv(.c) void {
+        return self.loader.getInstanceProcAddr(self.instance, name);
+    }
+};
+
+/// Resolve every field of a function table by name
+fn loadFns(comptime T: type, context: anytype, lookup: anytype) vk.VulkanError!T {
+    var fns: T = undefined;
+    inline for (std.meta.fields(T)) |field| {
+        const ptr = lookup(context, field.name) orelse return vk.VulkanError.FunctionNotFound;
+        @field(fns, field.name) = @ptrCast(ptr);
+    }
+    return fns;
+}
+
+// =============================================================================
+// Shader Table
+// =============================================================================
+
+/// Synthesis shader with the constants block it is timed with. Sampled
+/// bindings read the input frame, the storage output writes the output;
+/// binding 8 holds the tile lists (unused by the full-frame variants),
+/// binding 9 the shader's block of output slot 0.
+const BenchShader = struct {
+    pass: frame_synthesis.PassShader,
+    constants: [synthesis_constants.block_size]u8,
+
+    fn name(self: BenchShader) []const u8 {
+        return self.pass.name();
+    }
+};
+
+// One per shader, plus the recording section's warp and blend sets of
+// every output slot
+const descriptor_sets: u32 = shader_variants.synthesis_shaders.len + 2 * frame_synthesis.max_batch_frames;
+
+fn benchShaders() [shader_variants.synthesis_shaders.len]BenchShader {
+    const warp = frame_synthesis.WarpConstants{ .mv_scale_x = 1, .mv_scale_y = 1, .interpolation = 0.5, .direction = 1 };
+    const blend = frame_synthesis.BlendConstants{ .weight = 0.5, .tile_confidence = 1 };
+    const confidence = frame_synthesis.ConfidenceBlendConstants{ .interpolation = 0.5, .cost_scale = 1, .min_confidence = 0.1, .tile_confidence = 1 };
+    // Frames are cleared to 0.5, so a 0.25 threshold takes the fill path
+    // everywhere (worst case)
+    const fill = frame_synthesis.OcclusionFillConstants{ .occlusion_threshold = 0.25, .fill_radius = 2, .interpolation = 0.5 };
+    return .{
+        .{ .pass = .forward_warp, .constants = std.mem.toBytes(warp) },
+        .{ .pass = .backward_warp, .constants = std.mem.toBytes(warp) },
+        .{ .pass = .linear_blend, .constants = std.mem.toBytes(blend) },
+        .{ .pass = .confidence_blend, .constants = std.mem.toBytes(confidence) },
+        .{ .pass = .occlusion_fill, .constants = std.mem.toBytes(fill) },
+    };
+}
+
+// =============================================================================
+// Headless Context
+// =============================================================================
+
+const Headless = struct {
+    loader: vk.Loader,
+    instance: vk.VkInstance,
+    ifns: InstanceFns,
+    physical_device: vk.VkPhysicalDevice,
+    props: vk.VkPhysicalDeviceProperties,
+    caps: shader_variants.DeviceCaps,
+    mem_props: VkPhysicalDeviceMemoryProperties,
+    device: vk.VkDevice,
+    dfns: DeviceFns,
+    dispatch: vk.DeviceDispatch,
+    queue: vk.VkQueue,
+    queue_family: u32,
+
+    fn init(device_index: u32) !Headless {
+        var loader = try vk.Loader.init();
+        errdefer loader.deinit();
+
+        const create_instance: *const fn (*const VkInstanceCreateInfo, ?*const vk.VkAllocationCallbacks, *vk.VkInstance) callconv(.c) vk.VkResult =
+            @ptrCast(loader.getInstanceProcAddr(null, "vkCreateInstance") orelse return vk.VulkanError.FunctionNotFound);
+        const app = VkApplicationInfo{};
+        var instance: vk.VkInstance = undefined;
+        try vk.check(create_instance(&.{ .pApplicationInfo = &app }, null, &instance));
+
+        const ifns = try loadFns(InstanceFns, InstanceLookup{ .loader = &loader, .instance = instance }, InstanceLookup.lookup);
+        errdefer ifns.vkDestroyInstance(instance, null);
+
+        var count: u32 = 0;
+        try vk.check(ifns.vkEnumeratePhysicalDevices(instance, &count, null));
+        var devices: [16]vk.VkPhysicalDevice = undefined;
+        count = @min(count, devices.len);
+        try vk.check(ifns.vkEnumeratePhysicalDevices(instance, &count, &devices));
+        if (device_index >= count) return vk.VulkanError.InitializationFailed;
+        const physical_device = devices[device_index];
+
+        var props = vk.VkPhysicalDeviceProperties{};
+        ifns.vkGetPhysicalDeviceProperties(physical_device, &props);
+        const caps = shader_variants.queryDeviceCaps(physical_device, ifns.vkGetPhysicalDeviceProperties, ifns.vkGetPhysicalDeviceFeatures2);
+        var mem_props: VkPhysicalDeviceMemoryProperties = undefined;
+        ifns.vkGetPhysicalDeviceMemoryProperties(physical_device, &mem_props);
+
+        var family_count: u32 = 0;
+        ifns.vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, null);
+        var families: [16]VkQueueFamilyProperties = undefined;
+        family_count = @min(family_count, families.len);
+        ifns.vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, &families);
+        const queue_family: u32 = for (families[0..family_count], 0..) |f, i| {
+            if (f.queueFlags & VK_QUEUE_COMPUTE_BIT != 0) break @intCast(i);
+        } else return vk.VulkanError.InitializationFailed;
+
+        // fp16 variants need shaderFloat16
+        var float16 = vk.VkPhysicalDeviceShaderFloat16Int8Features{
+            .shaderFloat16 = if (caps.shader_float16) vk.VK_TRUE else vk.VK_FALSE,
+        };
+        const features = vk.VkPhysicalDeviceFeatures2{ .pNext = &float16 };
+        const priority = [_]f32{1.0};
+        const queue_info = [_]VkDeviceQueueCreateInfo{.{ .queueFamilyIndex = queue_family, .pQueuePriorities = &priority }};
+        var device: vk.VkDevice = undefined;
+        try vk.check(ifns.vkCreateDevice(physical_device, &.{
+            .pNext = &features,
+            .pQueueCreateInfos = &queue_info,
+        }, null, &device));
+
+        const dfns = loadFns(DeviceFns, device, ifns.vkGetDeviceProcAddr) catch |err| {
+            // vkDestroyDevice resolves like any device function
+            if (ifns.vkGetDeviceProcAddr(device, "vkDestroyDevice")) |destroy| {
+                const destroy_device: *const fn (vk.VkDevice, ?*const vk.VkAllocationCallbacks) callconv(.c) void = @ptrCast(destroy);
+                destroy_device(device, null);
+            }
+            return err;
+        };
+        var queue: vk.VkQueue = undefined;
+        dfns.vkGetDeviceQueue(device, queue_family, 0, &queue);
+
+        return .{
+            .loader = loader,
+            .instance = instance,
+            .ifns = ifns,
+            .physical_device = physical_device,
+            .props = props,
+            .caps = caps,
+            .mem_props = mem_props,
+            .device = device,
+            .dfns = dfns,
+            .dispatch = vk.DeviceDispatch.init(device, ifns.vkGetDeviceProcAddr),
+            .queue = queue,
+            .queue_family = queue_family,
+        };
+    }
+
+    fn deinit(self: *Headless) void {
+        _ = self.dfns.vkDeviceWaitIdle(self.device);
+        self.dfns.vkDestroyDevice(self.device, null);
+        self.ifns.vkDestroyInstance(self.instance, null);
+        self.loader.deinit();
+    }
+
+    fn allocate(self: *const Headless, req: VkMemoryRequirements) !vk.VkDeviceMemory {
+        const type_index = for (0..self.mem_props.memoryTypeCount) |i| {
+            const t = self.mem_props.memoryTypes[i];
+            if (req.memoryTypeBits & (@as(u32, 1) << @intCast(i)) != 0 and
+                t.propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT != 0) break @as(u32, @intCast(i));
+        } else return vk.VulkanError.OutOfDeviceMemory;
+        var memory: vk.VkDeviceMemory = undefined;
+        try vk.check(self.dfns.vkAllocateMemory(self.device, &.{
+            .allocationSize = req.size,
+            .memoryTypeIndex = type_index,
+        }, null, &memory));
+        return memory;
+    }
+};
+
+/// rgba8 frame usable as sampled and storage image (GENERAL layout)
+const Frame = struct {
+    image: vk.VkImage,
+    view: vk.VkImageView,
+    memory: vk.VkDeviceMemory,
+
+    fn init(h: *const Headless, width: u32, height: u32) !Frame {
+        var image: vk.VkImage = undefined;
+        try vk.check(h.dfns.vkCreateImage(h.device, &.{
+            .extent = .{ .width = width, .height = height, .depth = 1 },
+            .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        }, null, &image));
+        errdefer h.dfns.vkDestroyImage(h.device, image, null);
+
+        var req: VkMemoryRequirements = undefined;
+        h.dfns.vkGetImageMemoryRequirements(h.device, image, &req);
+        const memory = try h.allocate(req);
+        errdefer h.dfns.vkFreeMemory(h.device, memory, null);
+        try vk.check(h.dfns.vkBindImageMemory(h.device, image, memory, 0));
+
+        var view: vk.VkImageView = undefined;
+        try vk.check(h.dfns.vkCreateImageView(h.device, &.{ .image = image }, null, &view));
+        return .{ .image = image, .view = view, .memory = memory };
+    }
+
+    fn deinit(self: *const Frame, h: *const Headless) void {
+        h.dfns.vkDestroyImageView(h.device, self.view, null);
+        h.dfns.vkDestroyImage(h.device, self.image, null);
+        h.dfns.vkFreeMemory(h.device, self.memory, null);
+    }
+};
+
+// =============================================================================
+// Benchmark
+// =============================================================================
+
+const Bench = struct {
+    h: *Headless,
+    allocator: std.mem.Allocator,
+    library: *shader_library.ShaderLibrary,
+    width: u32,
+    height: u32,
+    input: Frame,
+    output: Frame,
+    sampler: vk.VkSampler,
+    tile_buffer: vk.VkBuffer,
+    tile_memory: vk.VkDeviceMemory,
+    constants_buffer: vk.VkBuffer,
+    constants_memory: vk.VkDeviceMemory,
+    descriptor_pool: vk.VkDescriptorPool,
+    command_pool: VkCommandPool,
+    cmd: vk.VkCommandBuffer,
+    fence: VkFence,
+
+    fn init(h: *Headless, allocator: std.mem.Allocator, library: *shader_library.ShaderLibrary, width: u32, height: u32) !Bench {
+        const d = &h.dfns;
+        const input = try Frame.init(h, width, height);
+        const output = try Frame.init(h, width, height);
+
+        var sampler: vk.VkSampler = undefined;
+        try vk.check(d.vkCreateSampler(h.device, &.{}, null, &sampler));
+
+        var tile_buffer: vk.VkBuffer = undefined;
+        try vk.check(d.vkCreateBuffer(h.device, &.{ .size = 256, .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT }, null, &tile_buffer));
+        var req: VkMemoryRequirements = undefined;
+        d.vkGetBufferMemoryRequirements(h.device, tile_buffer, &req);
+        const tile_memory = try h.allocate(req);
+        try vk.check(d.vkBindBufferMemory(h.device, tile_buffer, tile_memory, 0));
+
+        var constants_buffer: vk.VkBuffer = undefined;
+        try vk.check(d.vkCreateBuffer(h.device, &.{
+            .size = synthesis_constants.buffer_size,
+            .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        }, null, &constants_buffer));
+        d.vkGetBufferMemoryRequirements(h.device, constants_buffer, &req);
+        const constants_memory = try h.allocate(req);
+        try vk.check(d.vkBindBufferMemory(h.device, constants_buffer, constants_memory, 0));
+
+        const pool_sizes = [_]VkDescriptorPoolSize{
+            .{ .type = vk.VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = frame_synthesis.max_pass_bindings * descriptor_sets },
+            .{ .type = vk.VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .descriptorCount = descriptor_sets },
+            .{ .type = vk.VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = descriptor_sets },
+            .{ .type = vk.VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = descriptor_sets },
+        };
+        var descriptor_pool: vk.VkDescriptorPool = undefined;
+        try vk.check(d.vkCreateDescriptorPool(h.device, &.{
+            .maxSets = descriptor_sets,
+            .poolSizeCount = pool_sizes.len,
+            .pPoolSizes = &pool_sizes,
+        }, null, &descriptor_pool));
+
+        var command_pool: VkCommandPool = undefined;
+        try vk.check(d.vkCreateCommandPool(h.device, &.{ .queueFamilyIndex = h.queue_family }, null, &command_pool));
+        var cmd: vk.VkCommandBuffer = undefined;
+        try vk.check(d.vkAllocateCommandBuffers(h.device, &.{ .commandPool = command_pool }, &cmd));
+        var fence: VkFence = undefined;
+        try vk.check(d.vkCreateFence(h.device, &.{}, null, &fence));
+
+        var bench = Bench{
+            .h = h,
+            .allocator = allocator,
+            .library = library,
+            .width = width,
+            .height = height,
+            .input = input,
+            .output = output,
+            .sampler = sampler,
+            .tile_buffer = tile_buffer,
+            .tile_memory = tile_memory,
+            .constants_buffer = constants_buffer,
+            .constants_memory = constants_memory,
+            .descriptor_pool = descriptor_pool,
+            .command_pool = command_pool,
+            .cmd = cmd,
+            .fence = fence,
+        };
+        try bench.prepareFrames();
+        return bench;
+    }
+
+    fn deinit(self: *Bench) void {
+        const h = self.h;
+        const d = &h.dfns;
+        _ = d.vkDeviceWaitIdle(h.device);
+        d.vkDestroyFence(h.device, self.fence, null);
+        d.vkDestroyCommandPool(h.device, self.command_pool, null);
+        d.vkDestroyDescriptorPool(h.device, self.descriptor_pool, null);
+        d.vkDestroyBuffer(h.device, self.tile_buffer, null);
+        d.vkFreeMemory(h.device, self.tile_memory, null);
+        d.vkDestroyBuffer(h.device, self.constants_buffer, null);
+        d.vkFreeMemory(h.device, self.constants_memory, null);
+        d.vkDestroySampler(h.device, self.sampler, null);
+        self.output.deinit(h);
+        self.input.deinit(h);
+    }
+
+    /// Fill the input with mid gray, move both frames to GENERAL and upload
+    /// every shader's constants block
+    fn prepareFrames(self: *Bench) !void {
+        const d = &self.h.dfns;
+        const barrier = self.h.dispatch.vkCmdPipelineBarrier orelse return vk.VulkanError.FunctionNotFound;
+        const update = self.h.dispatch.vkCmdUpdateBuffer orelse return vk.VulkanError.FunctionNotFound;
+        try vk.check(d.vkBeginCommandBuffer(self.cmd, &.{}));
+
+        var blocks = synthesis_constants.Blocks{};
+        for (benchShaders()) |shader| blocks.set(0, shader.pass, shader.constants);
+        update(self.cmd, self.constants_buffer, 0, synthesis_constants.slot_size, &blocks.bytes);
+
+        const to_transfer = [_]VkImageMemoryBarrier{.{
+            .dstAccessMask = vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .image = self.input.image,
+        }};
+        barrier(self.cmd, vk.VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, vk.VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, null, 0, null, 1, &to_transfer);
+        const gray = VkClearColorValue{ .float32 = .{ 0.5, 0.5, 0.5, 1.0 } };
+        const range = [_]VkImageSubresourceRange{.{}};
+        d.vkCmdClearColorImage(self.cmd, self.input.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &gray, 1, &range);
+
+        const to_general = [_]VkImageMemoryBarrier{
+            .{
+                .srcAccessMask = vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = vk.VK_ACCESS_SHADER_READ_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .newLayout = vk.VK_IMAGE_LAYOUT_GENERAL,
+                .image = self.input.image,
+            },
+            .{
+                .dstAccessMask = vk.VK_ACCESS_SHADER_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = vk.VK_IMAGE_LAYOUT_GENERAL,
+                .image = self.output.image,
+            },
+        };
+        barrier(self.cmd, vk.VK_PIPELINE_STAGE_TRANSFER_BIT, vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, null, 0, null, to_general.len, &to_general);
+        self.h.dispatch.cmdMemoryBarrier(
+            self.cmd,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            vk.VK_ACCESS_UNIFORM_READ_BIT,
+        );
+
+        try vk.check(d.vkEndCommandBuffer(self.cmd));
+        try self.submitAndWait();
+    }
+
+    fn submitAndWait(self: *Bench) !void {
+        const d = &self.h.dfns;
+        const cmds = [_]vk.VkCommandBuffer{self.cmd};
+        const fences = [_]VkFence{self.fence};
+        try vk.check(d.vkQueueSubmit(self.h.queue, 1, &[_]VkSubmitInfo{.{ .pCommandBuffers = &cmds }}, self.fence));
+        try vk.check(d.vkWaitForFences(self.h.device, 1, &fences, vk.VK_TRUE, std.math.maxInt(u64)));
+        try vk.check(d.vkResetFences(self.h.device, 1, &fences));
+    }
+
+    /// Descriptor set layout for a shader: its binding table
+    /// (frame_synthesis.PassShader.bindings)
+    fn createSetLayout(self: *Bench, shader: BenchShader) !vk.VkDescriptorSetLayout {
+        const table = shader.pass.bindings();
+        var bindings: [frame_synthesis.max_pass_bindings]vk.VkDescriptorSetLayoutBinding = undefined;
+        for (table, bindings[0..table.len]) |b, *binding| {
+            binding.* = .{
+                .binding = b.binding,
+                .descriptorType = b.descriptorType(),
+                .descriptorCount = 1,
+                .stageFlags = vk.VK_SHADER_STAGE_COMPUTE_BIT,
+                .pImmutableSamplers = null,
+            };
+        }
+        var layout: vk.VkDescriptorSetLayout = undefined;
+        try vk.check(self.h.dfns.vkCreateDescriptorSetLayout(self.h.device, &.{
+            .bindingCount = @intCast(table.len),
+            .pBindings = &bindings,
+        }, null, &layout));
+        return layout;
+    }
+
+    /// Bind the frames, the tile lists and the shader's constants block of
+    /// an output slot
+    fn writeSet(self: *Bench, set: vk.VkDescriptorSet, shader: BenchShader, slot: u32) void {
+        const sampled = VkDescriptorImageInfo{ .sampler = self.sampler, .imageView = self.input.view };
+        const storage = VkDescriptorImageInfo{ .sampler = null, .imageView = self.output.view };
+        const tiles = VkDescriptorBufferInfo{ .buffer = self.tile_buffer };
+        const constants = VkDescriptorBufferInfo{
+            .buffer = self.constants_buffer,
+            .offset = synthesis_constants.blockOffset(slot, shader.pass),
+            .range = synthesis_constants.block_size,
+        };
+        const table = shader.pass.bindings();
+        var writes: [frame_synthesis.max_pass_bindings]VkWriteDescriptorSet = undefined;
+        for (table, writes[0..table.len]) |b, *write| {
+            write.* = .{ .dstSet = set, .dstBinding = b.binding, .descriptorType = b.descriptorType() };
+            switch (b.source) {
+                .tile_lists => write.pBufferInfo = &tiles,
+                .constants => write.pBufferInfo = &constants,
+                else => write.pImageInfo = if (b.written) &storage else &sampled,
+            }
+        }
+        self.h.dfns.vkUpdateDescriptorSets(self.h.device, @intCast(table.len), &writes, 0, null);
+    }
+
+    /// SPIR-V of a shader file (directory first, then embedded)
+    fn loadSpirv(self: *Bench, name: []const u8) ![]const u32 {
+        return self.library.load(name) orelse error.ShaderNotFound;
+    }
+
+    fn createPipelineLayout(self: *Bench, set_layout: vk.VkDescriptorSetLayout) !vk.VkPipelineLayout {
+        const set_layouts = [_]vk.VkDescriptorSetLayout{set_layout};
+        var layout: vk.VkPipelineLayout = undefined;
+        try vk.check(self.h.dfns.vkCreatePipelineLayout(self.h.device, &.{
+            .pSetLayouts = &set_layouts,
+        }, null, &layout));
+        return layout;
+    }
+
+    /// Average time of one dispatch of a shader variant, in nanoseconds
+    fn timeVariant(
+        self: *Bench,
+        shader: BenchShader,
+        variant: shader_variants.Variant,
+        layout: vk.VkPipelineLayout,
+        set: vk.VkDescriptorSet,
+    ) !u64 {
+        var name_buf: [64]u8 = undefined;
+        const spirv = try self.loadSpirv(try variant.spirvName(&name_buf, shader.name()));
+
+        const d = &self.h.dispatch;
+        const pipeline = try shader_variants.createComputePipeline(d, spirv, layout, .fullFrame(variant), null);
+        defer d.vkDestroyPipeline.?(self.h.device, pipeline, null);
+
+        var best_ns: u64 = std.math.maxInt(u64);
+        for (0..warmup_submits + measured_submits) |submit| {
+            try vk.check(self.h.dfns.vkBeginCommandBuffer(self.cmd, &.{}));
+            d.vkCmdBindPipeline.?(self.cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+            const sets = [_]vk.VkDescriptorSet{set};
+            d.vkCmdBindDescriptorSets.?(self.cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets, 0, null);
+            for (0..dispatches_per_submit) |_| {
+                d.vkCmdDispatch.?(self.cmd, variant.workgroup.groupsX(self.width), variant.workgroup.groupsY(self.height), 1);
+                d.cmdMemoryBarrier(
+                    self.cmd,
+                    vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    vk.VK_ACCESS_SHADER_WRITE_BIT,
+                    vk.VK_ACCESS_SHADER_WRITE_BIT,
+                );
+            }
+            try vk.check(self.h.dfns.vkEndCommandBuffer(self.cmd));
+
+            const start = std.time.nanoTimestamp();
+            try self.submitAndWait();
+            const elapsed: u64 = @intCast(std.time.nanoTimestamp() - start);
+            if (submit >= warmup_submits) best_ns = @min(best_ns, elapsed);
+        }
+        return best_ns / dispatches_per_submit;
+    }
+
+    /// Time every shader in every variant. Returns per-variant totals.
+    fn run(self: *Bench, timings: []shader_variants.VariantTiming) !void {
+        const d = &self.h.dfns;
+        for (benchShaders()) |shader| {
+            const set_layout = try self.createSetLayout(shader);
+            defer d.vkDestroyDescriptorSetLayout(self.h.device, set_layout, null);
+            const set_layouts = [_]vk.VkDescriptorSetLayout{set_layout};
+            const layout = try self.createPipelineLayout(set_layout);
+            defer d.vkDestroyPipelineLayout(self.h.device, layout, null);
+
+            var set: vk.VkDescriptorSet = undefined;
+            try vk.check(d.vkAllocateDescriptorSets(self.h.device, &.{
+                .descriptorPool = self.descriptor_pool,
+                .pSetLayouts = &set_layouts,
+            }, &set));
+            self.writeSet(set, shader, 0);
+
+            for (timings) |*t| {
+                if (t.variant.precision == .fp16 and !self.h.caps.shader_float16) continue;
+                const ns = self.timeVariant(shader, t.variant, layout, set) catch |err| {
+                    std.debug.print("  {s:<18} {s:<5} {d:>2}x{d:<2}  failed: {s}\n", .{
+                        shader.name(), @tagName(t.variant.precision), t.variant.workgroup.x, t.variant.workgroup.y, @errorName(err),
+                    });
+                    continue;
+                };
+                t.time_ns += ns;
+                std.debug.print("  {s:<18} {s:<5} {d:>2}x{d:<2}  {d:>8.3} ms\n", .{
+                    shader.name(),
+                    @tagName(t.variant.precision),
+                    t.variant.workgroup.x,
+                    t.variant.workgroup.y,
+                    ms(ns),
+                });
+            }
+        }
+    }
+
+    /// Startup cost of the synthesis pipelines of one variant. Reads from
+    /// the directory bypass the library's cache, as on a first start.
+    fn runStartup(self: *Bench, variant: shader_variants.Variant, shader_dir: ?[]const u8) !Startup {
+        const d = &self.h.dispatch;
+        var startup = Startup{};
+        for (benchShaders()) |shader| {
+            const set_layout = try self.createSetLayout(shader);
+            defer self.h.dfns.vkDestroyDescriptorSetLayout(self.h.device, set_layout, null);
+            const layout = try self.createPipelineLayout(set_layout);
+            defer self.h.dfns.vkDestroyPipelineLayout(self.h.device, layout, null);
+
+            var name_buf: [64]u8 = undefined;
+            const name = try variant.spirvName(&name_buf, shader.name());
+
+            var start = std.time.nanoTimestamp();
+            const spirv = shader_library.embedded(name) orelse return error.ShaderNotFound;
+            startup.embedded_ns += @intCast(std.time.nanoTimestamp() - start);
+
+            if (shader_dir) |dir| {
+                start = std.time.nanoTimestamp();
+                const words = try shader_library.readSpirvFile(self.allocator, dir, name);
+                startup.file_ns += @intCast(std.time.nanoTimestamp() - start);
+                self.allocator.free(words);
+            }
+
+            start = std.time.nanoTimestamp();
+            const pipeline = try shader_variants.createComputePipeline(d, spirv, layout, .fullFrame(variant), null);
+            startup.pipeline_ns += @intCast(std.time.nanoTimestamp() - start);
+            d.vkDestroyPipeline.?(self.h.device, pipeline, null);
+        }
+        return startup;
+    }
+
+    /// CPU cost of one 4x batch (three frames of forward warp + linear
+    /// blend) recorded directly vs replayed. Recorded only, never submitted.
+    fn runRecording(self: *Bench, variant: shader_variants.Variant) !Recording {
+        const d = &self.h.dispatch;
+        const shaders = benchShaders();
+        const warp_shader = shaders[0];
+        const blend_shader = shaders[2];
+
+        const warp_set_layout = try self.createSetLayout(warp_shader);
+        defer self.h.dfns.vkDestroyDescriptorSetLayout(self.h.device, warp_set_layout, null);
+        const blend_set_layout = try self.createSetLayout(blend_shader);
+        defer self.h.dfns.vkDestroyDescriptorSetLayout(self.h.device, blend_set_layout, null);
+        const warp_layout = try self.createPipelineLayout(warp_set_layout);
+        defer self.h.dfns.vkDestroyPipelineLayout(self.h.device, warp_layout, null);
+        const blend_layout = try self.createPipelineLayout(blend_set_layout);
+        defer self.h.dfns.vkDestroyPipelineLayout(self.h.device, blend_layout, null);
+
+        // Warp and blend set of every output slot
+        const set_layouts = [_]vk.VkDescriptorSetLayout{ warp_set_layout, blend_set_layout } ** frame_synthesis.max_batch_frames;
+        var sets: [set_layouts.len]vk.VkDescriptorSet = undefined;
+        try vk.check(self.h.dfns.vkAllocateDescriptorSets(self.h.device, &.{
+            .descriptorPool = self.descriptor_pool,
+            .descriptorSetCount = set_layouts.len,
+            .pSetLayouts = &set_layouts,
+        }, &sets[0]));
+
+        var name_buf: [64]u8 = undefined;
+        const warp = try shader_variants.createComputePipeline(d, try self.loadSpirv(try variant.spirvName(&name_buf, warp_shader.name())), warp_layout, .fullFrame(variant), null);
+        defer d.vkDestroyPipeline.?(self.h.device, warp, null);
+        const blend = try shader_variants.createComputePipeline(d, try self.loadSpirv(try variant.spirvName(&name_buf, blend_shader.name())), blend_layout, .fullFrame(variant), null);
+        defer d.vkDestroyPipeline.?(self.h.device, blend, null);
+
+        var ctx = frame_synthesis.FrameSynthesisContext.init(self.h.device, self.width, self.height, .performance, d, self.allocator);
+        defer ctx.deinit();
+        ctx.warp_pipeline = warp;
+        ctx.blend_pipeline = blend;
+        ctx.pipeline_layouts.set(.forward_warp, warp_layout);
+        ctx.pipeline_layouts.set(.linear_blend, blend_layout);
+        ctx.workgroup = variant.workgroup;
+        try ctx.setConstantsBuffer(self.constants_buffer);
+        for (0..frame_synthesis.max_batch_frames) |slot| {
+            const warp_set = sets[2 * slot];
+            const blend_set = sets[2 * slot + 1];
+            self.writeSet(warp_set, warp_shader, @intCast(slot));
+            self.writeSet(blend_set, blend_shader, @intCast(slot));
+            var pass_sets = frame_synthesis.PassSets.initFill(null);
+            pass_sets.set(.forward_warp, warp_set);
+            pass_sets.set(.linear_blend, blend_set);
+            try ctx.setOutputTarget(@intCast(slot), .{ .view = self.output.view, .descriptor_sets = pass_sets });
+        }
+
+        const mvb = nvvk.MotionVectorBuffer{
+            .forward = self.input.image,
+            .forward_view = self.input.view,
+            .forward_memory = self.input.memory,
+            .width = self.width / 4,
+            .height = self.height / 4,
+            .grid_size = .@"4x4",
+        };
+
+        var recording = Recording{};
+        recording.direct_ns = try self.timeRecording(&ctx, &mvb);
+        ctx.replay = try nvvk.ReplayCache.init(d, self.h.queue_family);
+        recording.replay_ns = try self.timeRecording(&ctx, &mvb);
+        return recording;
+    }
+
+    /// Best average CPU time to record a batch into the frame's command buffer
+    fn timeRecording(self: *Bench, ctx: *frame_synthesis.FrameSynthesisContext, mvb: *const nvvk.MotionVectorBuffer) !u64 {
+        const factors = [_]f32{ 0.25, 0.5, 0.75 };
+        var views: [factors.len]vk.VkImageView = undefined;
+        var best_ns: u64 = std.math.maxInt(u64);
+        for (0..warmup_submits + measured_submits) |round| {
+            const start = std.time.nanoTimestamp();
+            for (0..recorded_batches) |_| {
+                try vk.check(self.h.dfns.vkBeginCommandBuffer(self.cmd, &.{}));
+                _ = try ctx.replayBatch(self.cmd, .interpolate, self.input.view, self.input.view, mvb, &factors, &views);
+                try vk.check(self.h.dfns.vkEndCommandBuffer(self.cmd));
+            }
+            const elapsed: u64 = @intCast(std.time.nanoTimestamp() - start);
+            if (round >= warmup_submits) best_ns = @min(best_ns, elapsed);
+        }
+        return best_ns / recorded_batches;
+    }
+};
+
+const Startup = struct {
+    embedded_ns: u64 = 0,
+    file_ns: u64 = 0,
+    pipeline_ns: u64 = 0,
+};
+
+const Recording = struct {
+    direct_ns: u64 = 0,
+    replay_ns: u64 = 0,
+};
+
+fn ms(ns: u64) f64 {
+    return @as(f64, @floatFromInt(ns)) / 1e6;
+}
+
+fn us(ns: u64) f64 {
+    return @as(f64, @floatFromInt(ns)) / 1e3;
+}
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    const args = try std.process.argsAlloc(allocator);
+    defer std.process.argsFree(allocator, args);
+    const shader_dir: ?[]const u8 = if (args.len > 1 and !std.mem.eql(u8, args[1], "-")) args[1] else null;
+    const width = if (args.len > 2) try std.fmt.parseInt(u32, args[2], 10) else 1920;
+    const height = if (args.len > 3) try std.fmt.parseInt(u32, args[3], 10) else 1080;
+    const device_index = if (args.len > 4) try std.fmt.parseInt(u32, args[4], 10) else 0;
+
+    var h = try Headless.init(device_index);
+    defer h.deinit();
+
+    std.debug.print("nvvk-bench: {s} (vendor 0x{X}, shaderFloat16 {})\n", .{ h.props.name(), h.caps.vendor_id, h.caps.shader_float16 });
+    std.debug.print("{d}x{d}, best of {d} submits of {d} dispatches\n\n", .{ width, height, measured_submits, dispatches_per_submit });
+
+    var timings: [shader_variants.WorkgroupShape.candidates.len * 2]shader_variants.VariantTiming = undefined;
+    for (shader_variants.WorkgroupShape.candidates, 0..) |shape, i| {
+        timings[2 * i] = .{ .variant = .{ .precision = .fp32, .workgroup = shape }, .time_ns = 0 };
+        timings[2 * i + 1] = .{ .variant = .{ .precision = .fp16, .workgroup = shape }, .time_ns = 0 };
+    }
+
+    var library = shader_library.ShaderLibrary.init(allocator, shader_dir);
+    defer library.deinit();
+
+    var bench = try Bench.init(&h, allocator, &library, width, height);
+    defer bench.deinit();
+
+    const heuristic = shader_variants.selectVariant(h.caps);
+    if (shader_library.embeddedCount() > 0) {
+        const startup = try bench.runStartup(heuristic, shader_dir);
+        std.debug.print("Startup ({s} {d}x{d}, {d} shaders, no pipeline cache):\n", .{
+            @tagName(heuristic.precision), heuristic.workgroup.x, heuristic.workgroup.y, benchShaders().len,
+        });
+        std.debug.print("  SPIR-V embedded      {d:>8.3} ms\n", .{ms(startup.embedded_ns)});
+        if (shader_dir) |dir| {
+            std.debug.print("  SPIR-V from {s:<8} {d:>8.3} ms\n", .{ dir, ms(startup.file_ns) });
+        }
+        std.debug.print("  pipeline creation    {d:>8.3} ms\n", .{ms(startup.pipeline_ns)});
+        std.debug.print("  first frame-gen      {d:>8.3} ms\n\n", .{ms(startup.embedded_ns + startup.pipeline_ns)});
+    } else {
+        std.debug.print("Startup: skipped, built with -Dembed-shaders=false\n\n", .{});
+    }
+
+    if (bench.runRecording(heuristic)) |recording| {
+        std.debug.print("Recording (CPU, 4x batch of forward warp + linear blend):\n", .{});
+        std.debug.print("  recorded per frame   {d:>8.3} us\n", .{us(recording.direct_ns)});
+        std.debug.print("  replayed secondary   {d:>8.3} us\n\n", .{us(recording.replay_ns)});
+    } else |err| {
+        std.debug.print("Recording: failed: {s}\n\n", .{@errorName(err)});
+    }
+
+    try bench.run(&timings);
+
+    std.debug.print("\nHeuristic variant: {s} {d}x{d}\n", .{ @tagName(heuristic.precision), heuristic.workgroup.x, heuristic.workgroup.y });
+    if (shader_variants.selectFastest(&timings)) |fastest| {
+        std.debug.print("Fastest variant:   {s} {d}x{d}\n", .{ @tagName(fastest.precision), fastest.workgroup.x, fastest.workgroup.y });
+    }
+}
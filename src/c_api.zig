@@ -407,13 +407,54 @@ pub const NvvkFrameGenMode = enum(i32) {
     quality = 3,
 };
 
+pub const NvvkFrameGenStrategy = enum(i32) {
+    interpolate = 0,
+    extrapolate = 1,
+    latency_budget = 2,
+};
+
+/// Timed GPU stage (same order as gpu_timing.Stage)
+pub const NvvkGpuStage = enum(i32) {
+    flow = 0,
+    mv_resolve = 1,
+    synthesis = 2,
+    forward_warp = 3,
+    backward_warp = 4,
+    blend = 5,
+    occlusion_fill = 6,
+};
+
+const gpu_stage_count = nvvk.gpu_timing.stage_count;
+
+comptime {
+    for (std.enums.values(nvvk.gpu_timing.Stage)) |stage| {
+        std.debug.assert(@intFromEnum(@field(NvvkGpuStage, @tagName(stage))) == @intFromEnum(stage));
+    }
+}
+
+/// Layout frozen for existing callers; extend NvvkFrameGenStatsEx instead
 pub const NvvkFrameGenStats = extern struct {
     generated_frames: u64,
     skipped_frames: u64,
     avg_gen_time_us: u64,
     confidence: f32,
     scene_change_detected: bool,
-    _padding: [3]u8 = .{ 0, 0, 0 },
+};
+
+/// Statistics added after NvvkFrameGenStats. Callers set struct_size to
+/// the size they were built with; only fields within it are written, so
+/// new fields go at the end.
+pub const NvvkFrameGenStatsEx = extern struct {
+    struct_size: u32,
+    frame_multiplier: u32 = 0,
+    last_batch_count: u32 = 0,
+    _padding: u32 = 0,
+    /// GPU time per NvvkGpuStage of the newest timed frame, in ns
+    gpu_stage_ns: [gpu_stage_count]u64 = .{0} ** gpu_stage_count,
+    /// Mean and maximum over the last rolling window of timed frames
+    gpu_stage_avg_ns: [gpu_stage_count]u64 = .{0} ** gpu_stage_count,
+    gpu_stage_max_ns: [gpu_stage_count]u64 = .{0} ** gpu_stage_count,
+    gpu_flow_overlap_ns: u64 = 0,
 };
 
 pub const NvvkGeneratedFrame = extern struct {
@@ -423,11 +464,43 @@ pub const NvvkGeneratedFrame = extern struct {
     generation_time_us: u64,
     frame_id: u64,
     should_present: bool,
-    _padding: [7]u8 = .{ 0, 0, 0, 0, 0, 0, 0 },
+    /// Present after the real frame instead of before it
+    extrapolated: bool,
+    batch_index: u8,
+    _padding: u8 = 0,
+    interpolation_factor: f32,
+};
+
+/// Most frames generated per real frame (4x)
+const max_generated_frames = nvvk.frame_synthesis.max_batch_frames;
+
+/// Frames generated for one real frame, filled in place (no allocation)
+pub const NvvkGeneratedFrames = extern struct {
+    count: u32,
+    _padding: u32 = 0,
+    frames: [max_generated_frames]NvvkGeneratedFrame,
+    /// Timeline semaphore and value signalled once an async push completes
+    /// (0 for pushes recorded into the caller's command buffer)
+    done_semaphore: u64 = 0,
+    done_value: u64 = 0,
+};
+
+/// Queues for nvvk_frame_gen_init2
+pub const NvvkFrameGenQueues = extern struct {
+    graphics_family: u32,
+    compute_family: u32,
+    compute_index: u32,
+    /// Optical flow queue family, or -1 when the compute queue supports
+    /// optical flow
+    flow_family: i32,
+    flow_index: u32,
 };
 
 const FrameGenHandle = struct {
     ctx: nvvk.FrameGenContext,
+    // Set by nvvk_frame_gen_init2 (the context points into it)
+    dispatch: ?nvvk.DeviceDispatch = null,
+    get_device_proc_addr: ?nvvk.vulkan.PFN_vkGetDeviceProcAddr = null,
 };
 
 /// Initialize frame generation context
@@ -455,7 +528,67 @@ export fn nvvk_frame_gen_init(
     };
 
     const vk_device: nvvk.VkDevice = @ptrCast(device);
-    handle.ctx = nvvk.FrameGenContext.init(vk_device, config, null, null, allocator);
+    handle.* = .{ .ctx = nvvk.FrameGenContext.init(vk_device, config, null, null, allocator) };
+
+    return handle;
+}
+
+/// Initialize frame generation context with a dispatch table, optional
+/// nvvk-owned queues and the swapchain format
+export fn nvvk_frame_gen_init2(
+    device: NvvkDevice,
+    get_device_proc_addr: *const fn (*anyopaque, [*:0]const u8) callconv(.c) ?*const fn () callconv(.c) void,
+    width: u32,
+    height: u32,
+    mode: NvvkFrameGenMode,
+    queues: ?*const NvvkFrameGenQueues,
+    swapchain_format: u32,
+    swapchain_color_space: u32,
+) ?*FrameGenHandle {
+    const allocator = gpa.allocator();
+
+    const handle = allocator.create(FrameGenHandle) catch return null;
+
+    const config = nvvk.FrameGenConfig{
+        .width = width,
+        .height = height,
+        .mode = switch (mode) {
+            .off => .off,
+            .performance => .performance,
+            .balanced => .balanced,
+            .quality => .quality,
+        },
+    };
+
+    const vk_device: nvvk.VkDevice = @ptrCast(device);
+    handle.* = .{
+        .ctx = undefined,
+        .dispatch = nvvk.DeviceDispatch.init(vk_device, @ptrCast(get_device_proc_addr)),
+        .get_device_proc_addr = @ptrCast(get_device_proc_addr),
+    };
+    const dispatch = &handle.dispatch.?;
+    handle.ctx = nvvk.FrameGenContext.init(vk_device, config, null, dispatch, allocator);
+
+    // VK_FORMAT_UNDEFINED keeps the default RGBA8 output
+    if (swapchain_format != 0) {
+        handle.ctx.setSwapchainFormat(swapchain_format, swapchain_color_space) catch {
+            nvvk_frame_gen_destroy(handle);
+            return null;
+        };
+    }
+
+    if (queues) |q| {
+        handle.ctx.async_queues = nvvk.AsyncQueues.init(dispatch, .{
+            .graphics_family = q.graphics_family,
+            .compute_family = q.compute_family,
+            .compute_index = q.compute_index,
+            .flow_family = if (q.flow_family < 0) null else @intCast(q.flow_family),
+            .flow_index = q.flow_index,
+        }) catch {
+            nvvk_frame_gen_destroy(handle);
+            return null;
+        };
+    }
 
     return handle;
 }
@@ -488,6 +621,322 @@ export fn nvvk_frame_gen_set_mode(handle: ?*FrameGenHandle, mode: NvvkFrameGenMo
     }
 }
 
+/// Set interpolation vs. extrapolation policy
+export fn nvvk_frame_gen_set_strategy(
+    handle: ?*FrameGenHandle,
+    strategy: NvvkFrameGenStrategy,
+    latency_budget_us: u64,
+) void {
+    if (handle) |h| {
+        const zig_policy: nvvk.StrategyPolicy = switch (strategy) {
+            .interpolate => .interpolate,
+            .extrapolate => .extrapolate,
+            .latency_budget => .latency_budget,
+        };
+        h.ctx.setStrategyPolicy(zig_policy, latency_budget_us);
+    }
+}
+
+/// Set presented frames per real frame (2-4)
+export fn nvvk_frame_gen_set_multiplier(handle: ?*FrameGenHandle, multiplier: u32) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    const m = std.math.cast(u8, multiplier) orelse return .error_not_supported;
+    h.ctx.setFrameMultiplier(m) catch return .error_not_supported;
+    return .success;
+}
+
+/// Write generated frames in the swapchain's format and color space
+export fn nvvk_frame_gen_set_swapchain_format(handle: ?*FrameGenHandle, format: u32, color_space: u32) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    h.ctx.setSwapchainFormat(format, color_space) catch |err| return switch (err) {
+        error.UnsupportedFormat => .error_not_supported,
+        else => frameGenResult(err),
+    };
+    return .success;
+}
+
+/// Set the caller-owned output image of a batch slot (0 to max - 1).
+/// descriptor_sets (one per synthesis shader, PassShader order) may be
+/// null with push descriptors or a descriptor buffer.
+export fn nvvk_frame_gen_set_output_target(
+    handle: ?*FrameGenHandle,
+    slot: u32,
+    image: u64,
+    image_view: u64,
+    descriptor_sets: ?*const [nvvk.frame_synthesis.pass_shader_count]u64,
+) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    h.ctx.synthesis_ctx.setOutputTarget(slot, .{
+        .image = @ptrFromInt(image),
+        .view = @ptrFromInt(image_view),
+        .descriptor_sets = passSets(descriptor_sets),
+    }) catch return .error_not_supported;
+    return .success;
+}
+
+/// Set the caller-owned output image of a batch slot with a second set
+/// per synthesis shader for history slot parity 1, so no set is rewritten
+/// while a batch using it may be pending (and batches can be replayed)
+export fn nvvk_frame_gen_set_output_target2(
+    handle: ?*FrameGenHandle,
+    slot: u32,
+    image: u64,
+    image_view: u64,
+    descriptor_sets: ?*const [nvvk.frame_synthesis.pass_shader_count]u64,
+    alternate_descriptor_sets: ?*const [nvvk.frame_synthesis.pass_shader_count]u64,
+) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    h.ctx.synthesis_ctx.setOutputTarget(slot, .{
+        .image = @ptrFromInt(image),
+        .view = @ptrFromInt(image_view),
+        .descriptor_sets = passSets(descriptor_sets),
+        .alternate_descriptor_sets = passSets(alternate_descriptor_sets),
+    }) catch return .error_not_supported;
+    h.ctx.synthesis_ctx.invalidateReplay();
+    return .success;
+}
+
+fn passSets(handles: ?*const [nvvk.frame_synthesis.pass_shader_count]u64) nvvk.frame_synthesis.PassSets {
+    var sets = nvvk.frame_synthesis.PassSets.initFill(null);
+    if (handles) |h| {
+        for (h, 0..) |set, i| {
+            if (set != 0) sets.set(@enumFromInt(i), @ptrFromInt(set));
+        }
+    }
+    return sets;
+}
+
+/// Bind the synthesis passes through push descriptors (VK_KHR_push_descriptor)
+/// instead of caller-owned descriptor sets. Call before creating set
+/// layouts and pipelines. input_layout is the VkImageLayout of the frames,
+/// motion vectors and cost map while synthesis reads them.
+export fn nvvk_frame_gen_use_push_descriptors(handle: ?*FrameGenHandle, sampler: u64, input_layout: u32) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    if (sampler == 0) return .error_invalid_handle;
+    h.ctx.synthesis_ctx.usePushDescriptors(.{
+        .sampler = @ptrFromInt(sampler),
+        .input_layout = input_layout,
+    }) catch |err| return frameGenResult(err);
+    return .success;
+}
+
+/// Create the descriptor set layout of a synthesis pass for the context's
+/// descriptor model. The caller owns it and builds the pass's pipeline
+/// layout from it.
+export fn nvvk_frame_gen_create_set_layout(handle: ?*FrameGenHandle, pass: u32, set_layout: *u64) NvvkResult {
+    set_layout.* = 0;
+    const h = handle orelse return .error_invalid_handle;
+    const dispatch = if (h.dispatch) |*d| d else return .error_not_supported;
+    if (pass >= nvvk.frame_synthesis.pass_shader_count) return .error_not_supported;
+    const layout = nvvk.frame_synthesis.createDescriptorSetLayout(
+        h.ctx.device,
+        dispatch,
+        @enumFromInt(pass),
+        std.meta.activeTag(h.ctx.synthesis_ctx.descriptors),
+    ) catch |err| return frameGenResult(err);
+    set_layout.* = @intFromPtr(layout);
+    return .success;
+}
+
+/// Create the synthesis pipelines from the embedded SPIR-V, one per pass
+/// with a pipeline layout (pass_layouts indexed by NvvkSynthesisPass, 0 =
+/// pass unused). Layouts stay owned by the caller.
+export fn nvvk_frame_gen_create_pipelines(
+    handle: ?*FrameGenHandle,
+    pass_layouts: *const [nvvk.frame_synthesis.pass_shader_count]u64,
+) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    if (h.dispatch == null) return .error_not_supported;
+    var layouts = nvvk.output_format.PipelineLayouts{ .descriptors = std.meta.activeTag(h.ctx.synthesis_ctx.descriptors) };
+    for (pass_layouts, 0..) |layout, i| {
+        if (layout != 0) layouts.passes.set(@enumFromInt(i), @ptrFromInt(layout));
+    }
+    h.ctx.createPipelines(layouts, nvvk.shader_library.embedded_source) catch |err| return frameGenResult(err);
+    return .success;
+}
+
+/// Create the optical flow session for pushed frames of `image_format`
+/// (VkFormat). Call after nvvk_frame_gen_set_motion_vectors.
+export fn nvvk_frame_gen_create_flow_session(handle: ?*FrameGenHandle, image_format: u32) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    const get_proc = h.get_device_proc_addr orelse return .error_not_supported;
+    h.ctx.createFlowSession(get_proc, image_format) catch |err| return frameGenResult(err);
+    return .success;
+}
+
+/// Caller-owned optical flow output images, at the frame size divided by
+/// the 4x4 flow grid (0 = absent; forward is required)
+pub const NvvkMotionVectorImages = extern struct {
+    forward: u64,
+    forward_view: u64,
+    forward_memory: u64,
+    backward: u64,
+    backward_view: u64,
+    cost: u64,
+    cost_view: u64,
+    backward_cost: u64,
+    backward_cost_view: u64,
+    width: u32,
+    height: u32,
+};
+
+/// Set the images optical flow writes and synthesis reads
+export fn nvvk_frame_gen_set_motion_vectors(handle: ?*FrameGenHandle, images: *const NvvkMotionVectorImages) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    if (images.forward == 0 or images.forward_view == 0 or images.forward_memory == 0) return .error_invalid_handle;
+    h.ctx.mv_ctx.mv_buffer = .{
+        .forward = @ptrFromInt(images.forward),
+        .forward_view = @ptrFromInt(images.forward_view),
+        .forward_memory = @ptrFromInt(images.forward_memory),
+        .backward = if (images.backward != 0) @ptrFromInt(images.backward) else null,
+        .backward_view = if (images.backward_view != 0) @ptrFromInt(images.backward_view) else null,
+        .cost = if (images.cost != 0) @ptrFromInt(images.cost) else null,
+        .cost_view = if (images.cost_view != 0) @ptrFromInt(images.cost_view) else null,
+        .backward_cost = if (images.backward_cost != 0) @ptrFromInt(images.backward_cost) else null,
+        .backward_cost_view = if (images.backward_cost_view != 0) @ptrFromInt(images.backward_cost_view) else null,
+        .width = images.width,
+        .height = images.height,
+        .grid_size = h.ctx.mv_ctx.config.grid_size,
+    };
+    h.ctx.synthesis_ctx.invalidateReplay();
+    return .success;
+}
+
+/// Caller-owned intermediate images of the synthesis passes, at the frame
+/// size in the output storage format (0 = absent). Balanced and quality
+/// need backward_warped; quality also needs filled_output.
+pub const NvvkSynthesisImages = extern struct {
+    warp_scratch: u64,
+    warp_scratch_view: u64,
+    backward_warped: u64,
+    backward_warped_view: u64,
+    filled_output: u64,
+    filled_output_view: u64,
+};
+
+/// Set the intermediate images the synthesis passes write
+export fn nvvk_frame_gen_set_synthesis_images(handle: ?*FrameGenHandle, images: *const NvvkSynthesisImages) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    if (images.warp_scratch == 0 or images.warp_scratch_view == 0) return .error_invalid_handle;
+    const synthesis = &h.ctx.synthesis_ctx;
+    synthesis.warp_scratch = @ptrFromInt(images.warp_scratch);
+    synthesis.warp_scratch_view = @ptrFromInt(images.warp_scratch_view);
+    var qp = synthesis.quality_pipeline orelse nvvk.frame_synthesis.QualityPipeline{};
+    qp.backward_warped = if (images.backward_warped != 0) @ptrFromInt(images.backward_warped) else null;
+    qp.backward_warped_view = if (images.backward_warped_view != 0) @ptrFromInt(images.backward_warped_view) else null;
+    qp.filled_output = if (images.filled_output != 0) @ptrFromInt(images.filled_output) else null;
+    qp.filled_output_view = if (images.filled_output_view != 0) @ptrFromInt(images.filled_output_view) else null;
+    synthesis.quality_pipeline = qp;
+    synthesis.invalidateReplay();
+    return .success;
+}
+
+// NVVK_SYNTHESIS_CONSTANTS_STRIDE and NVVK_SYNTHESIS_CONSTANTS_SIZE
+comptime {
+    std.debug.assert(nvvk.synthesis_constants.block_alignment == 256);
+    std.debug.assert(nvvk.synthesis_constants.buffer_size == 5412);
+}
+
+/// Set the buffer the synthesis passes read their per-frame values and
+/// gates from
+export fn nvvk_frame_gen_set_constants_buffer(handle: ?*FrameGenHandle, buffer: u64) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    if (buffer == 0) return .error_invalid_handle;
+    h.ctx.synthesis_ctx.setConstantsBuffer(@ptrFromInt(buffer)) catch |err| return frameGenResult(err);
+    return .success;
+}
+
+/// Push a rendered frame and record optical flow and synthesis of its
+/// generated frames into `cmd`
+export fn nvvk_frame_gen_push_frame(
+    handle: ?*FrameGenHandle,
+    cmd: ?NvvkCommandBuffer,
+    image: u64,
+    image_view: u64,
+    width: u32,
+    height: u32,
+    result: *NvvkGeneratedFrames,
+) NvvkResult {
+    result.* = std.mem.zeroes(NvvkGeneratedFrames);
+    const h = handle orelse return .error_invalid_handle;
+    const c = cmd orelse return .error_invalid_handle;
+    const frame = frameImage(image, image_view, width, height) orelse return .error_invalid_handle;
+
+    var out: [max_generated_frames]nvvk.GeneratedFrame = undefined;
+    const count = h.ctx.pushFrameMulti(@ptrCast(c), frame, &out) catch |err| return frameGenResult(err);
+    writeGeneratedFrames(result, out[0..count]);
+    return .success;
+}
+
+/// Push a rendered frame and submit its frame generation on the queues of
+/// nvvk_frame_gen_init2. `rendered_semaphore` reaches `rendered_value`
+/// once the frame is complete; the frame is in `layout`.
+export fn nvvk_frame_gen_push_frame_async(
+    handle: ?*FrameGenHandle,
+    image: u64,
+    image_view: u64,
+    width: u32,
+    height: u32,
+    layout: u32,
+    rendered_semaphore: u64,
+    rendered_value: u64,
+    result: *NvvkGeneratedFrames,
+) NvvkResult {
+    result.* = std.mem.zeroes(NvvkGeneratedFrames);
+    const h = handle orelse return .error_invalid_handle;
+    const frame = frameImage(image, image_view, width, height) orelse return .error_invalid_handle;
+    if (rendered_semaphore == 0) return .error_invalid_handle;
+
+    var out: [max_generated_frames]nvvk.GeneratedFrame = undefined;
+    const pushed = h.ctx.pushFrameAsync(frame, layout, .{
+        .semaphore = @ptrFromInt(rendered_semaphore),
+        .value = rendered_value,
+    }, &out) catch |err| return frameGenResult(err);
+    writeGeneratedFrames(result, out[0..pushed.count]);
+    result.done_semaphore = @intFromPtr(pushed.done.semaphore);
+    result.done_value = pushed.done.value;
+    return .success;
+}
+
+fn frameImage(image: u64, image_view: u64, width: u32, height: u32) ?nvvk.MotionVectorContext.FrameImage {
+    if (image == 0 or image_view == 0) return null;
+    return .{
+        .image = @ptrFromInt(image),
+        .view = @ptrFromInt(image_view),
+        .width = width,
+        .height = height,
+    };
+}
+
+fn writeGeneratedFrames(result: *NvvkGeneratedFrames, frames: []const nvvk.GeneratedFrame) void {
+    result.count = @intCast(frames.len);
+    for (frames, result.frames[0..frames.len]) |frame, *c_frame| {
+        c_frame.* = .{
+            .image_view = if (frame.image_view) |view| @intFromPtr(view) else 0,
+            .image = if (frame.image) |image| @intFromPtr(image) else 0,
+            .confidence = frame.confidence,
+            .generation_time_us = frame.generation_time_us,
+            .frame_id = frame.frame_id,
+            .should_present = frame.should_present,
+            .extrapolated = frame.strategy == .extrapolate,
+            .batch_index = frame.batch_index,
+            .interpolation_factor = frame.interpolation_factor,
+        };
+    }
+}
+
+fn frameGenResult(err: anyerror) NvvkResult {
+    return switch (err) {
+        error.OutOfMemory, nvvk.VulkanError.OutOfHostMemory, nvvk.VulkanError.OutOfDeviceMemory => .error_out_of_memory,
+        nvvk.VulkanError.DeviceLost => .error_device_lost,
+        // Missing dispatch, queues, flow session or output targets
+        error.NotInitialized, error.ExtensionNotLoaded, nvvk.VulkanError.FunctionNotFound, nvvk.VulkanError.ExtensionNotPresent => .error_not_supported,
+        // Descriptor model changed after pipelines were created
+        error.PipelinesCreated => .error_not_supported,
+        else => .error_unknown,
+    };
+}
+
 /// Get frame generation statistics
 export fn nvvk_frame_gen_get_stats(handle: ?*const FrameGenHandle, stats: *NvvkFrameGenStats) void {
     if (handle) |h| {
@@ -502,6 +951,44 @@ export fn nvvk_frame_gen_get_stats(handle: ?*const FrameGenHandle, stats: *NvvkF
     }
 }
 
+/// Get the statistics of NvvkFrameGenStatsEx, up to stats.struct_size bytes
+export fn nvvk_frame_gen_get_stats_ex(handle: ?*const FrameGenHandle, stats: *NvvkFrameGenStatsEx) NvvkResult {
+    const h = handle orelse return .error_invalid_handle;
+    const size = @min(stats.struct_size, @sizeOf(NvvkFrameGenStatsEx));
+    if (size < @sizeOf(u32)) return .error_not_supported;
+
+    const s = h.ctx.getStats();
+    var full = NvvkFrameGenStatsEx{
+        .struct_size = stats.struct_size,
+        .frame_multiplier = s.frame_multiplier,
+        .last_batch_count = s.last_batch_count,
+        .gpu_flow_overlap_ns = s.gpu_flow_overlap_ns,
+    };
+    for (std.enums.values(nvvk.gpu_timing.Stage)) |stage| {
+        const i = @intFromEnum(stage);
+        full.gpu_stage_ns[i] = gpuStageNs(s, stage);
+        const rolling = h.ctx.getGpuStageStats(stage) orelse continue;
+        full.gpu_stage_avg_ns[i] = rolling.averageNs();
+        full.gpu_stage_max_ns[i] = rolling.maxNs();
+    }
+    // The caller's struct may predate later fields
+    const dst: [*]u8 = @ptrCast(stats);
+    @memcpy(dst[@sizeOf(u32)..size], std.mem.asBytes(&full)[@sizeOf(u32)..size]);
+    return .success;
+}
+
+fn gpuStageNs(s: nvvk.FrameGenStats, stage: nvvk.gpu_timing.Stage) u64 {
+    return switch (stage) {
+        .flow => s.gpu_flow_ns,
+        .mv_resolve => s.gpu_mv_resolve_ns,
+        .synthesis => s.gpu_synthesis_ns,
+        .forward_warp => s.gpu_forward_warp_ns,
+        .backward_warp => s.gpu_backward_warp_ns,
+        .blend => s.gpu_blend_ns,
+        .occlusion_fill => s.gpu_occlusion_fill_ns,
+    };
+}
+
 /// Get latency compensation in microseconds
 export fn nvvk_frame_gen_get_latency_compensation(handle: ?*const FrameGenHandle) u64 {
     if (handle) |h| {
@@ -523,6 +1010,13 @@ export fn nvvk_get_optical_flow_extension_name() [*:0]const u8 {
     return nvvk.optical_flow.VK_NV_OPTICAL_FLOW_EXTENSION_NAME;
 }
 
+/// Get embedded SPIR-V of a shader by file name, or null if not embedded
+export fn nvvk_get_shader_spirv(name: ?[*:0]const u8, size_bytes: ?*usize) ?[*]const u32 {
+    const spirv = nvvk.shader_library.embedded(std.mem.span(name orelse return null)) orelse return null;
+    if (size_bytes) |size| size.* = spirv.len * @sizeOf(u32);
+    return spirv.ptr;
+}
+
 // =============================================================================
 // Present Injection C API
 // =============================================================================
@@ -531,6 +1025,7 @@ pub const NvvkInjectionMode = enum(i32) {
     disabled = 0,
     single = 1,
     double = 2,
+    multi = 3,
 };
 
 pub const NvvkTimingMode = enum(i32) {
@@ -568,6 +1063,7 @@ export fn nvvk_present_injection_init(
         .disabled => .disabled,
         .single => .single,
         .double => .double,
+        .multi => .multi,
     };
 
     const zig_timing_mode: nvvk.TimingMode = switch (timing_mode) {
@@ -626,6 +1122,18 @@ export fn nvvk_present_injection_get_timing(handle: ?*PresentInjectionHandle) u6
     return 8333; // Default ~60fps half interval
 }
 
+/// Get present offsets (microseconds) for the generated frames of one real frame
+/// Returns number of offsets written
+export fn nvvk_present_injection_get_schedule(
+    handle: ?*PresentInjectionHandle,
+    offsets_us: ?[*]u64,
+    max_count: u32,
+) u32 {
+    const h = handle orelse return 0;
+    const offsets = offsets_us orelse return 0;
+    return @intCast(h.ctx.calculateInjectionSchedule(offsets[0..max_count]));
+}
+
 /// Record present time
 export fn nvvk_present_injection_record_present(handle: ?*PresentInjectionHandle, is_generated: bool) void {
     if (handle) |h| {
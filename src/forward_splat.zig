@@ -0,0 +1,188 @@
+//! Forward Splatting
+//!
+//! Depth-ordered forward warp. forward_warp.comp gathers: it samples the
+//! motion vector at the destination pixel, which drags background motion
+//! over moving foreground and leaves halos for occlusion fill to hide.
+//!
+//! splat_forward.comp scatters instead: every source pixel moves along its
+//! own vector and claims its destination with a 64-bit atomicMin of
+//! (depth key << 32 | source index), so the nearest source wins. Depth
+//! comes from the engine when available (MotionSource.engine), otherwise
+//! motion magnitude is the proxy. splat_resolve.comp then fetches the
+//! winning colors, closes single-pixel cracks and writes a splat cost map
+//! with holes at maximum cost for occlusion fill.
+//!
+//! Requires shaderBufferInt64Atomics.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const shader_variants = @import("shader_variants.zig");
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Empty splat buffer entry (fill byte)
+pub const empty_fill: u32 = 0xFFFFFFFF;
+
+/// Cost of a hole in the splat cost map (optical flow cost units)
+pub const hole_cost: f32 = 255.0;
+
+/// Size of the splat buffer (one u64 per pixel)
+pub fn splatBufferSize(width: u32, height: u32) vk.VkDeviceSize {
+    return @as(vk.VkDeviceSize, width) * height * @sizeOf(u64);
+}
+
+/// Push constants for splat_forward.comp and splat_resolve.comp
+pub const SplatPushConstants = extern struct {
+    mv_scale_x: f32,
+    mv_scale_y: f32,
+    /// Distance along the vectors (sign = direction)
+    interpolation: f32,
+    /// Bit 0: depth, bit 1: reversed Z, bit 2: cost map valid
+    flags: u32,
+};
+
+/// Forward splat warp
+pub const ForwardSplat = struct {
+    // Pipelines (optional until created), sharing one layout
+    splat_pipeline: ?vk.VkPipeline = null,
+    resolve_pipeline: ?vk.VkPipeline = null,
+    pipeline_layout: ?vk.VkPipelineLayout = null,
+    /// Source frame (0), vectors anchored at the source frame (1), depth
+    /// (2), cost map (3), splat buffer (4), warped frame (5) and splat cost
+    /// map (6). The warped frame is the forward warp scratch image. One
+    /// set per history slot: the source frame is the previous frame of
+    /// that slot's pair (FrameSynthesisContext.history_slot).
+    descriptor_sets: [2]?vk.VkDescriptorSet = .{ null, null },
+
+    /// Splat buffer (splatBufferSize)
+    splat_buffer: ?vk.VkBuffer = null,
+    /// Splat cost map image, needed only to transition it when its memory
+    /// is aliased (synthesis_graph.zig)
+    cost_image: ?vk.VkImage = null,
+    /// Splat cost map view, bound as the occlusion fill cost map
+    cost_view: ?vk.VkImageView = null,
+
+    // Depth ordering (depth bound at binding 2)
+    has_depth: bool = false,
+    reversed_z: bool = false,
+
+    // Dispatch table
+    dispatch: ?*const vk.DeviceDispatch,
+
+    /// Initialize forward splat
+    pub fn init(dispatch: ?*const vk.DeviceDispatch) ForwardSplat {
+        return .{ .dispatch = dispatch };
+    }
+
+    /// Check if splatting can run for a history slot (pipelines, the
+    /// slot's descriptor set and buffer)
+    pub fn isActive(self: *const ForwardSplat, history_slot: u32) bool {
+        const d = self.dispatch orelse return false;
+        if (!d.hasComputeRecording() or d.vkCmdFillBuffer == null) return false;
+        if (self.splat_pipeline == null or self.resolve_pipeline == null or self.pipeline_layout == null) return false;
+        return self.descriptor_sets[history_slot] != null and self.splat_buffer != null;
+    }
+
+    /// Shader flags
+    pub fn flags(self: *const ForwardSplat, cost_enabled: bool) u32 {
+        var f: u32 = 0;
+        if (self.has_depth) f |= 1;
+        if (self.reversed_z) f |= 2;
+        if (cost_enabled) f |= 4;
+        return f;
+    }
+
+    /// Record clear, splat and resolve for one interpolation factor. Both
+    /// passes run one invocation per pixel, so a synthesis gate applies to
+    /// them unchanged. Returns false if not active.
+    pub fn record(
+        self: *const ForwardSplat,
+        cmd: vk.VkCommandBuffer,
+        history_slot: u32,
+        width: u32,
+        height: u32,
+        workgroup: shader_variants.WorkgroupShape,
+        mv_scale: f32,
+        factor: f32,
+        cost_enabled: bool,
+        gate: ?frame_synthesis.DispatchGate,
+    ) bool {
+        if (!self.isActive(history_slot)) return false;
+        const d = self.dispatch.?;
+        const layout = self.pipeline_layout.?;
+
+        d.vkCmdFillBuffer.?(cmd, self.splat_buffer.?, 0, splatBufferSize(width, height), empty_fill);
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT | vk.VK_ACCESS_SHADER_WRITE_BIT,
+        );
+
+        const push = SplatPushConstants{
+            .mv_scale_x = mv_scale,
+            .mv_scale_y = mv_scale,
+            .interpolation = factor,
+            .flags = self.flags(cost_enabled),
+        };
+        const sets = [_]vk.VkDescriptorSet{self.descriptor_sets[history_slot].?};
+        if (d.vkCmdBindDescriptorSets) |bind_sets| {
+            bind_sets(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets, 0, null);
+        }
+        d.vkCmdPushConstants.?(cmd, layout, vk.VK_SHADER_STAGE_COMPUTE_BIT, 0, @sizeOf(SplatPushConstants), &push);
+
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.splat_pipeline.?);
+        dispatchFrame(d, cmd, width, height, workgroup, gate);
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT,
+        );
+
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.resolve_pipeline.?);
+        dispatchFrame(d, cmd, width, height, workgroup, gate);
+        return true;
+    }
+
+    fn dispatchFrame(
+        d: *const vk.DeviceDispatch,
+        cmd: vk.VkCommandBuffer,
+        width: u32,
+        height: u32,
+        workgroup: shader_variants.WorkgroupShape,
+        gate: ?frame_synthesis.DispatchGate,
+    ) void {
+        if (gate) |g| {
+            if (d.vkCmdDispatchIndirect) |dispatch_indirect| {
+                dispatch_indirect(cmd, g.buffer, g.offset);
+                return;
+            }
+        }
+        d.vkCmdDispatch.?(cmd, workgroup.groupsX(width), workgroup.groupsY(height), 1);
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "splat buffer sizing" {
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 1920 * 1080 * 8), splatBufferSize(1920, 1080));
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(SplatPushConstants));
+}
+
+test "ForwardSplat flags and activity" {
+    var s = ForwardSplat.init(null);
+    try std.testing.expect(!s.isActive(0));
+    try std.testing.expectEqual(@as(u32, 0b100), s.flags(true));
+
+    s.has_depth = true;
+    s.reversed_z = true;
+    try std.testing.expectEqual(@as(u32, 0b011), s.flags(false));
+}
@@ -10,6 +10,19 @@
 //! 3. Synthesize intermediate frame (warp + blend)
 //! 4. Present: real -> generated -> real -> generated...
 //!
+//! Interpolation places the generated frame between the previous and
+//! current real frames, so the current frame is held back by half a frame.
+//! Extrapolation predicts past the current frame instead and adds no hold;
+//! the strategy policy picks between them from the latency budget.
+//!
+//! pushFrameOverlapped moves optical flow onto its own queue through the
+//! motion vector ring (mv_ring.zig), so frame N+1's flow overlaps frame N's
+//! synthesis. A GpuTimer reports per-stage GPU times (down to each warp,
+//! blend and hole fill pass) and that overlap.
+//! pushFrameAsync goes further and submits frame generation on nvvk-owned
+//! async compute (and optical flow) queues (async_queue.zig), so it
+//! overlaps the game's rendering of the next frame.
+//!
 //! Requires NVIDIA driver 590+ and VK_NV_optical_flow extension.
 
 const std = @import("std");
@@ -17,7 +30,16 @@ const vk = @import("vulkan.zig");
 const optical_flow = @import("optical_flow.zig");
 const motion_vectors = @import("motion_vectors.zig");
 const frame_synthesis = @import("frame_synthesis.zig");
+const scene_change = @import("scene_change.zig");
 const low_latency = @import("low_latency.zig");
+const pipeline_cache = @import("pipeline_cache.zig");
+const gpu_timing = @import("gpu_timing.zig");
+const output_format = @import("output_format.zig");
+const mv_ring = @import("mv_ring.zig");
+const output_ring = @import("output_ring.zig");
+const async_queue = @import("async_queue.zig");
+const frame_resize = @import("frame_resize.zig");
+const test_stubs = @import("test_stubs.zig");
 
 /// Get current time in microseconds using monotonic clock
 fn getTimeMicros() i128 {
@@ -41,18 +63,71 @@ pub const FrameGenMode = enum {
     quality,
 };
 
+/// How a generated frame is placed relative to the real frames
+pub const GenerationStrategy = enum {
+    /// Between previous and current frame (t-0.5), best quality
+    interpolate,
+    /// Past the current frame (t+0.5), no added display latency
+    extrapolate,
+};
+
+/// Policy for choosing the generation strategy each frame
+pub const StrategyPolicy = enum {
+    /// Always interpolate
+    interpolate,
+    /// Always extrapolate
+    extrapolate,
+    /// Interpolate while its added latency fits latency_budget_us
+    latency_budget,
+};
+
 /// Frame generation statistics
 pub const FrameGenStats = struct {
     /// Total frames generated
     generated_frames: u64 = 0,
-    /// Frames where generation was skipped (scene change, etc.)
+    /// Frames where generation was skipped (scene change, low confidence)
     skipped_frames: u64 = 0,
     /// Average generation time in microseconds
     avg_gen_time_us: u64 = 0,
-    /// Current confidence score (0.0-1.0)
+    /// Flow confidence of the last frame read back from the GPU (0.0-1.0)
     confidence: f32 = 1.0,
     /// Scene change detected in last frame
     scene_change_detected: bool = false,
+    /// Frames generated by extrapolation
+    extrapolated_frames: u64 = 0,
+    /// Strategy used for the last generated frame
+    strategy: GenerationStrategy = .interpolate,
+    /// Presented frames per real frame
+    frame_multiplier: u8 = 2,
+    /// Frames generated for the last real frame
+    last_batch_count: u8 = 0,
+    /// Mean optical flow cost (0-255) of the last frame read back
+    flow_cost: f32 = 0.0,
+    /// Relative mean cost reduction of hinted over unhinted executions
+    /// (0.0 until both have been measured)
+    hint_cost_reduction: f32 = 0.0,
+    /// GPU time of the newest timed frame's optical flow (0 without a
+    /// GpuTimer; results arrive gpu_timing.frames_in_flight frames late)
+    gpu_flow_ns: u64 = 0,
+    /// GPU time of the newest timed frame's ring slot resolve
+    gpu_mv_resolve_ns: u64 = 0,
+    /// GPU time of the newest timed frame's synthesis batch
+    gpu_synthesis_ns: u64 = 0,
+    /// Time that frame's optical flow ran alongside the previous frame's
+    /// synthesis (pushFrameOverlapped)
+    gpu_flow_overlap_ns: u64 = 0,
+    /// GPU time of that frame's forward warps (or splats), summed over the
+    /// batch
+    gpu_forward_warp_ns: u64 = 0,
+    /// GPU time of that frame's backward warps
+    gpu_backward_warp_ns: u64 = 0,
+    /// GPU time of that frame's blends
+    gpu_blend_ns: u64 = 0,
+    /// GPU time of that frame's occlusion (or pull-push) fills
+    gpu_occlusion_fill_ns: u64 = 0,
+    /// Batches whose output ring set was still held by presentation, so
+    /// synthesis had to wait for its release on the GPU
+    output_busy_batches: u64 = 0,
 };
 
 /// Configuration for frame generation
@@ -60,16 +135,78 @@ pub const FrameGenConfig = struct {
     width: u32,
     height: u32,
     mode: FrameGenMode = .performance,
-    /// Minimum confidence threshold to use generated frame
+    /// Minimum flow confidence to synthesize and present a generated frame
     confidence_threshold: f32 = 0.3,
-    /// Scene change detection threshold
+    /// Scene change detection threshold (fraction of high-cost flow samples)
     scene_change_threshold: f32 = 0.7,
+    /// Also compare luminance histograms for scene change detection
+    /// (always on when the mode has no cost map)
+    scene_change_histogram: bool = false,
     /// Enable latency compensation (adjust timing for generated frames)
     latency_compensation: bool = true,
     /// Target frame time in microseconds (for pacing)
     target_frame_time_us: u64 = 16667, // 60 FPS default
+    /// Interpolation vs. extrapolation policy
+    strategy_policy: StrategyPolicy = .interpolate,
+    /// Maximum latency frame generation may add (for .latency_budget)
+    latency_budget_us: u64 = 0,
+    /// Presented frames per real frame (2x-4x); frame_multiplier - 1 are generated
+    frame_multiplier: u8 = 2,
+    /// Edge-aware motion vector upsampling (null = mode default, see
+    /// defaultUpsample). Buys edge quality without slower optical flow.
+    mv_upsample: ?motion_vectors.UpsampleTarget = null,
+    /// Optical flow input resolution (null = mode default, see defaultFlowScale)
+    flow_scale: ?motion_vectors.FlowScale = null,
+    /// Frame pixel count above which performance mode runs optical flow
+    /// on half-resolution luma
+    flow_downsample_min_pixels: u64 = 2560 * 1440,
+    /// Optical flow hint source. Sessions whose executions are hinted run
+    /// one PerformanceLevel faster (see flowPerformance); only set when the
+    /// device reports OpticalFlowProperties.supportsFlowHints.
+    flow_hints: motion_vectors.HintSource = .none,
+    /// Motion field source. Engine motion vectors skip optical flow, the
+    /// most expensive stage; depth sharpens disocclusion edges.
+    motion_source: motion_vectors.MotionSource = .optical_flow,
+    /// Engine motion vector encoding (motion_source = .engine)
+    engine_motion: motion_vectors.EngineMotionFormat = .{},
 };
 
+/// Optical flow performance level per mode. A hint starts the search near
+/// the answer, so hinted flow runs one level faster at similar cost; the
+/// hinted level only applies to sessions whose executions are hinted
+/// (MotionVectorContext.createFlowSession).
+pub fn flowPerformance(mode: FrameGenMode, hinted: bool) optical_flow.PerformanceLevel {
+    const level: optical_flow.PerformanceLevel = switch (mode) {
+        .off => .fast,
+        .performance => .fast,
+        .balanced => .medium,
+        .quality => .slow,
+    };
+    return if (hinted) level.faster() else level;
+}
+
+/// Default optical flow input resolution: performance mode halves it above
+/// min_pixels (optical flow dominates frame generation cost at 4K)
+pub fn defaultFlowScale(mode: FrameGenMode, width: u32, height: u32, min_pixels: u64) motion_vectors.FlowScale {
+    if (mode != .performance) return .full;
+    const pixels = @as(u64, width) * height;
+    return if (pixels > min_pixels) .half else .full;
+}
+
+/// Default motion vector upsampling per mode (engine vectors are ingested
+/// on a 1x1 grid, so already per pixel)
+pub fn defaultUpsample(source: motion_vectors.MotionSource, mode: FrameGenMode) motion_vectors.UpsampleTarget {
+    if (source == .engine) return .none;
+    return switch (mode) {
+        .off, .performance => .none,
+        .balanced => .grid_2x2,
+        .quality => .full,
+    };
+}
+
+/// Highest supported frame multiplier (4x)
+pub const max_frame_multiplier: u8 = frame_synthesis.max_batch_frames + 1;
+
 /// Generated frame result
 pub const GeneratedFrame = struct {
     /// The generated image view
@@ -82,10 +219,60 @@ pub const GeneratedFrame = struct {
     generation_time_us: u64,
     /// Frame ID (matches present ID from Reflex)
     frame_id: u64,
-    /// Whether this frame should be presented
+    /// Whether this frame should be presented. Decided from the previous
+    /// frame's GPU readback: a batch the GPU gated is only known one frame
+    /// later, so it is still reported presentable (its outputs keep their
+    /// last contents) and the batch after it is not.
     should_present: bool,
+    /// Extrapolated frames are presented after the current real frame,
+    /// interpolated frames before it
+    strategy: GenerationStrategy = .interpolate,
+    /// Position within the batch generated for one real frame
+    batch_index: u8 = 0,
+    /// Temporal position k/N relative to the real frame pair
+    interpolation_factor: f32 = 0.5,
+};
+
+/// Result of pushFrameAsync
+pub const AsyncPush = struct {
+    /// Generated frames written to `out`
+    count: usize,
+    /// Signalled once the submission completes; present the real frame and
+    /// its generated frames after waiting on it
+    done: mv_ring.TimelineValue,
 };
 
+/// Temporal factor of the k-th (0-based) generated frame at multiplier N
+pub fn batchFactor(index: usize, multiplier: u8) f32 {
+    return @as(f32, @floatFromInt(index + 1)) / @as(f32, @floatFromInt(multiplier));
+}
+
+/// Time the current real frame is held back by interpolation: it is shown
+/// after the N-1 generated frames, each 1/N of a real frame interval apart
+pub fn interpolationHoldUs(frame_interval_us: u64, multiplier: u8) u64 {
+    if (multiplier <= 1) return 0;
+    return frame_interval_us * (multiplier - 1) / multiplier;
+}
+
+/// Pick interpolation or extrapolation.
+/// Interpolation holds the current frame (see interpolationHoldUs) and adds
+/// the generation time; extrapolation only adds the generation time.
+pub fn selectStrategy(
+    policy: StrategyPolicy,
+    latency_budget_us: u64,
+    interpolation_hold_us: u64,
+    gen_time_us: u64,
+) GenerationStrategy {
+    return switch (policy) {
+        .interpolate => .interpolate,
+        .extrapolate => .extrapolate,
+        .latency_budget => if (interpolation_hold_us + gen_time_us <= latency_budget_us)
+            .interpolate
+        else
+            .extrapolate,
+    };
+}
+
 /// Frame generation context
 pub const FrameGenContext = struct {
     device: vk.VkDevice,
@@ -105,12 +292,39 @@ pub const FrameGenContext = struct {
     stats: FrameGenStats,
 
     // Timing
-    last_frame_time_us: u64,
+    last_frame_time_us: u64, // Timestamp of the last pushed real frame
+    real_frame_interval_us: u64,
     frame_times: [8]u64, // Ring buffer for averaging
     frame_time_idx: u8,
 
-    // Scene change detection
-    prev_frame_luminance: f32,
+    // Scene change detection (GPU reduction, read back one frame late)
+    scene_detector: scene_change.SceneChangeDetector,
+    // Frames generated per readback slot, reclassified as skipped on a cut.
+    // A gated batch still presents: the GPU fills its outputs with the
+    // current frame (FrameSynthesisContext.passthrough_gate).
+    pending_batches: [scene_change.readback_depth]u8,
+    // Hint use per readback slot, and mean cost averages per hint use
+    pending_hints: [scene_change.readback_depth]motion_vectors.HintUse,
+    hinted_cost: f32 = 0.0,
+    unhinted_cost: f32 = 0.0,
+
+    // Persistent pipeline cache, saved on deinit. Its handle() goes to
+    // synthesis_ctx.format_pipelines.pipeline_cache.
+    pipeline_cache: ?pipeline_cache.PersistentPipelineCache = null,
+
+    // Per-stage GPU timestamps (optional until created)
+    gpu_timer: ?gpu_timing.GpuTimer = null,
+    // Timeline values of the last pushFrameOverlapped
+    flow_sync: ?mv_ring.FrameSync = null,
+    // Output ring set of the last batch
+    output_sync: ?output_ring.Acquired = null,
+
+    // nvvk-owned compute and optical flow queues (optional, see
+    // pushFrameAsync)
+    async_queues: ?async_queue.AsyncQueues = null,
+
+    // Staged swapchain resize (see resize)
+    resizer: frame_resize.Resizer = .{},
 
     // Dispatch table
     dispatch: ?*const vk.DeviceDispatch,
@@ -126,15 +340,19 @@ pub const FrameGenContext = struct {
         const mv_config = motion_vectors.MotionVectorConfig{
             .width = config.width,
             .height = config.height,
-            .grid_size = .@"4x4",
-            .performance = switch (config.mode) {
-                .off => .fast,
-                .performance => .fast,
-                .balanced => .medium,
-                .quality => .slow,
-            },
+            // Engine vectors are ingested per pixel, so they need no upsample
+            .grid_size = if (config.motion_source == .engine) .@"1x1" else .@"4x4",
+            .performance = flowPerformance(config.mode, false),
+            .hinted_performance = flowPerformance(config.mode, true),
             .bidirectional = config.mode == .quality,
-            .enable_cost = config.mode != .performance,
+            // Ingest derives the cost map almost for free
+            .enable_cost = config.mode != .performance or config.motion_source == .engine,
+            .flow_scale = config.flow_scale orelse
+                defaultFlowScale(config.mode, config.width, config.height, config.flow_downsample_min_pixels),
+            .upsample = config.mv_upsample orelse defaultUpsample(config.motion_source, config.mode),
+            .hint_source = config.flow_hints,
+            .source = config.motion_source,
+            .engine_motion = config.engine_motion,
         };
 
         const synthesis_mode: frame_synthesis.QualityMode = switch (config.mode) {
@@ -160,11 +378,23 @@ pub const FrameGenContext = struct {
             .config = config,
             .enabled = config.mode != .off,
             .current_frame_id = 0,
-            .stats = .{},
+            .stats = .{ .frame_multiplier = config.frame_multiplier },
             .last_frame_time_us = 0,
+            .real_frame_interval_us = config.target_frame_time_us,
             .frame_times = .{ 0, 0, 0, 0, 0, 0, 0, 0 },
             .frame_time_idx = 0,
-            .prev_frame_luminance = 0.5,
+            .scene_detector = scene_change.SceneChangeDetector.init(
+                .{
+                    .cut_fraction = config.scene_change_threshold,
+                    // Derived ingest cost does not rise on cuts
+                    .use_histogram = config.scene_change_histogram or config.motion_source == .engine,
+                    .min_confidence = config.confidence_threshold,
+                },
+                mv_config.enable_cost,
+                dispatch,
+            ),
+            .pending_batches = [_]u8{0} ** scene_change.readback_depth,
+            .pending_hints = [_]motion_vectors.HintUse{.none} ** scene_change.readback_depth,
             .dispatch = dispatch,
         };
     }
@@ -174,71 +404,366 @@ pub const FrameGenContext = struct {
         self.enabled = enabled and self.config.mode != .off;
     }
 
-    /// Set frame generation mode
+    /// Set frame generation mode. Flow scale and motion vector upsampling
+    /// size the flow session, luma copies and motion vector buffers, so the
+    /// mode's defaults for them only take effect with the next resize
+    /// (applyResize), never on the live set.
     pub fn setMode(self: *FrameGenContext, mode: FrameGenMode) void {
         self.config.mode = mode;
         self.enabled = mode != .off;
     }
 
-    /// Push a new frame and optionally generate an intermediate frame
+    /// Set interpolation vs. extrapolation policy
+    pub fn setStrategyPolicy(self: *FrameGenContext, policy: StrategyPolicy, latency_budget_us: u64) void {
+        self.config.strategy_policy = policy;
+        self.config.latency_budget_us = latency_budget_us;
+    }
+
+    /// Set presented frames per real frame (2-4)
+    pub fn setFrameMultiplier(self: *FrameGenContext, multiplier: u8) !void {
+        if (multiplier < 2 or multiplier > max_frame_multiplier) return error.InvalidMultiplier;
+        self.config.frame_multiplier = multiplier;
+        self.stats.frame_multiplier = multiplier;
+    }
+
+    /// Write generated frames in a swapchain's format (VkFormat and
+    /// VkColorSpaceKHR). Call after (re)creating the swapchain; output
+    /// targets must be recreated in the matching storage format.
+    pub fn setSwapchainFormat(self: *FrameGenContext, format: u32, color_space: u32) !void {
+        try self.synthesis_ctx.setSwapchainFormat(format, color_space);
+    }
+
+    /// Create the optical flow session for pushed frames of `image_format`
+    /// (MotionVectorContext.createFlowSession). Unused with engine motion.
+    pub fn createFlowSession(self: *FrameGenContext, getDeviceProcAddr: vk.PFN_vkGetDeviceProcAddr, image_format: u32) !void {
+        try self.mv_ctx.createFlowSession(getDeviceProcAddr, image_format);
+    }
+
+    /// Create the synthesis pipelines of every pass with a layout, through
+    /// the persistent pipeline cache when there is one
+    pub fn createPipelines(self: *FrameGenContext, layouts: output_format.PipelineLayouts, source: output_format.SpirvSource) !void {
+        const cache = if (self.pipeline_cache) |*c| c.handle() else null;
+        try self.synthesis_ctx.createPipelines(layouts, source, cache);
+    }
+
+    /// Stage a resize to width x height. Returns the set of sized
+    /// resources to build (null when the size is unchanged); frames keep
+    /// being generated at the current size meanwhile. Call finishResize()
+    /// once it is built, from any thread: the next push swaps it in.
+    pub fn resize(self: *FrameGenContext, width: u32, height: u32) !?*frame_resize.SizedResources {
+        return self.resizer.begin(
+            .{ .width = self.config.width, .height = self.config.height },
+            .{ .width = width, .height = height },
+        );
+    }
+
+    /// Mark the set returned by resize() complete
+    pub fn finishResize(self: *FrameGenContext) void {
+        self.resizer.markReady();
+    }
+
+    /// Hand back the resources swapped out by the last resize, once every
+    /// submission before the swap has completed (null if none). Destroy
+    /// its images, views and descriptor sets; the next resize reuses its
+    /// memory. No further resize is swapped in until this is called.
+    pub fn releaseResize(self: *FrameGenContext) ?frame_resize.SizedResources {
+        const released = self.resizer.release() orelse return null;
+        if (self.synthesis_ctx.replay) |*cache| cache.retire(self.resizer.generation);
+        return released;
+    }
+
+    /// Push a new frame and optionally generate an intermediate frame.
+    /// Returns the first generated frame; use pushFrameMulti when
+    /// frame_multiplier > 2 to receive the whole batch.
     pub fn pushFrame(
         self: *FrameGenContext,
         cmd: vk.VkCommandBuffer,
         frame_image: motion_vectors.MotionVectorContext.FrameImage,
     ) !?GeneratedFrame {
+        var frames: [frame_synthesis.max_batch_frames]GeneratedFrame = undefined;
+        const count = try self.pushFrameMulti(cmd, frame_image, &frames);
+        if (count == 0) return null;
+        return frames[0];
+    }
+
+    /// Push a new frame and generate frame_multiplier - 1 frames at
+    /// factors k/N. Motion estimation runs once and is shared by the whole
+    /// batch, which is recorded into `cmd`. Returns the number of frames
+    /// written to `out`, in presentation order.
+    ///
+    /// On a scene cut, or when flow confidence is below
+    /// confidence_threshold, the GPU skips synthesis for the batch and
+    /// fills its outputs with the current frame instead. Both are reported
+    /// one frame later through stats.scene_change_detected and
+    /// stats.confidence, which PresentInjectionContext.shouldInject checks
+    /// before presenting.
+    ///
+    /// With a descriptor buffer, set synthesis_ctx.batch_release to the
+    /// timeline value the submission of `cmd` signals and keep at most
+    /// synthesis_descriptors.regions_in_flight batches pending; a batch
+    /// past that fails with error.DescriptorsBusy rather than waiting.
+    pub fn pushFrameMulti(
+        self: *FrameGenContext,
+        cmd: vk.VkCommandBuffer,
+        frame_image: motion_vectors.MotionVectorContext.FrameImage,
+        out: []GeneratedFrame,
+    ) !usize {
         const start_time = getTimeMicros();
+        self.updateRealFrameInterval(start_time);
+
+        // Blits need a graphics queue, which the async compute queue is not
+        self.applyResize(if (self.async_queues == null) cmd else null);
 
         // Always push to history
         const have_enough_frames = self.mv_ctx.pushFrame(frame_image);
 
+        self.stats.last_batch_count = 0;
+        self.output_sync = null;
         if (!self.enabled or !have_enough_frames) {
-            return null;
+            return 0;
         }
 
         self.current_frame_id += 1;
 
-        // Execute motion vector estimation
+        // Execute motion vector estimation (once for the whole batch)
+        if (self.gpu_timer) |*timer| timer.beginFrame(cmd);
+        self.timeBegin(cmd, .flow);
         try self.mv_ctx.execute(cmd);
+        self.timeEnd(cmd, .flow);
+
+        return self.generate(cmd, start_time, out);
+    }
+
+    /// Push a new frame like pushFrameMulti, with optical flow recorded
+    /// into `flow_cmd` for the optical flow queue and writing the next
+    /// motion vector ring slot. The batch is recorded into `cmd`.
+    ///
+    /// Submit flow_cmd, then cmd, with the timeline values of
+    /// getFlowSync() (null when nothing was recorded). Flow of the next
+    /// frame can then start while this frame is still being synthesized.
+    pub fn pushFrameOverlapped(
+        self: *FrameGenContext,
+        flow_cmd: vk.VkCommandBuffer,
+        cmd: vk.VkCommandBuffer,
+        frame_image: motion_vectors.MotionVectorContext.FrameImage,
+        out: []GeneratedFrame,
+    ) !usize {
+        if (!self.mv_ctx.isRingActive()) return error.NotInitialized;
+        self.flow_sync = null;
+
+        const start_time = getTimeMicros();
+        self.updateRealFrameInterval(start_time);
+
+        // Flow reads the history before cmd runs, and its queue cannot blit
+        self.applyResize(null);
+
+        // Always push to history
+        const have_enough_frames = self.mv_ctx.pushFrame(frame_image);
+
+        self.stats.last_batch_count = 0;
+        self.output_sync = null;
+        if (!self.enabled or !have_enough_frames) {
+            return 0;
+        }
+
+        self.current_frame_id += 1;
+
+        // Optical flow on its own queue, into the next ring slot
+        if (self.gpu_timer) |*timer| timer.beginFrame(flow_cmd);
+        self.timeBegin(flow_cmd, .flow);
+        self.flow_sync = try self.mv_ctx.executeFlow(flow_cmd);
+        self.timeEnd(flow_cmd, .flow);
+        // The synthesis submission signals its ring value once done
+        if (self.flow_sync) |sync| self.synthesis_ctx.batch_release = sync.synthesis.signal;
+
+        self.timeBegin(cmd, .mv_resolve);
+        try self.mv_ctx.resolveFlow(cmd);
+        self.timeEnd(cmd, .mv_resolve);
+
+        return self.generate(cmd, start_time, out);
+    }
+
+    /// Push a new frame and submit its frame generation on the async
+    /// queues, without a command buffer of the caller's. Optical flow goes
+    /// to the optical flow queue when one is configured (through the motion
+    /// vector ring), otherwise into the compute command buffer.
+    ///
+    /// `rendered` is the game's timeline value for frame_image being
+    /// complete; with EXCLUSIVE images the game releases frame_image with
+    /// AsyncQueues.recordReleaseToCompute before signalling it, and takes
+    /// it and the generated frames back with recordAcquireFromCompute.
+    /// frame_layout is the layout frame_image is in.
+    ///
+    /// If recording fails, a submission that only hands frame_image back
+    /// to graphics still signals the frame's value
+    /// (AsyncQueues.submitReleaseOnly) before the error is returned.
+    pub fn pushFrameAsync(
+        self: *FrameGenContext,
+        frame_image: motion_vectors.MotionVectorContext.FrameImage,
+        frame_layout: u32,
+        rendered: mv_ring.TimelineValue,
+        out: []GeneratedFrame,
+    ) !AsyncPush {
+        const queues = if (self.async_queues) |*q| q else return error.NotInitialized;
+        self.flow_sync = null;
+        const frame = try queues.beginFrame();
+        self.synthesis_ctx.batch_release = .{ .semaphore = queues.timeline, .value = frame.number };
+
+        var owned: [async_queue.max_transfer_images]async_queue.OwnedImage = undefined;
+        owned[0] = .{ .image = frame_image.image, .layout = frame_layout, .concurrent = frame_image.concurrent };
+        queues.acquireFromGraphics(frame.compute_cmd, owned[0..1]);
+
+        const count = blk: {
+            // The game released the frame to compute: on a failed recording
+            // still hand it back, and signal what later frames wait on
+            errdefer queues.submitReleaseOnly(frame, rendered, self.flow_sync, owned[0..1]) catch {};
+            break :blk if (frame.flow_cmd) |flow_cmd|
+                try self.pushFrameOverlapped(flow_cmd, frame.compute_cmd, frame_image, out)
+            else
+                try self.pushFrameMulti(frame.compute_cmd, frame_image, out);
+        };
+
+        // Hand the real frame and the generated frames back to the game
+        var owned_count: usize = 1;
+        for (out[0..count]) |generated| {
+            const image = generated.image orelse continue;
+            if (owned_count == owned.len) break;
+            owned[owned_count] = .{
+                .image = image,
+                .layout = vk.VK_IMAGE_LAYOUT_GENERAL,
+                .concurrent = self.synthesis_ctx.getOutputTarget(generated.batch_index).concurrent,
+            };
+            owned_count += 1;
+        }
+        queues.releaseToGraphics(frame.compute_cmd, owned[0..owned_count]);
+
+        const output_wait = if (self.output_sync) |acquired| acquired.wait else null;
+        const done = try queues.submit(frame, rendered, self.flow_sync, output_wait);
+        return .{ .count = count, .done = done };
+    }
+
+    /// Timeline values for the submissions of the last pushFrameOverlapped
+    pub fn getFlowSync(self: *const FrameGenContext) ?mv_ring.FrameSync {
+        return self.flow_sync;
+    }
+
+    /// Output ring set of the last generated batch (null without a ring or
+    /// when nothing was generated). Submit the batch with its wait value and
+    /// signal its release value once its frames have been presented.
+    pub fn getOutputSync(self: *const FrameGenContext) ?output_ring.Acquired {
+        return self.output_sync;
+    }
+
+    /// Scene statistics and synthesis of a batch from the motion vectors of
+    /// the current frame pair
+    fn generate(
+        self: *FrameGenContext,
+        cmd: vk.VkCommandBuffer,
+        start_time: i128,
+        out: []GeneratedFrame,
+    ) !usize {
+        self.timeBegin(cmd, .synthesis);
 
         // Get motion vectors
-        const mvb = self.mv_ctx.getMotionVectors() orelse return null;
+        const mvb = self.mv_ctx.getMotionVectors() orelse return 0;
 
-        // Check for scene change (basic luminance-based check)
-        // In full implementation, use cost map variance
-        const scene_change = self.detectSceneChange(mvb);
-        self.stats.scene_change_detected = scene_change;
+        // Scene change and confidence: the reduction gates this frame's
+        // synthesis on the GPU; the previous frame's result is read back
+        // without waiting
+        const gates = self.scene_detector.record(
+            cmd,
+            self.mv_ctx.getFlowGrid() orelse mvb,
+            self.synthesis_ctx.workgroup.groupsX(self.config.width),
+            self.synthesis_ctx.workgroup.groupsY(self.config.height),
+            self.config.width,
+            self.config.height,
+        );
+        self.synthesis_ctx.dispatch_gate = if (gates) |g| g.synthesis else null;
+        self.synthesis_ctx.tile_gate = if (gates) |g| g.tiles else null;
+        self.synthesis_ctx.passthrough_gate = if (gates) |g| g.passthrough else null;
+        // The detector wrote the tile confidence image for this frame
+        self.synthesis_ctx.tile_confidence = gates != null and self.synthesis_ctx.tile_confidence_view != null;
+        self.pending_hints[self.scene_detector.frame_index % scene_change.readback_depth] = self.mv_ctx.last_hint;
+        self.detectSceneChange();
+
+        const multiplier = std.math.clamp(self.config.frame_multiplier, 2, max_frame_multiplier);
+        const strategy = selectStrategy(
+            self.config.strategy_policy,
+            self.config.latency_budget_us,
+            interpolationHoldUs(self.real_frame_interval_us, multiplier),
+            self.stats.avg_gen_time_us,
+        );
 
-        if (scene_change) {
-            self.stats.skipped_frames += 1;
-            return null;
+        // Factors k/N for every generated frame of the batch
+        const count = @min(@as(usize, multiplier - 1), out.len, frame_synthesis.max_batch_frames);
+        var factors: [frame_synthesis.max_batch_frames]f32 = undefined;
+        for (0..count) |k| {
+            factors[k] = batchFactor(k, multiplier);
         }
 
-        // Synthesize intermediate frame
-        const prev_frame = self.mv_ctx.getPreviousFrame() orelse return null;
-        const curr_frame = self.mv_ctx.getCurrentFrame() orelse return null;
+        // Synthesize intermediate (or extrapolated) frames
+        const prev_frame = self.mv_ctx.getPreviousFrame() orelse return 0;
+        const curr_frame = self.mv_ctx.getCurrentFrame() orelse return 0;
 
-        const output_view = try self.synthesis_ctx.synthesize(
+        // Oldest output set; if presentation still holds it the GPU waits,
+        // never the CPU. Given back if the batch fails to record, since
+        // nothing would signal its release.
+        const outputs = try self.synthesis_ctx.acquireOutputs();
+        errdefer if (outputs) |acquired| self.synthesis_ctx.cancelOutputs(acquired);
+
+        // Recorded once per combination of history slot and output set when
+        // the synthesis context has a replay cache (and no timer); factors
+        // and gates go through its constants buffer
+        self.synthesis_ctx.history_slot = self.mv_ctx.current_frame_idx;
+        self.synthesis_ctx.timer = if (self.gpu_timer) |*timer| timer else null;
+        var views: [frame_synthesis.max_batch_frames]vk.VkImageView = undefined;
+        const written = try self.synthesis_ctx.replayBatch(
             cmd,
+            switch (strategy) {
+                .interpolate => .interpolate,
+                .extrapolate => .extrapolate,
+            },
             prev_frame.view,
             curr_frame.view,
             mvb,
+            factors[0..count],
+            views[0..count],
         );
+        self.timeEnd(cmd, .synthesis);
+
+        self.output_sync = outputs;
+        if (outputs) |acquired| {
+            if (acquired.wait != null) self.stats.output_busy_batches += 1;
+        }
 
         const end_time = getTimeMicros();
         const gen_time: u64 = @intCast(@max(0, end_time - start_time));
 
         // Update statistics
-        self.stats.generated_frames += 1;
+        self.stats.generated_frames += written;
+        if (strategy == .extrapolate) self.stats.extrapolated_frames += written;
+        self.stats.strategy = strategy;
+        self.stats.last_batch_count = @intCast(written);
+        self.pending_batches[self.scene_detector.frame_index % scene_change.readback_depth] = @intCast(written);
         self.updateFrameTime(gen_time);
+        self.updateGpuStats();
 
-        return GeneratedFrame{
-            .image_view = output_view,
-            .image = self.synthesis_ctx.getOutputImage(),
-            .confidence = self.calculateConfidence(mvb),
-            .generation_time_us = gen_time,
-            .frame_id = self.current_frame_id,
-            .should_present = true,
-        };
+        const confidence = self.calculateConfidence();
+        const should_present = confidence >= self.config.confidence_threshold;
+        for (0..written) |k| {
+            out[k] = .{
+                .image_view = views[k],
+                .image = self.synthesis_ctx.getOutputTarget(@intCast(k)).image,
+                .confidence = confidence,
+                .generation_time_us = gen_time,
+                .frame_id = self.current_frame_id,
+                .should_present = should_present,
+                .strategy = strategy,
+                .batch_index = @intCast(k),
+                .interpolation_factor = factors[k],
+            };
+        }
+        return written;
     }
 
     /// Get latency compensation in microseconds
@@ -249,9 +774,16 @@ pub const FrameGenContext = struct {
             return 0;
         }
 
-        // Compensation = half frame time (generated frame shown at t+0.5)
-        // Plus average generation overhead
-        return (self.config.target_frame_time_us / 2) + self.stats.avg_gen_time_us;
+        // Extrapolated frames do not hold back the real frame
+        if (self.stats.strategy == .extrapolate) {
+            return self.stats.avg_gen_time_us;
+        }
+
+        // Compensation = hold of the real frame behind the generated ones
+        // (half the measured frame interval at 2x) plus average generation
+        // overhead
+        return interpolationHoldUs(self.real_frame_interval_us, self.config.frame_multiplier) +
+            self.stats.avg_gen_time_us;
     }
 
     /// Get current statistics
@@ -259,6 +791,13 @@ pub const FrameGenContext = struct {
         return self.stats;
     }
 
+    /// GPU times of a stage over the last gpu_timing.rolling_window timed
+    /// frames (null without a GpuTimer)
+    pub fn getGpuStageStats(self: *const FrameGenContext, stage: gpu_timing.Stage) ?gpu_timing.RollingStats {
+        const timer = self.gpu_timer orelse return null;
+        return timer.stageStats(stage);
+    }
+
     /// Get current frame ID
     pub fn getCurrentFrameId(self: *const FrameGenContext) u64 {
         return self.current_frame_id;
@@ -266,35 +805,135 @@ pub const FrameGenContext = struct {
 
     /// Cleanup resources
     pub fn deinit(self: *FrameGenContext) void {
+        if (self.pipeline_cache) |*cache| {
+            // Best effort: a failed save only costs the next launch
+            cache.save() catch {};
+            cache.deinit();
+        }
+        if (self.gpu_timer) |*timer| {
+            timer.deinit();
+        }
+        if (self.async_queues) |*queues| {
+            queues.deinit();
+        }
         self.mv_ctx.deinit();
         self.synthesis_ctx.deinit();
+        self.resizer.deinit();
     }
 
     // ==========================================================================
     // Private Methods
     // ==========================================================================
 
-    fn detectSceneChange(self: *FrameGenContext, mvb: *const motion_vectors.MotionVectorBuffer) bool {
-        _ = mvb;
-        // Simple scene change detection based on cost map or motion magnitude
-        // In full implementation:
-        // - Check average cost from cost map
-        // - Check motion vector variance
-        // - Check luminance histogram difference
+    /// Swap in a finished resize before the frame is pushed. With `cmd`
+    /// (graphics) the previous frame is scaled into the set's history
+    /// image; otherwise warm-up restarts.
+    fn applyResize(self: *FrameGenContext, cmd: ?vk.VkCommandBuffer) void {
+        const set = self.resizer.takeReady() orelse return;
+        const history = set.history;
+        set.exchange(&self.mv_ctx, &self.synthesis_ctx, &self.scene_detector);
+        self.resizer.retire();
 
-        // For now, always return false (no scene change)
-        _ = self;
-        return false;
+        self.config.width = self.mv_ctx.config.width;
+        self.config.height = self.mv_ctx.config.height;
+        // The new set is built for the current mode (setMode)
+        self.mv_ctx.config.flow_scale = self.config.flow_scale orelse
+            defaultFlowScale(self.config.mode, self.config.width, self.config.height, self.config.flow_downsample_min_pixels);
+        self.mv_ctx.config.upsample = self.config.mv_upsample orelse defaultUpsample(self.config.motion_source, self.config.mode);
+        // Hints are sized for the old flow grid
+        self.mv_ctx.invalidateHint();
+        self.synthesis_ctx.replay_generation = self.resizer.generation;
+
+        // The newest frame is the one before current_frame_idx
+        const prev_idx = self.mv_ctx.current_frame_idx ^ 1;
+        const previous = self.mv_ctx.frame_history[prev_idx];
+        if (cmd != null and history != null and previous != null and self.dispatch != null) {
+            frame_resize.recordHistoryBlit(self.dispatch.?, cmd.?, previous.?, history.?);
+            self.mv_ctx.frame_history = .{ null, null };
+            self.mv_ctx.frame_history[prev_idx] = history.?;
+            self.resizer.stats.warm_history += 1;
+        } else {
+            self.mv_ctx.frame_history = .{ null, null };
+        }
+    }
+
+    fn timeBegin(self: *FrameGenContext, cmd: vk.VkCommandBuffer, stage: gpu_timing.Stage) void {
+        if (self.gpu_timer) |*timer| timer.begin(cmd, stage);
+    }
+
+    fn timeEnd(self: *FrameGenContext, cmd: vk.VkCommandBuffer, stage: gpu_timing.Stage) void {
+        if (self.gpu_timer) |*timer| timer.end(cmd, stage);
+    }
+
+    /// Copy the newest completed GPU timings into stats
+    fn updateGpuStats(self: *FrameGenContext) void {
+        const timer = &(self.gpu_timer orelse return);
+        const latest = timer.getLatest() orelse return;
+        self.stats.gpu_flow_ns = latest.durationNs(.flow);
+        self.stats.gpu_mv_resolve_ns = latest.durationNs(.mv_resolve);
+        self.stats.gpu_synthesis_ns = latest.durationNs(.synthesis);
+        self.stats.gpu_flow_overlap_ns = timer.flowOverlapNs();
+        self.stats.gpu_forward_warp_ns = latest.durationNs(.forward_warp);
+        self.stats.gpu_backward_warp_ns = latest.durationNs(.backward_warp);
+        self.stats.gpu_blend_ns = latest.durationNs(.blend);
+        self.stats.gpu_occlusion_fill_ns = latest.durationNs(.occlusion_fill);
+    }
+
+    fn detectSceneChange(self: *FrameGenContext) void {
+        const scene = self.scene_detector.poll() orelse return;
+        self.stats.scene_change_detected = scene.scene_change;
+        self.stats.confidence = scene.confidence;
+        self.stats.flow_cost = scene.mean_cost;
+
+        const prev_slot = (self.scene_detector.frame_index - 1) % scene_change.readback_depth;
+        if (scene.scene_change) {
+            // The previous motion field says nothing about the new scene
+            self.mv_ctx.invalidateHint();
+        } else {
+            self.updateHintCost(self.pending_hints[prev_slot], scene.mean_cost);
+        }
+
+        if (self.scene_detector.thresholds.gatesSynthesis(scene)) {
+            // The GPU skipped synthesis for the previous frame and passed
+            // the current frame through: count its batch as skipped instead
+            // of generated
+            self.stats.generated_frames -|= self.pending_batches[prev_slot];
+            self.stats.skipped_frames += self.pending_batches[prev_slot];
+            self.pending_batches[prev_slot] = 0;
+        }
     }
 
-    fn calculateConfidence(self: *const FrameGenContext, mvb: *const motion_vectors.MotionVectorBuffer) f32 {
-        _ = mvb;
-        _ = self;
-        // In full implementation, use cost map to calculate confidence
-        // Lower cost = higher confidence
+    /// Track mean flow cost separately for hinted and unhinted executions
+    fn updateHintCost(self: *FrameGenContext, use: motion_vectors.HintUse, mean_cost: f32) void {
+        switch (use) {
+            .none => return,
+            .hinted => self.hinted_cost = costAverage(self.hinted_cost, mean_cost),
+            .unhinted => self.unhinted_cost = costAverage(self.unhinted_cost, mean_cost),
+        }
+        if (self.hinted_cost > 0.0 and self.unhinted_cost > 0.0) {
+            self.stats.hint_cost_reduction = 1.0 - self.hinted_cost / self.unhinted_cost;
+        }
+    }
 
-        // For performance mode, always return high confidence
-        return 0.95;
+    /// Latest GPU flow confidence. The current frame's score is only known
+    /// one frame later; the GPU has already gated its synthesis, so the
+    /// previous score is a conservative estimate for presentation. Each
+    /// score comes from its own frame's reduction even with two frames in
+    /// flight (SceneChangeDetector.record). Without detection there is no
+    /// signal and generated frames are trusted.
+    fn calculateConfidence(self: *const FrameGenContext) f32 {
+        if (!self.scene_detector.isActive()) return 1.0;
+        return self.stats.confidence;
+    }
+
+    fn updateRealFrameInterval(self: *FrameGenContext, now: i128) void {
+        const now_us: u64 = @intCast(@max(0, now));
+        if (self.last_frame_time_us > 0 and now_us > self.last_frame_time_us) {
+            const interval = now_us - self.last_frame_time_us;
+            // Exponential moving average (1/8 weight) to ride out single hitches
+            self.real_frame_interval_us = (self.real_frame_interval_us * 7 + interval) / 8;
+        }
+        self.last_frame_time_us = now_us;
     }
 
     fn updateFrameTime(self: *FrameGenContext, gen_time: u64) void {
@@ -316,6 +955,12 @@ pub const FrameGenContext = struct {
     }
 };
 
+/// Exponential moving average (1/8 weight), seeded by the first sample
+fn costAverage(avg: f32, sample: f32) f32 {
+    if (avg == 0.0) return sample;
+    return avg + (sample - avg) / 8.0;
+}
+
 // =============================================================================
 // Tests
 // =============================================================================
@@ -342,6 +987,370 @@ test "FrameGenStats defaults" {
     try std.testing.expectApproxEqRel(@as(f32, 1.0), stats.confidence, 0.001);
 }
 
+test "selectStrategy" {
+    // Fixed policies ignore timing
+    try std.testing.expectEqual(GenerationStrategy.interpolate, selectStrategy(.interpolate, 0, 16667, 1000));
+    try std.testing.expectEqual(GenerationStrategy.extrapolate, selectStrategy(.extrapolate, 100_000, 16667, 1000));
+
+    // 60 FPS: interpolation adds 8333 + 1000us
+    const hold_60 = interpolationHoldUs(16667, 2);
+    try std.testing.expectEqual(GenerationStrategy.interpolate, selectStrategy(.latency_budget, 10_000, hold_60, 1000));
+    try std.testing.expectEqual(GenerationStrategy.extrapolate, selectStrategy(.latency_budget, 5_000, hold_60, 1000));
+
+    // 144 FPS: interpolation adds 3472 + 1000us
+    try std.testing.expectEqual(GenerationStrategy.interpolate, selectStrategy(.latency_budget, 5_000, interpolationHoldUs(6944, 2), 1000));
+}
+
+test "multi-frame factors and hold" {
+    // 4x: three generated frames at 1/4, 2/4, 3/4
+    try std.testing.expectApproxEqRel(@as(f32, 0.25), batchFactor(0, 4), 0.001);
+    try std.testing.expectApproxEqRel(@as(f32, 0.5), batchFactor(1, 4), 0.001);
+    try std.testing.expectApproxEqRel(@as(f32, 0.75), batchFactor(2, 4), 0.001);
+    try std.testing.expectApproxEqRel(@as(f32, 0.5), batchFactor(0, 2), 0.001);
+
+    // Real frame shown after N-1 generated frames spaced 1/N apart
+    try std.testing.expectEqual(@as(u64, 8000), interpolationHoldUs(16000, 2));
+    try std.testing.expectEqual(@as(u64, 12000), interpolationHoldUs(16000, 4));
+    try std.testing.expectEqual(@as(u8, 4), max_frame_multiplier);
+
+    // Compensation follows the measured interval, not the target
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080 }, null, null, std.testing.allocator);
+    try std.testing.expectEqual(@as(u64, 8333), ctx.getLatencyCompensation());
+    ctx.real_frame_interval_us = 33000;
+    try std.testing.expectEqual(@as(u64, 16500), ctx.getLatencyCompensation());
+}
+
+test "FrameGenContext scene detection defaults" {
+    const perf = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080 }, null, null, std.testing.allocator);
+    // Performance mode has no cost map, so the histogram is the only signal
+    try std.testing.expect(perf.scene_detector.thresholds.use_histogram);
+    try std.testing.expect(!perf.scene_detector.isActive());
+
+    const quality = FrameGenContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .mode = .quality,
+        .scene_change_threshold = 0.6,
+    }, null, null, std.testing.allocator);
+    try std.testing.expect(!quality.scene_detector.thresholds.use_histogram);
+    try std.testing.expectApproxEqRel(@as(f32, 0.6), quality.scene_detector.thresholds.cut_fraction, 0.001);
+}
+
+test "FrameGenContext confidence gating" {
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .mode = .balanced,
+        .confidence_threshold = 0.4,
+    }, null, null, std.testing.allocator);
+    // Threshold is forwarded to the GPU synthesis gate
+    try std.testing.expectApproxEqRel(@as(f32, 0.4), ctx.scene_detector.thresholds.min_confidence, 0.001);
+
+    // No detection: nothing to judge by
+    ctx.stats.confidence = 0.1;
+    try std.testing.expectApproxEqRel(@as(f32, 1.0), ctx.calculateConfidence(), 0.001);
+}
+
+test "FrameGenContext reclassifies a gated batch" {
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080, .frame_multiplier = 4 }, null, null, std.testing.allocator);
+    var results: [scene_change.readback_depth]scene_change.SceneStatsResult = undefined;
+    ctx.scene_detector.dispatch = &test_stubs.recording_dispatch;
+    try test_stubs.bindDetector(&ctx.scene_detector, &results);
+
+    // Frame 2 generated a batch of 3 that the GPU gated on a cut
+    ctx.scene_detector.frame_index = 3;
+    ctx.pending_batches[2 % scene_change.readback_depth] = 3;
+    ctx.stats.generated_frames = 3;
+    results[2 % scene_change.readback_depth].frame_index = 2;
+    results[2 % scene_change.readback_depth].scene_change = 1;
+    results[2 % scene_change.readback_depth].high_cost_fraction = 0.9;
+    results[2 % scene_change.readback_depth].confidence = 0.9;
+    ctx.detectSceneChange();
+    try std.testing.expectEqual(@as(u64, 0), ctx.stats.generated_frames);
+    try std.testing.expectEqual(@as(u64, 3), ctx.stats.skipped_frames);
+    try std.testing.expectEqual(@as(u8, 0), ctx.pending_batches[2 % scene_change.readback_depth]);
+
+    // The batch after the cut is not touched
+    ctx.pending_batches[3 % scene_change.readback_depth] = 3;
+    ctx.stats.generated_frames = 3;
+    ctx.scene_detector.frame_index = 4;
+    ctx.detectSceneChange();
+    try std.testing.expectEqual(@as(u64, 3), ctx.stats.generated_frames);
+    try std.testing.expectEqual(@as(u64, 3), ctx.stats.skipped_frames);
+}
+
+test "FrameGenContext confidence with two frames in flight" {
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080, .confidence_threshold = 0.5 }, null, null, std.testing.allocator);
+    var results: [scene_change.readback_depth]scene_change.SceneStatsResult = undefined;
+    ctx.scene_detector.dispatch = &test_stubs.recording_dispatch;
+    try test_stubs.bindDetector(&ctx.scene_detector, &results);
+    const mvb = test_stubs.motionVectors(0x1);
+    const cmd: vk.VkCommandBuffer = @ptrFromInt(0x4);
+
+    // Frames 1 and 2 recorded before either completes, each into its own
+    // readback slot behind the other's reads
+    _ = ctx.scene_detector.record(cmd, &mvb, 240, 135, 1920, 1080);
+    _ = ctx.scene_detector.record(cmd, &mvb, 240, 135, 1920, 1080);
+    results[1 % scene_change.readback_depth].frame_index = 1;
+    results[1 % scene_change.readback_depth].confidence = 0.2;
+    results[2 % scene_change.readback_depth].frame_index = 2;
+    results[2 % scene_change.readback_depth].confidence = 0.8;
+
+    // Frame 2 reads frame 1's score, frame 3 frame 2's
+    ctx.detectSceneChange();
+    try std.testing.expectApproxEqRel(@as(f32, 0.2), ctx.calculateConfidence(), 0.001);
+    _ = ctx.scene_detector.record(cmd, &mvb, 240, 135, 1920, 1080);
+    ctx.detectSceneChange();
+    try std.testing.expectApproxEqRel(@as(f32, 0.8), ctx.calculateConfidence(), 0.001);
+    try std.testing.expectEqual(@as(u64, 1), ctx.scene_detector.gated_frames);
+}
+
+var test_dispatches: u32 = 0;
+var test_flow_executions: u32 = 0;
+var test_session_performance: u32 = 0;
+
+fn stubCountDispatch(_: vk.VkCommandBuffer, _: u32, _: u32, _: u32) callconv(.c) void {
+    test_dispatches += 1;
+}
+
+fn stubCreateSession(_: vk.VkDevice, info: *const optical_flow.VkOpticalFlowSessionCreateInfoNV, _: ?*const vk.VkAllocationCallbacks, session: *optical_flow.VkOpticalFlowSessionNV) callconv(.c) i32 {
+    test_session_performance = info.performanceLevel;
+    session.* = @ptrFromInt(0x5000);
+    return 0;
+}
+fn stubDestroySession(_: vk.VkDevice, _: optical_flow.VkOpticalFlowSessionNV, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {}
+fn stubBindSessionImage(_: vk.VkDevice, _: optical_flow.VkOpticalFlowSessionNV, _: u32, _: vk.VkImageView, _: u32) callconv(.c) i32 {
+    return 0;
+}
+fn stubExecuteFlow(_: vk.VkCommandBuffer, _: optical_flow.VkOpticalFlowSessionNV, _: *const optical_flow.VkOpticalFlowExecuteInfoNV) callconv(.c) void {
+    test_flow_executions += 1;
+}
+
+fn stubGetDeviceProcAddr(_: vk.VkDevice, name: [*:0]const u8) callconv(.c) ?*const fn () callconv(.c) void {
+    const n = std.mem.span(name);
+    if (std.mem.eql(u8, n, "vkCreateOpticalFlowSessionNV")) return @ptrCast(&stubCreateSession);
+    if (std.mem.eql(u8, n, "vkDestroyOpticalFlowSessionNV")) return @ptrCast(&stubDestroySession);
+    if (std.mem.eql(u8, n, "vkBindOpticalFlowSessionImageNV")) return @ptrCast(&stubBindSessionImage);
+    if (std.mem.eql(u8, n, "vkCmdOpticalFlowExecuteNV")) return @ptrCast(&stubExecuteFlow);
+    return null;
+}
+
+test "FrameGenContext pushes a frame through created session and pipelines" {
+    var d = test_stubs.withPipelines(test_stubs.recording_dispatch);
+    d.vkCmdDispatch = stubCountDispatch;
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080 }, null, &d, std.testing.allocator);
+    defer ctx.deinit();
+    test_dispatches = 0;
+    test_flow_executions = 0;
+
+    try ctx.createFlowSession(stubGetDeviceProcAddr, 44);
+    try ctx.createPipelines(.{ .passes = .initFill(@ptrFromInt(0x2000)) }, .{ .load = &test_stubs.loadSpirv });
+    ctx.mv_ctx.mv_buffer = test_stubs.motionVectors(0x10);
+    ctx.synthesis_ctx.warp_scratch = @ptrFromInt(0x20);
+    ctx.synthesis_ctx.warp_scratch_view = @ptrFromInt(0x21);
+    try ctx.synthesis_ctx.setOutputTarget(0, .{
+        .image = @ptrFromInt(0x30),
+        .view = @ptrFromInt(0x31),
+        .descriptor_sets = .initFill(@ptrFromInt(0x32)),
+    });
+
+    var out: [frame_synthesis.max_batch_frames]GeneratedFrame = undefined;
+    const cmd: vk.VkCommandBuffer = @ptrFromInt(0x40);
+    const frames = [_]motion_vectors.MotionVectorContext.FrameImage{
+        .{ .image = @ptrFromInt(0x50), .view = @ptrFromInt(0x51), .width = 1920, .height = 1080 },
+        .{ .image = @ptrFromInt(0x60), .view = @ptrFromInt(0x61), .width = 1920, .height = 1080 },
+    };
+    // Warm-up: one frame of history
+    try std.testing.expectEqual(@as(usize, 0), try ctx.pushFrameMulti(cmd, frames[0], &out));
+
+    try std.testing.expectEqual(@as(usize, 1), try ctx.pushFrameMulti(cmd, frames[1], &out));
+    try std.testing.expectEqual(@as(?vk.VkImageView, @ptrFromInt(0x31)), out[0].image_view);
+    try std.testing.expectEqual(@as(u32, 1), test_flow_executions);
+    // Performance mode: forward warp + linear blend
+    try std.testing.expectEqual(@as(u32, 2), test_dispatches);
+}
+
+test "FrameGenContext builds pipelines for a format set before them" {
+    const d = test_stubs.withPipelines(.{ .device = test_stubs.device });
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080 }, null, &d, std.testing.allocator);
+    defer ctx.deinit();
+
+    // nvvk_frame_gen_init2 with an HDR10 swapchain: no pipelines exist yet
+    try ctx.setSwapchainFormat(output_format.VK_FORMAT_A2B10G10R10_UNORM_PACK32, output_format.VK_COLOR_SPACE_HDR10_ST2084_EXT);
+    try ctx.createPipelines(.{ .passes = .initFill(@ptrFromInt(0x2000)) }, .{ .load = &test_stubs.loadSpirv });
+    const hdr10 = output_format.FormatKey{ .output = .rgb10a2, .transfer = .pq };
+    try std.testing.expect(ctx.synthesis_ctx.format_pipelines.?.contains(hdr10));
+    try std.testing.expect(!ctx.synthesis_ctx.format_pipelines.?.contains(.{}));
+    try std.testing.expect(ctx.synthesis_ctx.warp_pipeline != null);
+
+    // scRGB swapchain recreated later
+    try ctx.setSwapchainFormat(output_format.VK_FORMAT_R16G16B16A16_SFLOAT, output_format.VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT);
+    try std.testing.expectEqual(output_format.OutputFormat.rgba16f, ctx.synthesis_ctx.output_key.output);
+}
+
+test "defaultFlowScale" {
+    const min_pixels = (FrameGenConfig{ .width = 0, .height = 0 }).flow_downsample_min_pixels;
+    try std.testing.expectEqual(motion_vectors.FlowScale.full, defaultFlowScale(.performance, 1920, 1080, min_pixels));
+    try std.testing.expectEqual(motion_vectors.FlowScale.half, defaultFlowScale(.performance, 3840, 2160, min_pixels));
+    try std.testing.expectEqual(motion_vectors.FlowScale.full, defaultFlowScale(.quality, 3840, 2160, min_pixels));
+
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 3840, .height = 2160 }, null, null, std.testing.allocator);
+    try std.testing.expectEqual(motion_vectors.FlowScale.half, ctx.mv_ctx.config.flow_scale);
+    // The live set keeps the scale it was sized for
+    ctx.setMode(.balanced);
+    try std.testing.expectEqual(motion_vectors.FlowScale.half, ctx.mv_ctx.config.flow_scale);
+    try std.testing.expectEqual(motion_vectors.UpsampleTarget.none, ctx.mv_ctx.config.upsample);
+}
+
+test "defaultUpsample" {
+    try std.testing.expectEqual(motion_vectors.UpsampleTarget.none, defaultUpsample(.optical_flow, .performance));
+    try std.testing.expectEqual(motion_vectors.UpsampleTarget.grid_2x2, defaultUpsample(.optical_flow, .balanced));
+    try std.testing.expectEqual(motion_vectors.UpsampleTarget.full, defaultUpsample(.optical_flow, .quality));
+    try std.testing.expectEqual(motion_vectors.UpsampleTarget.none, defaultUpsample(.engine, .quality));
+
+    const ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .mode = .quality,
+        .mv_upsample = .grid_2x2,
+    }, null, null, std.testing.allocator);
+    try std.testing.expectEqual(motion_vectors.UpsampleTarget.grid_2x2, ctx.mv_ctx.config.upsample);
+}
+
+test "flow hints" {
+    try std.testing.expectEqual(optical_flow.PerformanceLevel.slow, flowPerformance(.quality, false));
+    try std.testing.expectEqual(optical_flow.PerformanceLevel.medium, flowPerformance(.quality, true));
+    try std.testing.expectEqual(optical_flow.PerformanceLevel.fast, flowPerformance(.performance, true));
+
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .mode = .balanced,
+        .flow_hints = .previous_flow,
+    }, null, null, std.testing.allocator);
+    // Unhinted until a session is created with hint resources
+    try std.testing.expectEqual(optical_flow.PerformanceLevel.medium, ctx.mv_ctx.config.performance);
+    try std.testing.expectEqual(optical_flow.PerformanceLevel.fast, ctx.mv_ctx.config.hinted_performance.?);
+    try std.testing.expectEqual(motion_vectors.HintSource.previous_flow, ctx.mv_ctx.config.hint_source);
+
+    // Cost reduction needs both hinted and unhinted samples
+    ctx.updateHintCost(.hinted, 30.0);
+    try std.testing.expectApproxEqAbs(@as(f32, 0.0), ctx.stats.hint_cost_reduction, 0.001);
+    ctx.updateHintCost(.unhinted, 40.0);
+    try std.testing.expectApproxEqRel(@as(f32, 0.25), ctx.stats.hint_cost_reduction, 0.001);
+    ctx.updateHintCost(.none, 100.0);
+    try std.testing.expectApproxEqRel(@as(f32, 0.25), ctx.stats.hint_cost_reduction, 0.001);
+}
+
+test "flow session runs faster only when hinted" {
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .mode = .balanced,
+        .flow_hints = .external,
+    }, null, null, std.testing.allocator);
+    defer ctx.deinit();
+
+    // No hint resources: unhinted session at the mode's level
+    try ctx.createFlowSession(stubGetDeviceProcAddr, 44);
+    try std.testing.expect(!ctx.mv_ctx.isHinting());
+    try std.testing.expectEqual(@intFromEnum(optical_flow.PerformanceLevel.medium), test_session_performance);
+
+    ctx.mv_ctx.zero_hint_view = @ptrFromInt(0x10);
+    try ctx.createFlowSession(stubGetDeviceProcAddr, 44);
+    try std.testing.expect(ctx.mv_ctx.isHinting());
+    try std.testing.expectEqual(@intFromEnum(optical_flow.PerformanceLevel.fast), test_session_performance);
+}
+
+test "engine motion source" {
+    const ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .motion_source = .engine,
+        .engine_motion = .{ .has_depth = true },
+    }, null, null, std.testing.allocator);
+    try std.testing.expectEqual(motion_vectors.MotionSource.engine, ctx.mv_ctx.config.source);
+    try std.testing.expect(ctx.mv_ctx.config.engine_motion.has_depth);
+    // mv_buffer is per pixel, matching the skipped upsample
+    try std.testing.expectEqual(optical_flow.GridSize.@"1x1", ctx.mv_ctx.config.grid_size);
+    try std.testing.expectEqual(motion_vectors.UpsampleTarget.none, ctx.mv_ctx.config.upsample);
+    const dims = motion_vectors.calculateMVDimensions(1920, 1080, ctx.mv_ctx.config.grid_size);
+    try std.testing.expectEqual(@as(u32, 1920), dims.width);
+    // Derived cost map even in performance mode; cuts come from the histogram
+    try std.testing.expect(ctx.mv_ctx.config.enable_cost);
+    try std.testing.expect(ctx.scene_detector.thresholds.use_histogram);
+}
+
+test "FrameGenContext overlapped push needs the ring" {
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080 }, null, null, std.testing.allocator);
+    var frames: [frame_synthesis.max_batch_frames]GeneratedFrame = undefined;
+    const frame = motion_vectors.MotionVectorContext.FrameImage{
+        .image = @ptrFromInt(0x10),
+        .view = @ptrFromInt(0x11),
+        .memory = @ptrFromInt(0x12),
+        .width = 1920,
+        .height = 1080,
+    };
+    try std.testing.expectError(error.NotInitialized, ctx.pushFrameOverlapped(@ptrFromInt(0x2000), @ptrFromInt(0x2001), frame, &frames));
+    // Nothing was pushed to history
+    try std.testing.expect(ctx.mv_ctx.getCurrentFrame() == null);
+    try std.testing.expect(ctx.getFlowSync() == null);
+    try std.testing.expectEqual(@as(u64, 0), ctx.getStats().gpu_flow_overlap_ns);
+    try std.testing.expect(ctx.getGpuStageStats(.blend) == null);
+}
+
+test "FrameGenContext async push needs the queues" {
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080 }, null, null, std.testing.allocator);
+    var frames: [frame_synthesis.max_batch_frames]GeneratedFrame = undefined;
+    const frame = motion_vectors.MotionVectorContext.FrameImage{
+        .image = @ptrFromInt(0x10),
+        .view = @ptrFromInt(0x11),
+        .memory = @ptrFromInt(0x12),
+        .width = 1920,
+        .height = 1080,
+    };
+    const rendered = mv_ring.TimelineValue{ .semaphore = @ptrFromInt(0x20), .value = 1 };
+    try std.testing.expectError(error.NotInitialized, ctx.pushFrameAsync(frame, vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, rendered, &frames));
+}
+
+test "FrameGenContext swaps a staged resize on push" {
+    var ctx = FrameGenContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080 }, null, null, std.testing.allocator);
+    defer ctx.deinit();
+    var frames: [frame_synthesis.max_batch_frames]GeneratedFrame = undefined;
+    try std.testing.expect((try ctx.resize(1920, 1080)) == null);
+
+    const set = (try ctx.resize(1280, 720)).?;
+    set.synthesis.warp_scratch = @ptrFromInt(0x30);
+    const frame = motion_vectors.MotionVectorContext.FrameImage{
+        .image = @ptrFromInt(0x10),
+        .view = @ptrFromInt(0x11),
+        .width = 1920,
+        .height = 1080,
+    };
+    // Still building: the first frame goes to the current set
+    _ = try ctx.pushFrameMulti(@ptrFromInt(0x2000), frame, &frames);
+    try std.testing.expectEqual(@as(u32, 1920), ctx.config.width);
+
+    ctx.finishResize();
+    const resized = motion_vectors.MotionVectorContext.FrameImage{
+        .image = @ptrFromInt(0x20),
+        .view = @ptrFromInt(0x21),
+        .width = 1280,
+        .height = 720,
+    };
+    try std.testing.expectEqual(@as(usize, 0), try ctx.pushFrameMulti(@ptrFromInt(0x2000), resized, &frames));
+    try std.testing.expectEqual(@as(u32, 1280), ctx.config.width);
+    try std.testing.expectEqual(@as(u32, 720), ctx.synthesis_ctx.height);
+    try std.testing.expectEqual(@as(vk.VkImage, @ptrFromInt(0x30)), ctx.synthesis_ctx.warp_scratch.?);
+    // No history image: warm-up restarts from the resized frame
+    try std.testing.expect(ctx.mv_ctx.getPreviousFrame() == null);
+    try std.testing.expectEqual(@as(u32, 1), ctx.synthesis_ctx.replay_generation);
+
+    const old = ctx.releaseResize().?;
+    try std.testing.expectEqual(@as(u32, 1920), old.extent.width);
+    try std.testing.expect(ctx.releaseResize() == null);
+}
+
 test "GeneratedFrame" {
     const frame = GeneratedFrame{
         .image_view = null,
@@ -353,4 +1362,5 @@ test "GeneratedFrame" {
     };
     try std.testing.expect(frame.should_present);
     try std.testing.expectEqual(@as(u64, 42), frame.frame_id);
+    try std.testing.expectEqual(GenerationStrategy.interpolate, frame.strategy);
 }
@@ -0,0 +1,413 @@
+//! Staged Swapchain Resize
+//!
+//! Every image, buffer and descriptor set sized from the frame extent
+//! (flow grid, motion vectors, luma copies, outputs, scratch and quality
+//! intermediates) had to be recreated inside the resize callback, with the
+//! device idle and frame generation off until the next two real frames.
+//!
+//! FrameGenContext.resize() stages the change instead. It returns a
+//! SizedResources for the new extent that the caller builds while the
+//! current set keeps generating frames: nothing in it is referenced by the
+//! contexts yet, so it can be built on another thread, which calls
+//! finishResize() when done. The next pushFrame swaps the two sets between
+//! frames. The old set is retired until the caller has waited for the last
+//! submission that used it; releaseResize() then hands it back for
+//! destruction.
+//!
+//! Memory: allocate() places the new set in the arena of the last released
+//! set when it fits (MemoryArena.replan), so shrinking or resizing back
+//! within the largest extent seen allocates nothing.
+//!
+//! History: the previous real frame still has the old extent. With a
+//! `history` image the swap blits it there, and the first frame at the new
+//! extent already has a pair to estimate motion from. Blits need a
+//! graphics queue; without one (or without `history`) warm-up restarts.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const optical_flow = @import("optical_flow.zig");
+const motion_vectors = @import("motion_vectors.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const mv_ring = @import("mv_ring.zig");
+const output_ring = @import("output_ring.zig");
+const tile_classify = @import("tile_classify.zig");
+const forward_splat = @import("forward_splat.zig");
+const hole_fill = @import("hole_fill.zig");
+const synthesis_graph = @import("synthesis_graph.zig");
+const scene_change = @import("scene_change.zig");
+const memory_arena = @import("memory_arena.zig");
+const test_stubs = @import("test_stubs.zig");
+
+const FrameImage = motion_vectors.MotionVectorContext.FrameImage;
+const MotionVectorBuffer = motion_vectors.MotionVectorBuffer;
+const OutputTarget = frame_synthesis.OutputTarget;
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Frame extent in pixels
+pub const Extent = struct {
+    width: u32,
+    height: u32,
+
+    pub fn eql(self: Extent, other: Extent) bool {
+        return self.width == other.width and self.height == other.height;
+    }
+};
+
+/// Sized resources of MotionVectorContext (fields of the same name)
+pub const MotionResources = struct {
+    flow_ctx: ?optical_flow.OpticalFlowContext = null,
+    mv_buffer: ?MotionVectorBuffer = null,
+    upsampled_buffer: ?MotionVectorBuffer = null,
+    upsample_descriptor_sets: [2]?vk.VkDescriptorSet = .{ null, null },
+    downsample_descriptor_sets: [2]?vk.VkDescriptorSet = .{ null, null },
+    luma_history: [2]?FrameImage = .{ null, null },
+    hint_image: ?FrameImage = null,
+    ingest_descriptor_set: ?vk.VkDescriptorSet = null,
+    ring: ?mv_ring.MotionVectorRing = null,
+};
+
+/// Sized resources of FrameSynthesisContext (fields of the same name)
+pub const SynthesisResources = struct {
+    descriptor_sets: frame_synthesis.PassSets = .initFill(null),
+    alternate_descriptor_sets: frame_synthesis.PassSets = .initFill(null),
+    output_image: ?vk.VkImage = null,
+    output_view: ?vk.VkImageView = null,
+    output_memory: ?vk.VkDeviceMemory = null,
+    output_concurrent: bool = false,
+    extra_outputs: [frame_synthesis.max_batch_frames - 1]OutputTarget = [_]OutputTarget{.{}} ** (frame_synthesis.max_batch_frames - 1),
+    output_ring: ?output_ring.OutputRing = null,
+    warp_scratch: ?vk.VkImage = null,
+    warp_scratch_view: ?vk.VkImageView = null,
+    warp_scratch_memory: ?vk.VkDeviceMemory = null,
+    tile_confidence_view: ?vk.VkImageView = null,
+    tile_classifier: ?tile_classify.TileClassifier = null,
+    forward_splat: ?forward_splat.ForwardSplat = null,
+    pull_push: ?hole_fill.PullPushFill = null,
+    transient_aliases: ?synthesis_graph.AliasMap = null,
+};
+
+/// Images of QualityPipeline (swapped when the context has one)
+pub const QualityImages = struct {
+    backward_warped: ?vk.VkImage = null,
+    backward_warped_view: ?vk.VkImageView = null,
+    backward_warped_memory: ?vk.VkDeviceMemory = null,
+    filled_output: ?vk.VkImage = null,
+    filled_output_view: ?vk.VkImageView = null,
+    filled_output_memory: ?vk.VkDeviceMemory = null,
+};
+
+/// Every resource sized from the frame extent. Fields left at their
+/// defaults are swapped in as such: fill in everything the current set
+/// uses.
+pub const SizedResources = struct {
+    extent: Extent,
+    motion: MotionResources = .{},
+    synthesis: SynthesisResources = .{},
+    quality: QualityImages = .{},
+    /// Scene change readback slots (their descriptor sets bind the tile
+    /// confidence image). Readbacks in flight at the swap read as stale.
+    scene_slots: [scene_change.readback_depth]scene_change.ReadbackSlot = [_]scene_change.ReadbackSlot{.{}} ** scene_change.readback_depth,
+    /// Image at `extent` (SHADER_READ_ONLY_OPTIMAL after the swap) the
+    /// previous real frame is scaled into; null restarts warm-up
+    history: ?FrameImage = null,
+    /// Memory of the set, from allocate()
+    arena: ?memory_arena.MemoryArena = null,
+    /// allocate() placed the set in a reused arena
+    reused_arena: bool = false,
+
+    /// Memory for the set's resources: the reused arena when they fit in
+    /// its blocks, a new arena otherwise. Bind with bindImage/bindBuffer
+    /// and the *_memory fields with memoryOf.
+    pub fn allocate(
+        self: *SizedResources,
+        dispatch: *const vk.DeviceDispatch,
+        requests: []const memory_arena.Request,
+        options: memory_arena.PlanOptions,
+    ) !*memory_arena.MemoryArena {
+        if (self.arena) |*arena| {
+            if (try arena.replan(requests, options)) {
+                self.reused_arena = true;
+                return arena;
+            }
+            arena.deinit();
+            self.arena = null;
+        }
+        self.reused_arena = false;
+        self.arena = try memory_arena.MemoryArena.init(dispatch, requests, options);
+        return &self.arena.?;
+    }
+
+    /// Exchange the set with the one the contexts use, extents included
+    pub fn exchange(
+        self: *SizedResources,
+        mv: *motion_vectors.MotionVectorContext,
+        synthesis: *frame_synthesis.FrameSynthesisContext,
+        scene: *scene_change.SceneChangeDetector,
+    ) void {
+        inline for (std.meta.fields(MotionResources)) |field| {
+            std.mem.swap(field.type, &@field(mv, field.name), &@field(self.motion, field.name));
+        }
+        inline for (std.meta.fields(SynthesisResources)) |field| {
+            std.mem.swap(field.type, &@field(synthesis, field.name), &@field(self.synthesis, field.name));
+        }
+        if (synthesis.quality_pipeline) |*qp| {
+            inline for (std.meta.fields(QualityImages)) |field| {
+                std.mem.swap(field.type, &@field(qp, field.name), &@field(self.quality, field.name));
+            }
+        }
+        std.mem.swap([scene_change.readback_depth]scene_change.ReadbackSlot, &scene.slots, &self.scene_slots);
+
+        const previous = Extent{ .width = mv.config.width, .height = mv.config.height };
+        mv.config.width = self.extent.width;
+        mv.config.height = self.extent.height;
+        synthesis.width = self.extent.width;
+        synthesis.height = self.extent.height;
+        self.extent = previous;
+        // Luma copies are new
+        mv.luma_valid = .{ false, false };
+    }
+
+    /// Destroy what nvvk owns (flow session, ring semaphores, arena). The
+    /// caller destroys the images, views and descriptor sets first.
+    pub fn deinit(self: *SizedResources) void {
+        self.deinitOwned();
+        if (self.arena) |*arena| arena.deinit();
+        self.arena = null;
+    }
+
+    fn deinitOwned(self: *SizedResources) void {
+        if (self.motion.flow_ctx) |*ctx| ctx.deinit();
+        if (self.motion.ring) |*ring| ring.deinit();
+        if (self.synthesis.output_ring) |*ring| ring.deinit();
+        self.motion.flow_ctx = null;
+        self.motion.ring = null;
+        self.synthesis.output_ring = null;
+    }
+};
+
+/// Resize statistics
+pub const ResizeStats = struct {
+    /// Sets swapped in
+    swaps: u64 = 0,
+    /// Sets placed in a reused arena
+    reused_arenas: u64 = 0,
+    /// Swaps that kept the frame history
+    warm_history: u64 = 0,
+};
+
+/// Staged resize state of FrameGenContext
+pub const Resizer = struct {
+    /// Set being built for the next extent
+    pending: ?SizedResources = null,
+    /// pending is complete (set from the building thread)
+    ready: std.atomic.Value(bool) = .init(false),
+    /// Set swapped out, until released
+    retired: ?SizedResources = null,
+    /// Arena of the set in use, when it came through a resize
+    arena: ?memory_arena.MemoryArena = null,
+    /// Arena of the last released set, handed to the next pending set
+    spare: ?memory_arena.MemoryArena = null,
+    /// Incremented on every swap
+    generation: u32 = 0,
+    stats: ResizeStats = .{},
+
+    /// Stage a set for `next`. Returns null when the contexts already use
+    /// that extent.
+    pub fn begin(self: *Resizer, current: Extent, next: Extent) !?*SizedResources {
+        if (next.width == 0 or next.height == 0) return error.InvalidExtent;
+        if (self.pending != null) return error.ResizeInProgress;
+        if (current.eql(next)) return null;
+
+        self.ready.store(false, .release);
+        self.pending = .{ .extent = next, .arena = self.spare };
+        self.spare = null;
+        return &self.pending.?;
+    }
+
+    /// Mark the pending set complete; safe from any thread
+    pub fn markReady(self: *Resizer) void {
+        self.ready.store(true, .release);
+    }
+
+    /// Pending set to swap in now: complete, and the previous retired set
+    /// released
+    pub fn takeReady(self: *Resizer) ?*SizedResources {
+        if (self.pending == null or self.retired != null) return null;
+        if (!self.ready.load(.acquire)) return null;
+        return &self.pending.?;
+    }
+
+    /// Retire the pending set after exchange() put the old resources in it
+    pub fn retire(self: *Resizer) void {
+        var set = self.pending.?;
+        if (set.reused_arena) self.stats.reused_arenas += 1;
+        std.mem.swap(?memory_arena.MemoryArena, &self.arena, &set.arena);
+        self.retired = set;
+        self.pending = null;
+        self.ready.store(false, .release);
+        self.generation +%= 1;
+        self.stats.swaps += 1;
+    }
+
+    /// Hand back the retired set once the GPU is done with it. Its nvvk
+    /// objects are destroyed and its arena kept for the next resize; the
+    /// caller destroys the rest.
+    pub fn release(self: *Resizer) ?SizedResources {
+        var set = self.retired orelse return null;
+        self.retired = null;
+        set.deinitOwned();
+        if (set.arena) |arena| {
+            if (self.spare) |*spare| spare.deinit();
+            self.spare = arena;
+            set.arena = null;
+        }
+        return set;
+    }
+
+    /// Free every arena and the nvvk objects of staged sets. Images bound
+    /// to them must be destroyed first.
+    pub fn deinit(self: *Resizer) void {
+        if (self.pending) |*set| set.deinit();
+        if (self.retired) |*set| set.deinit();
+        if (self.arena) |*arena| arena.deinit();
+        if (self.spare) |*arena| arena.deinit();
+        self.* = .{};
+    }
+};
+
+/// Scale `src` (SHADER_READ_ONLY_OPTIMAL, kept) into `dst` (contents
+/// discarded, SHADER_READ_ONLY_OPTIMAL after). `cmd` must be on a graphics
+/// queue.
+pub fn recordHistoryBlit(d: *const vk.DeviceDispatch, cmd: vk.VkCommandBuffer, src: FrameImage, dst: FrameImage) void {
+    const blit = d.vkCmdBlitImage orelse return;
+
+    const to_transfer = [_]vk.VkImageMemoryBarrier{
+        .{
+            .srcAccessMask = vk.VK_ACCESS_SHADER_READ_BIT,
+            .dstAccessMask = vk.VK_ACCESS_TRANSFER_READ_BIT,
+            .oldLayout = vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .newLayout = vk.VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .image = src.image,
+        },
+        .{
+            .dstAccessMask = vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            .newLayout = vk.VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .image = dst.image,
+        },
+    };
+    d.cmdImageBarriers(cmd, vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, vk.VK_PIPELINE_STAGE_TRANSFER_BIT, .{}, &to_transfer);
+
+    const region = [_]vk.VkImageBlit{.{
+        .srcOffsets = .{ .{}, .{ .x = @intCast(src.width), .y = @intCast(src.height), .z = 1 } },
+        .dstOffsets = .{ .{}, .{ .x = @intCast(dst.width), .y = @intCast(dst.height), .z = 1 } },
+    }};
+    blit(cmd, src.image, vk.VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst.image, vk.VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region, vk.VK_FILTER_LINEAR);
+
+    const to_shader = [_]vk.VkImageMemoryBarrier{
+        .{
+            .srcAccessMask = vk.VK_ACCESS_TRANSFER_READ_BIT,
+            .dstAccessMask = vk.VK_ACCESS_SHADER_READ_BIT,
+            .oldLayout = vk.VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .newLayout = vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .image = src.image,
+        },
+        .{
+            .srcAccessMask = vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = vk.VK_ACCESS_SHADER_READ_BIT,
+            .oldLayout = vk.VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout = vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .image = dst.image,
+        },
+    };
+    d.cmdImageBarriers(cmd, vk.VK_PIPELINE_STAGE_TRANSFER_BIT, vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, .{}, &to_shader);
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+var stub_blits: usize = 0;
+var stub_blit_extent: [2]i32 = .{ 0, 0 };
+
+fn testGrid(width: u32, height: u32) MotionVectorBuffer {
+    var grid = test_stubs.motionVectors(0x40);
+    grid.width = width;
+    grid.height = height;
+    return grid;
+}
+
+fn stubBlit(_: vk.VkCommandBuffer, _: vk.VkImage, _: u32, _: vk.VkImage, _: u32, _: u32, regions: [*]const vk.VkImageBlit, _: u32) callconv(.c) void {
+    stub_blits += 1;
+    stub_blit_extent = .{ regions[0].dstOffsets[1].x, regions[0].dstOffsets[1].y };
+}
+
+test "Resizer stages, swaps and releases a set" {
+    const dispatch = test_stubs.memory_dispatch;
+    test_stubs.allocations = 0;
+    var mv = motion_vectors.MotionVectorContext.init(@ptrFromInt(0x1000), .{ .width = 1920, .height = 1080 }, null, std.testing.allocator);
+    defer mv.deinit();
+    var synthesis = frame_synthesis.FrameSynthesisContext.init(null, 1920, 1080, .performance, null, std.testing.allocator);
+    defer synthesis.deinit();
+    var scene = scene_change.SceneChangeDetector.init(.{}, false, null);
+    mv.mv_buffer = testGrid(480, 270);
+    synthesis.warp_scratch = @ptrFromInt(0x10);
+
+    var resizer = Resizer{};
+    defer resizer.deinit();
+    const current = Extent{ .width = 1920, .height = 1080 };
+    try std.testing.expect((try resizer.begin(current, current)) == null);
+
+    const requests = [_]memory_arena.Request{.{ .size = 4096, .memory_type_bits = 1 }};
+    const set = (try resizer.begin(current, .{ .width = 1280, .height = 720 })).?;
+    try std.testing.expectError(error.ResizeInProgress, resizer.begin(current, .{ .width = 640, .height = 360 }));
+    _ = try set.allocate(&dispatch, &requests, .{});
+    set.motion.mv_buffer = testGrid(320, 180);
+    set.synthesis.warp_scratch = @ptrFromInt(0x20);
+
+    // Not swapped until marked ready
+    try std.testing.expect(resizer.takeReady() == null);
+    resizer.markReady();
+    resizer.takeReady().?.exchange(&mv, &synthesis, &scene);
+    resizer.retire();
+    try std.testing.expectEqual(@as(u32, 1280), mv.config.width);
+    try std.testing.expectEqual(@as(u32, 720), synthesis.height);
+    try std.testing.expectEqual(@as(u32, 320), mv.mv_buffer.?.width);
+    try std.testing.expectEqual(@as(vk.VkImage, @ptrFromInt(0x20)), synthesis.warp_scratch.?);
+    try std.testing.expectEqual(@as(u32, 1), resizer.generation);
+
+    // The next set waits until the old one is released
+    const back = (try resizer.begin(.{ .width = 1280, .height = 720 }, current)).?;
+    resizer.markReady();
+    try std.testing.expect(resizer.takeReady() == null);
+    const old = resizer.release().?;
+    try std.testing.expectEqual(@as(u32, 1920), old.extent.width);
+    try std.testing.expectEqual(@as(vk.VkImage, @ptrFromInt(0x10)), old.synthesis.warp_scratch.?);
+    try std.testing.expectEqual(back, resizer.takeReady().?);
+    try std.testing.expect(back.arena == null);
+
+    // A released arena is reused by the following resize
+    resizer.takeReady().?.exchange(&mv, &synthesis, &scene);
+    resizer.retire();
+    _ = resizer.release().?;
+    _ = resizer.release();
+    const again = (try resizer.begin(current, .{ .width = 1280, .height = 720 })).?;
+    _ = try again.allocate(&dispatch, &requests, .{});
+    try std.testing.expect(again.reused_arena);
+    try std.testing.expectEqual(@as(u32, 1), test_stubs.allocations);
+}
+
+test "recordHistoryBlit scales into the history image" {
+    const dispatch = vk.DeviceDispatch{
+        .device = @ptrFromInt(0x1000),
+        .vkCmdBlitImage = stubBlit,
+    };
+    stub_blits = 0;
+    const src = FrameImage{ .image = @ptrFromInt(0x10), .view = @ptrFromInt(0x11), .width = 1920, .height = 1080 };
+    const dst = FrameImage{ .image = @ptrFromInt(0x20), .view = @ptrFromInt(0x21), .width = 1280, .height = 720 };
+    recordHistoryBlit(&dispatch, @ptrFromInt(0x30), src, dst);
+    try std.testing.expectEqual(@as(usize, 1), stub_blits);
+    try std.testing.expectEqual([2]i32{ 1280, 720 }, stub_blit_extent);
+}
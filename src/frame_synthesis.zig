@@ -3,6 +3,25 @@
 //! Generates intermediate frames using motion vectors.
 //! Performance mode: Simple forward warp with linear blend.
 //! Quality mode: Bidirectional warp with confidence weighting (future).
+//! Extrapolation: Forward warp of the latest real frame past t, so the
+//! generated frame does not wait for the next real frame.
+//! With a ForwardSplat (forward_splat.zig) the forward warp is a
+//! depth-ordered scatter instead of a gather, and with a PullPushFill
+//! (hole_fill.zig) quality mode fills holes from a mip pyramid.
+//! With a FormatPipelineCache (output_format.zig) frames are written in
+//! the swapchain's format class, HDR10 and scRGB included.
+//! Full-frame barriers follow the pass graph of synthesis_graph.zig, which
+//! also lets transients share memory (transient_aliases).
+//! With an OutputRing (output_ring.zig) each batch writes the oldest of
+//! several target sets, so frames still being presented are not overwritten.
+//! With a ReplayCache (synthesis_replay.zig) each batch is recorded once
+//! into a secondary command buffer and replayed on later frames; the
+//! values that change per frame reach the passes through a constants
+//! buffer updated ahead of each batch (synthesis_constants.zig).
+//! Bindings reach the passes through descriptor sets, push descriptors or a
+//! descriptor buffer (synthesis_descriptors.zig).
+//! With a GpuTimer (gpu_timing.zig) every warp, blend and hole fill pass is
+//! bracketed by timestamps per batch slot.
 //!
 //! The synthesized frame is inserted between real frames to double
 //! the effective frame rate.
@@ -10,6 +29,21 @@
 const std = @import("std");
 const vk = @import("vulkan.zig");
 const motion_vectors = @import("motion_vectors.zig");
+const tile_classify = @import("tile_classify.zig");
+const forward_splat = @import("forward_splat.zig");
+const shader_variants = @import("shader_variants.zig");
+const hole_fill = @import("hole_fill.zig");
+const output_format = @import("output_format.zig");
+const synthesis_graph = @import("synthesis_graph.zig");
+const output_ring = @import("output_ring.zig");
+const mv_ring = @import("mv_ring.zig");
+const synthesis_replay = @import("synthesis_replay.zig");
+const synthesis_descriptors = @import("synthesis_descriptors.zig");
+const gpu_timing = @import("gpu_timing.zig");
+const synthesis_constants = @import("synthesis_constants.zig");
+const test_stubs = @import("test_stubs.zig");
+
+const SlotBinding = synthesis_descriptors.SlotBinding;
 
 // =============================================================================
 // Types
@@ -25,6 +59,34 @@ pub const QualityMode = enum {
     quality,
 };
 
+/// Maximum generated frames per real frame (4x multi-frame generation)
+pub const max_batch_frames: u32 = 3;
+
+/// GPU-written indirect dispatch arguments that gate every synthesis pass
+/// (see scene_change.zig); a zero group count skips synthesis
+pub const DispatchGate = struct {
+    buffer: vk.VkBuffer,
+    offset: vk.VkDeviceSize,
+};
+
+/// Output target for one generated frame of a batch. Memory may be a
+/// block shared with other images (memory_arena.zig).
+pub const OutputTarget = struct {
+    image: ?vk.VkImage = null,
+    view: ?vk.VkImageView = null,
+    memory: ?vk.VkDeviceMemory = null,
+    /// Set of every pass shader with this target bound as the output
+    /// and the slot's constants blocks (synthesis_descriptors.writeSet)
+    descriptor_sets: PassSets = .initFill(null),
+    /// Same bindings with the input frames of history slot parity 1
+    /// (null = the pass's set is rewritten by the caller every frame,
+    /// which rules out replay)
+    alternate_descriptor_sets: PassSets = .initFill(null),
+    /// Created with VK_SHARING_MODE_CONCURRENT: pushFrameAsync does not
+    /// transfer its ownership
+    concurrent: bool = false,
+};
+
 /// Frame synthesis context
 pub const FrameSynthesisContext = struct {
     device: ?vk.VkDevice,
@@ -32,19 +94,38 @@ pub const FrameSynthesisContext = struct {
 
     // Compute pipelines (optional until created)
     warp_pipeline: ?vk.VkPipeline = null,
-    warp_pipeline_layout: ?vk.VkPipelineLayout = null,
     blend_pipeline: ?vk.VkPipeline = null,
-    blend_pipeline_layout: ?vk.VkPipelineLayout = null,
+    extrapolate_pipeline: ?vk.VkPipeline = null,
+    // Full-frame tile_copy.comp, the passthrough of gated batches
+    passthrough_pipeline: ?vk.VkPipeline = null,
+    // One layout per shader (createDescriptorSetLayout), shared by its
+    // full-frame and tiled pipelines
+    pipeline_layouts: PassLayouts = .initFill(null),
 
-    // Descriptor resources
+    // Descriptor resources. With push descriptors or a descriptor buffer
+    // the output targets' descriptor sets are unused.
+    descriptors: synthesis_descriptors.Descriptors = .classic,
+    // Timeline value the submission of the next batch signals once done.
+    // Required with a descriptor buffer, whose region groups are only
+    // rewritten after their last batch's value; a batch recorded earlier
+    // fails with error.DescriptorsBusy (DescriptorBuffer.writeBatch).
+    batch_release: ?mv_ring.TimelineValue = null,
     descriptor_pool: ?vk.VkDescriptorPool = null,
-    descriptor_set_layout: ?vk.VkDescriptorSetLayout = null,
-    descriptor_set: ?vk.VkDescriptorSet = null,
+    descriptor_sets: PassSets = .initFill(null),
+    alternate_descriptor_sets: PassSets = .initFill(null),
 
     // Output image
     output_image: ?vk.VkImage = null,
     output_view: ?vk.VkImageView = null,
     output_memory: ?vk.VkDeviceMemory = null,
+    output_concurrent: bool = false,
+
+    // Output targets for batch slots 1.. (multi-frame generation)
+    extra_outputs: [max_batch_frames - 1]OutputTarget = [_]OutputTarget{.{}} ** (max_batch_frames - 1),
+
+    // Ring of output target sets replacing the targets above (null or not
+    // ready = single set). Advanced by acquireOutputs once per batch.
+    output_ring: ?output_ring.OutputRing = null,
 
     // Scratch buffers for warping
     warp_scratch: ?vk.VkImage = null,
@@ -54,10 +135,65 @@ pub const FrameSynthesisContext = struct {
     // Quality mode resources (bidirectional warp + confidence blend)
     quality_pipeline: ?QualityPipeline = null,
 
+    // Indirect arguments for the current frame's passes (null = direct dispatch)
+    dispatch_gate: ?DispatchGate = null,
+    // Same gate over the 16x16 tile grid for the tile classifier and the
+    // full-resolution pull-push passes
+    tile_gate: ?DispatchGate = null,
+    // Inverse of the gate over the tile grid: non-zero only when synthesis
+    // is skipped, then every output slot gets the current frame
+    passthrough_gate: ?DispatchGate = null,
+
+    // History slot parity of the current frame: 1 selects the targets'
+    // alternate descriptor sets
+    history_slot: u32 = 0,
+
+    // Recorded batches replayed through secondary command buffers (null =
+    // record every frame). Used by replayBatch.
+    replay: ?synthesis_replay.ReplayCache = null,
+    // Resource generation batches are recorded against (frame_resize.zig)
+    replay_generation: u32 = 0,
+
+    // Per-frame pass values and gate copies (setConstantsBuffer). Passes
+    // are not recorded without it.
+    constants: ?synthesis_constants.ConstantsBuffer = null,
+
+    // Timestamps around every pass (null = untimed). Owned by the caller,
+    // which must have begun the timer's frame before recording. Timed
+    // batches are never replayed.
+    timer: ?*const gpu_timing.GpuTimer = null,
+
+    // Tile classification (null or inactive = full-frame passes)
+    tile_classifier: ?tile_classify.TileClassifier = null,
+
+    // Depth-ordered forward splat replacing the forward warp (null or
+    // inactive = gather warp). Splatting is full-frame, so it bypasses
+    // tile classification.
+    forward_splat: ?forward_splat.ForwardSplat = null,
+
+    // Pull-push hole fill replacing occlusion fill in quality mode (null or
+    // inactive = occlusion_fill.comp). The pyramid spans the frame, so it
+    // bypasses tile classification as well.
+    pull_push: ?hole_fill.PullPushFill = null,
+
+    // Per-format pipelines (null = caller-created rgba8 pipelines only).
+    // Output targets and warp scratch must be created in
+    // output_key.output.storageFormat().
+    format_pipelines: ?output_format.FormatPipelineCache = null,
+    output_key: output_format.FormatKey = .{},
+
+    // Transients sharing memory (null = each has its own). The plan must
+    // be made for the mode, splatting and pull-push recorded with;
+    // synthesizeBatch fails with error.AliasingMismatch otherwise.
+    transient_aliases: ?synthesis_graph.AliasMap = null,
+
     // Configuration
     width: u32,
     height: u32,
     mode: QualityMode,
+    // Workgroup shape the full-frame pipelines were specialized with
+    // (shader_variants.zig). Tiled pipelines are always 16x16.
+    workgroup: shader_variants.WorkgroupShape = .{},
 
     // Frame timing for interpolation factor
     interpolation_factor: f32,
@@ -66,6 +202,13 @@ pub const FrameSynthesisContext = struct {
     cost_scale: f32 = 0.004, // 1/255 default
     min_confidence: f32 = 0.1,
     occlusion_threshold: f32 = 128.0,
+    fill_radius: f32 = 2.0,
+    // Blend shaders read the per-tile confidence texture written by
+    // scene_stats.comp (tile_confidence_view, which must also be bound in
+    // every classic descriptor set). Ignored without the view.
+    tile_confidence: bool = false,
+    // The image scene_stats.comp writes at binding 7 of the readback sets
+    tile_confidence_view: ?vk.VkImageView = null,
 
     // Dispatch table
     dispatch: ?*const vk.DeviceDispatch,
@@ -90,13 +233,69 @@ pub const FrameSynthesisContext = struct {
         };
     }
 
+    /// Switch to the pipelines of a swapchain format, creating them on first
+    /// use. Before any pipeline exists the format is only stored, and
+    /// createPipelines builds for it. With caller-created pipelines only
+    /// 8-bit SDR is supported.
+    pub fn setSwapchainFormat(self: *FrameSynthesisContext, format: u32, color_space: u32) !void {
+        const key = output_format.FormatKey.fromSwapchain(format, color_space) orelse return error.UnsupportedFormat;
+        if (self.format_pipelines) |*cache| {
+            self.applyPipelines(try cache.get(key));
+        } else if (key.output != self.output_key.output and self.hasPipelines()) {
+            // Caller-created pipelines write 8-bit SDR as stored (sRGB
+            // swapchains blend encoded values until createPipelines)
+            return error.UnsupportedFormat;
+        }
+        self.output_key = key;
+    }
+
+    /// Check if any synthesis pipeline has been set or created
+    fn hasPipelines(self: *const FrameSynthesisContext) bool {
+        if (self.warp_pipeline != null or self.blend_pipeline != null or self.extrapolate_pipeline != null) return true;
+        const qp = self.quality_pipeline orelse return false;
+        return qp.backward_warp_pipeline != null or qp.confidence_blend_pipeline != null or qp.occlusion_fill_pipeline != null;
+    }
+
+    /// Create the pipelines of every pass with a layout, for the current
+    /// swapchain format, through a new FormatPipelineCache (other formats
+    /// are created by setSwapchainFormat on first use). Replaces existing
+    /// format pipelines and drops recorded batches; none may be pending.
+    pub fn createPipelines(
+        self: *FrameSynthesisContext,
+        layouts: output_format.PipelineLayouts,
+        source: output_format.SpirvSource,
+        pipeline_cache: ?vk.VkPipelineCache,
+    ) !void {
+        var cache = output_format.FormatPipelineCache.init(layouts, .{ .workgroup = self.workgroup }, source, self.dispatch);
+        cache.pipeline_cache = pipeline_cache;
+        errdefer cache.deinit();
+        _ = try cache.get(self.output_key);
+
+        if (self.format_pipelines) |*old| old.deinit();
+        self.format_pipelines = cache;
+        self.pipeline_layouts = layouts.passes;
+        // Already created: get only looks the entry up
+        self.applyPipelines(try self.format_pipelines.?.get(self.output_key));
+        self.invalidateReplay();
+    }
+
+    /// Bind through push descriptors instead of caller-owned descriptor
+    /// sets. Set layouts and pipelines must be created afterwards, for the
+    /// push model; fails once pipelines exist.
+    pub fn usePushDescriptors(self: *FrameSynthesisContext, push: synthesis_descriptors.PushDescriptors) !void {
+        const d = self.dispatch orelse return error.NotInitialized;
+        if (!d.hasPushDescriptors()) return vk.VulkanError.ExtensionNotPresent;
+        if (self.format_pipelines != null or self.hasPipelines()) return error.PipelinesCreated;
+        self.descriptors = .{ .push = push };
+        self.invalidateReplay();
+    }
+
     /// Set interpolation factor (0.0 = frame N-1, 1.0 = frame N)
     pub fn setInterpolationFactor(self: *FrameSynthesisContext, factor: f32) void {
         self.interpolation_factor = std.math.clamp(factor, 0.0, 1.0);
     }
 
-    /// Synthesize an intermediate frame
-    /// Performance mode: Linear blend with forward warp
+    /// Synthesize an intermediate frame at the current interpolation factor
     pub fn synthesize(
         self: *FrameSynthesisContext,
         cmd: vk.VkCommandBuffer,
@@ -104,42 +303,788 @@ pub const FrameSynthesisContext = struct {
         curr_frame: vk.VkImageView,
         mv_buffer: *const motion_vectors.MotionVectorBuffer,
     ) !vk.VkImageView {
-        _ = cmd;
-        _ = prev_frame;
-        _ = curr_frame;
-        _ = mv_buffer;
+        const factors = [_]f32{self.interpolation_factor};
+        var views: [1]vk.VkImageView = undefined;
+        _ = try self.synthesizeBatch(cmd, prev_frame, curr_frame, mv_buffer, &factors, &views);
+        return views[0];
+    }
 
-        // In full implementation:
-        // 1. Forward warp prev_frame using motion vectors * (1 - factor)
-        // 2. Forward warp curr_frame using motion vectors * (-factor)
-        // 3. Linear blend the two warped images
+    /// Synthesize one intermediate frame per factor into output slots
+    /// 0..factors.len, all recorded into `cmd`. The motion vectors are
+    /// estimated once by the caller and shared by every factor.
+    ///
+    /// Performance: forward warp -> linear blend
+    /// Balanced: forward + backward warp -> confidence blend
+    /// Quality: balanced -> occlusion fill
+    ///
+    /// With an active tile classifier the motion field is classified once
+    /// for the batch, and each slot copies static tiles, runs forward warp
+    /// + linear blend on simple tiles and the mode's chain on fill tiles.
+    /// Otherwise barriers between passes and slots follow the pass graph
+    /// (synthesis_graph.zig).
+    pub fn synthesizeBatch(
+        self: *FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        prev_frame: vk.VkImageView,
+        curr_frame: vk.VkImageView,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        factors: []const f32,
+        views_out: []vk.VkImageView,
+    ) !usize {
+        if (factors.len > max_batch_frames or views_out.len < factors.len) return error.BatchTooLarge;
+        return self.recordBatch(cmd, cmd, .interpolate, prev_frame, curr_frame, mv_buffer, factors, views_out);
+    }
+
+    /// Synthesize a frame past the current one (t + factor) from the current
+    /// frame and the last motion field. Disoccluded pixels hold the current frame.
+    pub fn extrapolate(
+        self: *FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        curr_frame: vk.VkImageView,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        factor: f32,
+    ) !vk.VkImageView {
+        const factors = [_]f32{factor};
+        var views: [1]vk.VkImageView = undefined;
+        _ = try self.extrapolateBatch(cmd, curr_frame, mv_buffer, &factors, &views);
+        return views[0];
+    }
+
+    /// Extrapolate one frame per factor into output slots 0..factors.len
+    pub fn extrapolateBatch(
+        self: *FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        curr_frame: vk.VkImageView,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        factors: []const f32,
+        views_out: []vk.VkImageView,
+    ) !usize {
+        if (factors.len > max_batch_frames or views_out.len < factors.len) return error.BatchTooLarge;
+        // Extrapolation reads the current frame only
+        return self.recordBatch(cmd, cmd, .extrapolate, curr_frame, curr_frame, mv_buffer, factors, views_out);
+    }
+
+    /// Record a batch through the replay cache: the first batch with a key
+    /// records a secondary command buffer, later ones replay it with one
+    /// vkCmdExecuteCommands. Either way the batch's constants are updated
+    /// in `cmd` first. Without a cache, once it is full, or with a timer
+    /// (timestamps go to the frame's query range) the batch is recorded
+    /// into `cmd` directly. prev_frame is ignored when extrapolating.
+    pub fn replayBatch(
+        self: *FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        kind: synthesis_replay.Kind,
+        prev_frame: vk.VkImageView,
+        curr_frame: vk.VkImageView,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        factors: []const f32,
+        views_out: []vk.VkImageView,
+    ) !usize {
+        if (factors.len > max_batch_frames or views_out.len < factors.len) return error.BatchTooLarge;
+        // Extrapolation reads the current frame only, so the previous one
+        // must not split its replay keys
+        const prev = if (kind == .extrapolate) curr_frame else prev_frame;
+        const cache = if (self.replay) |*r| r else return self.recordBatch(cmd, cmd, kind, prev, curr_frame, mv_buffer, factors, views_out);
+        if (self.timer != null) return self.recordBatch(cmd, cmd, kind, prev, curr_frame, mv_buffer, factors, views_out);
+
+        const key = self.replayKey(kind, prev, curr_frame, mv_buffer, factors);
+        if (cache.find(key)) |recorded| {
+            for (0..factors.len) |slot| {
+                views_out[slot] = self.getOutputTarget(@intCast(slot)).view orelse return error.NotInitialized;
+            }
+            // Descriptor buffer contents are written per batch on the CPU
+            if (self.descriptors == .buffer) {
+                var bindings: [max_batch_frames]SlotBinding = undefined;
+                try self.prepareBindings(null, prev, curr_frame, mv_buffer, bindings[0..factors.len]);
+            }
+            self.recordConstants(cmd, kind, mv_buffer, factors);
+            cache.execute(cmd, recorded);
+            return factors.len;
+        }
+
+        const secondary = try cache.begin() orelse return self.recordBatch(cmd, cmd, kind, prev, curr_frame, mv_buffer, factors, views_out);
+        const written = self.recordBatch(cmd, secondary, kind, prev, curr_frame, mv_buffer, factors, views_out) catch |err| {
+            cache.cancel();
+            return err;
+        };
+        cache.execute(cmd, try cache.end(key));
+        return written;
+    }
+
+    /// Read the per-frame values of the passes and the gates from a
+    /// caller-owned constants buffer (synthesis_constants.zig), which
+    /// classic descriptor sets bind at binding 9. Passes are not recorded
+    /// without one. Drops recorded batches; none may be pending.
+    pub fn setConstantsBuffer(self: *FrameSynthesisContext, buffer: vk.VkBuffer) !void {
+        const d = self.dispatch orelse return error.NotInitialized;
+        self.constants = try synthesis_constants.ConstantsBuffer.init(d, buffer);
+        self.invalidateReplay();
+    }
+
+    /// Drop every recorded batch. Required after changing pipelines,
+    /// descriptor set contents or pass resources while replaying; no
+    /// replayed batch may still be pending.
+    pub fn invalidateReplay(self: *FrameSynthesisContext) void {
+        if (self.replay) |*cache| cache.invalidate();
+    }
+
+    /// Check if the forward warp runs as a depth-ordered splat
+    pub fn isSplatting(self: *const FrameSynthesisContext) bool {
+        const splat = self.forward_splat orelse return false;
+        return splat.isActive(self.history_slot);
+    }
 
-        // For performance mode (simple implementation):
-        // - Single forward warp of prev_frame
-        // - Alpha blend with curr_frame based on interpolation factor
+    /// Check if batches are classified into tile lists (unless splatting or
+    /// pull-push runs full-frame)
+    pub fn isTiled(self: *const FrameSynthesisContext) bool {
+        const classifier = self.tile_classifier orelse return false;
+        return classifier.isActive(self.mode);
+    }
 
-        return self.output_view;
+    /// Check if the blends apply the tile confidence fallback
+    pub fn isTileConfidence(self: *const FrameSynthesisContext) bool {
+        return self.tile_confidence and self.tile_confidence_view != null;
+    }
+
+    /// Check if quality mode fills holes with the pull-push pyramid
+    pub fn isPullPush(self: *const FrameSynthesisContext, slot: u32) bool {
+        if (self.mode != .quality) return false;
+        const fill = self.pull_push orelse return false;
+        return fill.isActive(slot);
+    }
+
+    /// Check if batches rotate through the output ring
+    pub fn isOutputRing(self: *const FrameSynthesisContext) bool {
+        const ring = self.output_ring orelse return false;
+        return ring.isReady();
+    }
+
+    /// Move to the oldest ring set for the next batch. Returns null without
+    /// a ring; otherwise the timeline values the synthesis submission must
+    /// wait on and the consumer of the frames must signal.
+    pub fn acquireOutputs(self: *FrameSynthesisContext) !?output_ring.Acquired {
+        if (!self.isOutputRing()) return null;
+        return try self.output_ring.?.acquire();
+    }
+
+    /// Give back a set acquired for a batch that failed to record
+    pub fn cancelOutputs(self: *FrameSynthesisContext, acquired: output_ring.Acquired) void {
+        if (self.output_ring) |*ring| ring.cancel(acquired);
+    }
+
+    /// Set the output target for a batch slot (slot 0 is the primary output).
+    /// Drops recorded batches, which bind the previous target.
+    pub fn setOutputTarget(self: *FrameSynthesisContext, slot: u32, target: OutputTarget) !void {
+        if (slot >= max_batch_frames) return error.BatchTooLarge;
+        if (slot == 0) {
+            self.output_image = target.image;
+            self.output_view = target.view;
+            self.output_memory = target.memory;
+            self.descriptor_sets = target.descriptor_sets;
+            self.alternate_descriptor_sets = target.alternate_descriptor_sets;
+            self.output_concurrent = target.concurrent;
+        } else {
+            self.extra_outputs[slot - 1] = target;
+        }
+        self.invalidateReplay();
+    }
+
+    /// Get the output target for a batch slot (of the current ring set)
+    pub fn getOutputTarget(self: *const FrameSynthesisContext, slot: u32) OutputTarget {
+        if (self.isOutputRing()) return self.output_ring.?.target(slot);
+        if (slot == 0) {
+            return .{
+                .image = self.output_image,
+                .view = self.output_view,
+                .memory = self.output_memory,
+                .descriptor_sets = self.descriptor_sets,
+                .alternate_descriptor_sets = self.alternate_descriptor_sets,
+                .concurrent = self.output_concurrent,
+            };
+        }
+        if (slot >= max_batch_frames) return .{};
+        return self.extra_outputs[slot - 1];
     }
 
     /// Get the output image view
     pub fn getOutputView(self: *const FrameSynthesisContext) ?vk.VkImageView {
-        return self.output_view;
+        return self.getOutputTarget(0).view;
     }
 
     /// Get the output image
     pub fn getOutputImage(self: *const FrameSynthesisContext) ?vk.VkImage {
-        return self.output_image;
+        return self.getOutputTarget(0).image;
     }
 
     /// Cleanup resources
     pub fn deinit(self: *FrameSynthesisContext) void {
-        _ = self;
-        // Note: Caller is responsible for destroying Vulkan resources
+        // Cached format pipelines are ours; the caller is responsible for
+        // destroying every other Vulkan resource
+        if (self.format_pipelines) |*cache| cache.deinit();
+        if (self.output_ring) |*ring| ring.deinit();
+        if (self.replay) |*cache| cache.deinit();
+    }
+
+    // ==========================================================================
+    // Private Methods
+    // ==========================================================================
+
+    /// Record a batch of either kind: the constants update into `cmd`, the
+    /// passes into `passes` (`cmd` itself or a secondary command buffer)
+    fn recordBatch(
+        self: *FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        passes: vk.VkCommandBuffer,
+        kind: synthesis_replay.Kind,
+        prev_frame: vk.VkImageView,
+        curr_frame: vk.VkImageView,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        factors: []const f32,
+        views_out: []vk.VkImageView,
+    ) !usize {
+        for (0..factors.len) |slot| {
+            views_out[slot] = self.getOutputTarget(@intCast(slot)).view orelse return error.NotInitialized;
+        }
+        var bindings: [max_batch_frames]SlotBinding = undefined;
+        try self.prepareBindings(passes, prev_frame, curr_frame, mv_buffer, bindings[0..factors.len]);
+        switch (kind) {
+            .interpolate => try self.recordInterpolationBatch(cmd, passes, mv_buffer, factors, bindings[0..factors.len]),
+            .extrapolate => {
+                self.recordConstants(cmd, .extrapolate, mv_buffer, factors);
+                for (bindings[0..factors.len], 0..) |binding, slot| {
+                    self.passBegin(passes, .forward_warp, @intCast(slot));
+                    self.recordPass(passes, binding, .extrapolate_warp, self.extrapolate_pipeline);
+                    self.passEnd(passes, .forward_warp, @intCast(slot));
+                    self.recordPassthrough(passes, binding);
+                }
+            },
+        }
+        return factors.len;
+    }
+
+    /// Record the constants update of an interpolation batch into `cmd` and
+    /// its passes into `passes`
+    fn recordInterpolationBatch(
+        self: *FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        passes: vk.VkCommandBuffer,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        factors: []const f32,
+        bindings: []const SlotBinding,
+    ) !void {
+        const splatting = self.isSplatting();
+        const cost_enabled = mv_buffer.cost_view != null;
+        const full_frame = splatting or self.isPullPush(0);
+        var graphs: [max_batch_frames]synthesis_graph.Graph = undefined;
+        for (0..factors.len) |slot| {
+            graphs[slot] = .init(.{ .mode = self.mode, .splatting = splatting, .pull_push = self.isPullPush(@intCast(slot)) });
+            if (self.transient_aliases) |aliases| {
+                if (!aliases.fits(&graphs[slot])) return error.AliasingMismatch;
+            }
+        }
+        self.recordConstants(cmd, .interpolate, mv_buffer, factors);
+
+        var tracker = synthesis_graph.BarrierTracker.init(.{ .mode = self.mode, .splatting = splatting }, self.transient_aliases);
+        const tiled = if (full_frame) false else if (self.tile_classifier) |*classifier| classifier.record(
+            passes,
+            self.mode,
+            self.width,
+            self.height,
+            mv_buffer,
+            self.occlusion_threshold,
+            self.gate(.tiles),
+        ) else false;
+        if (tiled and factors.len > 0) self.recordGraphStep(passes, tracker.enter(&graphs[0]), false);
+
+        for (factors, bindings, 0..) |factor, binding, slot| {
+            if (tiled) {
+                // Slots share the warp scratch images
+                if (slot > 0) self.recordComputeBarrier(passes);
+                self.recordTiledInterpolation(passes, binding, @intCast(slot), &self.tile_classifier.?);
+            } else {
+                const f = std.math.clamp(factor, 0.0, 1.0);
+                self.recordInterpolation(passes, binding, @intCast(slot), f, mv_buffer, &graphs[slot], &tracker, cost_enabled);
+            }
+            self.recordPassthrough(passes, binding);
+        }
+    }
+
+    /// Stage the constants of every slot of a batch and record their update,
+    /// with the copies of the gates, into `cmd`. No-op without a constants
+    /// buffer.
+    fn recordConstants(
+        self: *const FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        kind: synthesis_replay.Kind,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        factors: []const f32,
+    ) void {
+        const constants = self.constants orelse return;
+        const mv_scale = mv_buffer.mvScale();
+        var blocks = synthesis_constants.Blocks{};
+        for (factors, 0..) |factor, i| {
+            const slot: u32 = @intCast(i);
+            const f = std.math.clamp(factor, 0.0, 1.0);
+            switch (kind) {
+                .interpolate => {
+                    const warp = WarpConstants{
+                        .mv_scale_x = mv_scale,
+                        .mv_scale_y = mv_scale,
+                        .interpolation = f,
+                        .direction = 1.0,
+                    };
+                    blocks.set(slot, .forward_warp, warp);
+                    // backward_warp.comp applies (1 - interpolation) itself
+                    blocks.set(slot, .backward_warp, backwardWarp(warp, mv_buffer));
+                    blocks.set(slot, .linear_blend, BlendConstants{
+                        .weight = f,
+                        .tile_confidence = self.tileConfidenceFlag(),
+                    });
+                    blocks.set(slot, .confidence_blend, ConfidenceBlendConstants{
+                        .interpolation = f,
+                        .cost_scale = self.cost_scale,
+                        .min_confidence = self.min_confidence,
+                        .tile_confidence = self.tileConfidenceFlag(),
+                    });
+                    blocks.set(slot, .occlusion_fill, OcclusionFillConstants{
+                        .occlusion_threshold = self.occlusion_threshold,
+                        .fill_radius = self.fill_radius,
+                        .interpolation = f,
+                    });
+                    // Static tiles; the full-frame passthrough ignores it
+                    blocks.set(slot, .tile_copy, tile_classify.TileCopyConstants{ .interpolation = f });
+                },
+                .extrapolate => blocks.set(slot, .extrapolate_warp, ExtrapolateConstants{
+                    .mv_scale_x = mv_scale,
+                    .mv_scale_y = mv_scale,
+                    .extrapolation = f,
+                    // Without a cost map only the motion divergence test applies
+                    .occlusion_threshold = if (mv_buffer.cost_view != null) self.occlusion_threshold else std.math.floatMax(f32),
+                }),
+            }
+        }
+        var gates = synthesis_constants.Gates.initFill(null);
+        gates.set(.synthesis, self.dispatch_gate);
+        gates.set(.tiles, self.tile_gate);
+        gates.set(.passthrough, self.passthrough_gate);
+        constants.record(cmd, &blocks, @intCast(factors.len), gates);
+    }
+
+    /// Replay key of a batch in the current state: what the recorded
+    /// commands bind and push. Values in the constants buffer are left out.
+    fn replayKey(
+        self: *const FrameSynthesisContext,
+        kind: synthesis_replay.Kind,
+        prev_frame: vk.VkImageView,
+        curr_frame: vk.VkImageView,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        factors: []const f32,
+    ) synthesis_replay.Key {
+        var key = synthesis_replay.Key{
+            .kind = kind,
+            .count = @intCast(factors.len),
+            .output_set = if (self.isOutputRing()) self.output_ring.?.current orelse 0 else 0,
+            .history_slot = self.history_slot,
+            .generation = self.replay_generation,
+            .mode = self.mode,
+            .format = @intCast(self.output_key.index()),
+            .splatting = self.isSplatting(),
+        };
+        for (std.enums.values(synthesis_constants.Gate)) |which| {
+            if (self.gate(which) != null) key.gates |= @as(u8, 1) << @intFromEnum(which);
+        }
+        switch (self.descriptors) {
+            .classic => {},
+            // Pushed bindings are recorded by view
+            .push => key.views = .{ prev_frame, curr_frame, mv_buffer.forward_view, mv_buffer.backward_view },
+            .buffer => |*buffer| key.descriptor_group = buffer.nextGroup(),
+        }
+        for (0..factors.len) |slot| {
+            if (self.isPullPush(@intCast(slot))) key.pull_push |= @as(u8, 1) << @intCast(slot);
+        }
+        // The tile classifier, splat and pull-push passes push their own
+        if (kind == .interpolate and (key.splatting or key.pull_push != 0 or self.isTiled())) {
+            key.pushed = .{
+                .mv_scale = mv_buffer.mvScale(),
+                .occlusion_threshold = self.occlusion_threshold,
+                .cost = mv_buffer.cost_view != null,
+            };
+            if (key.splatting) {
+                for (factors, 0..) |factor, slot| key.pushed.factors[slot] = std.math.clamp(factor, 0.0, 1.0);
+            }
+        }
+        return key;
+    }
+
+    /// Bindings of every slot of a batch. With a descriptor buffer the
+    /// batch's descriptors are written, and the buffer bound to `cmd` when
+    /// recording, once batch_release allows reusing its region group. Slot
+    /// views must have been validated.
+    fn prepareBindings(
+        self: *FrameSynthesisContext,
+        cmd: ?vk.VkCommandBuffer,
+        prev_frame: vk.VkImageView,
+        curr_frame: vk.VkImageView,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        out: []SlotBinding,
+    ) !void {
+        var images: [max_batch_frames]synthesis_descriptors.PassImages = undefined;
+        for (images[0..out.len], 0..) |*slot_images, slot| {
+            slot_images.* = self.passImages(@intCast(slot), prev_frame, curr_frame, mv_buffer);
+        }
+
+        switch (self.descriptors) {
+            .classic => for (out, 0..) |*binding, slot| {
+                binding.* = .{ .classic = self.slotDescriptorSets(@intCast(slot)) };
+            },
+            .push => for (out, images[0..out.len]) |*binding, slot_images| {
+                binding.* = .{ .push = slot_images };
+            },
+            .buffer => |*buffer| {
+                const release = self.batch_release orelse return error.NotInitialized;
+                const group = try buffer.writeBatch(images[0..out.len], release);
+                if (cmd) |c| buffer.bind(c);
+                for (out, 0..) |*binding, slot| {
+                    binding.* = .{ .buffer = synthesis_descriptors.DescriptorBuffer.region(group, @intCast(slot)) };
+                }
+            },
+        }
+    }
+
+    /// Images the passes of a batch slot bind. Slot views must have been
+    /// validated.
+    fn passImages(
+        self: *const FrameSynthesisContext,
+        slot: u32,
+        prev_frame: vk.VkImageView,
+        curr_frame: vk.VkImageView,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+    ) synthesis_descriptors.PassImages {
+        const qp = self.quality_pipeline orelse QualityPipeline{};
+        const tile_lists = if (self.tile_classifier) |classifier| classifier.tile_buffer else null;
+        return .{
+            .prev = prev_frame,
+            .curr = curr_frame,
+            .motion = mv_buffer.forward_view,
+            .backward_motion = mv_buffer.backward_view,
+            .cost = mv_buffer.cost_view,
+            .backward_cost = if (mv_buffer.backward_view != null) mv_buffer.backward_cost_view else null,
+            .tile_confidence = self.tile_confidence_view,
+            .fill_cost = if (self.isSplatting()) self.forward_splat.?.cost_view else null,
+            .warp_scratch = self.warp_scratch_view,
+            .backward_warped = qp.backward_warped_view,
+            // Balanced blends straight into the output
+            .filled_output = if (self.mode == .quality) qp.filled_output_view else null,
+            .output = self.getOutputTarget(slot).view.?,
+            .tile_lists = tile_lists,
+            .tile_lists_size = tile_classify.tileListBufferSize(self.width, self.height),
+            .constants = if (self.constants) |constants| constants.buffer else null,
+            .slot = slot,
+        };
+    }
+
+    /// Descriptor sets of a batch slot for the current history slot
+    fn slotDescriptorSets(self: *const FrameSynthesisContext, slot: u32) PassSets {
+        const target = self.getOutputTarget(slot);
+        var sets = target.descriptor_sets;
+        if (self.history_slot == 1) {
+            for (std.enums.values(PassShader)) |shader| {
+                if (target.alternate_descriptor_sets.get(shader)) |set| sets.set(shader, set);
+            }
+        }
+        return sets;
+    }
+
+    /// Point every pass at a format's pipelines. Passes without a pipeline
+    /// for the format (no layout given to the cache) go inactive.
+    fn applyPipelines(self: *FrameSynthesisContext, p: *const output_format.FormatPipelines) void {
+        self.warp_pipeline = p.warp;
+        self.blend_pipeline = p.blend;
+        self.extrapolate_pipeline = p.extrapolate;
+        self.passthrough_pipeline = p.passthrough;
+
+        var qp = self.quality_pipeline orelse QualityPipeline{};
+        qp.backward_warp_pipeline = p.backward_warp;
+        qp.confidence_blend_pipeline = p.confidence_blend;
+        qp.occlusion_fill_pipeline = p.occlusion_fill;
+        self.quality_pipeline = qp;
+
+        if (self.tile_classifier) |*classifier| classifier.pipelines = p.tiled;
+        if (self.forward_splat) |*splat| splat.resolve_pipeline = p.splat_resolve;
+        if (self.pull_push) |*fill| fill.push_pipeline = p.pullpush_push;
+    }
+
+    /// Record the interpolation passes for one factor into one output slot,
+    /// each preceded by the barrier and discards the graph requires
+    fn recordInterpolation(
+        self: *const FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        binding: SlotBinding,
+        slot: u32,
+        factor: f32,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        graph: *const synthesis_graph.Graph,
+        tracker: *synthesis_graph.BarrierTracker,
+        cost_enabled: bool,
+    ) void {
+        const qp = self.quality_pipeline orelse QualityPipeline{};
+
+        for (graph.slice(), 0..) |pass, i| {
+            self.recordGraphStep(cmd, tracker.step(graph, i), graph.config.splatting);
+            self.passBegin(cmd, passStage(pass), slot);
+            defer self.passEnd(cmd, passStage(pass), slot);
+            switch (pass) {
+                .forward_warp => self.recordPass(cmd, binding, .forward_warp, self.warp_pipeline),
+                .splat => {
+                    _ = self.forward_splat.?.record(cmd, self.history_slot, self.width, self.height, self.workgroup, mv_buffer.mvScale(), factor, cost_enabled, self.gate(.synthesis));
+                },
+                .backward_warp => self.recordPass(cmd, binding, .backward_warp, qp.backward_warp_pipeline),
+                .linear_blend => self.recordPass(cmd, binding, .linear_blend, self.blend_pipeline),
+                .confidence_blend => self.recordPass(cmd, binding, .confidence_blend, qp.confidence_blend_pipeline),
+                .occlusion_fill => self.recordPass(cmd, binding, .occlusion_fill, qp.occlusion_fill_pipeline),
+                .pull_push => {
+                    // 16x16 groups over the frame, like the tile gate
+                    _ = self.pull_push.?.record(cmd, slot, self.occlusion_threshold, cost_enabled, self.gate(.tiles));
+                },
+            }
+        }
+    }
+
+    /// Record the tiled passes for one output slot. Every pass dispatches
+    /// one workgroup per tile of its class list.
+    fn recordTiledInterpolation(
+        self: *const FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        binding: SlotBinding,
+        slot: u32,
+        classifier: *const tile_classify.TileClassifier,
+    ) void {
+        const t = classifier.pipelines;
+        const static_list = classifier.classArgs(.static) orelse return;
+        const simple_list = classifier.classArgs(.simple) orelse return;
+        const fill_list = classifier.classArgs(.fill) orelse return;
+
+        // Static tiles: straight copy
+        self.recordTiledPass(cmd, binding, .tile_copy, t.copy_pipeline, static_list);
+
+        // Warps for simple and fill tiles write disjoint scratch tiles
+        self.passBegin(cmd, .forward_warp, slot);
+        self.recordTiledPass(cmd, binding, .forward_warp, t.simple_warp_pipeline, simple_list);
+        self.recordTiledPass(cmd, binding, .forward_warp, t.fill_warp_pipeline, fill_list);
+        self.passEnd(cmd, .forward_warp, slot);
+        if (self.mode != .performance) {
+            self.passBegin(cmd, .backward_warp, slot);
+            self.recordTiledPass(cmd, binding, .backward_warp, t.fill_quality.backward_warp_pipeline, fill_list);
+            self.passEnd(cmd, .backward_warp, slot);
+        }
+        self.recordComputeBarrier(cmd);
+
+        // Both blends of the slot are timed as one pass
+        self.passBegin(cmd, .blend, slot);
+        self.recordTiledPass(cmd, binding, .linear_blend, t.simple_blend_pipeline, simple_list);
+
+        switch (self.mode) {
+            .performance => {
+                self.recordTiledPass(cmd, binding, .linear_blend, t.fill_blend_pipeline, fill_list);
+                self.passEnd(cmd, .blend, slot);
+            },
+            .balanced, .quality => {
+                self.recordTiledPass(cmd, binding, .confidence_blend, t.fill_quality.confidence_blend_pipeline, fill_list);
+                self.passEnd(cmd, .blend, slot);
+
+                if (self.mode == .quality) {
+                    self.recordComputeBarrier(cmd);
+                    self.passBegin(cmd, .occlusion_fill, slot);
+                    self.recordTiledPass(cmd, binding, .occlusion_fill, t.fill_quality.occlusion_fill_pipeline, fill_list);
+                    self.passEnd(cmd, .occlusion_fill, slot);
+                }
+            },
+        }
+    }
+
+    /// Backward warp constants. The backward field (bound with
+    /// bidirectional flow) points the other way than the forward field
+    /// bound in its place otherwise.
+    fn backwardWarp(warp: WarpConstants, mv_buffer: *const motion_vectors.MotionVectorBuffer) WarpConstants {
+        var backward = warp;
+        if (mv_buffer.backward_view != null) backward.direction = -1.0;
+        return backward;
+    }
+
+    /// Gate a pass dispatches from: its copy in the constants buffer, which
+    /// replayed batches read as well (null = ungated)
+    fn gate(self: *const FrameSynthesisContext, which: synthesis_constants.Gate) ?DispatchGate {
+        const source = switch (which) {
+            .synthesis => self.dispatch_gate,
+            .tiles => self.tile_gate,
+            .passthrough => self.passthrough_gate,
+        } orelse return null;
+        const constants = self.constants orelse return source;
+        return constants.gate(which);
+    }
+
+    fn passBegin(self: *const FrameSynthesisContext, cmd: vk.VkCommandBuffer, stage: gpu_timing.Stage, slot: u32) void {
+        if (self.timer) |timer| timer.beginPass(cmd, stage, slot);
+    }
+
+    fn passEnd(self: *const FrameSynthesisContext, cmd: vk.VkCommandBuffer, stage: gpu_timing.Stage, slot: u32) void {
+        if (self.timer) |timer| timer.endPass(cmd, stage, slot);
+    }
+
+    fn tileConfidenceFlag(self: *const FrameSynthesisContext) f32 {
+        return if (self.isTileConfidence()) 1.0 else 0.0;
+    }
+
+    /// Record one full-frame compute pass. No-op until pipelines, the
+    /// constants buffer and the dispatch table are available.
+    fn recordPass(
+        self: *const FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        binding: SlotBinding,
+        shader: PassShader,
+        pipeline: ?vk.VkPipeline,
+    ) void {
+        const d = self.bindPass(cmd, binding, shader, pipeline) orelse return;
+
+        // Gated dispatch: group counts come from the GPU (zero on scene change)
+        if (self.gate(.synthesis)) |gate_args| {
+            if (d.vkCmdDispatchIndirect) |dispatch_indirect| {
+                dispatch_indirect(cmd, gate_args.buffer, gate_args.offset);
+                return;
+            }
+        }
+        d.vkCmdDispatch.?(cmd, self.workgroup.groupsX(self.width), self.workgroup.groupsY(self.height), 1);
+    }
+
+    /// Record the passthrough of a gated slot: the current frame copied
+    /// into its output. The passthrough arguments are zero whenever the
+    /// slot's passes ran and vice versa, so the two never both write the
+    /// output and need no barrier between them.
+    fn recordPassthrough(self: *const FrameSynthesisContext, cmd: vk.VkCommandBuffer, binding: SlotBinding) void {
+        const gate_args = self.gate(.passthrough) orelse return;
+        const d = self.bindPass(cmd, binding, .tile_copy, self.passthrough_pipeline) orelse return;
+        const dispatch_indirect = d.vkCmdDispatchIndirect orelse return;
+        dispatch_indirect(cmd, gate_args.buffer, gate_args.offset);
+    }
+
+    /// Record one pass over the tiles of a class list
+    fn recordTiledPass(
+        self: *const FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        binding: SlotBinding,
+        shader: PassShader,
+        pipeline: ?vk.VkPipeline,
+        list: DispatchGate,
+    ) void {
+        const d = self.bindPass(cmd, binding, shader, pipeline) orelse return;
+        d.vkCmdDispatchIndirect.?(cmd, list.buffer, list.offset);
+    }
+
+    /// Bind pipeline and the shader's descriptor set of a pass, whose
+    /// constants are in the constants buffer. Returns null if the pass
+    /// cannot be recorded.
+    fn bindPass(
+        self: *const FrameSynthesisContext,
+        cmd: vk.VkCommandBuffer,
+        binding: SlotBinding,
+        shader: PassShader,
+        pipeline: ?vk.VkPipeline,
+    ) ?*const vk.DeviceDispatch {
+        const d = self.dispatch orelse return null;
+        if (!d.hasComputeRecording()) return null;
+        if (self.constants == null) return null;
+        const p = pipeline orelse return null;
+        const l = self.pipeline_layouts.get(shader) orelse return null;
+        if (binding == .classic and binding.classic.get(shader) == null) return null;
+
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, p);
+        switch (binding) {
+            .classic => |sets| if (d.vkCmdBindDescriptorSets) |bind_sets| {
+                const set = [_]vk.VkDescriptorSet{sets.get(shader).?};
+                bind_sets(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, l, 0, 1, &set, 0, null);
+            },
+            .push => |images| self.descriptors.push.record(d, cmd, l, shader, images),
+            .buffer => |region| self.descriptors.buffer.select(cmd, l, region, shader),
+        }
+        return d;
+    }
+
+    /// Record a graph step: a barrier (also covering the splat buffer clear
+    /// when splatting) with aliased images moved out of UNDEFINED
+    fn recordGraphStep(self: *const FrameSynthesisContext, cmd: vk.VkCommandBuffer, step: synthesis_graph.Step, splatting: bool) void {
+        if (!step.barrier and step.discards.count() == 0) return;
+        const d = self.dispatch orelse return;
+
+        var images: [std.meta.fields(synthesis_graph.Resource).len]vk.VkImageMemoryBarrier = undefined;
+        var count: usize = 0;
+        var it = step.discards.iterator();
+        while (it.next()) |resource| {
+            const image = self.transientImage(resource) orelse continue;
+            images[count] = .{ .dstAccessMask = vk.VK_ACCESS_SHADER_WRITE_BIT, .image = image };
+            count += 1;
+        }
+
+        const transfer_stage: vk.VkPipelineStageFlags = if (splatting) vk.VK_PIPELINE_STAGE_TRANSFER_BIT else 0;
+        const transfer_access: vk.VkAccessFlags = if (splatting) vk.VK_ACCESS_TRANSFER_WRITE_BIT else 0;
+        d.cmdImageBarriers(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | transfer_stage,
+            .{
+                .srcAccessMask = vk.VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = vk.VK_ACCESS_SHADER_READ_BIT | vk.VK_ACCESS_SHADER_WRITE_BIT | transfer_access,
+            },
+            images[0..count],
+        );
+    }
+
+    /// Image of a transient, if the context knows it
+    fn transientImage(self: *const FrameSynthesisContext, resource: synthesis_graph.Resource) ?vk.VkImage {
+        return switch (resource) {
+            .warp_scratch => self.warp_scratch,
+            .backward_warped => if (self.quality_pipeline) |qp| qp.backward_warped else null,
+            .filled_output => if (self.quality_pipeline) |qp| qp.filled_output else null,
+            .splat_buffer => null,
+            .splat_cost => if (self.forward_splat) |splat| splat.cost_image else null,
+            .pyramid => if (self.pull_push) |fill| fill.pyramid_image else null,
+        };
+    }
+
+    /// Make writes from the previous compute pass visible to the next one
+    fn recordComputeBarrier(self: *const FrameSynthesisContext, cmd: vk.VkCommandBuffer) void {
+        const d = self.dispatch orelse return;
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT,
+        );
     }
 };
 
-/// Push constants for warp shader
-pub const WarpPushConstants = extern struct {
+/// Workgroup edge length of the default synthesis variant and of tiled
+/// and auxiliary passes (local_size_x/y)
+pub const workgroup_size: u32 = 16;
+
+/// Number of workgroups needed to cover an extent
+pub fn groupCount(extent: u32) u32 {
+    return (extent + workgroup_size - 1) / workgroup_size;
+}
+
+/// Timed stage a graph pass is reported under (splatting replaces the
+/// forward warp, pull-push the occlusion fill)
+pub fn passStage(pass: synthesis_graph.Pass) gpu_timing.Stage {
+    return switch (pass) {
+        .forward_warp, .splat => .forward_warp,
+        .backward_warp => .backward_warp,
+        .linear_blend, .confidence_blend => .blend,
+        .occlusion_fill, .pull_push => .occlusion_fill,
+    };
+}
+
+/// Constants block of the warp shaders
+pub const WarpConstants = extern struct {
     /// Motion vector scale (based on grid size)
     mv_scale_x: f32,
     mv_scale_y: f32,
@@ -149,28 +1094,41 @@ pub const WarpPushConstants = extern struct {
     direction: f32,
 };
 
-/// Push constants for linear blend shader (performance mode)
-pub const BlendPushConstants = extern struct {
+/// Constants block of the extrapolation warp shader
+pub const ExtrapolateConstants = extern struct {
+    /// Motion vector scale (based on grid size)
+    mv_scale_x: f32,
+    mv_scale_y: f32,
+    /// Distance past the current frame (0.5 = t+0.5)
+    extrapolation: f32,
+    /// Cost threshold for disocclusion detection
+    occlusion_threshold: f32,
+};
+
+/// Constants block of the linear blend shader (performance mode)
+pub const BlendConstants = extern struct {
     /// Blend weight for warped frame
     weight: f32,
+    /// 1.0 = fall back toward the nearest frame in low-confidence tiles
+    tile_confidence: f32 = 0,
     /// Reserved for future use
-    _reserved: [3]f32 = .{ 0, 0, 0 },
+    _reserved: [2]f32 = .{ 0, 0 },
 };
 
-/// Push constants for confidence blend shader (quality mode)
-pub const ConfidenceBlendPushConstants = extern struct {
+/// Constants block of the confidence blend shader (quality mode)
+pub const ConfidenceBlendConstants = extern struct {
     /// Interpolation factor (0.0 = prev, 1.0 = curr)
     interpolation: f32,
     /// Scale factor for cost -> confidence mapping
     cost_scale: f32,
     /// Minimum confidence threshold
     min_confidence: f32,
-    /// Reserved
-    _reserved: f32 = 0,
+    /// 1.0 = fall back toward the nearest frame in low-confidence tiles
+    tile_confidence: f32 = 0,
 };
 
-/// Push constants for occlusion fill shader
-pub const OcclusionFillPushConstants = extern struct {
+/// Constants block of the occlusion fill shader
+pub const OcclusionFillConstants = extern struct {
     /// Cost threshold for occlusion detection
     occlusion_threshold: f32,
     /// Search radius for neighbor fill
@@ -193,7 +1151,7 @@ pub const QualityPipeline = struct {
     backward_warped_view: ?vk.VkImageView = null,
     backward_warped_memory: ?vk.VkDeviceMemory = null,
 
-    // Filled output after occlusion handling
+    // Confidence blend result occlusion handling fills
     filled_output: ?vk.VkImage = null,
     filled_output_view: ?vk.VkImageView = null,
     filled_output_memory: ?vk.VkDeviceMemory = null,
@@ -203,71 +1161,190 @@ pub const QualityPipeline = struct {
 // Shader Binding Layout
 // =============================================================================
 
-/// Descriptor binding indices for synthesis shaders
-pub const BindingIndex = struct {
-    pub const input_prev: u32 = 0;
-    pub const input_curr: u32 = 1;
-    pub const motion_vectors: u32 = 2;
-    pub const cost_map: u32 = 3;
-    pub const output: u32 = 4;
-    pub const scratch: u32 = 5;
+/// Synthesis shader. Each has its own set layout and pipeline layout,
+/// built from its binding table; tiled pipelines share their shader's.
+pub const PassShader = enum {
+    forward_warp,
+    backward_warp,
+    linear_blend,
+    confidence_blend,
+    occlusion_fill,
+    extrapolate_warp,
+    tile_copy,
+
+    /// Set 0 of the shader as declared in shaders/<name>.comp. Each pass
+    /// reads the intermediates the previous one wrote (synthesis_graph.zig).
+    /// Binding 8 is only declared by the tiled variants (tiles.glsl),
+    /// binding 9 holds the pass's constants block.
+    pub fn bindings(self: PassShader) []const PassBinding {
+        return switch (self) {
+            .forward_warp => &.{
+                .{ .binding = 0, .source = .prev },
+                .{ .binding = 1, .source = .motion },
+                .{ .binding = 2, .source = .warp_scratch, .written = true },
+                .{ .binding = 8, .source = .tile_lists },
+                .{ .binding = 9, .source = .constants },
+            },
+            .backward_warp => &.{
+                .{ .binding = 0, .source = .curr },
+                .{ .binding = 1, .source = .backward_motion },
+                .{ .binding = 2, .source = .backward_warped, .written = true },
+                .{ .binding = 8, .source = .tile_lists },
+                .{ .binding = 9, .source = .constants },
+            },
+            .linear_blend => &.{
+                .{ .binding = 0, .source = .warp_scratch },
+                .{ .binding = 1, .source = .curr },
+                .{ .binding = 2, .source = .output, .written = true },
+                .{ .binding = 3, .source = .tile_confidence },
+                .{ .binding = 8, .source = .tile_lists },
+                .{ .binding = 9, .source = .constants },
+            },
+            .confidence_blend => &.{
+                .{ .binding = 0, .source = .warp_scratch },
+                .{ .binding = 1, .source = .backward_warped },
+                .{ .binding = 2, .source = .cost },
+                .{ .binding = 3, .source = .backward_cost },
+                .{ .binding = 4, .source = .blend_target, .written = true },
+                .{ .binding = 5, .source = .tile_confidence },
+                .{ .binding = 8, .source = .tile_lists },
+                .{ .binding = 9, .source = .constants },
+            },
+            .occlusion_fill => &.{
+                .{ .binding = 0, .source = .filled_output },
+                .{ .binding = 1, .source = .curr },
+                .{ .binding = 2, .source = .fill_cost },
+                .{ .binding = 3, .source = .output, .written = true },
+                .{ .binding = 8, .source = .tile_lists },
+                .{ .binding = 9, .source = .constants },
+            },
+            .extrapolate_warp => &.{
+                .{ .binding = 0, .source = .curr },
+                .{ .binding = 1, .source = .motion },
+                .{ .binding = 2, .source = .cost },
+                .{ .binding = 3, .source = .output, .written = true },
+                .{ .binding = 9, .source = .constants },
+            },
+            .tile_copy => &.{
+                .{ .binding = 0, .source = .prev },
+                .{ .binding = 1, .source = .curr },
+                .{ .binding = 2, .source = .output, .written = true },
+                .{ .binding = 8, .source = .tile_lists },
+                .{ .binding = 9, .source = .constants },
+            },
+        };
+    }
+
+    /// SPIR-V base name (build.zig)
+    pub fn name(self: PassShader) []const u8 {
+        return @tagName(self);
+    }
+
+    /// SPIR-V base name of the full-frame or tiled variant. The full-frame
+    /// tile_copy is the passthrough of gated batches.
+    pub fn variantName(self: PassShader, tiled: bool) []const u8 {
+        return switch (self) {
+            .extrapolate_warp => @tagName(self),
+            inline else => |shader| if (tiled) @tagName(shader) ++ "_tiled" else @tagName(shader),
+        };
+    }
 };
 
-/// Create descriptor set layout for frame synthesis
-pub fn createDescriptorSetLayout(device: vk.VkDevice, dispatch: *const vk.DeviceDispatch) !vk.VkDescriptorSetLayout {
-    const bindings = [_]vk.VkDescriptorSetLayoutBinding{
-        // Input previous frame
-        .{
-            .binding = BindingIndex.input_prev,
-            .descriptorType = vk.VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 1,
-            .stageFlags = vk.VK_SHADER_STAGE_COMPUTE_BIT,
-            .pImmutableSamplers = null,
-        },
-        // Input current frame
-        .{
-            .binding = BindingIndex.input_curr,
-            .descriptorType = vk.VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 1,
-            .stageFlags = vk.VK_SHADER_STAGE_COMPUTE_BIT,
-            .pImmutableSamplers = null,
-        },
-        // Motion vectors
-        .{
-            .binding = BindingIndex.motion_vectors,
-            .descriptorType = vk.VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 1,
-            .stageFlags = vk.VK_SHADER_STAGE_COMPUTE_BIT,
-            .pImmutableSamplers = null,
-        },
-        // Cost map (optional)
-        .{
-            .binding = BindingIndex.cost_map,
-            .descriptorType = vk.VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 1,
-            .stageFlags = vk.VK_SHADER_STAGE_COMPUTE_BIT,
-            .pImmutableSamplers = null,
-        },
-        // Output image
-        .{
-            .binding = BindingIndex.output,
-            .descriptorType = vk.VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+/// What a synthesis binding is fed with (synthesis_descriptors.PassImages)
+pub const BindingSource = enum {
+    prev,
+    curr,
+    /// Forward motion field
+    motion,
+    /// Backward motion field with bidirectional flow, else the forward one
+    backward_motion,
+    /// Flow cost map (the motion field stands in without one)
+    cost,
+    /// Backward flow cost map with bidirectional flow, else the cost map
+    backward_cost,
+    /// Cost map occlusion fill reads: the splat cost map while splatting
+    fill_cost,
+    /// Per-tile flow confidence (scene_stats.comp)
+    tile_confidence,
+    warp_scratch,
+    backward_warped,
+    /// Confidence blend result occlusion fill reads (quality)
+    filled_output,
+    /// Confidence blend target: filled_output in quality mode, else output
+    blend_target,
+    /// Output target of the slot
+    output,
+    /// Tile list buffer (tile_classify.zig), read by tiled variants only
+    tile_lists,
+    /// The pass's block of the constants buffer (synthesis_constants.zig)
+    constants,
+
+    /// Written by an earlier pass of the frame, so always in GENERAL
+    pub fn isTransient(self: BindingSource) bool {
+        return switch (self) {
+            .warp_scratch, .backward_warped, .filled_output => true,
+            else => false,
+        };
+    }
+};
+
+/// One binding of a synthesis shader
+pub const PassBinding = struct {
+    binding: u32,
+    source: BindingSource,
+    /// Storage image the pass writes; read bindings are combined image
+    /// samplers
+    written: bool = false,
+
+    pub fn descriptorType(self: PassBinding) u32 {
+        if (self.source == .tile_lists) return vk.VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        if (self.source == .constants) return vk.VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        return if (self.written) vk.VK_DESCRIPTOR_TYPE_STORAGE_IMAGE else vk.VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    }
+};
+
+/// Most bindings of any synthesis shader
+pub const max_pass_bindings = 8;
+
+pub const pass_shader_count: u32 = std.meta.fields(PassShader).len;
+
+/// Pipeline layout per synthesis shader (null = pass unused)
+pub const PassLayouts = std.EnumArray(PassShader, ?vk.VkPipelineLayout);
+
+/// Descriptor set per synthesis shader
+pub const PassSets = std.EnumArray(PassShader, ?vk.VkDescriptorSet);
+
+/// Create the descriptor set layout of a synthesis shader. Its pipeline
+/// layout must use the layout of the context's descriptor model.
+pub fn createDescriptorSetLayout(
+    device: vk.VkDevice,
+    dispatch: *const vk.DeviceDispatch,
+    shader: PassShader,
+    model: synthesis_descriptors.Model,
+) !vk.VkDescriptorSetLayout {
+    const table = shader.bindings();
+    var bindings: [max_pass_bindings]vk.VkDescriptorSetLayoutBinding = undefined;
+    for (table, bindings[0..table.len]) |b, *layout_binding| {
+        layout_binding.* = .{
+            .binding = b.binding,
+            .descriptorType = b.descriptorType(),
             .descriptorCount = 1,
             .stageFlags = vk.VK_SHADER_STAGE_COMPUTE_BIT,
             .pImmutableSamplers = null,
-        },
-    };
+        };
+    }
 
     var layout: vk.VkDescriptorSetLayout = undefined;
     const create_info = vk.VkDescriptorSetLayoutCreateInfo{
         .sType = vk.VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
         .pNext = null,
-        .flags = 0,
-        .bindingCount = bindings.len,
+        .flags = synthesis_descriptors.layoutFlags(model),
+        .bindingCount = @intCast(table.len),
         .pBindings = &bindings,
     };
 
-    try vk.check(dispatch.vkCreateDescriptorSetLayout(device, &create_info, null, &layout));
+    const create = dispatch.vkCreateDescriptorSetLayout orelse return vk.VulkanError.FunctionNotFound;
+    try vk.check(create(device, &create_info, null, &layout));
     return layout;
 }
 
@@ -280,20 +1357,95 @@ test "QualityMode" {
     try std.testing.expectEqual(QualityMode.performance, perf);
 }
 
-test "WarpPushConstants size" {
-    try std.testing.expectEqual(@as(usize, 16), @sizeOf(WarpPushConstants));
+test "WarpConstants size" {
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(WarpConstants));
+}
+
+test "ExtrapolateConstants size" {
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(ExtrapolateConstants));
+}
+
+test "groupCount" {
+    try std.testing.expectEqual(@as(u32, 120), groupCount(1920));
+    try std.testing.expectEqual(@as(u32, 68), groupCount(1080));
+    try std.testing.expectEqual(@as(u32, 1), groupCount(1));
+}
+
+test "passStage" {
+    try std.testing.expectEqual(gpu_timing.Stage.forward_warp, passStage(.splat));
+    try std.testing.expectEqual(gpu_timing.Stage.blend, passStage(.confidence_blend));
+    try std.testing.expectEqual(gpu_timing.Stage.occlusion_fill, passStage(.pull_push));
+    for (std.enums.values(synthesis_graph.Pass)) |pass| try std.testing.expect(passStage(pass).isPass());
+}
+
+test "BlendConstants size" {
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(BlendConstants));
+}
+
+test "ConfidenceBlendConstants size" {
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(ConfidenceBlendConstants));
+}
+
+test "OcclusionFillConstants size" {
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(OcclusionFillConstants));
+}
+
+test "output targets" {
+    var ctx = FrameSynthesisContext.init(null, 1920, 1080, .performance, null, std.testing.allocator);
+    try std.testing.expect(ctx.getOutputTarget(0).view == null);
+    try std.testing.expect(ctx.getOutputTarget(max_batch_frames).view == null);
+    try std.testing.expectError(error.BatchTooLarge, ctx.setOutputTarget(max_batch_frames, .{}));
+
+    const view: vk.VkImageView = @ptrFromInt(0x1000);
+    try ctx.setOutputTarget(2, .{ .view = view });
+    try std.testing.expectEqual(view, ctx.getOutputTarget(2).view.?);
+    try std.testing.expect(ctx.getOutputTarget(1).view == null);
+}
+
+test "output ring replaces the single target set" {
+    const dispatch = vk.DeviceDispatch{ .device = @ptrFromInt(0x1000) };
+    var ctx = FrameSynthesisContext.init(null, 1920, 1080, .performance, &dispatch, std.testing.allocator);
+    try ctx.setOutputTarget(0, .{ .view = @ptrFromInt(0x10) });
+    try std.testing.expect((try ctx.acquireOutputs()) == null);
+
+    ctx.output_ring = .{ .dispatch = &dispatch, .depth = 2, .release_timeline = @ptrFromInt(0x20) };
+    // Not ready: the single set stays in use
+    try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x10)), ctx.getOutputView().?);
+
+    try ctx.output_ring.?.setTarget(0, 0, .{ .view = @ptrFromInt(0x100) });
+    try ctx.output_ring.?.setTarget(1, 0, .{ .view = @ptrFromInt(0x200) });
+    try std.testing.expect(ctx.isOutputRing());
+    // Sets never acquired need no counter query
+    try std.testing.expectEqual(@as(u32, 0), (try ctx.acquireOutputs()).?.index);
+    try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x100)), ctx.getOutputView().?);
+    try std.testing.expectEqual(@as(u32, 1), (try ctx.acquireOutputs()).?.index);
+    try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x200)), ctx.getOutputTarget(0).view.?);
+    try std.testing.expect(ctx.getOutputTarget(1).view == null);
 }
 
-test "BlendPushConstants size" {
-    try std.testing.expectEqual(@as(usize, 16), @sizeOf(BlendPushConstants));
+test "forward splat inactive without resources" {
+    var ctx = FrameSynthesisContext.init(null, 1920, 1080, .quality, null, std.testing.allocator);
+    try std.testing.expect(!ctx.isSplatting());
+    ctx.forward_splat = forward_splat.ForwardSplat.init(null);
+    try std.testing.expect(!ctx.isSplatting());
 }
 
-test "ConfidenceBlendPushConstants size" {
-    try std.testing.expectEqual(@as(usize, 16), @sizeOf(ConfidenceBlendPushConstants));
+test "tile confidence needs the image" {
+    var ctx = FrameSynthesisContext.init(null, 1920, 1080, .balanced, null, std.testing.allocator);
+    ctx.tile_confidence = true;
+    try std.testing.expect(!ctx.isTileConfidence());
+    ctx.tile_confidence_view = @ptrFromInt(0x40);
+    try std.testing.expect(ctx.isTileConfidence());
+    try std.testing.expectEqual(@as(f32, 1.0), ctx.tileConfidenceFlag());
 }
 
-test "OcclusionFillPushConstants size" {
-    try std.testing.expectEqual(@as(usize, 16), @sizeOf(OcclusionFillPushConstants));
+test "pull-push fill only in quality mode" {
+    var ctx = FrameSynthesisContext.init(null, 1920, 1080, .balanced, null, std.testing.allocator);
+    ctx.pull_push = hole_fill.PullPushFill.init(1920, 1080, null);
+    try std.testing.expect(!ctx.isPullPush(0));
+    ctx.mode = .quality;
+    // Still needs pipelines and descriptor sets
+    try std.testing.expect(!ctx.isPullPush(0));
 }
 
 test "QualityPipeline defaults" {
@@ -302,7 +1454,147 @@ test "QualityPipeline defaults" {
     try std.testing.expect(qp.confidence_blend_pipeline == null);
 }
 
-test "BindingIndex values" {
-    try std.testing.expectEqual(@as(u32, 0), BindingIndex.input_prev);
-    try std.testing.expectEqual(@as(u32, 4), BindingIndex.output);
+test "pass binding tables" {
+    for (std.enums.values(PassShader)) |shader| {
+        const table = shader.bindings();
+        try std.testing.expect(table.len <= max_pass_bindings);
+        var written: u32 = 0;
+        for (table, 0..) |b, i| {
+            if (b.written) written += 1;
+            for (table[i + 1 ..]) |other| try std.testing.expect(other.binding != b.binding);
+        }
+        try std.testing.expectEqual(@as(u32, 1), written);
+    }
+    // Every pass reads what the previous one of its graph wrote
+    try std.testing.expectEqual(BindingSource.warp_scratch, PassShader.forward_warp.bindings()[2].source);
+    try std.testing.expectEqual(BindingSource.warp_scratch, PassShader.linear_blend.bindings()[0].source);
+    try std.testing.expectEqual(BindingSource.backward_warped, PassShader.confidence_blend.bindings()[1].source);
+    try std.testing.expectEqual(BindingSource.filled_output, PassShader.occlusion_fill.bindings()[0].source);
+
+    // Tile lists on binding 8 of every shader with a tiled variant, the
+    // constants block on binding 9 of every shader
+    for (std.enums.values(PassShader)) |shader| {
+        const table = shader.bindings();
+        const last = table[table.len - 1];
+        try std.testing.expect(last.source == .constants and last.binding == 9);
+        const tiles = table[table.len - 2];
+        try std.testing.expectEqual(shader != .extrapolate_warp, tiles.source == .tile_lists and tiles.binding == 8);
+    }
+    try std.testing.expectEqual(vk.VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, PassShader.tile_copy.bindings()[3].descriptorType());
+    try std.testing.expectEqual(vk.VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, PassShader.tile_copy.bindings()[4].descriptorType());
+    try std.testing.expectEqualStrings("linear_blend_tiled", PassShader.linear_blend.variantName(true));
+    try std.testing.expectEqualStrings("linear_blend", PassShader.linear_blend.variantName(false));
+    try std.testing.expectEqualStrings("tile_copy_tiled", PassShader.tile_copy.variantName(true));
+    try std.testing.expectEqualStrings("tile_copy", PassShader.tile_copy.variantName(false));
+}
+
+test "bidirectional flow bindings" {
+    var ctx = FrameSynthesisContext.init(null, 1920, 1080, .balanced, null, std.testing.allocator);
+    try ctx.setOutputTarget(0, .{ .view = @ptrFromInt(0x100) });
+    var mvb = test_stubs.motionVectors(0x1);
+    mvb.cost_view = @ptrFromInt(0x4);
+    const backward_motion = PassShader.backward_warp.bindings()[1];
+    const backward_cost = PassShader.confidence_blend.bindings()[3];
+    try std.testing.expectEqual(@as(u32, 1), backward_motion.binding);
+    try std.testing.expectEqual(@as(u32, 3), backward_cost.binding);
+    const warp = WarpConstants{ .mv_scale_x = 1.0, .mv_scale_y = 1.0, .interpolation = 0.5, .direction = 1.0 };
+
+    // Forward flow only: the forward field, warped the other way
+    var images = ctx.passImages(0, @ptrFromInt(0x10), @ptrFromInt(0x11), &mvb);
+    try std.testing.expectEqual(mvb.forward_view, images.view(backward_motion.source).?);
+    try std.testing.expectEqual(mvb.cost_view.?, images.view(backward_cost.source).?);
+    try std.testing.expectEqual(@as(f32, 1.0), backwardWarp(warp, &mvb).direction);
+
+    // Bidirectional: backward field and its cost map
+    mvb.backward_view = @ptrFromInt(0x5);
+    mvb.backward_cost_view = @ptrFromInt(0x6);
+    images = ctx.passImages(0, @ptrFromInt(0x10), @ptrFromInt(0x11), &mvb);
+    try std.testing.expectEqual(mvb.backward_view.?, images.view(backward_motion.source).?);
+    try std.testing.expectEqual(mvb.backward_cost_view.?, images.view(backward_cost.source).?);
+    try std.testing.expectEqual(mvb.forward_view, images.view(PassShader.forward_warp.bindings()[1].source).?);
+    try std.testing.expectEqual(mvb.cost_view.?, images.view(PassShader.confidence_blend.bindings()[2].source).?);
+    try std.testing.expectEqual(@as(f32, -1.0), backwardWarp(warp, &mvb).direction);
+}
+
+test "swapchain format without pipeline cache" {
+    var ctx = FrameSynthesisContext.init(null, 1920, 1080, .balanced, null, std.testing.allocator);
+    // No pipelines yet: any format is stored for createPipelines
+    try ctx.setSwapchainFormat(output_format.VK_FORMAT_R16G16B16A16_SFLOAT, output_format.VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT);
+    try std.testing.expectEqual(output_format.OutputFormat.rgba16f, ctx.output_key.output);
+
+    // Caller-created pipelines are 8-bit SDR only
+    ctx.warp_pipeline = @ptrFromInt(0x10);
+    try std.testing.expectError(
+        error.UnsupportedFormat,
+        ctx.setSwapchainFormat(output_format.VK_FORMAT_B8G8R8A8_UNORM, output_format.VK_COLOR_SPACE_SRGB_NONLINEAR_KHR),
+    );
+    ctx.output_key = .{};
+    try ctx.setSwapchainFormat(output_format.VK_FORMAT_B8G8R8A8_UNORM, output_format.VK_COLOR_SPACE_SRGB_NONLINEAR_KHR);
+    try ctx.setSwapchainFormat(output_format.VK_FORMAT_B8G8R8A8_SRGB, output_format.VK_COLOR_SPACE_SRGB_NONLINEAR_KHR);
+    try std.testing.expectEqual(output_format.TransferFunction.srgb, ctx.output_key.transfer);
+    try std.testing.expectError(
+        error.UnsupportedFormat,
+        ctx.setSwapchainFormat(output_format.VK_FORMAT_A2B10G10R10_UNORM_PACK32, output_format.VK_COLOR_SPACE_HDR10_ST2084_EXT),
+    );
+    try std.testing.expectError(error.UnsupportedFormat, ctx.setSwapchainFormat(0, 0));
+    try std.testing.expectEqual(output_format.OutputFormat.rgba8, ctx.output_key.output);
+}
+
+var test_passthrough_dispatches: u32 = 0;
+
+fn stubCountPassthrough(_: vk.VkCommandBuffer, buffer: vk.VkBuffer, offset: vk.VkDeviceSize) callconv(.c) void {
+    // Passes dispatch from the gate copies, never the readback slot
+    std.debug.assert(buffer == @as(vk.VkBuffer, @ptrFromInt(0x400)));
+    if (offset == synthesis_constants.gateOffset(.passthrough)) test_passthrough_dispatches += 1;
+}
+
+test "gated batch records a passthrough per slot" {
+    var d = test_stubs.recording_dispatch;
+    d.vkCmdDispatchIndirect = stubCountPassthrough;
+    var ctx = FrameSynthesisContext.init(@ptrFromInt(0x1000), 1920, 1080, .performance, &d, std.testing.allocator);
+    ctx.warp_pipeline = @ptrFromInt(0x10);
+    ctx.blend_pipeline = @ptrFromInt(0x11);
+    ctx.extrapolate_pipeline = @ptrFromInt(0x12);
+    ctx.passthrough_pipeline = @ptrFromInt(0x13);
+    ctx.pipeline_layouts = .initFill(@ptrFromInt(0x20));
+    try ctx.setConstantsBuffer(@ptrFromInt(0x400));
+    for (0..2) |slot| {
+        try ctx.setOutputTarget(@intCast(slot), .{
+            .view = @ptrFromInt(0x100 + slot),
+            .descriptor_sets = .initFill(@ptrFromInt(0x200 + slot)),
+        });
+    }
+    const mvb = test_stubs.motionVectors(0x1);
+    const factors = [_]f32{ 1.0 / 3.0, 2.0 / 3.0 };
+    var views: [2]vk.VkImageView = undefined;
+
+    // Ungated: no passthrough
+    test_passthrough_dispatches = 0;
+    _ = try ctx.synthesizeBatch(@ptrFromInt(0x4), @ptrFromInt(0x5), @ptrFromInt(0x6), &mvb, &factors, &views);
+    try std.testing.expectEqual(@as(u32, 0), test_passthrough_dispatches);
+
+    // Gated on the GPU: every slot gets the current frame when synthesis
+    // is skipped, so no slot presents a stale output
+    ctx.dispatch_gate = .{ .buffer = @ptrFromInt(0x300), .offset = 32 };
+    ctx.passthrough_gate = .{ .buffer = @ptrFromInt(0x300), .offset = 60 };
+    _ = try ctx.synthesizeBatch(@ptrFromInt(0x4), @ptrFromInt(0x5), @ptrFromInt(0x6), &mvb, &factors, &views);
+    try std.testing.expectEqual(@as(u32, 2), test_passthrough_dispatches);
+    _ = try ctx.extrapolateBatch(@ptrFromInt(0x4), @ptrFromInt(0x6), &mvb, factors[0..1], views[0..1]);
+    try std.testing.expectEqual(@as(u32, 3), test_passthrough_dispatches);
+}
+
+test "push descriptors only before pipelines" {
+    var d = vk.DeviceDispatch{ .device = test_stubs.device };
+    var ctx = FrameSynthesisContext.init(@ptrFromInt(0x1000), 1920, 1080, .performance, &d, std.testing.allocator);
+    const push = synthesis_descriptors.PushDescriptors{ .sampler = @ptrFromInt(0x10) };
+    try std.testing.expectError(vk.VulkanError.ExtensionNotPresent, ctx.usePushDescriptors(push));
+
+    d.vkCmdPushDescriptorSetKHR = test_stubs.pushDescriptorSet;
+    try ctx.usePushDescriptors(push);
+    try std.testing.expect(ctx.descriptors == .push);
+
+    ctx.descriptors = .classic;
+    ctx.warp_pipeline = @ptrFromInt(0x20);
+    try std.testing.expectError(error.PipelinesCreated, ctx.usePushDescriptors(push));
+    try std.testing.expect(ctx.descriptors == .classic);
 }
@@ -0,0 +1,491 @@
+//! GPU Stage Timing
+//!
+//! Timestamp queries around the stages of frame generation. Each frame
+//! writes its own range of a query pool; beginFrame reads the range back
+//! (without waiting) before resetting it for reuse, so results arrive
+//! frames_in_flight frames late and never stall the CPU. Frames whose
+//! results are not available yet are dropped.
+//!
+//! Timestamps of different queues share the device timeline, so comparing
+//! a frame's optical flow with the previous frame's synthesis shows how
+//! much of it ran concurrently (StageTimings.overlapNs).
+//!
+//! The synthesis passes (warps, blend, hole fill) are timed per batch slot
+//! inside the synthesis stage. Timed batches are recorded directly, never
+//! replayed (synthesis_replay.zig), but which passes run depends on the
+//! mode and batch size, so their queries are read by availability alone: a
+//! query reset by beginFrame and not written since stays unavailable.
+//! Durations of every completed frame also feed per-stage RollingStats.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Timed stage of frame generation
+pub const Stage = enum {
+    /// Optical flow (or engine motion ingest)
+    flow,
+    /// Copy of a flow ring slot and upsampling on the synthesis queue
+    mv_resolve,
+    /// Scene statistics and frame synthesis of the whole batch
+    synthesis,
+    /// Forward warp or splat (and extrapolation) of each generated frame
+    forward_warp,
+    /// Backward warp of each generated frame (balanced and quality)
+    backward_warp,
+    /// Linear or confidence blend of each generated frame
+    blend,
+    /// Occlusion or pull-push hole fill of each generated frame (quality)
+    occlusion_fill,
+
+    /// Synthesis pass, timed once per batch slot
+    pub fn isPass(self: Stage) bool {
+        return @intFromEnum(self) >= @intFromEnum(Stage.forward_warp);
+    }
+};
+
+pub const Stages = std.EnumSet(Stage);
+
+pub const stage_count = std.meta.fields(Stage).len;
+
+// Stages timed once per frame precede the pass stages
+const frame_stage_count = @intFromEnum(Stage.forward_warp);
+
+/// Batch slots a pass stage is timed in
+pub const max_slots = frame_synthesis.max_batch_frames;
+
+/// Frames whose queries can be pending at once
+pub const frames_in_flight = 4;
+
+/// Queries per frame: begin and end of every frame stage, and of every
+/// pass stage in every batch slot
+pub const queries_per_frame: u32 = frame_stage_count * 2 + (stage_count - frame_stage_count) * max_slots * 2;
+
+/// Timed frames the rolling statistics cover
+pub const rolling_window = 32;
+
+/// Begin and end of a stage on the device timeline, in nanoseconds
+pub const Interval = struct {
+    begin_ns: u64 = 0,
+    end_ns: u64 = 0,
+
+    pub fn durationNs(self: Interval) u64 {
+        return self.end_ns -| self.begin_ns;
+    }
+
+    /// Time both intervals were running
+    pub fn overlapNs(self: Interval, other: Interval) u64 {
+        return @min(self.end_ns, other.end_ns) -| @max(self.begin_ns, other.begin_ns);
+    }
+};
+
+/// Stage intervals of one frame. A pass stage's interval spans all of its
+/// batch slots; its duration is the sum of the slots' durations.
+pub const StageTimings = struct {
+    frame: u64 = 0,
+    intervals: std.EnumArray(Stage, Interval) = .initFill(.{}),
+    durations: std.EnumArray(Stage, u64) = .initFill(0),
+    valid: Stages = .initEmpty(),
+
+    pub fn get(self: *const StageTimings, stage: Stage) ?Interval {
+        if (!self.valid.contains(stage)) return null;
+        return self.intervals.get(stage);
+    }
+
+    pub fn durationNs(self: *const StageTimings, stage: Stage) u64 {
+        if (!self.valid.contains(stage)) return 0;
+        return self.durations.get(stage);
+    }
+
+    /// Add one timed interval of a stage
+    fn add(self: *StageTimings, stage: Stage, interval: Interval) void {
+        if (self.valid.contains(stage)) {
+            const span = self.intervals.getPtr(stage);
+            span.begin_ns = @min(span.begin_ns, interval.begin_ns);
+            span.end_ns = @max(span.end_ns, interval.end_ns);
+        } else {
+            self.intervals.set(stage, interval);
+            self.valid.insert(stage);
+        }
+        self.durations.getPtr(stage).* += interval.durationNs();
+    }
+
+    /// Time a stage of this frame overlapped a stage of another frame
+    pub fn overlapNs(self: *const StageTimings, stage: Stage, other: *const StageTimings, other_stage: Stage) u64 {
+        const a = self.get(stage) orelse return 0;
+        const b = other.get(other_stage) orelse return 0;
+        return a.overlapNs(b);
+    }
+};
+
+/// Durations of a stage over the last rolling_window frames it was timed in
+pub const RollingStats = struct {
+    samples: [rolling_window]u64 = .{0} ** rolling_window,
+    // Samples recorded so far (only the last rolling_window are kept)
+    count: u64 = 0,
+
+    pub fn push(self: *RollingStats, ns: u64) void {
+        self.samples[@intCast(self.count % rolling_window)] = ns;
+        self.count += 1;
+    }
+
+    pub fn window(self: *const RollingStats) []const u64 {
+        return self.samples[0..@intCast(@min(self.count, rolling_window))];
+    }
+
+    /// Newest sample (0 before the first)
+    pub fn lastNs(self: *const RollingStats) u64 {
+        if (self.count == 0) return 0;
+        return self.samples[@intCast((self.count - 1) % rolling_window)];
+    }
+
+    pub fn averageNs(self: *const RollingStats) u64 {
+        const samples = self.window();
+        if (samples.len == 0) return 0;
+        var sum: u64 = 0;
+        for (samples) |ns| sum += ns;
+        return sum / @as(u64, @intCast(samples.len));
+    }
+
+    pub fn minNs(self: *const RollingStats) u64 {
+        const samples = self.window();
+        if (samples.len == 0) return 0;
+        return std.mem.min(u64, samples);
+    }
+
+    pub fn maxNs(self: *const RollingStats) u64 {
+        const samples = self.window();
+        if (samples.len == 0) return 0;
+        return std.mem.max(u64, samples);
+    }
+};
+
+// =============================================================================
+// Timer
+// =============================================================================
+
+/// Timestamp query pool for frames_in_flight frames
+pub const GpuTimer = struct {
+    dispatch: *const vk.DeviceDispatch,
+    pool: vk.VkQueryPool,
+    /// Nanoseconds per tick (VkPhysicalDeviceProperties.timestampPeriod)
+    period_ns: f32,
+    /// Stages to time. Leave out .flow when the optical flow queue family
+    /// has timestampValidBits = 0.
+    timed: Stages = .initFull(),
+
+    // Frames begun so far (the current frame is frame - 1)
+    frame: u64 = 0,
+    // Stages written per query range
+    written: [frames_in_flight]Stages = [_]Stages{.initEmpty()} ** frames_in_flight,
+    // Newest completed frame and the one before it
+    latest: ?StageTimings = null,
+    previous: ?StageTimings = null,
+    rolling: std.EnumArray(Stage, RollingStats) = .initFill(.{}),
+
+    pub fn init(dispatch: *const vk.DeviceDispatch, period_ns: f32) !GpuTimer {
+        if (!dispatch.hasTimestampQueries()) return vk.VulkanError.FunctionNotFound;
+        var pool: vk.VkQueryPool = undefined;
+        try vk.check(dispatch.vkCreateQueryPool.?(dispatch.device, &.{
+            .queryCount = queries_per_frame * frames_in_flight,
+        }, null, &pool));
+        return .{ .dispatch = dispatch, .pool = pool, .period_ns = period_ns };
+    }
+
+    pub fn deinit(self: *GpuTimer) void {
+        self.dispatch.vkDestroyQueryPool.?(self.dispatch.device, self.pool, null);
+    }
+
+    /// Start a frame: collect the results last written to its query range
+    /// and reset the range. Record into the frame's first command buffer,
+    /// before any stage.
+    pub fn beginFrame(self: *GpuTimer, cmd: vk.VkCommandBuffer) void {
+        const range: usize = @intCast(self.frame % frames_in_flight);
+        if (self.written[range].count() > 0) {
+            if (self.collect(range, self.frame - frames_in_flight)) |timings| {
+                self.previous = self.latest;
+                self.latest = timings;
+                var it = timings.valid.iterator();
+                while (it.next()) |stage| self.rolling.getPtr(stage).push(timings.durationNs(stage));
+            }
+        }
+        self.dispatch.vkCmdResetQueryPool.?(cmd, self.pool, firstQuery(range), queries_per_frame);
+        self.written[range] = .initEmpty();
+        self.frame += 1;
+    }
+
+    /// Timestamp at the start of a stage of the current frame
+    pub fn begin(self: *GpuTimer, cmd: vk.VkCommandBuffer, stage: Stage) void {
+        std.debug.assert(!stage.isPass());
+        _ = self.write(cmd, stage, 0, 0, vk.VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    }
+
+    /// Timestamp once a stage of the current frame has completed
+    pub fn end(self: *GpuTimer, cmd: vk.VkCommandBuffer, stage: Stage) void {
+        std.debug.assert(!stage.isPass());
+        const range = self.write(cmd, stage, 0, 1, vk.VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT) orelse return;
+        self.written[range].insert(stage);
+    }
+
+    /// Timestamp at the start of a synthesis pass of a batch slot. Pass
+    /// timestamps are only collected within a timed synthesis stage.
+    pub fn beginPass(self: *const GpuTimer, cmd: vk.VkCommandBuffer, stage: Stage, slot: u32) void {
+        std.debug.assert(stage.isPass() and slot < max_slots);
+        _ = self.write(cmd, stage, slot, 0, vk.VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    }
+
+    /// Timestamp once a synthesis pass of a batch slot has completed
+    pub fn endPass(self: *const GpuTimer, cmd: vk.VkCommandBuffer, stage: Stage, slot: u32) void {
+        std.debug.assert(stage.isPass() and slot < max_slots);
+        _ = self.write(cmd, stage, slot, 1, vk.VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    }
+
+    /// Query range of the current frame (null before the first frame).
+    /// Recorded pass timestamps are only valid for frames of that range.
+    pub fn currentRange(self: *const GpuTimer) ?u32 {
+        if (self.frame == 0) return null;
+        return @intCast((self.frame - 1) % frames_in_flight);
+    }
+
+    /// Newest completed frame's timings
+    pub fn getLatest(self: *const GpuTimer) ?StageTimings {
+        return self.latest;
+    }
+
+    /// Durations of a stage over the last rolling_window completed frames
+    pub fn stageStats(self: *const GpuTimer, stage: Stage) RollingStats {
+        return self.rolling.get(stage);
+    }
+
+    /// Time the newest frame's optical flow ran alongside the synthesis of
+    /// the frame before it
+    pub fn flowOverlapNs(self: *const GpuTimer) u64 {
+        const latest = self.latest orelse return 0;
+        const previous = self.previous orelse return 0;
+        if (previous.frame + 1 != latest.frame) return 0;
+        return latest.overlapNs(.flow, &previous, .synthesis);
+    }
+
+    /// Write one timestamp of the current frame; returns its query range
+    fn write(self: *const GpuTimer, cmd: vk.VkCommandBuffer, stage: Stage, slot: u32, which: u32, pipeline_stage: vk.VkPipelineStageFlags) ?usize {
+        if (!self.timed.contains(stage)) return null;
+        const range: usize = self.currentRange() orelse return null;
+        const query = firstQuery(range) + stageQuery(stage, slot) + which;
+        self.dispatch.vkCmdWriteTimestamp.?(cmd, pipeline_stage, self.pool, query);
+        return range;
+    }
+
+    /// Read a query range without waiting; null if any written stage is
+    /// not available yet
+    fn collect(self: *const GpuTimer, range: usize, frame: u64) ?StageTimings {
+        const d = self.dispatch;
+        // Value and availability per query
+        var results: [queries_per_frame * 2]u64 = undefined;
+        const result = d.vkGetQueryPoolResults.?(
+            d.device,
+            self.pool,
+            firstQuery(range),
+            queries_per_frame,
+            @sizeOf(@TypeOf(results)),
+            &results,
+            2 * @sizeOf(u64),
+            vk.VK_QUERY_RESULT_64_BIT | vk.VK_QUERY_RESULT_WITH_AVAILABILITY_BIT,
+        );
+        if (result != .success and result != .not_ready) return null;
+
+        var timings = StageTimings{ .frame = frame };
+        var it = self.written[range].iterator();
+        while (it.next()) |stage| {
+            timings.add(stage, self.interval(&results, stageQuery(stage, 0)) orelse return null);
+        }
+
+        // Passes complete before the end of the synthesis stage around them
+        if (!timings.valid.contains(.synthesis)) return timings;
+        for (std.enums.values(Stage)) |stage| {
+            if (!stage.isPass()) continue;
+            for (0..max_slots) |slot| {
+                const pass = self.interval(&results, stageQuery(stage, @intCast(slot))) orelse continue;
+                timings.add(stage, pass);
+            }
+        }
+        return timings;
+    }
+
+    /// Interval of a begin/end query pair, null unless both are available
+    fn interval(self: *const GpuTimer, results: *const [queries_per_frame * 2]u64, query: u32) ?Interval {
+        const q: usize = query;
+        if (results[q * 2 + 1] == 0 or results[(q + 1) * 2 + 1] == 0) return null;
+        return .{
+            .begin_ns = self.ticksToNs(results[q * 2]),
+            .end_ns = self.ticksToNs(results[(q + 1) * 2]),
+        };
+    }
+
+    /// First query of a stage (and batch slot) within a frame's range
+    fn stageQuery(stage: Stage, slot: u32) u32 {
+        const index: u32 = @intFromEnum(stage);
+        if (!stage.isPass()) return index * 2;
+        return frame_stage_count * 2 + ((index - frame_stage_count) * max_slots + slot) * 2;
+    }
+
+    fn ticksToNs(self: *const GpuTimer, ticks: u64) u64 {
+        return @intFromFloat(@as(f64, @floatFromInt(ticks)) * self.period_ns);
+    }
+
+    fn firstQuery(range: usize) u32 {
+        return @as(u32, @intCast(range)) * queries_per_frame;
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "interval overlap" {
+    const a = Interval{ .begin_ns = 100, .end_ns = 400 };
+    const b = Interval{ .begin_ns = 300, .end_ns = 900 };
+    try std.testing.expectEqual(@as(u64, 300), a.durationNs());
+    try std.testing.expectEqual(@as(u64, 100), a.overlapNs(b));
+    try std.testing.expectEqual(@as(u64, 0), a.overlapNs(.{ .begin_ns = 500, .end_ns = 600 }));
+}
+
+// Stub pool: timestamp of query q of a range is 1000 * cmd + 10 * q
+var stub_timestamps: [queries_per_frame * frames_in_flight]u64 = undefined;
+var stub_written: [queries_per_frame * frames_in_flight]bool = .{false} ** (queries_per_frame * frames_in_flight);
+var stub_available: bool = true;
+
+fn stubCreateQueryPool(_: vk.VkDevice, _: *const vk.VkQueryPoolCreateInfo, _: ?*const vk.VkAllocationCallbacks, pool: *vk.VkQueryPool) callconv(.c) vk.VkResult {
+    pool.* = @ptrFromInt(0x7000);
+    return .success;
+}
+
+fn stubDestroyQueryPool(_: vk.VkDevice, _: vk.VkQueryPool, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {}
+
+fn stubResetQueryPool(_: vk.VkCommandBuffer, _: vk.VkQueryPool, first: u32, count: u32) callconv(.c) void {
+    @memset(stub_written[first..][0..count], false);
+}
+
+fn stubWriteTimestamp(cmd: vk.VkCommandBuffer, _: vk.VkPipelineStageFlags, _: vk.VkQueryPool, query: u32) callconv(.c) void {
+    const frame: u64 = @intFromPtr(cmd);
+    stub_timestamps[query] = 1000 * frame + 10 * (query % queries_per_frame);
+    stub_written[query] = true;
+}
+
+fn stubGetQueryPoolResults(_: vk.VkDevice, _: vk.VkQueryPool, first: u32, count: u32, _: usize, data: *anyopaque, _: vk.VkDeviceSize, _: u32) callconv(.c) vk.VkResult {
+    const out: [*]u64 = @ptrCast(@alignCast(data));
+    for (0..count) |i| {
+        out[i * 2] = stub_timestamps[first + i];
+        out[i * 2 + 1] = @intFromBool(stub_available and stub_written[first + i]);
+    }
+    return if (stub_available) .success else .not_ready;
+}
+
+test "GpuTimer reads results frames_in_flight frames late" {
+    const dispatch = vk.DeviceDispatch{
+        .device = @ptrFromInt(0x1000),
+        .vkCreateQueryPool = stubCreateQueryPool,
+        .vkDestroyQueryPool = stubDestroyQueryPool,
+        .vkCmdResetQueryPool = stubResetQueryPool,
+        .vkCmdWriteTimestamp = stubWriteTimestamp,
+        .vkGetQueryPoolResults = stubGetQueryPoolResults,
+    };
+    var timer = try GpuTimer.init(&dispatch, 1.0);
+    defer timer.deinit();
+    stub_available = true;
+    @memset(&stub_written, false);
+
+    // The command buffer handle doubles as the frame number for the stub
+    for (1..frames_in_flight + 2) |frame| {
+        const cmd: vk.VkCommandBuffer = @ptrFromInt(frame);
+        timer.beginFrame(cmd);
+        timer.begin(cmd, .flow);
+        timer.end(cmd, .flow);
+        timer.begin(cmd, .synthesis);
+        timer.end(cmd, .synthesis);
+        if (frame <= frames_in_flight) try std.testing.expect(timer.getLatest() == null);
+    }
+
+    // First frame (index 0): flow at queries 0-1, synthesis at 4-5
+    const latest = timer.getLatest().?;
+    try std.testing.expectEqual(@as(u64, 0), latest.frame);
+    try std.testing.expectEqual(@as(u64, 10), latest.durationNs(.flow));
+    try std.testing.expect(latest.get(.mv_resolve) == null);
+    try std.testing.expectEqual(@as(u64, 1040), latest.get(.synthesis).?.begin_ns);
+    try std.testing.expectEqual(@as(u64, 0), timer.flowOverlapNs());
+
+    // Unavailable results are dropped, not waited for
+    stub_available = false;
+    timer.beginFrame(@ptrFromInt(frames_in_flight + 2));
+    try std.testing.expectEqual(@as(u64, 0), timer.getLatest().?.frame);
+}
+
+test "overlap of flow with the previous frame's synthesis" {
+    var previous = StageTimings{ .frame = 7 };
+    previous.intervals.set(.synthesis, .{ .begin_ns = 1000, .end_ns = 3000 });
+    previous.valid.insert(.synthesis);
+    var latest = StageTimings{ .frame = 8 };
+    latest.intervals.set(.flow, .{ .begin_ns = 2500, .end_ns = 4000 });
+    latest.valid.insert(.flow);
+    try std.testing.expectEqual(@as(u64, 500), latest.overlapNs(.flow, &previous, .synthesis));
+    try std.testing.expectEqual(@as(u64, 0), latest.overlapNs(.synthesis, &previous, .synthesis));
+}
+
+test "pass stages sum their batch slots" {
+    const dispatch = vk.DeviceDispatch{
+        .device = @ptrFromInt(0x1000),
+        .vkCreateQueryPool = stubCreateQueryPool,
+        .vkDestroyQueryPool = stubDestroyQueryPool,
+        .vkCmdResetQueryPool = stubResetQueryPool,
+        .vkCmdWriteTimestamp = stubWriteTimestamp,
+        .vkGetQueryPoolResults = stubGetQueryPoolResults,
+    };
+    var timer = try GpuTimer.init(&dispatch, 1.0);
+    defer timer.deinit();
+    stub_available = true;
+    @memset(&stub_written, false);
+    try std.testing.expect(timer.currentRange() == null);
+
+    for (1..frames_in_flight + 2) |frame| {
+        const cmd: vk.VkCommandBuffer = @ptrFromInt(frame);
+        timer.beginFrame(cmd);
+        try std.testing.expectEqual(@as(u32, @intCast((frame - 1) % frames_in_flight)), timer.currentRange().?);
+        timer.begin(cmd, .synthesis);
+        // Two slots warp, one blends (as a replayed buffer would)
+        for (0..2) |slot| {
+            timer.beginPass(cmd, .forward_warp, @intCast(slot));
+            timer.endPass(cmd, .forward_warp, @intCast(slot));
+        }
+        timer.beginPass(cmd, .blend, 0);
+        timer.endPass(cmd, .blend, 0);
+        timer.end(cmd, .synthesis);
+    }
+
+    // Each pair is 10 ns apart; slot 1 starts 20 ns after slot 0
+    const latest = timer.getLatest().?;
+    try std.testing.expectEqual(@as(u64, 20), latest.durationNs(.forward_warp));
+    try std.testing.expectEqual(@as(u64, 30), latest.get(.forward_warp).?.durationNs());
+    try std.testing.expectEqual(@as(u64, 10), latest.durationNs(.blend));
+    try std.testing.expect(latest.get(.occlusion_fill) == null);
+
+    // Rolling statistics of the completed frame
+    const warp = timer.stageStats(.forward_warp);
+    try std.testing.expectEqual(@as(u64, 1), warp.count);
+    try std.testing.expectEqual(@as(u64, 20), warp.averageNs());
+    try std.testing.expectEqual(@as(u64, 20), warp.maxNs());
+    try std.testing.expectEqual(@as(u64, 0), timer.stageStats(.backward_warp).averageNs());
+}
+
+test "RollingStats keeps the last window" {
+    var stats = RollingStats{};
+    try std.testing.expectEqual(@as(u64, 0), stats.averageNs());
+    for (0..rolling_window + 2) |i| stats.push(i);
+    try std.testing.expectEqual(@as(usize, rolling_window), stats.window().len);
+    try std.testing.expectEqual(@as(u64, 2), stats.minNs());
+    try std.testing.expectEqual(@as(u64, rolling_window + 1), stats.maxNs());
+    try std.testing.expectEqual(@as(u64, rolling_window + 1), stats.lastNs());
+    try std.testing.expectEqual(@as(u64, (2 + rolling_window + 1) / 2), stats.averageNs());
+}
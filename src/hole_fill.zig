@@ -0,0 +1,246 @@
+//! Pull-Push Hole Filling
+//!
+//! Fills disocclusion holes from a mip pyramid of valid pixels instead of
+//! occlusion_fill.comp's 3x3 neighborhood search, whose large holes fall
+//! back to a 50% blend with the original frame and ghost.
+//!
+//! pullpush_pull.comp builds the pyramid (premultiplied color, cost-derived
+//! weight) from fine to coarse; pullpush_push.comp fills each level from
+//! the next coarser one and finally writes the output frame. That is
+//! 2 * log2(N) small dispatches whatever the hole size, and every hole is
+//! filled from the nearest valid surroundings.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const test_stubs = @import("test_stubs.zig");
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Maximum pyramid levels (8192 pixel frames)
+pub const max_levels: u32 = 14;
+
+/// Pyramid levels for a frame, down to 1x1
+pub fn levelCount(width: u32, height: u32) u32 {
+    var extent = @max(width, height, 1);
+    var levels: u32 = 1;
+    while (extent > 1 and levels < max_levels) : (levels += 1) {
+        extent = (extent + 1) / 2;
+    }
+    return levels;
+}
+
+/// Extent of a pyramid level
+pub fn levelExtent(width: u32, height: u32, level: u32) struct { width: u32, height: u32 } {
+    var w = width;
+    var h = height;
+    for (0..level) |_| {
+        w = @max((w + 1) / 2, 1);
+        h = @max((h + 1) / 2, 1);
+    }
+    return .{ .width = w, .height = h };
+}
+
+/// Push constants for pullpush_pull.comp and pullpush_push.comp
+pub const PullPushConstants = extern struct {
+    /// Pyramid level processed
+    level: u32,
+    /// Cost at which a pixel is a hole
+    occlusion_threshold: f32,
+    /// Bit 0: cost map valid, bit 1: final pass
+    flags: u32,
+    _reserved: u32 = 0,
+};
+
+pub const flag_cost: u32 = 1;
+pub const flag_final: u32 = 2;
+
+/// Pull-push hole fill
+pub const PullPushFill = struct {
+    // Pipelines (optional until created), sharing one layout
+    pull_pipeline: ?vk.VkPipeline = null,
+    push_pipeline: ?vk.VkPipeline = null,
+    pipeline_layout: ?vk.VkPipelineLayout = null,
+
+    /// Per level L: warped frame (0), cost map (1), level L-1 (2), level L
+    /// (3) and level L+1 (4, sampled). Levels are rgba16f images (or views
+    /// of one mipmapped image) sized by levelExtent.
+    level_descriptor_sets: [max_levels]?vk.VkDescriptorSet = [_]?vk.VkDescriptorSet{null} ** max_levels,
+    /// Level 0 set per batch slot, additionally binding the slot's output
+    /// frame (5) for the final pass
+    final_descriptor_sets: [frame_synthesis.max_batch_frames]?vk.VkDescriptorSet = [_]?vk.VkDescriptorSet{null} ** frame_synthesis.max_batch_frames,
+    /// Mipmapped pyramid image, needed only to transition it when its
+    /// memory is aliased (synthesis_graph.zig). Per-level images cannot
+    /// be aliased.
+    pyramid_image: ?vk.VkImage = null,
+
+    // Frame size the pyramid was created for
+    width: u32,
+    height: u32,
+
+    // Dispatch table
+    dispatch: ?*const vk.DeviceDispatch,
+
+    /// Initialize pull-push fill for a frame size
+    pub fn init(width: u32, height: u32, dispatch: ?*const vk.DeviceDispatch) PullPushFill {
+        return .{ .width = width, .height = height, .dispatch = dispatch };
+    }
+
+    /// Check if the fill can run into a batch slot (pipelines and every
+    /// level's descriptor set)
+    pub fn isActive(self: *const PullPushFill, slot: u32) bool {
+        const d = self.dispatch orelse return false;
+        if (!d.hasComputeRecording()) return false;
+        if (self.pull_pipeline == null or self.push_pipeline == null or self.pipeline_layout == null) return false;
+        if (slot >= frame_synthesis.max_batch_frames or self.final_descriptor_sets[slot] == null) return false;
+        for (self.level_descriptor_sets[0..levelCount(self.width, self.height)]) |set| {
+            if (set == null) return false;
+        }
+        return true;
+    }
+
+    /// Record pull and push passes writing the filled frame into a batch
+    /// slot's output. Returns false if not active.
+    ///
+    /// `gate` holds 16x16 group counts over the full frame (zero on scene
+    /// change, see FrameSynthesisContext.tile_gate): the full-resolution
+    /// pull and the final push dispatch through it, so a gated frame
+    /// neither reads the warped frame nor writes the output. Coarser levels
+    /// are a third of the work and always run.
+    pub fn record(
+        self: *const PullPushFill,
+        cmd: vk.VkCommandBuffer,
+        slot: u32,
+        occlusion_threshold: f32,
+        cost_enabled: bool,
+        gate: ?frame_synthesis.DispatchGate,
+    ) bool {
+        if (!self.isActive(slot)) return false;
+        const d = self.dispatch.?;
+        const levels = levelCount(self.width, self.height);
+        const cost_flag: u32 = if (cost_enabled) flag_cost else 0;
+
+        // Pull: fine to coarse
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.pull_pipeline.?);
+        for (0..levels) |l| {
+            const level: u32 = @intCast(l);
+            self.recordLevel(d, cmd, self.level_descriptor_sets[l].?, level, occlusion_threshold, cost_flag, gate);
+        }
+
+        // Push: coarse to fine, level 0 writes the output frame
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.push_pipeline.?);
+        var level = levels - 1;
+        while (level > 0) {
+            level -= 1;
+            const final = level == 0;
+            const set = if (final) self.final_descriptor_sets[slot].? else self.level_descriptor_sets[level].?;
+            self.recordLevel(d, cmd, set, level, occlusion_threshold, cost_flag | (if (final) flag_final else 0), gate);
+        }
+        return true;
+    }
+
+    /// Bind one level's set, dispatch over its extent (level 0 through the
+    /// gate) and make the result visible to the next level
+    fn recordLevel(
+        self: *const PullPushFill,
+        d: *const vk.DeviceDispatch,
+        cmd: vk.VkCommandBuffer,
+        set: vk.VkDescriptorSet,
+        level: u32,
+        occlusion_threshold: f32,
+        flags: u32,
+        gate: ?frame_synthesis.DispatchGate,
+    ) void {
+        const layout = self.pipeline_layout.?;
+        const push = PullPushConstants{
+            .level = level,
+            .occlusion_threshold = occlusion_threshold,
+            .flags = flags,
+        };
+        const sets = [_]vk.VkDescriptorSet{set};
+        if (d.vkCmdBindDescriptorSets) |bind_sets| {
+            bind_sets(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets, 0, null);
+        }
+        d.vkCmdPushConstants.?(cmd, layout, vk.VK_SHADER_STAGE_COMPUTE_BIT, 0, @sizeOf(PullPushConstants), &push);
+
+        const extent = levelExtent(self.width, self.height, level);
+        const gated = if (level == 0) gate else null;
+        if (gated != null and d.vkCmdDispatchIndirect != null) {
+            d.vkCmdDispatchIndirect.?(cmd, gated.?.buffer, gated.?.offset);
+        } else {
+            d.vkCmdDispatch.?(cmd, frame_synthesis.groupCount(extent.width), frame_synthesis.groupCount(extent.height), 1);
+        }
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT,
+        );
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "pyramid levels" {
+    // 1920 -> 960 -> ... -> 1: 12 levels
+    try std.testing.expectEqual(@as(u32, 12), levelCount(1920, 1080));
+    try std.testing.expectEqual(@as(u32, 13), levelCount(3840, 2160));
+    try std.testing.expectEqual(@as(u32, 1), levelCount(1, 1));
+    try std.testing.expectEqual(max_levels, levelCount(1 << 20, 16));
+
+    const l1 = levelExtent(1920, 1080, 1);
+    try std.testing.expectEqual(@as(u32, 960), l1.width);
+    try std.testing.expectEqual(@as(u32, 540), l1.height);
+    const top = levelExtent(1920, 1080, levelCount(1920, 1080) - 1);
+    try std.testing.expectEqual(@as(u32, 1), top.width);
+    try std.testing.expectEqual(@as(u32, 1), top.height);
+
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(PullPushConstants));
+}
+
+test "PullPushFill inactive without resources" {
+    var fill = PullPushFill.init(1920, 1080, null);
+    try std.testing.expect(!fill.isActive(0));
+    try std.testing.expect(!fill.isActive(frame_synthesis.max_batch_frames));
+}
+
+var stub_direct: u32 = 0;
+var stub_indirect: u32 = 0;
+
+fn stubDispatch(_: vk.VkCommandBuffer, _: u32, _: u32, _: u32) callconv(.c) void {
+    stub_direct += 1;
+}
+
+fn stubDispatchIndirect(_: vk.VkCommandBuffer, _: vk.VkBuffer, _: vk.VkDeviceSize) callconv(.c) void {
+    stub_indirect += 1;
+}
+
+test "PullPushFill gates the full-resolution passes" {
+    var d = test_stubs.recording_dispatch;
+    d.vkCmdDispatch = stubDispatch;
+    d.vkCmdDispatchIndirect = stubDispatchIndirect;
+    var fill = PullPushFill.init(64, 64, &d);
+    fill.pull_pipeline = @ptrFromInt(0x10);
+    fill.push_pipeline = @ptrFromInt(0x11);
+    fill.pipeline_layout = @ptrFromInt(0x12);
+    for (0..levelCount(64, 64)) |l| fill.level_descriptor_sets[l] = @ptrFromInt(0x20 + l);
+    fill.final_descriptor_sets[0] = @ptrFromInt(0x40);
+
+    // 7 levels: 7 pulls and 6 pushes, level 0 of each through the gate
+    stub_direct = 0;
+    stub_indirect = 0;
+    try std.testing.expect(fill.record(@ptrFromInt(0x30), 0, 0.5, true, .{ .buffer = @ptrFromInt(0x50), .offset = 48 }));
+    try std.testing.expectEqual(@as(u32, 2), stub_indirect);
+    try std.testing.expectEqual(@as(u32, 11), stub_direct);
+
+    stub_direct = 0;
+    stub_indirect = 0;
+    try std.testing.expect(fill.record(@ptrFromInt(0x30), 0, 0.5, true, null));
+    try std.testing.expectEqual(@as(u32, 0), stub_indirect);
+    try std.testing.expectEqual(@as(u32, 13), stub_direct);
+}
@@ -78,6 +78,8 @@ pub fn main() !void {
     std.debug.print("    nvvk_diagnostics_set_checkpoint()\n", .{});
     std.debug.print("    nvvk_diagnostics_set_tagged_checkpoint()\n", .{});
 
+    printFrameGenMemory();
+
     std.debug.print("\nUsage:\n", .{});
     std.debug.print("  Zig:  const nvvk = @import(\"nvvk\");\n", .{});
     std.debug.print("  C:    #include <nvvk/nvvk_low_latency.h>\n", .{});
@@ -85,3 +87,43 @@ pub fn main() !void {
 
     std.debug.print("\nReady for integration with DXVK/vkd3d-proton!\n", .{});
 }
+
+/// Estimated frame generation VRAM per resolution and mode (2x, RGBA8)
+fn printFrameGenMemory() void {
+    const resolutions = [_][2]u32{ .{ 1920, 1080 }, .{ 2560, 1440 }, .{ 3840, 2160 } };
+    const Row = struct { label: []const u8, mode: nvvk.frame_synthesis.QualityMode, full_frame: bool = false };
+    const rows = [_]Row{
+        .{ .label = "performance", .mode = .performance },
+        .{ .label = "balanced", .mode = .balanced },
+        .{ .label = "quality", .mode = .quality },
+        .{ .label = "quality+pp", .mode = .quality, .full_frame = true },
+    };
+
+    std.debug.print("\nFrame Generation Memory (2x, RGBA8, estimated; pp = splat + pull-push):\n", .{});
+    std.debug.print("  {s:<10} {s:<12} {s:>6} {s:>12} {s:>10} {s:>10}\n", .{ "size", "mode", "images", "dedicated", "arena", "aliased" });
+    for (resolutions) |res| {
+        for (rows) |row| {
+            const f = nvvk.memory_arena.footprint(.{
+                .width = res[0],
+                .height = res[1],
+                .mode = row.mode,
+                .splatting = row.full_frame,
+                .pull_push = row.full_frame,
+            }) catch continue;
+            var size_buf: [16]u8 = undefined;
+            const size = std.fmt.bufPrint(&size_buf, "{d}x{d}", .{ res[0], res[1] }) catch "?";
+            std.debug.print("  {s:<10} {s:<12} {d:>6} {d:>9.1} MiB {d:>6.1} MiB {d:>6.1} MiB\n", .{
+                size,
+                row.label,
+                f.resources,
+                mib(f.dedicated_bytes),
+                mib(f.arena_bytes),
+                mib(f.aliased_bytes),
+            });
+        }
+    }
+}
+
+fn mib(bytes: u64) f64 {
+    return @as(f64, @floatFromInt(bytes)) / (1024.0 * 1024.0);
+}
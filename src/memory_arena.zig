@@ -0,0 +1,509 @@
+//! Device Memory Arena
+//!
+//! Frame generation images (outputs, warp scratch, quality intermediates,
+//! flow and cost maps) each used their own VkDeviceMemory. Dedicated
+//! allocations round every image up to the allocation granularity and,
+//! across dozens of sessions, push against maxMemoryAllocationCount.
+//! MemoryArena places a set of resources in one allocation per memory
+//! type, which is one in practice and two when buffers need another type.
+//!
+//! Placement is linear: largest resource first, each at the lowest aligned
+//! offset that does not overlap a placed resource whose Lifetime
+//! intersects its own. Resources with disjoint lifetimes share memory.
+//! Lifetime.whole (the default) never aliases. Nothing is freed
+//! individually (a resize or mode change plans again), so a buddy
+//! allocator's free lists would buy nothing. replan() places a new set in
+//! an arena's existing blocks when it fits, so shrinking (or resizing back
+//! within the largest size seen) allocates nothing.
+//!
+//! Aliased memory has undefined contents when a resource starts its
+//! lifetime: transition such images from VK_IMAGE_LAYOUT_UNDEFINED.
+//!
+//! footprint() estimates the bytes per resolution and mode, with and
+//! without aliasing the transients of synthesis_graph.zig; nvvk-cli prints
+//! the table.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const output_format = @import("output_format.zig");
+const synthesis_graph = @import("synthesis_graph.zig");
+const test_stubs = @import("test_stubs.zig");
+
+/// Resources per arena
+pub const max_resources = 32;
+
+/// Allocations per arena (memory types)
+pub const max_blocks = 2;
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Range of passes a resource is used in (inclusive)
+pub const Lifetime = struct {
+    first: u16 = 0,
+    last: u16 = std.math.maxInt(u16),
+
+    /// Alive for the whole frame (never aliased)
+    pub const whole = Lifetime{};
+
+    pub fn overlaps(self: Lifetime, other: Lifetime) bool {
+        return self.first <= other.last and other.first <= self.last;
+    }
+};
+
+/// One resource to place
+pub const Request = struct {
+    size: vk.VkDeviceSize,
+    alignment: vk.VkDeviceSize = 1,
+    memory_type_bits: u32 = ~@as(u32, 0),
+    lifetime: Lifetime = .whole,
+
+    pub fn fromRequirements(req: vk.VkMemoryRequirements, lifetime: Lifetime) Request {
+        return .{
+            .size = req.size,
+            .alignment = req.alignment,
+            .memory_type_bits = req.memoryTypeBits,
+            .lifetime = lifetime,
+        };
+    }
+};
+
+pub const PlanOptions = struct {
+    /// Memory types to allocate from (e.g. the DEVICE_LOCAL ones)
+    allowed_types: u32 = ~@as(u32, 0),
+    /// bufferImageGranularity when images and buffers share a block
+    granularity: vk.VkDeviceSize = 1,
+};
+
+/// Where a resource lives
+pub const Placement = struct {
+    block: u8 = 0,
+    offset: vk.VkDeviceSize = 0,
+};
+
+/// One allocation of an arena
+pub const Block = struct {
+    memory_type: u32 = 0,
+    size: vk.VkDeviceSize = 0,
+};
+
+/// Memory layout of a set of resources
+pub const Plan = struct {
+    placements: [max_resources]Placement = [_]Placement{.{}} ** max_resources,
+    count: usize = 0,
+    blocks: [max_blocks]Block = [_]Block{.{}} ** max_blocks,
+    block_count: usize = 0,
+
+    /// Bytes allocated for all blocks
+    pub fn totalBytes(self: *const Plan) vk.VkDeviceSize {
+        var total: vk.VkDeviceSize = 0;
+        for (self.blocks[0..self.block_count]) |b| total += b.size;
+        return total;
+    }
+};
+
+// =============================================================================
+// Planning
+// =============================================================================
+
+/// Place resources in one block per memory type
+pub fn plan(requests: []const Request, options: PlanOptions) !Plan {
+    if (requests.len > max_resources) return error.TooManyResources;
+    var result = Plan{ .count = requests.len };
+
+    for (requests, 0..) |req, i| {
+        const bits = req.memory_type_bits & options.allowed_types;
+        if (bits == 0) return error.NoMemoryType;
+        const memory_type: u32 = @ctz(bits);
+        const block = for (result.blocks[0..result.block_count], 0..) |b, bi| {
+            if (b.memory_type == memory_type) break bi;
+        } else blk: {
+            if (result.block_count == max_blocks) return error.TooManyMemoryTypes;
+            result.blocks[result.block_count] = .{ .memory_type = memory_type };
+            result.block_count += 1;
+            break :blk result.block_count - 1;
+        };
+        result.placements[i].block = @intCast(block);
+    }
+
+    var order: [max_resources]u8 = undefined;
+    for (order[0..requests.len], 0..) |*o, i| o.* = @intCast(i);
+    std.mem.sort(u8, order[0..requests.len], requests, largerFirst);
+
+    var placed = [_]bool{false} ** max_resources;
+    for (order[0..requests.len]) |i| {
+        const req = requests[i];
+        const block = result.placements[i].block;
+        const alignment = @max(req.alignment, options.granularity, 1);
+
+        // Move past conflicting resources until the range is free. Each
+        // move goes to the end of a range the current offset overlaps, so
+        // no lower free offset is skipped.
+        var offset: vk.VkDeviceSize = 0;
+        var moved = true;
+        while (moved) {
+            moved = false;
+            for (0..requests.len) |j| {
+                if (!placed[j] or result.placements[j].block != block) continue;
+                if (!req.lifetime.overlaps(requests[j].lifetime)) continue;
+                const start = result.placements[j].offset;
+                const end = start + requests[j].size;
+                if (offset < end and start < offset + req.size) {
+                    offset = std.mem.alignForward(vk.VkDeviceSize, end, alignment);
+                    moved = true;
+                }
+            }
+        }
+
+        result.placements[i].offset = offset;
+        placed[i] = true;
+        const b = &result.blocks[block];
+        b.size = @max(b.size, offset + req.size);
+    }
+    return result;
+}
+
+fn largerFirst(requests: []const Request, a: u8, b: u8) bool {
+    return requests[a].size > requests[b].size;
+}
+
+// =============================================================================
+// Arena
+// =============================================================================
+
+/// Planned resources backed by one VkDeviceMemory per block
+pub const MemoryArena = struct {
+    dispatch: *const vk.DeviceDispatch,
+    plan: Plan,
+    memory: [max_blocks]?vk.VkDeviceMemory = .{ null, null },
+
+    pub fn init(dispatch: *const vk.DeviceDispatch, requests: []const Request, options: PlanOptions) !MemoryArena {
+        if (!dispatch.hasMemoryAllocation()) return vk.VulkanError.FunctionNotFound;
+        var arena = MemoryArena{ .dispatch = dispatch, .plan = try plan(requests, options) };
+        errdefer arena.deinit();
+
+        for (arena.plan.blocks[0..arena.plan.block_count], 0..) |block, i| {
+            var memory: vk.VkDeviceMemory = undefined;
+            try vk.check(dispatch.vkAllocateMemory.?(dispatch.device, &.{
+                .allocationSize = block.size,
+                .memoryTypeIndex = block.memory_type,
+            }, null, &memory));
+            arena.memory[i] = memory;
+        }
+        return arena;
+    }
+
+    /// Allocation holding a resource (for the *_memory fields)
+    pub fn memoryOf(self: *const MemoryArena, resource: usize) vk.VkDeviceMemory {
+        return self.memory[self.plan.placements[resource].block].?;
+    }
+
+    pub fn offsetOf(self: *const MemoryArena, resource: usize) vk.VkDeviceSize {
+        return self.plan.placements[resource].offset;
+    }
+
+    pub fn bindImage(self: *const MemoryArena, resource: usize, image: vk.VkImage) !void {
+        const d = self.dispatch;
+        try vk.check(d.vkBindImageMemory.?(d.device, image, self.memoryOf(resource), self.offsetOf(resource)));
+    }
+
+    pub fn bindBuffer(self: *const MemoryArena, resource: usize, buffer: vk.VkBuffer) !void {
+        const d = self.dispatch;
+        try vk.check(d.vkBindBufferMemory.?(d.device, buffer, self.memoryOf(resource), self.offsetOf(resource)));
+    }
+
+    /// Place a new set of resources in the existing blocks. Returns false
+    /// (keeping the current plan) when it needs another memory type or a
+    /// larger block. Resources bound under the old plan must no longer be
+    /// in use; bind the new ones with the new placements.
+    pub fn replan(self: *MemoryArena, requests: []const Request, options: PlanOptions) !bool {
+        var next = try plan(requests, options);
+
+        // Block of the arena holding each block of the new plan
+        var mapping: [max_blocks]u8 = undefined;
+        for (next.blocks[0..next.block_count], 0..) |block, i| {
+            mapping[i] = for (self.plan.blocks[0..self.plan.block_count], 0..) |current, bi| {
+                if (current.memory_type == block.memory_type) {
+                    if (block.size > current.size) return false;
+                    break @as(u8, @intCast(bi));
+                }
+            } else return false;
+        }
+        for (next.placements[0..next.count]) |*placement| placement.block = mapping[placement.block];
+        next.blocks = self.plan.blocks;
+        next.block_count = self.plan.block_count;
+        self.plan = next;
+        return true;
+    }
+
+    /// Free the blocks. Resources bound to them must be destroyed first.
+    pub fn deinit(self: *MemoryArena) void {
+        const d = self.dispatch;
+        for (&self.memory) |*memory| {
+            if (memory.*) |m| d.vkFreeMemory.?(d.device, m, null);
+            memory.* = null;
+        }
+    }
+};
+
+/// Request for an existing image (vkGetImageMemoryRequirements)
+pub fn imageRequest(d: *const vk.DeviceDispatch, image: vk.VkImage, lifetime: Lifetime) !Request {
+    const get = d.vkGetImageMemoryRequirements orelse return vk.VulkanError.FunctionNotFound;
+    var req = vk.VkMemoryRequirements{};
+    get(d.device, image, &req);
+    return Request.fromRequirements(req, lifetime);
+}
+
+// =============================================================================
+// Footprint Report
+// =============================================================================
+
+/// Typical optimal-tiling image alignment, used for estimates only; real
+/// plans use the driver's requirements
+pub const estimated_image_alignment: vk.VkDeviceSize = 64 * 1024;
+
+/// Frame generation configuration to estimate
+pub const FootprintConfig = struct {
+    width: u32,
+    height: u32,
+    mode: frame_synthesis.QualityMode,
+    frame_multiplier: u8 = 2,
+    /// Output target sets (output_ring.zig depth; 1 = no ring)
+    output_sets: u8 = 1,
+    output: output_format.OutputFormat = .rgba8,
+    /// Optical flow grid cell size in pixels
+    grid: u32 = 4,
+    /// Forward splat and pull-push fill (quality) active
+    splatting: bool = false,
+    pull_push: bool = false,
+};
+
+/// Frame generation images of a configuration with estimated requirements
+pub const ResourceSet = struct {
+    names: [max_resources][]const u8 = undefined,
+    requests: [max_resources]Request = undefined,
+    count: usize = 0,
+
+    fn add(self: *ResourceSet, name: []const u8, width: u32, height: u32, bytes_per_pixel: u32) void {
+        const bytes = @as(vk.VkDeviceSize, width) * height * bytes_per_pixel;
+        self.addRequest(name, .{
+            .size = std.mem.alignForward(vk.VkDeviceSize, bytes, estimated_image_alignment),
+            .alignment = estimated_image_alignment,
+        });
+    }
+
+    fn addRequest(self: *ResourceSet, name: []const u8, request: Request) void {
+        self.names[self.count] = name;
+        self.requests[self.count] = request;
+        self.count += 1;
+    }
+
+    pub fn slice(self: *const ResourceSet) []const Request {
+        return self.requests[0..self.count];
+    }
+};
+
+/// Images a configuration allocates: one output per generated frame and
+/// output set, the
+/// synthesis transients (warp scratch, quality intermediates, splat and
+/// pull-push resources) with their pass lifetimes and the flow grid maps
+pub fn frameGenResources(config: FootprintConfig) ResourceSet {
+    // Per output set, one name per batch slot
+    const output_names = [_][3][]const u8{
+        .{ "output 0", "output 1", "output 2" },
+        .{ "output 0 (set 1)", "output 1 (set 1)", "output 2 (set 1)" },
+        .{ "output 0 (set 2)", "output 1 (set 2)", "output 2 (set 2)" },
+    };
+    const color_bpp: u32 = switch (config.output) {
+        .rgba8, .rgb10a2 => 4,
+        .rgba16f => 8,
+    };
+    const w = config.width;
+    const h = config.height;
+    const grid_w = (w + config.grid - 1) / config.grid;
+    const grid_h = (h + config.grid - 1) / config.grid;
+
+    var set = ResourceSet{};
+    const outputs = @min(config.frame_multiplier - 1, output_names[0].len);
+    const sets = std.math.clamp(config.output_sets, 1, output_names.len);
+    for (output_names[0..sets]) |names| {
+        for (names[0..outputs]) |name| set.add(name, w, h, color_bpp);
+    }
+    const graph = synthesis_graph.Graph.init(.{
+        .mode = config.mode,
+        .splatting = config.splatting,
+        .pull_push = config.pull_push,
+    });
+    const transients = synthesis_graph.TransientSet.estimate(&graph, w, h, config.output);
+    for (transients.resources[0..transients.count], transients.slice()) |resource, req| {
+        set.addRequest(resource.label(), req);
+    }
+
+    // R16G16 S10.5 flow, R8 cost
+    set.add("forward flow", grid_w, grid_h, 4);
+    if (config.mode == .quality) set.add("backward flow", grid_w, grid_h, 4);
+    if (config.mode != .performance) set.add("cost", grid_w, grid_h, 1);
+    return set;
+}
+
+/// Estimated device memory of a configuration
+pub const Footprint = struct {
+    resources: usize,
+    /// One dedicated allocation per image
+    dedicated_bytes: vk.VkDeviceSize,
+    /// All images in an arena
+    arena_bytes: vk.VkDeviceSize,
+    arena_allocations: usize,
+    /// Arena with transients aliased by lifetime
+    aliased_bytes: vk.VkDeviceSize,
+};
+
+pub fn footprint(config: FootprintConfig) !Footprint {
+    const set = frameGenResources(config);
+    var dedicated: vk.VkDeviceSize = 0;
+    var whole: [max_resources]Request = undefined;
+    for (set.slice(), whole[0..set.count]) |req, *w| {
+        dedicated += req.size;
+        w.* = req;
+        w.lifetime = .whole;
+    }
+    const p = try plan(whole[0..set.count], .{});
+    const aliased = try plan(set.slice(), .{});
+    return .{
+        .resources = set.count,
+        .dedicated_bytes = dedicated,
+        .arena_bytes = p.totalBytes(),
+        .arena_allocations = p.block_count,
+        .aliased_bytes = aliased.totalBytes(),
+    };
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "linear placement respects alignment" {
+    const requests = [_]Request{
+        .{ .size = 100, .alignment = 64 },
+        .{ .size = 300, .alignment = 256 },
+        .{ .size = 50, .alignment = 16 },
+    };
+    const p = try plan(&requests, .{});
+    try std.testing.expectEqual(@as(usize, 1), p.block_count);
+    // Largest first: 300 at 0, 100 at 320, 50 at 432
+    try std.testing.expectEqual(@as(u64, 0), p.placements[1].offset);
+    try std.testing.expectEqual(@as(u64, 320), p.placements[0].offset);
+    try std.testing.expectEqual(@as(u64, 432), p.placements[2].offset);
+    try std.testing.expectEqual(@as(u64, 482), p.totalBytes());
+}
+
+test "disjoint lifetimes alias" {
+    const requests = [_]Request{
+        .{ .size = 1000, .lifetime = .{ .first = 0, .last = 1 } },
+        .{ .size = 800, .lifetime = .{ .first = 2, .last = 3 } },
+        .{ .size = 500, .lifetime = .{ .first = 1, .last = 2 } },
+        .{ .size = 10 },
+    };
+    const p = try plan(&requests, .{});
+    try std.testing.expectEqual(@as(u64, 0), p.placements[0].offset);
+    try std.testing.expectEqual(@as(u64, 0), p.placements[1].offset);
+    // Overlaps both: goes after the larger one
+    try std.testing.expectEqual(@as(u64, 1000), p.placements[2].offset);
+    try std.testing.expectEqual(@as(u64, 1500), p.placements[3].offset);
+    try std.testing.expectEqual(@as(u64, 1510), p.totalBytes());
+}
+
+test "one block per memory type" {
+    const two = [_]Request{
+        .{ .size = 64, .memory_type_bits = 0b0110 },
+        .{ .size = 64, .memory_type_bits = 0b1000 },
+        .{ .size = 64, .memory_type_bits = 0b0010 },
+    };
+    const p = try plan(&two, .{});
+    try std.testing.expectEqual(@as(usize, 2), p.block_count);
+    try std.testing.expectEqual(p.placements[0].block, p.placements[2].block);
+    try std.testing.expectEqual(@as(u64, 128), p.blocks[p.placements[0].block].size);
+
+    const three = [_]Request{
+        .{ .size = 64, .memory_type_bits = 0b001 },
+        .{ .size = 64, .memory_type_bits = 0b010 },
+        .{ .size = 64, .memory_type_bits = 0b100 },
+    };
+    try std.testing.expectError(error.TooManyMemoryTypes, plan(&three, .{}));
+    try std.testing.expectError(error.NoMemoryType, plan(&three, .{ .allowed_types = 0b1000 }));
+}
+
+test "footprint per resolution and mode" {
+    const perf = try footprint(.{ .width = 3840, .height = 2160, .mode = .performance });
+    const quality = try footprint(.{ .width = 3840, .height = 2160, .mode = .quality });
+    try std.testing.expectEqual(@as(usize, 3), perf.resources);
+    try std.testing.expectEqual(@as(usize, 7), quality.resources);
+    try std.testing.expect(quality.arena_bytes > perf.arena_bytes);
+    try std.testing.expect(quality.arena_bytes <= quality.dedicated_bytes);
+    try std.testing.expectEqual(@as(usize, 1), quality.arena_allocations);
+
+    // 4K RGBA8 frame: 33177600 bytes, rounded to 64 KiB
+    const set = frameGenResources(.{ .width = 3840, .height = 2160, .mode = .performance });
+    try std.testing.expectEqual(@as(u64, 33226752), set.requests[0].size);
+
+    const hdr = try footprint(.{ .width = 3840, .height = 2160, .mode = .performance, .output = .rgba16f });
+    try std.testing.expect(hdr.arena_bytes > perf.arena_bytes);
+
+    // Triple-buffered 3x outputs: six output images
+    const ring = try footprint(.{ .width = 3840, .height = 2160, .mode = .performance, .frame_multiplier = 3, .output_sets = 3 });
+    try std.testing.expectEqual(@as(usize, 8), ring.resources);
+}
+
+test "MemoryArena allocates one block per type" {
+    const dispatch = test_stubs.memory_dispatch;
+    test_stubs.allocations = 0;
+    const requests = [_]Request{
+        .{ .size = 4096, .memory_type_bits = 0b10 },
+        .{ .size = 256, .memory_type_bits = 0b11 },
+        .{ .size = 64, .memory_type_bits = 0b100 },
+    };
+    var arena = try MemoryArena.init(&dispatch, &requests, .{ .allowed_types = 0b110 });
+    try std.testing.expectEqual(@as(u32, 2), test_stubs.allocations);
+    try std.testing.expectEqual(arena.memoryOf(0), arena.memoryOf(1));
+    try std.testing.expect(arena.memoryOf(0) != arena.memoryOf(2));
+    try std.testing.expectEqual(@as(u64, 4096), arena.offsetOf(1));
+    try arena.bindImage(0, @ptrFromInt(0x5000));
+    arena.deinit();
+    try std.testing.expectEqual(@as(u32, 0), test_stubs.allocations);
+}
+
+test "MemoryArena replans into its blocks" {
+    const dispatch = test_stubs.memory_dispatch;
+    test_stubs.allocations = 0;
+    const requests = [_]Request{
+        .{ .size = 4096, .memory_type_bits = 0b10 },
+        .{ .size = 64, .memory_type_bits = 0b100 },
+    };
+    var arena = try MemoryArena.init(&dispatch, &requests, .{});
+    defer arena.deinit();
+
+    // Smaller set, blocks in the other order: fits without allocating
+    const smaller = [_]Request{
+        .{ .size = 32, .memory_type_bits = 0b100 },
+        .{ .size = 2048, .memory_type_bits = 0b10 },
+        .{ .size = 1024, .memory_type_bits = 0b10 },
+    };
+    try std.testing.expect(try arena.replan(&smaller, .{}));
+    try std.testing.expectEqual(@as(u32, 2), test_stubs.allocations);
+    try std.testing.expectEqual(arena.memoryOf(1), arena.memoryOf(2));
+    try std.testing.expectEqual(@as(vk.VkDeviceMemory, @ptrFromInt(0x4002)), arena.memoryOf(0));
+    try std.testing.expectEqual(@as(u64, 2048), arena.offsetOf(2));
+    try std.testing.expectEqual(@as(u64, 4096), arena.plan.blocks[arena.plan.placements[1].block].size);
+
+    // Larger, or in a new memory type: the plan is kept
+    try std.testing.expect(!try arena.replan(&.{.{ .size = 8192, .memory_type_bits = 0b10 }}, .{}));
+    try std.testing.expect(!try arena.replan(&.{.{ .size = 16, .memory_type_bits = 0b1 }}, .{}));
+    try std.testing.expectEqual(@as(usize, 3), arena.plan.count);
+}
+
+test "MemoryArena without allocation functions" {
+    const dispatch = vk.DeviceDispatch{ .device = @ptrFromInt(0x1000) };
+    try std.testing.expectError(vk.VulkanError.FunctionNotFound, MemoryArena.init(&dispatch, &.{}, .{}));
+}
@@ -5,15 +5,45 @@
 //!
 //! Motion vectors are in screen-space pixel coordinates, encoded as
 //! signed 16-bit fixed-point (S10.5 format).
+//!
+//! The optical flow grid (4x4 by default) can be upsampled to 2x2 or full
+//! resolution by an edge-aware joint-bilateral pass (mv_upsample.comp)
+//! guided by the frame colors, so warps do not smear motion across edges.
+//!
+//! At high resolutions optical flow can run on a half- or quarter-res luma
+//! copy of each frame (luma_downsample.comp). Vectors then come out in
+//! downsampled pixels; MotionVectorBuffer.vector_scale converts them back
+//! and is folded into every shader's mv_scale constant.
+//!
+//! With hints enabled, the previous forward flow (or engine-supplied
+//! motion vectors) is bound as the hint of the next execution, so the
+//! search starts near the answer and a faster PerformanceLevel reaches the
+//! same cost. Every hint_probe_interval executions one runs unhinted
+//! against a zero hint, so the cost improvement can be measured at runtime.
+//!
+//! With MotionSource.engine, optical flow is skipped entirely: engine motion
+//! vectors (and optional depth) are converted into the MotionVectorBuffer
+//! layout by mv_ingest.comp, which also derives a cost map from motion
+//! spread and depth edges.
+//!
+//! With a MotionVectorRing, optical flow records into its own command buffer
+//! (executeFlow) for the optical flow queue and writes the next ring slot,
+//! so it can run while the previous frame is still being synthesized;
+//! resolveFlow then brings the slot into mv_buffer on the synthesis queue.
 
 const std = @import("std");
 const vk = @import("vulkan.zig");
 const optical_flow = @import("optical_flow.zig");
+const mv_ring = @import("mv_ring.zig");
+const test_stubs = @import("test_stubs.zig");
 
 // =============================================================================
 // Types
 // =============================================================================
 
+/// Format of the downsampled luma flow input (R8_UNORM)
+pub const luma_format: u32 = 9;
+
 /// Motion vector buffer containing flow data
 pub const MotionVectorBuffer = struct {
     /// Forward flow (frame N-1 -> frame N)
@@ -31,9 +61,22 @@ pub const MotionVectorBuffer = struct {
     cost_view: ?vk.VkImageView = null,
     cost_memory: ?vk.VkDeviceMemory = null,
 
+    /// Cost map of the backward flow, optional with backward flow
+    backward_cost: ?vk.VkImage = null,
+    backward_cost_view: ?vk.VkImageView = null,
+    backward_cost_memory: ?vk.VkDeviceMemory = null,
+
     width: u32,
     height: u32,
     grid_size: optical_flow.GridSize,
+
+    /// Full-resolution pixels per flow vector unit (FlowScale divisor)
+    vector_scale: f32 = 1.0,
+
+    /// Scale from an SNORM-sampled vector to full-resolution pixels
+    pub fn mvScale(self: *const MotionVectorBuffer) f32 {
+        return s10_5_snorm_scale * self.vector_scale;
+    }
 };
 
 /// Motion vector extraction context
@@ -47,6 +90,54 @@ pub const MotionVectorContext = struct {
     // Motion vector output buffers
     mv_buffer: ?MotionVectorBuffer,
 
+    // Edge-aware upsampling (optional until created)
+    upsample_pipeline: ?vk.VkPipeline = null,
+    upsample_pipeline_layout: ?vk.VkPipelineLayout = null,
+    // One set per history slot: the guide is the frame bound as flow input
+    upsample_descriptor_sets: [2]?vk.VkDescriptorSet = .{ null, null },
+    // Upsampled forward flow (upsampleDimensions); backward flow and cost
+    // stay on the optical flow grid
+    upsampled_buffer: ?MotionVectorBuffer = null,
+
+    // Reduced-resolution flow input (optional until created)
+    downsample_pipeline: ?vk.VkPipeline = null,
+    downsample_pipeline_layout: ?vk.VkPipelineLayout = null,
+    // Per history slot: frame -> luma image of the same slot
+    downsample_descriptor_sets: [2]?vk.VkDescriptorSet = .{ null, null },
+    // R8 luma images at flowInputDimensions, one per history slot
+    luma_history: [2]?FrameImage = .{ null, null },
+    // Luma slot holds the downsampled copy of the frame in that slot
+    luma_valid: [2]bool = .{ false, false },
+
+    // Flow hints (optional until created)
+    // Copy of the last forward flow, flow grid dimensions and format
+    // (GENERAL layout, TRANSFER_DST usage)
+    hint_image: ?FrameImage = null,
+    // Engine motion vectors at the flow grid (HintSource.external)
+    external_hint_view: ?vk.VkImageView = null,
+    // Zero-filled hint for unhinted executions (probes, cold start)
+    zero_hint_view: ?vk.VkImageView = null,
+    // Session was created with hints (OpticalFlowProperties.supportsFlowHints)
+    hints_supported: bool = false,
+    // hint_image holds flow of the current motion field
+    hint_valid: bool = false,
+    // Every Nth hinted execution runs unhinted (0 = never)
+    hint_probe_interval: u32 = 64,
+    hint_executions: u32 = 0,
+    // How the last execution was hinted
+    last_hint: HintUse = .none,
+
+    // Engine motion ingest (optional until created)
+    ingest_pipeline: ?vk.VkPipeline = null,
+    ingest_pipeline_layout: ?vk.VkPipelineLayout = null,
+    // Engine motion (0), depth (1) and the mv_buffer images (2-4); all
+    // bindings must be valid, unused ones may alias mv_buffer images
+    ingest_descriptor_set: ?vk.VkDescriptorSet = null,
+
+    // Optical flow output ring for a separate flow queue (optional, see
+    // executeFlow)
+    ring: ?mv_ring.MotionVectorRing = null,
+
     // Frame history ring buffer (last 2 frames)
     frame_history: [2]?FrameImage,
     current_frame_idx: u8,
@@ -60,9 +151,12 @@ pub const MotionVectorContext = struct {
     pub const FrameImage = struct {
         image: vk.VkImage,
         view: vk.VkImageView,
-        memory: vk.VkDeviceMemory,
+        // Backing memory, when known (not used by motion estimation)
+        memory: ?vk.VkDeviceMemory = null,
         width: u32,
         height: u32,
+        /// Created with VK_SHARING_MODE_CONCURRENT (async_queue.OwnedImage)
+        concurrent: bool = false,
     };
 
     /// Initialize motion vector context
@@ -84,6 +178,42 @@ pub const MotionVectorContext = struct {
         };
     }
 
+    /// Create the optical flow session for the configuration at the active
+    /// flow scale: bind the luma images and downsample pipeline first for
+    /// reduced-resolution flow. `image_format` is the format of the pushed
+    /// frames. The session is created with hints when hint resources are
+    /// present (zero_hint_view), and at hinted_performance when executions
+    /// will actually be hinted (isHinting), so set the hint image or ring
+    /// first. Replaces an existing session.
+    pub fn createFlowSession(self: *MotionVectorContext, getDeviceProcAddr: vk.PFN_vkGetDeviceProcAddr, image_format: u32) !void {
+        const scale = self.activeFlowScale();
+        const input = flowInputDimensions(self.config.width, self.config.height, scale);
+        const hints = self.config.hint_source != .none and self.zero_hint_view != null;
+
+        const was_supported = self.hints_supported;
+        errdefer self.hints_supported = was_supported;
+        self.hints_supported = hints;
+        const performance = if (self.isHinting())
+            self.config.hinted_performance orelse self.config.performance
+        else
+            self.config.performance;
+
+        const session = try optical_flow.OpticalFlowContext.init(self.device, getDeviceProcAddr, .{
+            .width = input.width,
+            .height = input.height,
+            .image_format = if (scale == .full) image_format else luma_format,
+            .output_grid_size = self.config.grid_size,
+            .hint_grid_size = if (hints) self.config.grid_size else .unknown,
+            .performance_level = performance,
+            .bidirectional = self.config.bidirectional,
+            .enable_cost = self.config.enable_cost,
+            .enable_hint = hints,
+        });
+        if (self.flow_ctx) |*old| old.deinit();
+        self.flow_ctx = session;
+        self.hint_valid = false;
+    }
+
     /// Check if optical flow is supported
     pub fn isSupported(self: *const MotionVectorContext) bool {
         if (self.flow_ctx) |ctx| {
@@ -96,6 +226,7 @@ pub const MotionVectorContext = struct {
     /// Returns true if we have enough frames to compute motion vectors
     pub fn pushFrame(self: *MotionVectorContext, frame: FrameImage) bool {
         self.frame_history[self.current_frame_idx] = frame;
+        self.luma_valid[self.current_frame_idx] = false;
         self.current_frame_idx = (self.current_frame_idx + 1) % 2;
 
         // Need at least 2 frames for motion estimation
@@ -108,6 +239,74 @@ pub const MotionVectorContext = struct {
         self: *MotionVectorContext,
         cmd: vk.VkCommandBuffer,
     ) !void {
+        if (self.config.source == .engine) {
+            if (!self.isIngesting()) return error.NotInitialized;
+            self.recordIngest(cmd);
+            self.recordUpsample(cmd);
+            return;
+        }
+
+        try self.recordFlow(cmd, if (self.mv_buffer) |*mvb| mvb else null);
+
+        // Flow output feeds the compute passes that follow
+        if (self.dispatch) |d| {
+            d.cmdMemoryBarrier(
+                cmd,
+                vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                vk.VK_ACCESS_MEMORY_WRITE_BIT,
+                vk.VK_ACCESS_SHADER_READ_BIT,
+            );
+        }
+
+        self.recordHintCopy(cmd);
+        self.recordUpsample(cmd);
+    }
+
+    /// Record optical flow into the next ring slot, for submission on the
+    /// optical flow queue with the returned FrameSync.flow. Submit the
+    /// synthesis command buffer, starting with resolveFlow, with
+    /// FrameSync.synthesis. With downsampling the flow queue must also
+    /// support compute.
+    pub fn executeFlow(self: *MotionVectorContext, flow_cmd: vk.VkCommandBuffer) !mv_ring.FrameSync {
+        if (!self.isRingActive()) return error.NotInitialized;
+        const ring = &self.ring.?;
+
+        try self.recordFlow(flow_cmd, ring.next());
+
+        // The slot is the next execution's hint
+        self.dispatch.?.cmdMemoryBarrier(
+            flow_cmd,
+            vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            vk.VK_ACCESS_MEMORY_WRITE_BIT,
+            vk.VK_ACCESS_MEMORY_READ_BIT,
+        );
+        if (self.config.hint_source == .previous_flow) self.hint_valid = true;
+        return ring.advance();
+    }
+
+    /// Copy the newest ring slot into mv_buffer and upsample it. Record at
+    /// the start of the synthesis command buffer of the frame.
+    pub fn resolveFlow(self: *MotionVectorContext, cmd: vk.VkCommandBuffer) !void {
+        if (!self.isRingActive()) return error.NotInitialized;
+        const ring = &self.ring.?;
+        if (ring.executions == 0) return error.InsufficientFrames;
+        ring.recordResolve(cmd, &self.mv_buffer.?);
+        self.recordUpsample(cmd);
+    }
+
+    /// Check if optical flow runs on its own queue through the ring
+    /// (configured, semaphores, slots and mv_buffer present)
+    pub fn isRingActive(self: *const MotionVectorContext) bool {
+        if (self.config.source != .optical_flow) return false;
+        const ring = self.ring orelse return false;
+        const d = self.dispatch orelse return false;
+        return d.vkCmdCopyImage != null and ring.isReady() and self.mv_buffer != null;
+    }
+
+    /// Bind the frame pair, `output` and the hint, and record optical flow
+    fn recordFlow(self: *MotionVectorContext, cmd: vk.VkCommandBuffer, output: ?*MotionVectorBuffer) !void {
         const flow = &(self.flow_ctx orelse return error.NotInitialized);
 
         // Get current and previous frame
@@ -115,20 +314,29 @@ pub const MotionVectorContext = struct {
         const prev_frame = self.frame_history[prev_idx] orelse return error.InsufficientFrames;
         const curr_frame = self.frame_history[self.current_frame_idx] orelse return error.InsufficientFrames;
 
-        // Bind input frames
-        try flow.bindImage(
-            .input,
-            curr_frame.view,
-            vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        );
-        try flow.bindImage(
-            .reference,
-            prev_frame.view,
-            vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        );
+        // Bind input frames (downsampled luma at reduced flow resolution)
+        if (self.isDownsampling()) {
+            self.recordDownsample(cmd);
+            try flow.bindImage(.input, self.luma_history[self.current_frame_idx].?.view, vk.VK_IMAGE_LAYOUT_GENERAL);
+            try flow.bindImage(.reference, self.luma_history[prev_idx].?.view, vk.VK_IMAGE_LAYOUT_GENERAL);
+        } else {
+            try flow.bindImage(
+                .input,
+                curr_frame.view,
+                vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            );
+            try flow.bindImage(
+                .reference,
+                prev_frame.view,
+                vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            );
+        }
+        if (output) |mvb| {
+            mvb.vector_scale = self.activeFlowScale().vectorScale();
+        }
 
         // Bind output
-        if (self.mv_buffer) |mvb| {
+        if (output) |mvb| {
             try flow.bindImage(
                 .flow_vector,
                 mvb.forward_view,
@@ -142,6 +350,13 @@ pub const MotionVectorContext = struct {
                     bv,
                     vk.VK_IMAGE_LAYOUT_GENERAL,
                 );
+                if (mvb.backward_cost_view) |bcv| {
+                    try flow.bindImage(
+                        .backward_cost,
+                        bcv,
+                        vk.VK_IMAGE_LAYOUT_GENERAL,
+                    );
+                }
             }
 
             // Bind cost map if enabled
@@ -154,12 +369,84 @@ pub const MotionVectorContext = struct {
             }
         }
 
+        // Bind hint (always bound once the session was created with hints)
+        if (self.selectHint()) |hint_view| {
+            try flow.bindImage(.hint, hint_view, vk.VK_IMAGE_LAYOUT_GENERAL);
+        }
+
         // Execute optical flow
-        flow.execute(cmd, null, .{});
+        flow.execute(cmd, null, .{ .disable_temporal_hints = !self.config.temporal_hints });
+    }
+
+    /// Check if executions are hinted (configured, session and resources
+    /// present)
+    pub fn isHinting(self: *const MotionVectorContext) bool {
+        if (!self.hints_supported or self.zero_hint_view == null) return false;
+        return switch (self.config.hint_source) {
+            .none => false,
+            .previous_flow => blk: {
+                // Ring slots hold the previous flow already
+                if (self.isRingActive()) break :blk true;
+                const d = self.dispatch orelse break :blk false;
+                break :blk d.vkCmdCopyImage != null and self.hint_image != null and self.mv_buffer != null;
+            },
+            // The engine may skip frames; those run against the zero hint
+            .external => true,
+        };
+    }
+
+    /// Drop the previous flow hint (scene cut, flow resolution change)
+    pub fn invalidateHint(self: *MotionVectorContext) void {
+        self.hint_valid = false;
+    }
+
+    /// Check if engine motion ingest can run (configured, pipeline and
+    /// output present)
+    pub fn isIngesting(self: *const MotionVectorContext) bool {
+        if (self.config.source != .engine) return false;
+        const d = self.dispatch orelse return false;
+        if (!d.hasComputeRecording()) return false;
+        if (self.ingest_pipeline == null or self.ingest_pipeline_layout == null) return false;
+        return self.ingest_descriptor_set != null and self.mv_buffer != null;
+    }
+
+    /// Check if optical flow runs on downsampled luma (configured, pipeline
+    /// and luma images present)
+    pub fn isDownsampling(self: *const MotionVectorContext) bool {
+        if (self.config.flow_scale == .full) return false;
+        const d = self.dispatch orelse return false;
+        if (!d.hasComputeRecording()) return false;
+        if (self.downsample_pipeline == null or self.downsample_pipeline_layout == null) return false;
+        for (self.downsample_descriptor_sets, self.luma_history) |set, luma| {
+            if (set == null or luma == null) return false;
+        }
+        return true;
+    }
+
+    /// Flow scale in effect (full when downsampling is not available)
+    pub fn activeFlowScale(self: *const MotionVectorContext) FlowScale {
+        return if (self.isDownsampling()) self.config.flow_scale else .full;
+    }
+
+    /// Check if edge-aware upsampling runs (configured, pipeline and
+    /// resources present)
+    pub fn isUpsampling(self: *const MotionVectorContext) bool {
+        if (self.config.upsample == .none) return false;
+        const d = self.dispatch orelse return false;
+        if (!d.hasComputeRecording()) return false;
+        if (self.upsample_pipeline == null or self.upsample_pipeline_layout == null) return false;
+        if (self.upsample_descriptor_sets[self.current_frame_idx] == null) return false;
+        return self.mv_buffer != null and self.upsampled_buffer != null;
     }
 
-    /// Get the computed motion vectors
+    /// Get the computed motion vectors (upsampled when enabled)
     pub fn getMotionVectors(self: *const MotionVectorContext) ?*const MotionVectorBuffer {
+        if (self.isUpsampling()) return &self.upsampled_buffer.?;
+        return self.getFlowGrid();
+    }
+
+    /// Get the motion vectors on the optical flow grid (statistics passes)
+    pub fn getFlowGrid(self: *const MotionVectorContext) ?*const MotionVectorBuffer {
         return if (self.mv_buffer) |*mvb| mvb else null;
     }
 
@@ -179,8 +466,317 @@ pub const MotionVectorContext = struct {
         if (self.flow_ctx) |*ctx| {
             ctx.deinit();
         }
+        if (self.ring) |*ring| {
+            ring.deinit();
+        }
         // Note: Caller is responsible for destroying images/memory
     }
+
+    /// Downsample every history slot whose luma copy is out of date (the
+    /// newly pushed frame in steady state)
+    fn recordDownsample(self: *MotionVectorContext, cmd: vk.VkCommandBuffer) void {
+        const d = self.dispatch.?;
+        const layout = self.downsample_pipeline_layout.?;
+        const push = DownsamplePushConstants{ .scale = self.config.flow_scale.divisor() };
+
+        var recorded = false;
+        for (0..2) |slot| {
+            if (self.luma_valid[slot] or self.frame_history[slot] == null) continue;
+            const luma = self.luma_history[slot].?;
+
+            const sets = [_]vk.VkDescriptorSet{self.downsample_descriptor_sets[slot].?};
+            d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.downsample_pipeline.?);
+            if (d.vkCmdBindDescriptorSets) |bind_sets| {
+                bind_sets(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets, 0, null);
+            }
+            d.vkCmdPushConstants.?(cmd, layout, vk.VK_SHADER_STAGE_COMPUTE_BIT, 0, @sizeOf(DownsamplePushConstants), &push);
+            d.vkCmdDispatch.?(cmd, (luma.width + 15) / 16, (luma.height + 15) / 16, 1);
+
+            self.luma_valid[slot] = true;
+            recorded = true;
+        }
+
+        // Luma feeds optical flow
+        if (recorded) {
+            d.cmdMemoryBarrier(
+                cmd,
+                vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                vk.VK_ACCESS_SHADER_WRITE_BIT,
+                vk.VK_ACCESS_MEMORY_READ_BIT,
+            );
+        }
+    }
+
+    /// Convert engine motion vectors into mv_buffer
+    fn recordIngest(self: *MotionVectorContext, cmd: vk.VkCommandBuffer) void {
+        const d = self.dispatch.?;
+        const layout = self.ingest_pipeline_layout.?;
+        const mvb = &self.mv_buffer.?;
+        const engine = self.config.engine_motion;
+
+        // Engine vectors are scaled to full-resolution pixels
+        mvb.vector_scale = 1.0;
+        self.last_hint = .none;
+
+        const scale = engine.scale(self.config.width, self.config.height);
+        const push = IngestPushConstants{
+            .scale_x = scale.x,
+            .scale_y = scale.y,
+            .spread_cost = engine.spread_cost,
+            .depth_edge_cost = engine.depth_edge_cost,
+            .flags = engine.ingestFlags(mvb.backward_view != null, mvb.cost_view != null),
+        };
+        const sets = [_]vk.VkDescriptorSet{self.ingest_descriptor_set.?};
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.ingest_pipeline.?);
+        if (d.vkCmdBindDescriptorSets) |bind_sets| {
+            bind_sets(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets, 0, null);
+        }
+        d.vkCmdPushConstants.?(cmd, layout, vk.VK_SHADER_STAGE_COMPUTE_BIT, 0, @sizeOf(IngestPushConstants), &push);
+        d.vkCmdDispatch.?(cmd, (mvb.width + 15) / 16, (mvb.height + 15) / 16, 1);
+
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT,
+        );
+    }
+
+    /// Pick the hint view for this execution and record how it was hinted
+    fn selectHint(self: *MotionVectorContext) ?vk.VkImageView {
+        if (!self.isHinting()) {
+            self.last_hint = .none;
+            return null;
+        }
+
+        const hint_view: ?vk.VkImageView = switch (self.config.hint_source) {
+            .none => null,
+            .previous_flow => if (!self.hint_valid)
+                null
+            else if (self.isRingActive())
+                if (self.ring.?.current()) |slot| slot.forward_view else null
+            else
+                self.hint_image.?.view,
+            .external => self.external_hint_view,
+        };
+
+        self.hint_executions +%= 1;
+        const probe = self.hint_probe_interval != 0 and self.hint_executions % self.hint_probe_interval == 0;
+        if (hint_view) |view| {
+            if (!probe) {
+                self.last_hint = .hinted;
+                return view;
+            }
+        }
+        self.last_hint = .unhinted;
+        return self.zero_hint_view.?;
+    }
+
+    /// Keep this execution's forward flow as the next execution's hint
+    fn recordHintCopy(self: *MotionVectorContext, cmd: vk.VkCommandBuffer) void {
+        if (self.config.hint_source != .previous_flow or !self.isHinting()) return;
+        if (self.hint_image == null) return;
+        const d = self.dispatch.?;
+        const mvb = self.mv_buffer.?;
+        const hint = self.hint_image.?;
+
+        // Flow output written, and the old hint read, by optical flow
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_ACCESS_MEMORY_WRITE_BIT,
+            vk.VK_ACCESS_TRANSFER_READ_BIT | vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+        );
+        const region = vk.VkImageCopy{
+            .extent = .{ .width = @min(mvb.width, hint.width), .height = @min(mvb.height, hint.height) },
+        };
+        d.vkCmdCopyImage.?(cmd, mvb.forward, vk.VK_IMAGE_LAYOUT_GENERAL, hint.image, vk.VK_IMAGE_LAYOUT_GENERAL, 1, @ptrCast(&region));
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            vk.VK_ACCESS_MEMORY_READ_BIT,
+        );
+        self.hint_valid = true;
+    }
+
+    fn recordUpsample(self: *MotionVectorContext, cmd: vk.VkCommandBuffer) void {
+        if (!self.isUpsampling()) return;
+        const d = self.dispatch.?;
+        const layout = self.upsample_pipeline_layout.?;
+        const grid = self.mv_buffer.?;
+        const up = &self.upsampled_buffer.?;
+
+        // Backward flow and cost are shared with the grid
+        up.vector_scale = grid.vector_scale;
+        up.backward = grid.backward;
+        up.backward_view = grid.backward_view;
+        up.backward_memory = grid.backward_memory;
+        up.cost = grid.cost;
+        up.cost_view = grid.cost_view;
+        up.cost_memory = grid.cost_memory;
+        up.backward_cost = grid.backward_cost;
+        up.backward_cost_view = grid.backward_cost_view;
+        up.backward_cost_memory = grid.backward_cost_memory;
+
+        const push = UpsamplePushConstants{
+            .sigma_spatial = self.config.upsample_sigma_spatial,
+            .sigma_range = self.config.upsample_sigma_range,
+            .cost_scale = 0.004,
+            .flags = if (grid.cost_view != null) 1 else 0,
+        };
+        const sets = [_]vk.VkDescriptorSet{self.upsample_descriptor_sets[self.current_frame_idx].?};
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.upsample_pipeline.?);
+        if (d.vkCmdBindDescriptorSets) |bind_sets| {
+            bind_sets(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets, 0, null);
+        }
+        d.vkCmdPushConstants.?(cmd, layout, vk.VK_SHADER_STAGE_COMPUTE_BIT, 0, @sizeOf(UpsamplePushConstants), &push);
+        d.vkCmdDispatch.?(cmd, (up.width + 15) / 16, (up.height + 15) / 16, 1);
+
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT,
+        );
+    }
+};
+
+/// Source of the motion field
+pub const MotionSource = enum {
+    /// VK_NV_optical_flow between consecutive frames
+    optical_flow,
+    /// Engine motion vectors (and optional depth), see EngineMotionFormat
+    engine,
+};
+
+/// Engine motion vector encoding
+pub const EngineMotionFormat = struct {
+    /// Vectors in pixels of the motion vector image (false = UV units)
+    pixels: bool = true,
+    /// Vectors point from the current to the previous position (DLSS/FSR
+    /// convention); flow points from previous to current
+    points_to_previous: bool = true,
+    /// Motion vector image size (render resolution), 0 = frame size
+    width: u32 = 0,
+    height: u32 = 0,
+    /// Depth image bound at ingest binding 1
+    has_depth: bool = false,
+    /// Depth 1.0 is nearest
+    reversed_z: bool = false,
+    /// Cost per pixel of motion spread in the 3x3 neighborhood
+    spread_cost: f32 = 32.0,
+    /// Cost per unit of depth range in the 3x3 neighborhood
+    depth_edge_cost: f32 = 1000.0,
+
+    /// Scale from engine units to full-resolution flow pixels
+    pub fn scale(self: EngineMotionFormat, frame_width: u32, frame_height: u32) struct { x: f32, y: f32 } {
+        const sign: f32 = if (self.points_to_previous) -1.0 else 1.0;
+        const fw: f32 = @floatFromInt(frame_width);
+        const fh: f32 = @floatFromInt(frame_height);
+        if (!self.pixels) return .{ .x = sign * fw, .y = sign * fh };
+
+        const mw: f32 = @floatFromInt(if (self.width == 0) frame_width else self.width);
+        const mh: f32 = @floatFromInt(if (self.height == 0) frame_height else self.height);
+        return .{ .x = sign * fw / mw, .y = sign * fh / mh };
+    }
+
+    /// mv_ingest.comp flags
+    pub fn ingestFlags(self: EngineMotionFormat, backward: bool, cost: bool) u32 {
+        var flags: u32 = 0;
+        if (self.has_depth) flags |= 1;
+        if (self.reversed_z) flags |= 2;
+        if (backward) flags |= 4;
+        if (cost) flags |= 8;
+        return flags;
+    }
+};
+
+/// Push constants for mv_ingest.comp
+pub const IngestPushConstants = extern struct {
+    /// Engine units -> flow pixels (sign included)
+    scale_x: f32,
+    scale_y: f32,
+    spread_cost: f32,
+    depth_edge_cost: f32,
+    /// Bit 0: depth, bit 1: reversed Z, bit 2: backward, bit 3: cost
+    flags: u32,
+    _reserved: [3]u32 = .{ 0, 0, 0 },
+};
+
+/// Source of the optical flow hint
+pub const HintSource = enum {
+    /// No hint
+    none,
+    /// Forward flow of the previous execution
+    previous_flow,
+    /// Engine-supplied motion vectors (external_hint_view)
+    external,
+};
+
+/// How an execution was hinted (for cost comparisons)
+pub const HintUse = enum {
+    /// Hints not active
+    none,
+    /// Real hint bound
+    hinted,
+    /// Zero hint bound (probe, or no hint available yet)
+    unhinted,
+};
+
+/// Optical flow input resolution
+pub const FlowScale = enum {
+    full,
+    half,
+    quarter,
+
+    /// Downsample factor per axis
+    pub fn divisor(self: FlowScale) u32 {
+        return switch (self) {
+            .full => 1,
+            .half => 2,
+            .quarter => 4,
+        };
+    }
+
+    /// Full-resolution pixels per flow vector unit
+    pub fn vectorScale(self: FlowScale) f32 {
+        return @floatFromInt(self.divisor());
+    }
+};
+
+/// Push constants for luma_downsample.comp
+pub const DownsamplePushConstants = extern struct {
+    /// Downsample factor (2 or 4)
+    scale: u32,
+    _reserved: [3]u32 = .{ 0, 0, 0 },
+};
+
+/// Edge-aware upsampling target for the optical flow grid
+pub const UpsampleTarget = enum {
+    /// Warp from the optical flow grid directly (bilinear)
+    none,
+    /// One vector per 2x2 pixels
+    grid_2x2,
+    /// One vector per pixel
+    full,
+};
+
+/// Push constants for mv_upsample.comp
+pub const UpsamplePushConstants = extern struct {
+    /// Spatial falloff in coarse grid samples
+    sigma_spatial: f32,
+    /// Guide color falloff
+    sigma_range: f32,
+    /// Cost -> weight scale
+    cost_scale: f32,
+    /// Bit 0: cost map valid
+    flags: u32,
 };
 
 /// Configuration for motion vector extraction
@@ -189,8 +785,31 @@ pub const MotionVectorConfig = struct {
     height: u32,
     grid_size: optical_flow.GridSize = .@"4x4",
     performance: optical_flow.PerformanceLevel = .fast,
+    /// Session performance level when executions are hinted (null =
+    /// performance), see createFlowSession
+    hinted_performance: ?optical_flow.PerformanceLevel = null,
     bidirectional: bool = false,
     enable_cost: bool = false,
+    /// Optical flow input resolution (luma images and flow grid are sized
+    /// from flowInputDimensions)
+    flow_scale: FlowScale = .full,
+    /// Edge-aware upsampling of the flow grid before warping
+    upsample: UpsampleTarget = .none,
+    /// Joint-bilateral spatial falloff (coarse grid samples)
+    upsample_sigma_spatial: f32 = 1.0,
+    /// Joint-bilateral color falloff
+    upsample_sigma_range: f32 = 0.1,
+    /// Optical flow hint (session must be created with enable_hint and
+    /// hint_grid_size = grid_size)
+    hint_source: HintSource = .none,
+    /// Let the driver also use its own temporal hints
+    /// (ExecuteFlags.disable_temporal_hints when false)
+    temporal_hints: bool = true,
+    /// Motion field source; with .engine the optical flow settings above
+    /// are unused and mv_ingest.comp writes mv_buffer, still sized from
+    /// grid_size (1x1 for per-pixel engine vectors)
+    source: MotionSource = .optical_flow,
+    engine_motion: EngineMotionFormat = .{},
 };
 
 // =============================================================================
@@ -217,6 +836,30 @@ pub fn calculateMVDimensions(
     };
 }
 
+/// Optical flow input dimensions for a flow scale
+pub fn flowInputDimensions(width: u32, height: u32, scale: FlowScale) struct { width: u32, height: u32 } {
+    const divisor = scale.divisor();
+    return .{
+        .width = (width + divisor - 1) / divisor,
+        .height = (height + divisor - 1) / divisor,
+    };
+}
+
+/// Upsampled flow dimensions for a target (grid dimensions for .none)
+pub fn upsampleDimensions(
+    width: u32,
+    height: u32,
+    grid_size: optical_flow.GridSize,
+    target: UpsampleTarget,
+) struct { width: u32, height: u32 } {
+    const dims = calculateMVDimensions(width, height, switch (target) {
+        .none => grid_size,
+        .grid_2x2 => .@"2x2",
+        .full => .@"1x1",
+    });
+    return .{ .width = dims.width, .height = dims.height };
+}
+
 /// Convert S10.5 fixed-point to float
 pub fn s10_5ToFloat(value: i16) f32 {
     return @as(f32, @floatFromInt(value)) / 32.0;
@@ -227,6 +870,9 @@ pub fn floatToS10_5(value: f32) i16 {
     return @intFromFloat(value * 32.0);
 }
 
+/// Scale from an S10.5 flow vector sampled through an SNORM view to pixels
+pub const s10_5_snorm_scale: f32 = 32767.0 / 32.0;
+
 // =============================================================================
 // Tests
 // =============================================================================
@@ -256,6 +902,10 @@ test "s10_5 conversion" {
     // Round trip
     try std.testing.expectEqual(@as(i16, 32), floatToS10_5(1.0));
     try std.testing.expectEqual(@as(i16, -32), floatToS10_5(-1.0));
+
+    // SNORM-sampled S10.5 back to pixels
+    const snorm: f32 = @as(f32, 32.0) / 32767.0;
+    try std.testing.expectApproxEqRel(@as(f32, 1.0), snorm * s10_5_snorm_scale, 0.001);
 }
 
 test "MotionVectorConfig defaults" {
@@ -267,4 +917,170 @@ test "MotionVectorConfig defaults" {
     try std.testing.expectEqual(optical_flow.PerformanceLevel.fast, config.performance);
     try std.testing.expect(!config.bidirectional);
     try std.testing.expect(!config.enable_cost);
+    try std.testing.expectEqual(UpsampleTarget.none, config.upsample);
+}
+
+test "FlowScale" {
+    try std.testing.expectEqual(@as(u32, 2), FlowScale.half.divisor());
+    try std.testing.expectApproxEqRel(@as(f32, 4.0), FlowScale.quarter.vectorScale(), 0.001);
+
+    // 4K half resolution: 1920x1080 luma, 480x270 flow grid
+    const input = flowInputDimensions(3840, 2160, .half);
+    try std.testing.expectEqual(@as(u32, 1920), input.width);
+    try std.testing.expectEqual(@as(u32, 1080), input.height);
+    const grid = calculateMVDimensions(input.width, input.height, .@"4x4");
+    try std.testing.expectEqual(@as(u32, 480), grid.width);
+
+    // Half-res vectors cover twice the full-res distance
+    var mvb = test_stubs.motionVectors(0x1);
+    mvb.vector_scale = FlowScale.half.vectorScale();
+    try std.testing.expectApproxEqRel(s10_5_snorm_scale * 2.0, mvb.mvScale(), 0.001);
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(DownsamplePushConstants));
+}
+
+test "upsampleDimensions" {
+    const grid = upsampleDimensions(1920, 1080, .@"4x4", .none);
+    try std.testing.expectEqual(@as(u32, 480), grid.width);
+
+    const half = upsampleDimensions(1920, 1080, .@"4x4", .grid_2x2);
+    try std.testing.expectEqual(@as(u32, 960), half.width);
+    try std.testing.expectEqual(@as(u32, 540), half.height);
+
+    const full = upsampleDimensions(1920, 1080, .@"4x4", .full);
+    try std.testing.expectEqual(@as(u32, 1920), full.width);
+    try std.testing.expectEqual(@as(u32, 1080), full.height);
+
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(UpsamplePushConstants));
+}
+
+test "MotionVectorContext upsampling inactive without resources" {
+    var ctx = MotionVectorContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .upsample = .full,
+    }, null, std.testing.allocator);
+    try std.testing.expect(!ctx.isUpsampling());
+    try std.testing.expect(ctx.getMotionVectors() == null);
+
+    ctx.mv_buffer = test_stubs.motionVectors(0x1);
+    // Falls back to the flow grid
+    try std.testing.expectEqual(@as(u32, 480), ctx.getMotionVectors().?.width);
+}
+
+test "EngineMotionFormat" {
+    // DLSS convention: render-res pixels pointing to the previous position
+    const dlss = EngineMotionFormat{ .width = 1280, .height = 720 };
+    const s = dlss.scale(1920, 1080);
+    try std.testing.expectApproxEqRel(@as(f32, -1.5), s.x, 0.001);
+    try std.testing.expectApproxEqRel(@as(f32, -1.5), s.y, 0.001);
+
+    // UV units pointing forward
+    const uv = (EngineMotionFormat{ .pixels = false, .points_to_previous = false }).scale(1920, 1080);
+    try std.testing.expectApproxEqRel(@as(f32, 1920.0), uv.x, 0.001);
+    try std.testing.expectApproxEqRel(@as(f32, 1080.0), uv.y, 0.001);
+
+    const depth = EngineMotionFormat{ .has_depth = true, .reversed_z = true };
+    try std.testing.expectEqual(@as(u32, 0b1011), depth.ingestFlags(false, true));
+    try std.testing.expectEqual(@as(u32, 0b0100), (EngineMotionFormat{}).ingestFlags(true, false));
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(IngestPushConstants));
+}
+
+test "MotionVectorContext engine source skips optical flow" {
+    var ctx = MotionVectorContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .source = .engine,
+    }, null, std.testing.allocator);
+    try std.testing.expect(!ctx.isIngesting());
+    try std.testing.expectError(error.NotInitialized, ctx.execute(@ptrFromInt(0x2000)));
+
+    ctx.config.source = .optical_flow;
+    ctx.ingest_pipeline = @ptrFromInt(0x10);
+    try std.testing.expect(!ctx.isIngesting());
+}
+
+test "MotionVectorContext hint selection" {
+    const dispatch = vk.DeviceDispatch{
+        .device = test_stubs.device,
+        .vkCmdCopyImage = test_stubs.copyImage,
+    };
+
+    var ctx = MotionVectorContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .hint_source = .previous_flow,
+    }, &dispatch, std.testing.allocator);
+    try std.testing.expect(!ctx.isHinting());
+    try std.testing.expect(ctx.selectHint() == null);
+    try std.testing.expectEqual(HintUse.none, ctx.last_hint);
+
+    ctx.hints_supported = true;
+    ctx.zero_hint_view = @ptrFromInt(0x10);
+    ctx.hint_image = .{
+        .image = @ptrFromInt(0x20),
+        .view = @ptrFromInt(0x21),
+        .memory = @ptrFromInt(0x22),
+        .width = 480,
+        .height = 270,
+    };
+    ctx.mv_buffer = test_stubs.motionVectors(0x1);
+    try std.testing.expect(ctx.isHinting());
+
+    // No previous flow yet: zero hint
+    try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x10)), ctx.selectHint().?);
+    try std.testing.expectEqual(HintUse.unhinted, ctx.last_hint);
+
+    ctx.hint_valid = true;
+    ctx.hint_probe_interval = 3;
+    try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x21)), ctx.selectHint().?);
+    try std.testing.expectEqual(HintUse.hinted, ctx.last_hint);
+
+    // Third execution is a probe
+    try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x10)), ctx.selectHint().?);
+    try std.testing.expectEqual(HintUse.unhinted, ctx.last_hint);
+
+    ctx.invalidateHint();
+    try std.testing.expect(!ctx.hint_valid);
+}
+
+test "MotionVectorContext ring hints from the newest slot" {
+    const dispatch = vk.DeviceDispatch{
+        .device = test_stubs.device,
+        .vkCmdCopyImage = test_stubs.copyImage,
+    };
+
+    var ctx = MotionVectorContext.init(@ptrFromInt(0x1000), .{
+        .width = 1920,
+        .height = 1080,
+        .hint_source = .previous_flow,
+    }, &dispatch, std.testing.allocator);
+    ctx.hints_supported = true;
+    ctx.zero_hint_view = @ptrFromInt(0x10);
+    ctx.mv_buffer = test_stubs.motionVectors(0x1);
+    ctx.ring = .{
+        .dispatch = &dispatch,
+        .depth = 2,
+        .flow_timeline = @ptrFromInt(0x30),
+        .consumed_timeline = @ptrFromInt(0x31),
+    };
+    try std.testing.expect(!ctx.isRingActive());
+
+    for (0..2) |i| {
+        const base: usize = 0x40 + 0x10 * i;
+        ctx.ring.?.slots[i] = test_stubs.motionVectors(base);
+    }
+    try std.testing.expect(ctx.isRingActive());
+    // No hint_image copy needed
+    try std.testing.expect(ctx.isHinting());
+    try std.testing.expectError(error.InsufficientFrames, ctx.resolveFlow(@ptrFromInt(0x2000)));
+    try std.testing.expectError(error.NotInitialized, ctx.executeFlow(@ptrFromInt(0x2000)));
+
+    // Second execution pending: hinted by the first slot
+    ctx.ring.?.executions = 1;
+    ctx.hint_valid = true;
+    try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x41)), ctx.selectHint().?);
+    try std.testing.expectEqual(HintUse.hinted, ctx.last_hint);
+
+    ctx.config.source = .engine;
+    try std.testing.expect(!ctx.isRingActive());
 }
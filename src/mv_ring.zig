@@ -0,0 +1,264 @@
+//! Motion Vector Ring
+//!
+//! Optical flow runs on its own hardware engine (the NVOFA) and queue. With
+//! a single mv_buffer, frame N+1's flow has to wait until frame N's
+//! synthesis has finished reading the vectors. The ring gives optical flow
+//! `depth` output slots instead, so it can run ahead of synthesis (and of
+//! the game's rendering on the graphics queue).
+//!
+//! Two timeline semaphores order the queues:
+//!   flow_timeline      = N once flow execution N has written its slot
+//!   consumed_timeline  = N once synthesis no longer needs slot of N
+//! Flow N waits for consumed >= N - depth before overwriting the slot;
+//! synthesis N waits for flow >= N.
+//!
+//! Synthesis first copies the newest slot into the context's mv_buffer (one
+//! flow grid, ~2 MB at 4K with 4x4 blocks), so every descriptor set bound to
+//! mv_buffer stays valid and the slot is released as soon as the copy is
+//! done. Slot images are owned by the caller, like mv_buffer; they must be
+//! created with VK_SHARING_MODE_CONCURRENT across the optical flow and
+//! synthesis queue families, in GENERAL layout with TRANSFER_SRC usage.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const motion_vectors = @import("motion_vectors.zig");
+const test_stubs = @import("test_stubs.zig");
+
+const MotionVectorBuffer = motion_vectors.MotionVectorBuffer;
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Deepest supported ring
+pub const max_depth = 3;
+
+/// Timeline semaphore value to wait on or signal
+pub const TimelineValue = struct {
+    semaphore: vk.VkSemaphore,
+    value: u64,
+};
+
+/// Timeline values of one queue submission (VkTimelineSemaphoreSubmitInfo)
+pub const SubmitSync = struct {
+    /// Null when there is nothing to wait for yet
+    wait: ?TimelineValue = null,
+    signal: TimelineValue,
+};
+
+/// Submissions of one flow execution: the optical flow command buffer and
+/// the synthesis command buffer that resolves it
+pub const FrameSync = struct {
+    flow: SubmitSync,
+    synthesis: SubmitSync,
+};
+
+/// Ring of optical flow outputs shared between the flow and synthesis queues
+pub const MotionVectorRing = struct {
+    dispatch: *const vk.DeviceDispatch,
+    // Flow output slots (caller-owned images, see module docs)
+    slots: [max_depth]?MotionVectorBuffer = .{null} ** max_depth,
+    // Slots in use (2 = double buffering)
+    depth: u32,
+    flow_timeline: vk.VkSemaphore,
+    consumed_timeline: vk.VkSemaphore,
+    // Flow executions recorded so far; execution N signals value N
+    executions: u64 = 0,
+
+    pub fn init(dispatch: *const vk.DeviceDispatch, depth: u32) !MotionVectorRing {
+        if (depth < 2 or depth > max_depth) return error.InvalidDepth;
+        if (!dispatch.hasTimelineSemaphores()) return vk.VulkanError.FunctionNotFound;
+
+        const flow_timeline = try createTimeline(dispatch);
+        errdefer dispatch.vkDestroySemaphore.?(dispatch.device, flow_timeline, null);
+        const consumed_timeline = try createTimeline(dispatch);
+        return .{
+            .dispatch = dispatch,
+            .depth = depth,
+            .flow_timeline = flow_timeline,
+            .consumed_timeline = consumed_timeline,
+        };
+    }
+
+    /// Destroy the semaphores. Both queues must be idle.
+    pub fn deinit(self: *MotionVectorRing) void {
+        const d = self.dispatch;
+        d.vkDestroySemaphore.?(d.device, self.flow_timeline, null);
+        d.vkDestroySemaphore.?(d.device, self.consumed_timeline, null);
+        // Note: Caller is responsible for destroying slot images/memory
+    }
+
+    /// Check if all `depth` slots are present
+    pub fn isReady(self: *const MotionVectorRing) bool {
+        for (self.slots[0..self.depth]) |slot| {
+            if (slot == null) return false;
+        }
+        return true;
+    }
+
+    /// Slot the next flow execution writes
+    pub fn next(self: *MotionVectorRing) *MotionVectorBuffer {
+        return self.slotFor(self.executions + 1);
+    }
+
+    /// Commit the next flow execution; returns its submissions
+    pub fn advance(self: *MotionVectorRing) FrameSync {
+        self.executions += 1;
+        return self.sync(self.executions);
+    }
+
+    /// Newest slot written by optical flow
+    pub fn current(self: *MotionVectorRing) ?*MotionVectorBuffer {
+        if (self.executions == 0) return null;
+        return self.slotFor(self.executions);
+    }
+
+    /// Timeline values of flow execution n
+    pub fn sync(self: *const MotionVectorRing, n: u64) FrameSync {
+        return .{
+            .flow = .{
+                // The slot was last written by execution n - depth
+                .wait = if (n > self.depth)
+                    .{ .semaphore = self.consumed_timeline, .value = n - self.depth }
+                else
+                    null,
+                .signal = .{ .semaphore = self.flow_timeline, .value = n },
+            },
+            .synthesis = .{
+                .wait = .{ .semaphore = self.flow_timeline, .value = n },
+                .signal = .{ .semaphore = self.consumed_timeline, .value = n },
+            },
+        };
+    }
+
+    /// Copy the newest slot into `dst` (synthesis queue, after waiting on
+    /// FrameSync.synthesis). Both are in GENERAL layout.
+    pub fn recordResolve(self: *MotionVectorRing, cmd: vk.VkCommandBuffer, dst: *MotionVectorBuffer) void {
+        const src = self.current() orelse return;
+        const d = self.dispatch;
+        const copy = d.vkCmdCopyImage orelse return;
+
+        // The previous frame's passes are done reading dst
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_ACCESS_MEMORY_READ_BIT,
+            vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+        );
+        const region = vk.VkImageCopy{
+            .extent = .{ .width = @min(src.width, dst.width), .height = @min(src.height, dst.height) },
+        };
+        copy(cmd, src.forward, vk.VK_IMAGE_LAYOUT_GENERAL, dst.forward, vk.VK_IMAGE_LAYOUT_GENERAL, 1, @ptrCast(&region));
+        if (src.backward) |b| {
+            if (dst.backward) |db| copy(cmd, b, vk.VK_IMAGE_LAYOUT_GENERAL, db, vk.VK_IMAGE_LAYOUT_GENERAL, 1, @ptrCast(&region));
+        }
+        if (src.cost) |c| {
+            if (dst.cost) |dc| copy(cmd, c, vk.VK_IMAGE_LAYOUT_GENERAL, dc, vk.VK_IMAGE_LAYOUT_GENERAL, 1, @ptrCast(&region));
+        }
+        dst.vector_scale = src.vector_scale;
+
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            vk.VK_ACCESS_MEMORY_READ_BIT,
+        );
+    }
+
+    /// Flow executions the GPU has completed
+    pub fn completedFlow(self: *const MotionVectorRing) !u64 {
+        return self.counterValue(self.flow_timeline);
+    }
+
+    /// Flow executions synthesis has released
+    pub fn completedSynthesis(self: *const MotionVectorRing) !u64 {
+        return self.counterValue(self.consumed_timeline);
+    }
+
+    fn slotFor(self: *MotionVectorRing, n: u64) *MotionVectorBuffer {
+        const index: usize = @intCast((n - 1) % self.depth);
+        return &self.slots[index].?;
+    }
+
+    fn counterValue(self: *const MotionVectorRing, semaphore: vk.VkSemaphore) !u64 {
+        var value: u64 = 0;
+        try vk.check(self.dispatch.vkGetSemaphoreCounterValue.?(self.dispatch.device, semaphore, &value));
+        return value;
+    }
+
+    fn createTimeline(dispatch: *const vk.DeviceDispatch) !vk.VkSemaphore {
+        const type_info = vk.VkSemaphoreTypeCreateInfo{};
+        var semaphore: vk.VkSemaphore = undefined;
+        try vk.check(dispatch.vkCreateSemaphore.?(dispatch.device, &.{ .pNext = &type_info }, null, &semaphore));
+        return semaphore;
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+var stub_copies: u32 = 0;
+
+fn stubCopyImage(_: vk.VkCommandBuffer, _: vk.VkImage, _: u32, _: vk.VkImage, _: u32, _: u32, _: [*]const vk.VkImageCopy) callconv(.c) void {
+    stub_copies += 1;
+}
+
+const stub_dispatch = blk: {
+    var d = test_stubs.timeline_dispatch;
+    d.vkCmdCopyImage = stubCopyImage;
+    break :blk d;
+};
+
+test "MotionVectorRing timeline values" {
+    var ring = try MotionVectorRing.init(&stub_dispatch, 2);
+    defer ring.deinit();
+    try std.testing.expect(!ring.isReady());
+    ring.slots[0] = test_stubs.motionVectors(0x100);
+    ring.slots[1] = test_stubs.motionVectors(0x200);
+    try std.testing.expect(ring.isReady());
+    try std.testing.expect(ring.current() == null);
+
+    // The first two executions have free slots
+    try std.testing.expectEqual(@as(vk.VkImage, @ptrFromInt(0x100)), ring.next().forward);
+    const first = ring.advance();
+    try std.testing.expect(first.flow.wait == null);
+    try std.testing.expectEqual(@as(u64, 1), first.flow.signal.value);
+    try std.testing.expectEqual(ring.flow_timeline, first.synthesis.wait.?.semaphore);
+    try std.testing.expectEqual(ring.consumed_timeline, first.synthesis.signal.semaphore);
+    try std.testing.expect(ring.advance().flow.wait == null);
+
+    // The third reuses slot 0 once synthesis of execution 1 released it
+    try std.testing.expectEqual(@as(vk.VkImage, @ptrFromInt(0x100)), ring.next().forward);
+    const third = ring.advance();
+    try std.testing.expectEqual(ring.consumed_timeline, third.flow.wait.?.semaphore);
+    try std.testing.expectEqual(@as(u64, 1), third.flow.wait.?.value);
+    try std.testing.expectEqual(@as(u64, 3), third.synthesis.wait.?.value);
+    test_stubs.timeline_value = 7;
+    try std.testing.expectEqual(@as(u64, 7), try ring.completedFlow());
+
+    try std.testing.expectError(error.InvalidDepth, MotionVectorRing.init(&stub_dispatch, max_depth + 1));
+}
+
+test "MotionVectorRing resolve copies the newest slot" {
+    var ring = try MotionVectorRing.init(&stub_dispatch, 3);
+    defer ring.deinit();
+    for (0..3) |i| ring.slots[i] = test_stubs.motionVectors(0x100 * (i + 1));
+    ring.slots[1].?.cost = @ptrFromInt(0x2f0);
+    ring.slots[1].?.vector_scale = 2.0;
+
+    var dst = test_stubs.motionVectors(0x900);
+    dst.cost = @ptrFromInt(0x9f0);
+    stub_copies = 0;
+    ring.recordResolve(@ptrFromInt(0x2000), &dst);
+    try std.testing.expectEqual(@as(u32, 0), stub_copies);
+
+    _ = ring.advance();
+    _ = ring.advance();
+    ring.recordResolve(@ptrFromInt(0x2000), &dst);
+    // Forward and cost; no backward flow in the slot
+    try std.testing.expectEqual(@as(u32, 2), stub_copies);
+    try std.testing.expectApproxEqRel(@as(f32, 2.0), dst.vector_scale, 0.001);
+}
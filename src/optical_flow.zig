@@ -37,6 +37,8 @@ pub const VK_OBJECT_TYPE_OPTICAL_FLOW_SESSION_NV: u32 = 1000464000;
 
 // Format for optical flow output
 pub const VK_FORMAT_R16G16_S10_5_NV: u32 = 1000464000;
+// Format for the cost map
+pub const VK_FORMAT_R8_UINT: u32 = 13;
 
 // =============================================================================
 // Enums and Flags
@@ -67,6 +69,25 @@ pub const PerformanceLevel = enum(u32) {
     slow = 1,
     medium = 2,
     fast = 3,
+
+    /// Next faster level (fast stays fast)
+    pub fn faster(self: PerformanceLevel) PerformanceLevel {
+        return switch (self) {
+            .slow => .medium,
+            .medium, .fast => .fast,
+            .unknown => .unknown,
+        };
+    }
+};
+
+/// Session creation flags
+pub const SessionCreateFlags = packed struct(u32) {
+    enable_hint: bool = false,
+    enable_cost: bool = false,
+    enable_global_flow: bool = false,
+    allow_regions: bool = false,
+    both_directions: bool = false,
+    _padding: u27 = 0,
 };
 
 /// Session binding points
@@ -206,6 +227,42 @@ pub const OpticalFlowContext = struct {
     vkBindOpticalFlowSessionImageNV: ?PFN_vkBindOpticalFlowSessionImageNV,
     vkCmdOpticalFlowExecuteNV: ?PFN_vkCmdOpticalFlowExecuteNV,
 
+    /// Create a session. Flow vectors are R16G16_S10_5 and the cost map
+    /// R8_UINT; `config.image_format` is the format of the bound frames.
+    pub fn init(device: vk.VkDevice, getDeviceProcAddr: vk.PFN_vkGetDeviceProcAddr, config: OpticalFlowConfig) !OpticalFlowContext {
+        const create: ?PFN_vkCreateOpticalFlowSessionNV = @ptrCast(getDeviceProcAddr(device, "vkCreateOpticalFlowSessionNV"));
+        var ctx = OpticalFlowContext{
+            .device = device,
+            .session = undefined,
+            .width = config.width,
+            .height = config.height,
+            .output_grid_size = config.output_grid_size,
+            .performance_level = config.performance_level,
+            .bidirectional = config.bidirectional,
+            .vkDestroyOpticalFlowSessionNV = @ptrCast(getDeviceProcAddr(device, "vkDestroyOpticalFlowSessionNV")),
+            .vkBindOpticalFlowSessionImageNV = @ptrCast(getDeviceProcAddr(device, "vkBindOpticalFlowSessionImageNV")),
+            .vkCmdOpticalFlowExecuteNV = @ptrCast(getDeviceProcAddr(device, "vkCmdOpticalFlowExecuteNV")),
+        };
+        const create_session = create orelse return error.ExtensionNotLoaded;
+        if (ctx.vkDestroyOpticalFlowSessionNV == null or ctx.vkBindOpticalFlowSessionImageNV == null or ctx.vkCmdOpticalFlowExecuteNV == null) {
+            return error.ExtensionNotLoaded;
+        }
+
+        const info = VkOpticalFlowSessionCreateInfoNV{
+            .width = config.width,
+            .height = config.height,
+            .imageFormat = config.image_format,
+            .flowVectorFormat = VK_FORMAT_R16G16_S10_5_NV,
+            .costFormat = if (config.enable_cost) VK_FORMAT_R8_UINT else 0,
+            .outputGridSize = @intFromEnum(config.output_grid_size),
+            .hintGridSize = if (config.enable_hint) @intFromEnum(config.hint_grid_size) else 0,
+            .performanceLevel = @intFromEnum(config.performance_level),
+            .flags = @bitCast(config.sessionFlags()),
+        };
+        try vk.check(@enumFromInt(create_session(device, &info, null, &ctx.session)));
+        return ctx;
+    }
+
     /// Destroy the optical flow session
     pub fn deinit(self: *OpticalFlowContext) void {
         if (self.vkDestroyOpticalFlowSessionNV) |destroy| {
@@ -230,7 +287,7 @@ pub const OpticalFlowContext = struct {
             image_view,
             layout,
         );
-        try vk.check(result);
+        try vk.check(@enumFromInt(result));
     }
 
     /// Execute optical flow estimation
@@ -263,6 +320,17 @@ pub const OpticalFlowConfig = struct {
     bidirectional: bool = false,
     enable_cost: bool = false,
     enable_global_flow: bool = false,
+    enable_hint: bool = false,
+
+    /// Session create flags for this configuration
+    pub fn sessionFlags(self: OpticalFlowConfig) SessionCreateFlags {
+        return .{
+            .enable_hint = self.enable_hint,
+            .enable_cost = self.enable_cost,
+            .enable_global_flow = self.enable_global_flow,
+            .both_directions = self.bidirectional,
+        };
+    }
 };
 
 /// Query optical flow properties for a physical device
@@ -304,6 +372,11 @@ pub const OpticalFlowProperties = struct {
     pub fn supportsHintGridSize(self: OpticalFlowProperties, size: GridSize) bool {
         return (self.supported_hint_grid_sizes & @intFromEnum(size)) != 0;
     }
+
+    /// Check if a flow grid can be fed back as the hint of the next execution
+    pub fn supportsFlowHints(self: OpticalFlowProperties, output_grid_size: GridSize) bool {
+        return self.hint_supported and self.supportsHintGridSize(output_grid_size);
+    }
 };
 
 // =============================================================================
@@ -333,4 +406,21 @@ test "config defaults" {
     };
     try std.testing.expectEqual(GridSize.@"4x4", config.output_grid_size);
     try std.testing.expectEqual(PerformanceLevel.fast, config.performance_level);
+    try std.testing.expectEqual(@as(u32, 0), @as(u32, @bitCast(config.sessionFlags())));
+}
+
+test "session flags" {
+    const config = OpticalFlowConfig{
+        .width = 1920,
+        .height = 1080,
+        .enable_hint = true,
+        .enable_cost = true,
+        .bidirectional = true,
+    };
+    try std.testing.expectEqual(@as(u32, 0b10011), @as(u32, @bitCast(config.sessionFlags())));
+}
+
+test "performance level faster" {
+    try std.testing.expectEqual(PerformanceLevel.medium, PerformanceLevel.slow.faster());
+    try std.testing.expectEqual(PerformanceLevel.fast, PerformanceLevel.fast.faster());
 }
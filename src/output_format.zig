@@ -0,0 +1,397 @@
+//! Output Formats
+//!
+//! Generated frames are written in the swapchain's format class, so HDR10
+//! and scRGB sessions keep their range and precision:
+//! - rgba8: 8-bit SDR (R8G8B8A8 / B8G8R8A8, UNORM or SRGB)
+//! - rgb10a2: A2B10G10R10 / A2R10G10B10, 10-bit SDR or HDR10
+//! - rgba16f: R16G16B16A16_SFLOAT, scRGB
+//!
+//! Storage image formats are fixed when a shader is compiled, so build.zig
+//! builds every frame-writing shader once per format (shaders/color.glsl).
+//! Shaders that mix colors decode the transfer function first (PQ code
+//! values do not average to the average luminance) and re-encode the
+//! result; the transfer is specialization constant 3.
+//!
+//! FormatPipelineCache creates the pipelines of a format on first use and
+//! keeps them, so a swapchain recreated in another format only pays for
+//! pipeline creation the first time.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const shader_variants = @import("shader_variants.zig");
+const tile_classify = @import("tile_classify.zig");
+const synthesis_descriptors = @import("synthesis_descriptors.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const test_stubs = @import("test_stubs.zig");
+
+const PassShader = frame_synthesis.PassShader;
+
+// =============================================================================
+// Types
+// =============================================================================
+
+// Swapchain formats (VkFormat)
+pub const VK_FORMAT_R8G8B8A8_UNORM: u32 = 37;
+pub const VK_FORMAT_R8G8B8A8_SRGB: u32 = 43;
+pub const VK_FORMAT_B8G8R8A8_UNORM: u32 = 44;
+pub const VK_FORMAT_B8G8R8A8_SRGB: u32 = 50;
+pub const VK_FORMAT_A2R10G10B10_UNORM_PACK32: u32 = 58;
+pub const VK_FORMAT_A2B10G10R10_UNORM_PACK32: u32 = 64;
+pub const VK_FORMAT_R16G16B16A16_SFLOAT: u32 = 97;
+
+// Swapchain color spaces (VkColorSpaceKHR)
+pub const VK_COLOR_SPACE_SRGB_NONLINEAR_KHR: u32 = 0;
+pub const VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT: u32 = 1000104002;
+pub const VK_COLOR_SPACE_HDR10_ST2084_EXT: u32 = 1000104008;
+
+/// Storage format class of generated frames
+pub const OutputFormat = enum(u32) {
+    rgba8 = 0,
+    rgb10a2 = 1,
+    rgba16f = 2,
+
+    /// Format class of a swapchain format, null if unsupported
+    pub fn fromVkFormat(format: u32) ?OutputFormat {
+        return switch (format) {
+            VK_FORMAT_R8G8B8A8_UNORM,
+            VK_FORMAT_R8G8B8A8_SRGB,
+            VK_FORMAT_B8G8R8A8_UNORM,
+            VK_FORMAT_B8G8R8A8_SRGB,
+            => .rgba8,
+            VK_FORMAT_A2R10G10B10_UNORM_PACK32,
+            VK_FORMAT_A2B10G10R10_UNORM_PACK32,
+            => .rgb10a2,
+            VK_FORMAT_R16G16B16A16_SFLOAT => .rgba16f,
+            else => null,
+        };
+    }
+
+    /// Format of output and warp scratch images (matches the shader's
+    /// storage qualifier)
+    pub fn storageFormat(self: OutputFormat) u32 {
+        return switch (self) {
+            .rgba8 => VK_FORMAT_R8G8B8A8_UNORM,
+            .rgb10a2 => VK_FORMAT_A2B10G10R10_UNORM_PACK32,
+            .rgba16f => VK_FORMAT_R16G16B16A16_SFLOAT,
+        };
+    }
+
+    /// SPIR-V file name suffix (build.zig)
+    pub fn suffix(self: OutputFormat) []const u8 {
+        return switch (self) {
+            .rgba8 => "",
+            .rgb10a2 => "_rgb10a2",
+            .rgba16f => "_rgba16f",
+        };
+    }
+};
+
+/// Encoding of stored color (TRANSFER in shaders/color.glsl)
+pub const TransferFunction = enum(u32) {
+    /// Mix code values as stored (8-bit SDR as before, linear scRGB)
+    none = 0,
+    srgb = 1,
+    /// SMPTE ST 2084 (HDR10)
+    pq = 2,
+};
+
+/// Output format and transfer function of a swapchain
+pub const FormatKey = struct {
+    output: OutputFormat = .rgba8,
+    transfer: TransferFunction = .none,
+
+    pub const count = 3 * 3;
+
+    /// Key for a swapchain format and color space, null if unsupported
+    pub fn fromSwapchain(format: u32, color_space: u32) ?FormatKey {
+        const output = OutputFormat.fromVkFormat(format) orelse return null;
+        const transfer: TransferFunction = switch (output) {
+            // Storage images are UNORM; SRGB swapchains hold encoded values
+            .rgba8 => switch (format) {
+                VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_B8G8R8A8_SRGB => .srgb,
+                else => .none,
+            },
+            .rgb10a2 => if (color_space == VK_COLOR_SPACE_HDR10_ST2084_EXT) .pq else .none,
+            .rgba16f => .none,
+        };
+        return .{ .output = output, .transfer = transfer };
+    }
+
+    pub fn index(self: FormatKey) usize {
+        return @as(usize, @intFromEnum(self.output)) * 3 + @intFromEnum(self.transfer);
+    }
+
+    /// Precision for the synthesis kernels. Linear PQ spans 1e-6 to 1, below
+    /// the fp16 normal range near black, so HDR10 stays fp32.
+    pub fn precision(self: FormatKey, wanted: shader_variants.Precision) shader_variants.Precision {
+        return if (self.transfer == .pq) .fp32 else wanted;
+    }
+};
+
+/// SPIR-V file name of a shader for a precision and output format
+pub fn spirvName(
+    buf: []u8,
+    shader: []const u8,
+    precision: shader_variants.Precision,
+    output: OutputFormat,
+) ![]const u8 {
+    const half: []const u8 = if (precision == .fp16) "_fp16" else "";
+    return std.fmt.bufPrint(buf, "{s}{s}{s}.spv", .{ shader, half, output.suffix() });
+}
+
+/// Where pipeline creation gets SPIR-V from
+pub const SpirvSource = struct {
+    context: ?*anyopaque = null,
+    /// SPIR-V of a file name as built by build.zig, or null if missing
+    load: *const fn (context: ?*anyopaque, name: []const u8) ?[]const u32,
+};
+
+/// Layouts of the passes to create pipelines for (null = pass unused).
+/// Tiled pipelines share the layout of their shader.
+pub const PipelineLayouts = struct {
+    /// Per synthesis shader (frame_synthesis.createDescriptorSetLayout)
+    passes: frame_synthesis.PassLayouts = .initFill(null),
+    splat: ?vk.VkPipelineLayout = null,
+    pull_push: ?vk.VkPipelineLayout = null,
+    /// Also create the per-tile-class pipelines
+    tiled: bool = false,
+    /// Descriptor model the synthesis set layouts use
+    descriptors: synthesis_descriptors.Model = .classic,
+};
+
+/// Frame-writing pipelines of one output format
+pub const FormatPipelines = struct {
+    warp: ?vk.VkPipeline = null,
+    blend: ?vk.VkPipeline = null,
+    extrapolate: ?vk.VkPipeline = null,
+    backward_warp: ?vk.VkPipeline = null,
+    confidence_blend: ?vk.VkPipeline = null,
+    occlusion_fill: ?vk.VkPipeline = null,
+    tiled: tile_classify.TiledPipelines = .{},
+    splat_resolve: ?vk.VkPipeline = null,
+    pullpush_push: ?vk.VkPipeline = null,
+    /// Full-frame tile_copy.comp (passthrough of gated batches)
+    passthrough: ?vk.VkPipeline = null,
+
+    fn destroy(self: *FormatPipelines, d: *const vk.DeviceDispatch) void {
+        const destroy_pipeline = d.vkDestroyPipeline orelse return;
+        const all = [_]*?vk.VkPipeline{
+            &self.warp,
+            &self.blend,
+            &self.extrapolate,
+            &self.backward_warp,
+            &self.confidence_blend,
+            &self.occlusion_fill,
+            &self.tiled.copy_pipeline,
+            &self.tiled.simple_warp_pipeline,
+            &self.tiled.simple_blend_pipeline,
+            &self.tiled.fill_warp_pipeline,
+            &self.tiled.fill_blend_pipeline,
+            &self.tiled.fill_quality.backward_warp_pipeline,
+            &self.tiled.fill_quality.confidence_blend_pipeline,
+            &self.tiled.fill_quality.occlusion_fill_pipeline,
+            &self.splat_resolve,
+            &self.pullpush_push,
+            &self.passthrough,
+        };
+        for (all) |p| {
+            if (p.*) |pipeline| destroy_pipeline(d.device, pipeline, null);
+            p.* = null;
+        }
+    }
+};
+
+/// Per-format pipelines, created lazily
+pub const FormatPipelineCache = struct {
+    entries: [FormatKey.count]?FormatPipelines = [_]?FormatPipelines{null} ** FormatKey.count,
+    layouts: PipelineLayouts,
+    variant: shader_variants.Variant,
+    source: SpirvSource,
+    pipeline_cache: ?vk.VkPipelineCache = null,
+    dispatch: ?*const vk.DeviceDispatch,
+
+    pub fn init(
+        layouts: PipelineLayouts,
+        variant: shader_variants.Variant,
+        source: SpirvSource,
+        dispatch: ?*const vk.DeviceDispatch,
+    ) FormatPipelineCache {
+        return .{ .layouts = layouts, .variant = variant, .source = source, .dispatch = dispatch };
+    }
+
+    /// Pipelines for a format, created on first use
+    pub fn get(self: *FormatPipelineCache, key: FormatKey) !*const FormatPipelines {
+        const i = key.index();
+        if (self.entries[i] == null) {
+            self.entries[i] = try self.create(key);
+        }
+        return &self.entries[i].?;
+    }
+
+    /// Check if a format's pipelines exist
+    pub fn contains(self: *const FormatPipelineCache, key: FormatKey) bool {
+        return self.entries[key.index()] != null;
+    }
+
+    /// Destroy every cached pipeline
+    pub fn deinit(self: *FormatPipelineCache) void {
+        const d = self.dispatch orelse return;
+        for (&self.entries) |*entry| {
+            if (entry.*) |*p| p.destroy(d);
+            entry.* = null;
+        }
+    }
+
+    fn create(self: *FormatPipelineCache, key: FormatKey) !FormatPipelines {
+        const d = self.dispatch orelse return vk.VulkanError.InitializationFailed;
+        const l = self.layouts;
+        const transfer = @intFromEnum(key.transfer);
+        const half = key.precision(self.variant.precision);
+
+        var full = shader_variants.SpecializationConstants.fullFrame(self.variant);
+        full.transfer = transfer;
+        var simple = shader_variants.SpecializationConstants.tiled(@intFromEnum(tile_classify.TileClass.simple));
+        simple.transfer = transfer;
+        var fill = shader_variants.SpecializationConstants.tiled(@intFromEnum(tile_classify.TileClass.fill));
+        fill.transfer = transfer;
+        const pass = shader_variants.SpecializationConstants{ .transfer = transfer };
+
+        var p = FormatPipelines{};
+        errdefer p.destroy(d);
+
+        p.warp = try self.buildPass(d, .forward_warp, false, half, key, full);
+        p.extrapolate = try self.buildPass(d, .extrapolate_warp, false, .fp32, key, full);
+        p.backward_warp = try self.buildPass(d, .backward_warp, false, half, key, full);
+        p.blend = try self.buildPass(d, .linear_blend, false, half, key, full);
+        p.confidence_blend = try self.buildPass(d, .confidence_blend, false, half, key, full);
+        p.occlusion_fill = try self.buildPass(d, .occlusion_fill, false, half, key, full);
+        p.splat_resolve = try self.build(d, "splat_resolve", .fp32, key, l.splat, full, 0);
+        p.pullpush_push = try self.build(d, "pullpush_push", .fp32, key, l.pull_push, pass, 0);
+        p.passthrough = try self.buildPass(d, .tile_copy, false, .fp32, key, pass);
+
+        if (l.tiled) {
+            const t = &p.tiled;
+            t.copy_pipeline = try self.buildPass(d, .tile_copy, true, .fp32, key, pass);
+            t.simple_warp_pipeline = try self.buildPass(d, .forward_warp, true, half, key, simple);
+            t.simple_blend_pipeline = try self.buildPass(d, .linear_blend, true, half, key, simple);
+            t.fill_warp_pipeline = try self.buildPass(d, .forward_warp, true, half, key, fill);
+            t.fill_blend_pipeline = try self.buildPass(d, .linear_blend, true, half, key, fill);
+            t.fill_quality.backward_warp_pipeline = try self.buildPass(d, .backward_warp, true, half, key, fill);
+            t.fill_quality.confidence_blend_pipeline = try self.buildPass(d, .confidence_blend, true, half, key, fill);
+            t.fill_quality.occlusion_fill_pipeline = try self.buildPass(d, .occlusion_fill, true, half, key, fill);
+        }
+        return p;
+    }
+
+    /// Create a synthesis shader's full-frame or tiled pipeline with its
+    /// layout, or null if the shader has none
+    fn buildPass(
+        self: *const FormatPipelineCache,
+        d: *const vk.DeviceDispatch,
+        shader: PassShader,
+        tiled: bool,
+        precision: shader_variants.Precision,
+        key: FormatKey,
+        spec: shader_variants.SpecializationConstants,
+    ) !?vk.VkPipeline {
+        const flags = synthesis_descriptors.pipelineFlags(self.layouts.descriptors);
+        return self.build(d, shader.variantName(tiled), precision, key, self.layouts.passes.get(shader), spec, flags);
+    }
+
+    /// Create one pipeline, or null if its pass has no layout
+    fn build(
+        self: *const FormatPipelineCache,
+        d: *const vk.DeviceDispatch,
+        shader: []const u8,
+        precision: shader_variants.Precision,
+        key: FormatKey,
+        layout: ?vk.VkPipelineLayout,
+        spec: shader_variants.SpecializationConstants,
+        flags: u32,
+    ) !?vk.VkPipeline {
+        const l = layout orelse return null;
+        var buf: [64]u8 = undefined;
+        const name = try spirvName(&buf, shader, precision, key.output);
+        const spirv = self.source.load(self.source.context, name) orelse return error.ShaderNotFound;
+        return try shader_variants.createComputePipelineFlags(d, spirv, l, spec, self.pipeline_cache, flags);
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "swapchain format keys" {
+    const sdr = FormatKey.fromSwapchain(VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR).?;
+    try std.testing.expectEqual(OutputFormat.rgba8, sdr.output);
+    try std.testing.expectEqual(TransferFunction.none, sdr.transfer);
+    try std.testing.expectEqual(@as(usize, 0), sdr.index());
+
+    const hdr10 = FormatKey.fromSwapchain(VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_COLOR_SPACE_HDR10_ST2084_EXT).?;
+    try std.testing.expectEqual(OutputFormat.rgb10a2, hdr10.output);
+    try std.testing.expectEqual(TransferFunction.pq, hdr10.transfer);
+    try std.testing.expectEqual(shader_variants.Precision.fp32, hdr10.precision(.fp16));
+
+    const srgb = FormatKey.fromSwapchain(VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR).?;
+    try std.testing.expectEqual(OutputFormat.rgba8, srgb.output);
+    try std.testing.expectEqual(TransferFunction.srgb, srgb.transfer);
+    try std.testing.expect(srgb.index() != sdr.index());
+    try std.testing.expectEqual(TransferFunction.srgb, FormatKey.fromSwapchain(VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR).?.transfer);
+
+    const sdr10 = FormatKey.fromSwapchain(VK_FORMAT_A2R10G10B10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR).?;
+    try std.testing.expectEqual(TransferFunction.none, sdr10.transfer);
+    try std.testing.expectEqual(shader_variants.Precision.fp16, sdr10.precision(.fp16));
+
+    const scrgb = FormatKey.fromSwapchain(VK_FORMAT_R16G16B16A16_SFLOAT, VK_COLOR_SPACE_EXTENDED_SRGB_LINEAR_EXT).?;
+    try std.testing.expectEqual(OutputFormat.rgba16f, scrgb.output);
+    try std.testing.expectEqual(VK_FORMAT_R16G16B16A16_SFLOAT, scrgb.output.storageFormat());
+    try std.testing.expect(scrgb.index() < FormatKey.count);
+
+    // R5G6B5 and friends are not supported
+    try std.testing.expect(FormatKey.fromSwapchain(4, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) == null);
+}
+
+test "spirv names per format" {
+    var buf: [64]u8 = undefined;
+    try std.testing.expectEqualStrings("linear_blend.spv", try spirvName(&buf, "linear_blend", .fp32, .rgba8));
+    try std.testing.expectEqualStrings("linear_blend_fp16_rgb10a2.spv", try spirvName(&buf, "linear_blend", .fp16, .rgb10a2));
+    try std.testing.expectEqualStrings("tile_copy_rgba16f.spv", try spirvName(&buf, "tile_copy", .fp32, .rgba16f));
+    // Tiled variants as build.zig names them
+    try std.testing.expectEqualStrings(
+        "forward_warp_tiled_fp16_rgb10a2.spv",
+        try spirvName(&buf, PassShader.forward_warp.variantName(true), .fp16, .rgb10a2),
+    );
+}
+
+test "FormatPipelineCache creates lazily and once" {
+    const dispatch = test_stubs.withPipelines(.{ .device = test_stubs.device });
+    test_stubs.spirv_loads = 0;
+    test_stubs.pipelines_created = 0;
+    test_stubs.pipelines_destroyed = 0;
+
+    var cache = FormatPipelineCache.init(
+        .{ .passes = .initFill(@ptrFromInt(0x2000)) },
+        .{},
+        .{ .load = &test_stubs.loadSpirv },
+        &dispatch,
+    );
+    const hdr10 = FormatKey{ .output = .rgb10a2, .transfer = .pq };
+    try std.testing.expect(!cache.contains(hdr10));
+
+    const p = try cache.get(hdr10);
+    try std.testing.expect(p.warp != null and p.blend != null);
+    // No splat or pull-push layout: those passes stay off for the format
+    try std.testing.expect(p.splat_resolve == null and p.pullpush_push == null);
+    try std.testing.expect(p.tiled.copy_pipeline == null);
+    try std.testing.expect(p.passthrough != null);
+    // warp, extrapolate, backward warp, linear/confidence blend, occlusion
+    // fill, passthrough
+    try std.testing.expectEqual(@as(u32, 7), test_stubs.pipelines_created);
+
+    _ = try cache.get(hdr10);
+    try std.testing.expectEqual(@as(u32, 7), test_stubs.spirv_loads);
+    try std.testing.expect(cache.contains(hdr10));
+
+    cache.deinit();
+    try std.testing.expectEqual(@as(u32, 7), test_stubs.pipelines_destroyed);
+}
@@ -0,0 +1,193 @@
+//! Generated Frame Output Ring
+//!
+//! With a single set of output targets, the next batch overwrites frames
+//! the present engine may still be scanning out (or copying into the
+//! swapchain). The ring holds `depth` sets of batch targets instead; each
+//! batch acquires the oldest set, and whoever consumes the generated frames
+//! signals the set's release value on a timeline semaphore once done with
+//! them (the submission that copies or composites them into the swapchain).
+//!
+//! acquire() never blocks the CPU. If the oldest set has not been released
+//! yet it is counted as busy and the synthesis submission must wait for its
+//! release value on the GPU; a deeper ring makes that rare.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const mv_ring = @import("mv_ring.zig");
+const test_stubs = @import("test_stubs.zig");
+
+const OutputTarget = frame_synthesis.OutputTarget;
+const max_batch_frames = frame_synthesis.max_batch_frames;
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Deepest supported ring (triple buffering)
+pub const max_depth = 3;
+
+/// Output targets of one batch
+pub const OutputSet = [max_batch_frames]OutputTarget;
+
+/// A set acquired for one batch
+pub const Acquired = struct {
+    index: u32,
+    /// Release value of the previous use, when it was still pending at
+    /// acquire: the synthesis submission must wait for it
+    wait: ?mv_ring.TimelineValue,
+    /// Signal once the generated frames of this batch are consumed
+    release: mv_ring.TimelineValue,
+    /// Ring state before the acquire (OutputRing.cancel)
+    previous_release: u64 = 0,
+    previous_current: ?u32 = null,
+};
+
+/// Output ring statistics
+pub const OutputRingStats = struct {
+    /// Sets acquired
+    acquires: u64 = 0,
+    /// Acquires whose set was still held by presentation
+    busy: u64 = 0,
+};
+
+/// Ring of batch output sets released through a timeline semaphore
+pub const OutputRing = struct {
+    dispatch: *const vk.DeviceDispatch,
+    // Batch targets per ring slot (caller-owned images and descriptor sets)
+    sets: [max_depth]OutputSet = [_]OutputSet{[_]OutputTarget{.{}} ** max_batch_frames} ** max_depth,
+    depth: u32,
+    release_timeline: vk.VkSemaphore,
+    // Value releasing each set's last use (0 = never acquired)
+    release_values: [max_depth]u64 = .{0} ** max_depth,
+    // Set of the current batch (null before the first acquire)
+    current: ?u32 = null,
+    stats: OutputRingStats = .{},
+
+    pub fn init(dispatch: *const vk.DeviceDispatch, depth: u32) !OutputRing {
+        if (depth < 2 or depth > max_depth) return error.InvalidDepth;
+        if (!dispatch.hasTimelineSemaphores()) return vk.VulkanError.FunctionNotFound;
+
+        const type_info = vk.VkSemaphoreTypeCreateInfo{};
+        var semaphore: vk.VkSemaphore = undefined;
+        try vk.check(dispatch.vkCreateSemaphore.?(dispatch.device, &.{ .pNext = &type_info }, null, &semaphore));
+        return .{ .dispatch = dispatch, .depth = depth, .release_timeline = semaphore };
+    }
+
+    /// Destroy the semaphore. Every release must have been signalled.
+    pub fn deinit(self: *OutputRing) void {
+        self.dispatch.vkDestroySemaphore.?(self.dispatch.device, self.release_timeline, null);
+        // Note: Caller is responsible for destroying images/memory
+    }
+
+    /// Set the output target for a batch slot of a ring set
+    pub fn setTarget(self: *OutputRing, set: u32, slot: u32, target: OutputTarget) !void {
+        if (set >= self.depth) return error.InvalidDepth;
+        if (slot >= max_batch_frames) return error.BatchTooLarge;
+        self.sets[set][slot] = target;
+    }
+
+    /// Check if every set has a primary output. Descriptor sets are only
+    /// needed with the classic model and are checked per pass.
+    pub fn isReady(self: *const OutputRing) bool {
+        for (self.sets[0..self.depth]) |set| {
+            if (set[0].view == null) return false;
+        }
+        return true;
+    }
+
+    /// Take the oldest set for the next batch without waiting
+    pub fn acquire(self: *OutputRing) !Acquired {
+        const index: u32 = @intCast(self.stats.acquires % self.depth);
+        const pending = self.release_values[index];
+
+        var wait: ?mv_ring.TimelineValue = null;
+        if (pending > 0) {
+            var completed: u64 = 0;
+            try vk.check(self.dispatch.vkGetSemaphoreCounterValue.?(self.dispatch.device, self.release_timeline, &completed));
+            if (completed < pending) {
+                self.stats.busy += 1;
+                wait = .{ .semaphore = self.release_timeline, .value = pending };
+            }
+        }
+
+        // Batches are consumed in order, so release values increase
+        const previous_current = self.current;
+        self.stats.acquires += 1;
+        self.release_values[index] = self.stats.acquires;
+        self.current = index;
+        return .{
+            .index = index,
+            .wait = wait,
+            .release = .{ .semaphore = self.release_timeline, .value = self.stats.acquires },
+            .previous_release = pending,
+            .previous_current = previous_current,
+        };
+    }
+
+    /// Undo the last acquire when its batch was not recorded: the set keeps
+    /// its previous release value and the next acquire takes it again, so
+    /// no release value is left unsignalled
+    pub fn cancel(self: *OutputRing, acquired: Acquired) void {
+        std.debug.assert(acquired.release.value == self.stats.acquires);
+        self.release_values[acquired.index] = acquired.previous_release;
+        self.stats.acquires -= 1;
+        if (acquired.wait != null) self.stats.busy -= 1;
+        self.current = acquired.previous_current;
+    }
+
+    /// Output target of a batch slot in the current set
+    pub fn target(self: *const OutputRing, slot: u32) OutputTarget {
+        const index = self.current orelse return .{};
+        if (slot >= max_batch_frames) return .{};
+        return self.sets[index][slot];
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "OutputRing counts busy sets" {
+    var ring = try OutputRing.init(&test_stubs.timeline_dispatch, 3);
+    defer ring.deinit();
+    try std.testing.expect(!ring.isReady());
+    try std.testing.expect(ring.target(0).view == null);
+    for (0..3) |i| {
+        try ring.setTarget(@intCast(i), 0, .{ .view = @ptrFromInt(0x100 * (i + 1)) });
+    }
+    try std.testing.expect(ring.isReady());
+    try std.testing.expectError(error.InvalidDepth, ring.setTarget(3, 0, .{}));
+
+    // First pass over the ring: every set is free
+    test_stubs.timeline_value = 0;
+    for (0..3) |i| {
+        const acquired = try ring.acquire();
+        try std.testing.expectEqual(@as(u32, @intCast(i)), acquired.index);
+        try std.testing.expect(acquired.wait == null);
+        try std.testing.expectEqual(@as(u64, i + 1), acquired.release.value);
+    }
+    try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x300)), ring.target(0).view.?);
+
+    // Set 0 released: free again
+    test_stubs.timeline_value = 1;
+    try std.testing.expect((try ring.acquire()).wait == null);
+
+    // Set 1 still presented: the GPU waits for release 2
+    const busy = try ring.acquire();
+    try std.testing.expectEqual(@as(u32, 1), busy.index);
+    try std.testing.expectEqual(@as(u64, 2), busy.wait.?.value);
+    try std.testing.expectEqual(@as(u64, 5), busy.release.value);
+    try std.testing.expectEqual(@as(u64, 1), ring.stats.busy);
+    try std.testing.expectEqual(@as(u64, 5), ring.stats.acquires);
+
+    // A batch that failed to record gives its set back
+    ring.cancel(busy);
+    try std.testing.expectEqual(@as(u64, 0), ring.stats.busy);
+    try std.testing.expectEqual(@as(u64, 4), ring.stats.acquires);
+    try std.testing.expectEqual(@as(?u32, 0), ring.current);
+    const again = try ring.acquire();
+    try std.testing.expectEqual(@as(u32, 1), again.index);
+    try std.testing.expectEqual(@as(u64, 2), again.wait.?.value);
+    try std.testing.expectEqual(@as(u64, 5), again.release.value);
+}
@@ -0,0 +1,488 @@
+//! Persistent Pipeline Cache
+//!
+//! Creating the synthesis pipelines cold costs tens of milliseconds on
+//! every launch, in every container. PersistentPipelineCache loads a
+//! VkPipelineCache from the XDG cache directory ($XDG_CACHE_HOME/nvvk,
+//! else ~/.cache/nvvk) and writes it back on save.
+//!
+//! Files are keyed by CacheKey: device (vendor, device ID,
+//! pipelineCacheUUID), driver (Vulkan driverVersion and the kernel module
+//! version from getDriverVersion) and the hash of the embedded shaders.
+//! Each file starts with a FileHeader repeating the key plus the payload
+//! size and hash. A file that does not match, or whose Vulkan header names
+//! another device, is ignored and the cache starts cold.
+//!
+//! Concurrent writers (several games launching at once) are serialized by
+//! an exclusive lock file. Under the lock, save merges what is on disk
+//! into our cache (vkMergePipelineCaches), writes a temporary file and
+//! renames it into place, so readers never see a partial file and no
+//! writer drops pipelines another one saved.
+//!
+//! Only compute pipelines are cached; optical flow sessions have no
+//! cacheable state.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const root = @import("root.zig");
+const shader_library = @import("shader_library.zig");
+
+// =============================================================================
+// Types
+// =============================================================================
+
+pub const file_magic = [4]u8{ 'N', 'V', 'P', 'C' };
+pub const file_version: u32 = 1;
+
+/// What a cache file is valid for
+pub const CacheKey = struct {
+    vendor_id: u32 = 0,
+    device_id: u32 = 0,
+    driver_version: u32 = 0,
+    /// NVIDIA kernel module version (major, minor, patch), zeros elsewhere
+    kernel_driver: [3]u32 = .{ 0, 0, 0 },
+    uuid: [vk.VK_UUID_SIZE]u8 = [_]u8{0} ** vk.VK_UUID_SIZE,
+    shader_hash: u64 = 0,
+
+    pub fn init(
+        props: *const vk.VkPhysicalDeviceProperties,
+        kernel_driver: ?root.DriverVersion,
+        shader_hash: u64,
+    ) CacheKey {
+        const kd = kernel_driver orelse root.DriverVersion{ .major = 0, .minor = 0, .patch = 0 };
+        return .{
+            .vendor_id = props.vendorID,
+            .device_id = props.deviceID,
+            .driver_version = props.driverVersion,
+            .kernel_driver = .{ kd.major, kd.minor, kd.patch },
+            .uuid = props.pipelineCacheUUID,
+            .shader_hash = shader_hash,
+        };
+    }
+
+    /// Key for a device running this build's embedded shaders
+    pub fn forDevice(allocator: std.mem.Allocator, props: *const vk.VkPhysicalDeviceProperties) CacheKey {
+        return init(props, root.getDriverVersion(allocator), shader_library.embeddedHash());
+    }
+
+    /// Cache file name. Driver updates overwrite the file in place;
+    /// different library builds keep their own.
+    pub fn fileName(self: CacheKey, buf: []u8) ![]const u8 {
+        return std.fmt.bufPrint(buf, "{x:0>4}-{x:0>4}-{x:0>16}.bin", .{ self.vendor_id, self.device_id, self.shader_hash });
+    }
+};
+
+/// Header of a cache file, followed by the vkGetPipelineCacheData payload
+pub const FileHeader = extern struct {
+    magic: [4]u8 = file_magic,
+    version: u32 = file_version,
+    vendor_id: u32 = 0,
+    device_id: u32 = 0,
+    driver_version: u32 = 0,
+    kernel_driver: [3]u32 = .{ 0, 0, 0 },
+    uuid: [vk.VK_UUID_SIZE]u8 = [_]u8{0} ** vk.VK_UUID_SIZE,
+    shader_hash: u64 = 0,
+    data_size: u64 = 0,
+    data_hash: u64 = 0,
+
+    fn matches(self: *const FileHeader, key: CacheKey) bool {
+        return std.mem.eql(u8, &self.magic, &file_magic) and
+            self.version == file_version and
+            self.vendor_id == key.vendor_id and
+            self.device_id == key.device_id and
+            self.driver_version == key.driver_version and
+            std.mem.eql(u32, &self.kernel_driver, &key.kernel_driver) and
+            std.mem.eql(u8, &self.uuid, &key.uuid) and
+            self.shader_hash == key.shader_hash;
+    }
+};
+
+// =============================================================================
+// File Format
+// =============================================================================
+
+/// Cache file contents for a payload (caller frees)
+pub fn encode(allocator: std.mem.Allocator, key: CacheKey, data: []const u8) ![]u8 {
+    const header = FileHeader{
+        .vendor_id = key.vendor_id,
+        .device_id = key.device_id,
+        .driver_version = key.driver_version,
+        .kernel_driver = key.kernel_driver,
+        .uuid = key.uuid,
+        .shader_hash = key.shader_hash,
+        .data_size = data.len,
+        .data_hash = std.hash.Wyhash.hash(0, data),
+    };
+    const file = try allocator.alloc(u8, @sizeOf(FileHeader) + data.len);
+    @memcpy(file[0..@sizeOf(FileHeader)], std.mem.asBytes(&header));
+    @memcpy(file[@sizeOf(FileHeader)..], data);
+    return file;
+}
+
+/// Payload of cache file contents, or null unless it is intact and valid
+/// for key
+pub fn decode(key: CacheKey, file: []const u8) ?[]const u8 {
+    if (file.len < @sizeOf(FileHeader)) return null;
+    const header = std.mem.bytesToValue(FileHeader, file[0..@sizeOf(FileHeader)]);
+    if (!header.matches(key)) return null;
+
+    const data = file[@sizeOf(FileHeader)..];
+    if (header.data_size != data.len) return null;
+    if (header.data_hash != std.hash.Wyhash.hash(0, data)) return null;
+    if (!isVulkanCacheFor(key, data)) return null;
+    return data;
+}
+
+/// Check the VkPipelineCacheHeaderVersionOne at the start of cache data
+pub fn isVulkanCacheFor(key: CacheKey, data: []const u8) bool {
+    const size = @sizeOf(vk.VkPipelineCacheHeaderVersionOne);
+    if (data.len < size) return false;
+    const header = std.mem.bytesToValue(vk.VkPipelineCacheHeaderVersionOne, data[0..size]);
+    return header.headerSize >= size and
+        header.headerSize <= data.len and
+        header.headerVersion == vk.VK_PIPELINE_CACHE_HEADER_VERSION_ONE and
+        header.vendorID == key.vendor_id and
+        header.deviceID == key.device_id and
+        std.mem.eql(u8, &header.pipelineCacheUUID, &key.uuid);
+}
+
+/// nvvk directory under the XDG cache home (caller frees)
+pub fn cacheDirPath(allocator: std.mem.Allocator) ![]u8 {
+    // Relative XDG paths are invalid and must be ignored
+    if (std.posix.getenv("XDG_CACHE_HOME")) |xdg| {
+        if (std.fs.path.isAbsolute(xdg)) return std.fs.path.join(allocator, &.{ xdg, "nvvk" });
+    }
+    const home = std.posix.getenv("HOME") orelse return error.NoCacheDir;
+    return std.fs.path.join(allocator, &.{ home, ".cache", "nvvk" });
+}
+
+/// Open (creating if needed) the nvvk cache directory
+pub fn openCacheDir(allocator: std.mem.Allocator) !std.fs.Dir {
+    const path = try cacheDirPath(allocator);
+    defer allocator.free(path);
+    return std.fs.cwd().makeOpenPath(path, .{});
+}
+
+fn readFile(allocator: std.mem.Allocator, dir: std.fs.Dir, name: []const u8) ![]u8 {
+    const file = try dir.openFile(name, .{});
+    defer file.close();
+    const size: usize = @intCast(try file.getEndPos());
+    const bytes = try allocator.alloc(u8, size);
+    errdefer allocator.free(bytes);
+    if (try file.readAll(bytes) != size) return error.UnexpectedEndOfFile;
+    return bytes;
+}
+
+// =============================================================================
+// Persistent Pipeline Cache
+// =============================================================================
+
+/// VkPipelineCache backed by a file in the cache directory
+pub const PersistentPipelineCache = struct {
+    allocator: std.mem.Allocator,
+    dispatch: *const vk.DeviceDispatch,
+    key: CacheKey,
+    // Cache directory (owned; null = in memory only)
+    dir: ?std.fs.Dir,
+    cache: vk.VkPipelineCache,
+    /// Payload size loaded from disk (0 = started cold)
+    loaded_size: usize = 0,
+
+    /// Load the cache for key from dir, which is owned from here on
+    pub fn init(
+        allocator: std.mem.Allocator,
+        dispatch: *const vk.DeviceDispatch,
+        key: CacheKey,
+        dir: ?std.fs.Dir,
+    ) !PersistentPipelineCache {
+        errdefer if (dir) |d| {
+            var owned = d;
+            owned.close();
+        };
+        if (!dispatch.hasPipelineCache()) return vk.VulkanError.FunctionNotFound;
+
+        var name_buf: [64]u8 = undefined;
+        const name = try key.fileName(&name_buf);
+        const file: ?[]u8 = if (dir) |d| readFile(allocator, d, name) catch null else null;
+        defer if (file) |f| allocator.free(f);
+        const payload = if (file) |f| decode(key, f) else null;
+
+        // A driver may still reject data with a valid header: start cold
+        const cache = createCache(dispatch, payload) catch |err| blk: {
+            if (payload == null) return err;
+            break :blk try createCache(dispatch, null);
+        };
+        return .{
+            .allocator = allocator,
+            .dispatch = dispatch,
+            .key = key,
+            .dir = dir,
+            .cache = cache,
+            .loaded_size = if (payload) |p| p.len else 0,
+        };
+    }
+
+    /// Load from the XDG cache directory; in memory only if unavailable
+    pub fn initDefault(
+        allocator: std.mem.Allocator,
+        dispatch: *const vk.DeviceDispatch,
+        key: CacheKey,
+    ) !PersistentPipelineCache {
+        const dir = openCacheDir(allocator) catch null;
+        return init(allocator, dispatch, key, dir);
+    }
+
+    /// Cache to pass to pipeline creation
+    pub fn handle(self: *const PersistentPipelineCache) vk.VkPipelineCache {
+        return self.cache;
+    }
+
+    /// Merge with what other processes saved and write the file back
+    pub fn save(self: *PersistentPipelineCache) !void {
+        const dir = self.dir orelse return;
+        var name_buf: [64]u8 = undefined;
+        const name = try self.key.fileName(&name_buf);
+        var lock_buf: [72]u8 = undefined;
+        const lock_name = try std.fmt.bufPrint(&lock_buf, "{s}.lock", .{name});
+        var tmp_buf: [72]u8 = undefined;
+        const tmp_name = try std.fmt.bufPrint(&tmp_buf, "{s}.tmp", .{name});
+
+        const lock = try dir.createFile(lock_name, .{ .lock = .exclusive });
+        defer lock.close();
+
+        // Pick up pipelines other writers saved since we loaded
+        if (readFile(self.allocator, dir, name)) |file| {
+            defer self.allocator.free(file);
+            if (decode(self.key, file)) |theirs| self.merge(theirs);
+        } else |_| {}
+
+        const data = try self.getData();
+        defer self.allocator.free(data);
+        const encoded = try encode(self.allocator, self.key, data);
+        defer self.allocator.free(encoded);
+
+        {
+            const tmp = try dir.createFile(tmp_name, .{});
+            defer tmp.close();
+            try tmp.writeAll(encoded);
+        }
+        try dir.rename(tmp_name, name);
+    }
+
+    /// Destroy the cache without saving
+    pub fn deinit(self: *PersistentPipelineCache) void {
+        self.dispatch.vkDestroyPipelineCache.?(self.dispatch.device, self.cache, null);
+        if (self.dir) |*dir| dir.close();
+        self.dir = null;
+    }
+
+    /// Merge cache data into ours. Data the driver rejects is dropped.
+    fn merge(self: *PersistentPipelineCache, data: []const u8) void {
+        const d = self.dispatch;
+        const other = createCache(d, data) catch return;
+        defer d.vkDestroyPipelineCache.?(d.device, other, null);
+        const sources = [_]vk.VkPipelineCache{other};
+        _ = d.vkMergePipelineCaches.?(d.device, self.cache, 1, &sources);
+    }
+
+    fn getData(self: *PersistentPipelineCache) ![]u8 {
+        const d = self.dispatch;
+        // Other threads may add pipelines between the size query and the copy
+        while (true) {
+            var size: usize = 0;
+            try vk.check(d.vkGetPipelineCacheData.?(d.device, self.cache, &size, null));
+            const data = try self.allocator.alloc(u8, size);
+            const result = d.vkGetPipelineCacheData.?(d.device, self.cache, &size, data.ptr);
+            if (result == .incomplete) {
+                self.allocator.free(data);
+                continue;
+            }
+            vk.check(result) catch |err| {
+                self.allocator.free(data);
+                return err;
+            };
+            return self.allocator.realloc(data, size);
+        }
+    }
+};
+
+fn createCache(d: *const vk.DeviceDispatch, data: ?[]const u8) vk.VulkanError!vk.VkPipelineCache {
+    var cache: vk.VkPipelineCache = undefined;
+    try vk.check(d.vkCreatePipelineCache.?(d.device, &.{
+        .initialDataSize = if (data) |b| b.len else 0,
+        .pInitialData = if (data) |b| b.ptr else null,
+    }, null, &cache));
+    return cache;
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+const test_key = CacheKey{
+    .vendor_id = vk.VK_VENDOR_ID_NVIDIA,
+    .device_id = 0x2684,
+    .driver_version = 0x93C08000,
+    .kernel_driver = .{ 590, 48, 1 },
+    .uuid = [_]u8{7} ** vk.VK_UUID_SIZE,
+    .shader_hash = 0xABCDEF,
+};
+
+/// Fake vkGetPipelineCacheData output: Vulkan header + payload bytes
+fn fakeBlob(buf: []u8, key: CacheKey, payload: []const u8) []u8 {
+    const header = vk.VkPipelineCacheHeaderVersionOne{
+        .headerSize = @sizeOf(vk.VkPipelineCacheHeaderVersionOne),
+        .headerVersion = vk.VK_PIPELINE_CACHE_HEADER_VERSION_ONE,
+        .vendorID = key.vendor_id,
+        .deviceID = key.device_id,
+        .pipelineCacheUUID = key.uuid,
+    };
+    const n = @sizeOf(vk.VkPipelineCacheHeaderVersionOne);
+    @memcpy(buf[0..n], std.mem.asBytes(&header));
+    @memcpy(buf[n..][0..payload.len], payload);
+    return buf[0 .. n + payload.len];
+}
+
+// Stub caches: handle 0x3000 + i, data = Vulkan header + one byte per
+// "pipeline". Merging adds the bytes dst does not have yet.
+const StubCache = struct {
+    data: [128]u8 = undefined,
+    len: usize = 0,
+};
+var stub_caches: [8]StubCache = [_]StubCache{.{}} ** 8;
+var stub_count: usize = 0;
+
+fn stubCache(cache: vk.VkPipelineCache) *StubCache {
+    return &stub_caches[@intFromPtr(cache) - 0x3000];
+}
+
+fn stubAddPipeline(cache: vk.VkPipelineCache, id: u8) void {
+    const c = stubCache(cache);
+    if (std.mem.indexOfScalar(u8, c.data[32..c.len], id) != null) return;
+    c.data[c.len] = id;
+    c.len += 1;
+}
+
+fn stubCreatePipelineCache(_: vk.VkDevice, info: *const vk.VkPipelineCacheCreateInfo, _: ?*const vk.VkAllocationCallbacks, cache: *vk.VkPipelineCache) callconv(.c) vk.VkResult {
+    const c = &stub_caches[stub_count];
+    if (info.pInitialData) |p| {
+        const bytes = @as([*]const u8, @ptrCast(p))[0..info.initialDataSize];
+        if (!isVulkanCacheFor(test_key, bytes)) return .error_initialization_failed;
+        @memcpy(c.data[0..bytes.len], bytes);
+        c.len = bytes.len;
+    } else {
+        c.len = fakeBlob(&c.data, test_key, "").len;
+    }
+    cache.* = @ptrFromInt(0x3000 + stub_count);
+    stub_count += 1;
+    return .success;
+}
+
+fn stubDestroyPipelineCache(_: vk.VkDevice, _: vk.VkPipelineCache, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {}
+
+fn stubGetPipelineCacheData(_: vk.VkDevice, cache: vk.VkPipelineCache, size: *usize, data: ?*anyopaque) callconv(.c) vk.VkResult {
+    const c = stubCache(cache);
+    if (data) |out| {
+        if (size.* < c.len) return .incomplete;
+        @memcpy(@as([*]u8, @ptrCast(out))[0..c.len], c.data[0..c.len]);
+    }
+    size.* = c.len;
+    return .success;
+}
+
+fn stubMergePipelineCaches(_: vk.VkDevice, dst: vk.VkPipelineCache, count: u32, sources: [*]const vk.VkPipelineCache) callconv(.c) vk.VkResult {
+    for (sources[0..count]) |src| {
+        const s = stubCache(src);
+        for (s.data[32..s.len]) |id| stubAddPipeline(dst, id);
+    }
+    return .success;
+}
+
+const stub_dispatch = vk.DeviceDispatch{
+    .device = @ptrFromInt(0x1000),
+    .vkCreatePipelineCache = stubCreatePipelineCache,
+    .vkDestroyPipelineCache = stubDestroyPipelineCache,
+    .vkGetPipelineCacheData = stubGetPipelineCacheData,
+    .vkMergePipelineCaches = stubMergePipelineCaches,
+};
+
+test "cache file round trip with a fake blob" {
+    var buf: [64]u8 = undefined;
+    const blob = fakeBlob(&buf, test_key, "pipelines");
+    const file = try encode(std.testing.allocator, test_key, blob);
+    defer std.testing.allocator.free(file);
+
+    try std.testing.expectEqualSlices(u8, blob, decode(test_key, file).?);
+
+    // Any key change invalidates the file
+    var newer_driver = test_key;
+    newer_driver.kernel_driver[1] = 65;
+    try std.testing.expect(decode(newer_driver, file) == null);
+    var other_uuid = test_key;
+    other_uuid.uuid[0] = 8;
+    try std.testing.expect(decode(other_uuid, file) == null);
+
+    // Truncated and corrupted files are rejected
+    try std.testing.expect(decode(test_key, file[0 .. file.len - 1]) == null);
+    try std.testing.expect(decode(test_key, file[0..10]) == null);
+    const corrupt = try std.testing.allocator.dupe(u8, file);
+    defer std.testing.allocator.free(corrupt);
+    corrupt[corrupt.len - 1] ^= 0xFF;
+    try std.testing.expect(decode(test_key, corrupt) == null);
+}
+
+test "Vulkan header of another device is rejected" {
+    var buf: [64]u8 = undefined;
+    var foreign = test_key;
+    foreign.device_id = 0x1234;
+    const blob = fakeBlob(&buf, foreign, "x");
+    try std.testing.expect(!isVulkanCacheFor(test_key, blob));
+
+    // A valid file header around it does not help
+    const file = try encode(std.testing.allocator, test_key, blob);
+    defer std.testing.allocator.free(file);
+    try std.testing.expect(decode(test_key, file) == null);
+}
+
+test "file name" {
+    var buf: [64]u8 = undefined;
+    try std.testing.expectEqualStrings("10de-2684-0000000000abcdef.bin", try test_key.fileName(&buf));
+}
+
+test "concurrent writers merge" {
+    stub_count = 0;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    // First launch: cold, creates pipeline 'a'
+    var first = try PersistentPipelineCache.init(std.testing.allocator, &stub_dispatch, test_key, try tmp.dir.openDir(".", .{}));
+    try std.testing.expectEqual(@as(usize, 0), first.loaded_size);
+    stubAddPipeline(first.handle(), 'a');
+    try first.save();
+    first.deinit();
+
+    // Two processes load the same file, each adds a pipeline and saves
+    var second = try PersistentPipelineCache.init(std.testing.allocator, &stub_dispatch, test_key, try tmp.dir.openDir(".", .{}));
+    defer second.deinit();
+    var third = try PersistentPipelineCache.init(std.testing.allocator, &stub_dispatch, test_key, try tmp.dir.openDir(".", .{}));
+    defer third.deinit();
+    try std.testing.expect(second.loaded_size > 0);
+    stubAddPipeline(second.handle(), 'b');
+    stubAddPipeline(third.handle(), 'c');
+    try second.save();
+    try third.save();
+
+    // The last writer kept the first writer's pipelines
+    var name_buf: [64]u8 = undefined;
+    const file = try readFile(std.testing.allocator, tmp.dir, try test_key.fileName(&name_buf));
+    defer std.testing.allocator.free(file);
+    const data = decode(test_key, file).?;
+    for ("abc") |id| try std.testing.expect(std.mem.indexOfScalar(u8, data[32..], id) != null);
+}
+
+test "init without pipeline cache functions" {
+    const dispatch = vk.DeviceDispatch{ .device = @ptrFromInt(0x1000) };
+    try std.testing.expectError(
+        vk.VulkanError.FunctionNotFound,
+        PersistentPipelineCache.init(std.testing.allocator, &dispatch, test_key, null),
+    );
+}
@@ -43,8 +43,14 @@ pub const InjectionMode = enum {
     single,
     /// Double injection - for 4x frame rate (experimental)
     double,
+    /// Multi injection - frame_multiplier - 1 generated frames per real frame,
+    /// following the frame generation context
+    multi,
 };
 
+/// Maximum generated frames scheduled per real frame
+pub const max_injected_per_real: usize = 3;
+
 /// Present timing mode
 pub const TimingMode = enum {
     /// Fixed timing based on target frame rate
@@ -202,6 +208,36 @@ pub const PresentInjectionContext = struct {
         return false;
     }
 
+    /// Number of generated frames presented per real frame
+    pub fn generatedPerReal(self: *const PresentInjectionContext) u8 {
+        return switch (self.config.mode) {
+            .disabled => 0,
+            .single => 1,
+            .double => 3,
+            .multi => if (self.frame_gen) |fg|
+                fg.config.frame_multiplier -| 1
+            else
+                1,
+        };
+    }
+
+    /// Present offsets (microseconds after the real frame slot starts) for
+    /// each generated frame of one real frame, spaced evenly at k/N.
+    /// Returns the number of offsets written.
+    pub fn calculateInjectionSchedule(self: *PresentInjectionContext, offsets: []u64) usize {
+        const generated: usize = @min(self.generatedPerReal(), max_injected_per_real);
+        const count = @min(generated, offsets.len);
+        if (count == 0) return 0;
+
+        // calculateInjectionTiming yields the half-interval for 2x pacing
+        const real_interval_us = self.calculateInjectionTiming() * 2;
+        const slots: u64 = generated + 1;
+        for (0..count) |k| {
+            offsets[k] = real_interval_us * @as(u64, k + 1) / slots;
+        }
+        return count;
+    }
+
     /// Update LFC state based on current FPS
     pub fn updateLfcState(self: *PresentInjectionContext) void {
         if (self.config.vrr_config) |vrr_cfg| {
@@ -359,6 +395,29 @@ test "InjectionMode" {
     try std.testing.expectEqual(InjectionMode.single, mode);
 }
 
+test "calculateInjectionSchedule" {
+    var ctx = PresentInjectionContext.init(null, 0, null, null, .{
+        .mode = .double,
+        .timing = .fixed,
+        .target_fps = 60.0,
+    }, null, std.testing.allocator);
+
+    // 4x: generated frames at 1/4, 2/4, 3/4 of the real frame interval
+    var offsets: [max_injected_per_real]u64 = undefined;
+    try std.testing.expectEqual(@as(usize, 3), ctx.calculateInjectionSchedule(&offsets));
+    try std.testing.expectEqual(@as(u64, 4166), offsets[0]);
+    try std.testing.expectEqual(@as(u64, 8333), offsets[1]);
+    try std.testing.expectEqual(@as(u64, 12499), offsets[2]);
+
+    // Single injection keeps the midpoint
+    ctx.setMode(.single);
+    try std.testing.expectEqual(@as(usize, 1), ctx.calculateInjectionSchedule(&offsets));
+    try std.testing.expectEqual(@as(u64, 8333), offsets[0]);
+
+    ctx.setMode(.disabled);
+    try std.testing.expectEqual(@as(usize, 0), ctx.calculateInjectionSchedule(&offsets));
+}
+
 test "TimingMode" {
     const timing: TimingMode = .adaptive;
     try std.testing.expectEqual(TimingMode.adaptive, timing);
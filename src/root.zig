@@ -50,6 +50,24 @@ pub const displacement_micromap = @import("displacement_micromap.zig");
 // Frame generation modules (Phase 3)
 pub const motion_vectors = @import("motion_vectors.zig");
 pub const frame_synthesis = @import("frame_synthesis.zig");
+pub const scene_change = @import("scene_change.zig");
+pub const tile_classify = @import("tile_classify.zig");
+pub const forward_splat = @import("forward_splat.zig");
+pub const hole_fill = @import("hole_fill.zig");
+pub const shader_variants = @import("shader_variants.zig");
+pub const output_format = @import("output_format.zig");
+pub const shader_library = @import("shader_library.zig");
+pub const pipeline_cache = @import("pipeline_cache.zig");
+pub const memory_arena = @import("memory_arena.zig");
+pub const synthesis_graph = @import("synthesis_graph.zig");
+pub const mv_ring = @import("mv_ring.zig");
+pub const gpu_timing = @import("gpu_timing.zig");
+pub const output_ring = @import("output_ring.zig");
+pub const async_queue = @import("async_queue.zig");
+pub const synthesis_replay = @import("synthesis_replay.zig");
+pub const synthesis_descriptors = @import("synthesis_descriptors.zig");
+pub const synthesis_constants = @import("synthesis_constants.zig");
+pub const frame_resize = @import("frame_resize.zig");
 pub const frame_generation = @import("frame_generation.zig");
 pub const present_injection = @import("present_injection.zig");
 
@@ -113,11 +131,34 @@ pub const MotionVectorContext = motion_vectors.MotionVectorContext;
 pub const MotionVectorConfig = motion_vectors.MotionVectorConfig;
 pub const MotionVectorBuffer = motion_vectors.MotionVectorBuffer;
 pub const FrameSynthesisContext = frame_synthesis.FrameSynthesisContext;
+pub const SceneChangeDetector = scene_change.SceneChangeDetector;
+pub const SceneStats = scene_change.SceneStats;
+pub const TileClassifier = tile_classify.TileClassifier;
+pub const ForwardSplat = forward_splat.ForwardSplat;
+pub const PullPushFill = hole_fill.PullPushFill;
+pub const ShaderVariant = shader_variants.Variant;
+pub const OutputFormat = output_format.OutputFormat;
+pub const ShaderLibrary = shader_library.ShaderLibrary;
+pub const PersistentPipelineCache = pipeline_cache.PersistentPipelineCache;
+pub const MemoryArena = memory_arena.MemoryArena;
+pub const SynthesisGraph = synthesis_graph.Graph;
+pub const MotionVectorRing = mv_ring.MotionVectorRing;
+pub const GpuTimer = gpu_timing.GpuTimer;
+pub const OutputRing = output_ring.OutputRing;
+pub const AsyncQueues = async_queue.AsyncQueues;
+pub const ReplayCache = synthesis_replay.ReplayCache;
+pub const DescriptorBuffer = synthesis_descriptors.DescriptorBuffer;
+pub const ConstantsBuffer = synthesis_constants.ConstantsBuffer;
+pub const PassShader = frame_synthesis.PassShader;
+pub const PassImages = synthesis_descriptors.PassImages;
+pub const SizedResources = frame_resize.SizedResources;
 pub const FrameGenContext = frame_generation.FrameGenContext;
 pub const FrameGenConfig = frame_generation.FrameGenConfig;
 pub const FrameGenMode = frame_generation.FrameGenMode;
 pub const FrameGenStats = frame_generation.FrameGenStats;
 pub const GeneratedFrame = frame_generation.GeneratedFrame;
+pub const GenerationStrategy = frame_generation.GenerationStrategy;
+pub const StrategyPolicy = frame_generation.StrategyPolicy;
 
 // Present injection exports
 pub const PresentInjectionContext = present_injection.PresentInjectionContext;
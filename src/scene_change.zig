@@ -0,0 +1,527 @@
+//! Scene Change Detection and Flow Confidence
+//!
+//! GPU reduction over the optical flow cost map and motion field that
+//! detects camera cuts and rates how far the motion field can be trusted,
+//! so frame generation does not synthesize garbage frames across cuts or
+//! present frames built from unreliable flow.
+//!
+//! Pipeline (recorded after optical flow, before synthesis):
+//! 1. scene_stats.comp: per-workgroup partial sums of cost, cost^2,
+//!    high-cost count, motion magnitude, magnitude^2 and confidence, plus
+//!    an optional 32-bin luminance histogram of the current frame. Also
+//!    writes the low-res tile confidence texture read by the blend shaders
+//! 2. scene_stats_finalize.comp: combines the partials, compares the
+//!    histogram with the previous frame's and writes the result to a
+//!    host-visible readback slot, together with the indirect dispatch
+//!    arguments that gate synthesis (zero groups on a cut or when the
+//!    global confidence is below the minimum). Synthesis passes and the
+//!    tile classifier get separate arguments: the passes run on the
+//!    workgroup shape's grid, the classifier on the 16x16 tile grid.
+//!    A third set is the inverse of the gate: the tile grid when gated,
+//!    so a skipped batch's outputs get a passthrough of the current frame.
+//!
+//! Per-sample confidence is 1 - cost * cost_scale, multiplied by the
+//! forward/backward consistency term when bidirectional flow is available.
+//!
+//! The CPU reads the ring one frame late and never waits on the GPU: a
+//! slot whose frame index does not match yet is counted as stale and skipped.
+//!
+//! Partials, histogram and the tile confidence image are shared by every
+//! frame in flight. Each record() starts with a barrier behind the previous
+//! frame's finalize, blends and indirect dispatches, so a frame's
+//! confidence and gates only ever come from its own reduction.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const motion_vectors = @import("motion_vectors.zig");
+const test_stubs = @import("test_stubs.zig");
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+/// Luminance histogram bins
+pub const histogram_bins: u32 = 32;
+
+/// Readback slots (results are read one frame after they are recorded)
+pub const readback_depth: u32 = 2;
+
+/// Push constant flag: cost map is valid
+pub const flag_cost: u32 = 1 << 0;
+/// Push constant flag: luminance histogram enabled
+pub const flag_histogram: u32 = 1 << 1;
+/// Push constant flag: backward flow is valid (consistency check)
+pub const flag_backward: u32 = 1 << 2;
+
+/// Flow samples per tile confidence texel along each axis
+/// (16x16 pixels at 4x4 grid size)
+pub const confidence_tile_samples: u32 = 4;
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// GPU result layout (std430), written by scene_stats_finalize.comp
+pub const SceneStatsResult = extern struct {
+    /// Low 32 bits of the frame index that produced this result
+    frame_index: u32,
+    scene_change: u32,
+    mean_cost: f32,
+    cost_variance: f32,
+    high_cost_fraction: f32,
+    mean_motion: f32,
+    motion_variance: f32,
+    histogram_diff: f32,
+    /// Indirect dispatch arguments for synthesis passes (zero on cut)
+    dispatch: vk.VkDispatchIndirectCommand,
+    /// Mean per-sample flow confidence (0.0-1.0)
+    confidence: f32,
+    /// Indirect dispatch arguments for tile classification, one group per
+    /// 16x16 tile (zero on cut)
+    tile_dispatch: vk.VkDispatchIndirectCommand,
+    /// Indirect dispatch arguments for the passthrough copy over the tile
+    /// grid (zero unless gated)
+    passthrough_dispatch: vk.VkDispatchIndirectCommand,
+    _reserved: [2]u32 = .{ 0, 0 },
+};
+
+/// Byte offset of the indirect dispatch arguments within SceneStatsResult
+pub const dispatch_args_offset: vk.VkDeviceSize = @offsetOf(SceneStatsResult, "dispatch");
+
+/// Byte offset of the tile classification arguments within SceneStatsResult
+pub const tile_dispatch_args_offset: vk.VkDeviceSize = @offsetOf(SceneStatsResult, "tile_dispatch");
+
+/// Byte offset of the passthrough arguments within SceneStatsResult
+pub const passthrough_dispatch_args_offset: vk.VkDeviceSize = @offsetOf(SceneStatsResult, "passthrough_dispatch");
+
+/// Gates of one frame, all in its readback slot's result
+pub const Gates = struct {
+    /// Synthesis passes (workgroup shape grid)
+    synthesis: frame_synthesis.DispatchGate,
+    /// Tile classification (tile grid)
+    tiles: frame_synthesis.DispatchGate,
+    /// Passthrough of the current frame (tile grid, inverse of the gate)
+    passthrough: frame_synthesis.DispatchGate,
+};
+
+/// Per-frame scene statistics
+pub const SceneStats = struct {
+    mean_cost: f32 = 0.0,
+    cost_variance: f32 = 0.0,
+    high_cost_fraction: f32 = 0.0,
+    mean_motion: f32 = 0.0,
+    motion_variance: f32 = 0.0,
+    histogram_diff: f32 = 0.0,
+    confidence: f32 = 1.0,
+    scene_change: bool = false,
+
+    pub fn fromResult(result: SceneStatsResult) SceneStats {
+        return .{
+            .mean_cost = result.mean_cost,
+            .cost_variance = result.cost_variance,
+            .high_cost_fraction = result.high_cost_fraction,
+            .mean_motion = result.mean_motion,
+            .motion_variance = result.motion_variance,
+            .histogram_diff = result.histogram_diff,
+            .confidence = result.confidence,
+            .scene_change = result.scene_change != 0,
+        };
+    }
+};
+
+/// Detection thresholds
+pub const Thresholds = struct {
+    /// Cost value counted as high (raw optical flow cost, 0-255)
+    high_cost: f32 = 128.0,
+    /// Fraction of high-cost samples that marks a cut
+    cut_fraction: f32 = 0.7,
+    /// Normalized histogram distance (0-1) that marks a cut
+    histogram: f32 = 0.5,
+    /// Compare luminance histograms (required when no cost map is available)
+    use_histogram: bool = false,
+    /// Global confidence below which synthesis is skipped (0 = never)
+    min_confidence: f32 = 0.0,
+
+    /// CPU mirror of the cut decision made by scene_stats_finalize.comp
+    pub fn isSceneChange(self: Thresholds, stats: SceneStats) bool {
+        if (stats.high_cost_fraction >= self.cut_fraction) return true;
+        return self.use_histogram and stats.histogram_diff >= self.histogram;
+    }
+
+    /// CPU mirror of the synthesis gate written by scene_stats_finalize.comp
+    pub fn gatesSynthesis(self: Thresholds, stats: SceneStats) bool {
+        return self.isSceneChange(stats) or stats.confidence < self.min_confidence;
+    }
+};
+
+/// Per-sample confidence mapping
+pub const ConfidenceParams = struct {
+    /// Cost -> confidence scale (1/255: maximum cost is zero confidence)
+    cost_scale: f32 = 0.004,
+    /// Forward/backward round-trip error in pixels that is zero confidence
+    consistency_tolerance: f32 = 2.0,
+};
+
+/// Push constants for scene_stats.comp
+pub const SceneStatsPushConstants = extern struct {
+    mv_scale_x: f32,
+    mv_scale_y: f32,
+    high_cost_threshold: f32,
+    flags: u32,
+    cost_scale: f32,
+    consistency_tolerance: f32,
+    _reserved: [2]f32 = .{ 0, 0 },
+};
+
+/// Push constants for scene_stats_finalize.comp
+pub const SceneFinalizePushConstants = extern struct {
+    partial_count: u32,
+    frame_index: u32,
+    cut_fraction: f32,
+    histogram_threshold: f32,
+    dispatch_x: u32,
+    dispatch_y: u32,
+    flags: u32,
+    min_confidence: f32,
+    tile_dispatch_x: u32,
+    tile_dispatch_y: u32,
+};
+
+/// Host-visible result buffer for one frame in flight
+pub const ReadbackSlot = struct {
+    /// Needs TRANSFER_SRC usage: synthesis copies the gates into its
+    /// constants buffer (synthesis_constants.zig)
+    buffer: ?vk.VkBuffer = null,
+    /// Persistently mapped, host-coherent
+    mapped: ?*volatile SceneStatsResult = null,
+    /// Descriptor set with this slot bound as the result buffer and the
+    /// tile confidence image at binding 7
+    descriptor_set: ?vk.VkDescriptorSet = null,
+};
+
+/// Workgroups of the reduction pass for a flow grid
+pub fn partialCount(grid_width: u32, grid_height: u32) u32 {
+    return frame_synthesis.groupCount(grid_width) * frame_synthesis.groupCount(grid_height);
+}
+
+/// Size of the partials storage buffer for a flow grid
+pub fn partialsBufferSize(grid_width: u32, grid_height: u32) vk.VkDeviceSize {
+    // Two vec4 per workgroup
+    return @as(vk.VkDeviceSize, partialCount(grid_width, grid_height)) * 2 * 16;
+}
+
+/// Tile confidence texture extent for a flow grid dimension
+pub fn confidenceExtent(grid_extent: u32) u32 {
+    return (grid_extent + confidence_tile_samples - 1) / confidence_tile_samples;
+}
+
+/// Scene change detector
+pub const SceneChangeDetector = struct {
+    // Pipelines (optional until created)
+    reduce_pipeline: ?vk.VkPipeline = null,
+    finalize_pipeline: ?vk.VkPipeline = null,
+    pipeline_layout: ?vk.VkPipelineLayout = null,
+
+    // Host-visible result ring
+    slots: [readback_depth]ReadbackSlot = [_]ReadbackSlot{.{}} ** readback_depth,
+
+    thresholds: Thresholds,
+    confidence: ConfidenceParams = .{},
+    cost_enabled: bool,
+
+    // State
+    frame_index: u64 = 0,
+    last_stats: SceneStats = .{},
+    cuts_detected: u64 = 0,
+    gated_frames: u64 = 0,
+    stale_reads: u64 = 0,
+
+    // Dispatch table
+    dispatch: ?*const vk.DeviceDispatch,
+
+    /// Initialize scene change detector
+    pub fn init(
+        thresholds: Thresholds,
+        cost_enabled: bool,
+        dispatch: ?*const vk.DeviceDispatch,
+    ) SceneChangeDetector {
+        var t = thresholds;
+        // Without a cost map the histogram is the only signal
+        if (!cost_enabled) t.use_histogram = true;
+        return .{
+            .thresholds = t,
+            .cost_enabled = cost_enabled,
+            .dispatch = dispatch,
+        };
+    }
+
+    /// Attach a host-visible result buffer to a readback slot
+    pub fn bindReadbackSlot(self: *SceneChangeDetector, slot: u32, readback: ReadbackSlot) !void {
+        if (slot >= readback_depth) return error.InvalidSlot;
+        self.slots[slot] = readback;
+    }
+
+    /// Check if GPU detection can run (pipelines, slots and indirect dispatch)
+    pub fn isActive(self: *const SceneChangeDetector) bool {
+        const d = self.dispatch orelse return false;
+        if (!d.hasComputeRecording() or d.vkCmdDispatchIndirect == null) return false;
+        if (self.reduce_pipeline == null or self.finalize_pipeline == null or self.pipeline_layout == null) return false;
+        for (self.slots) |slot| {
+            if (slot.buffer == null or slot.mapped == null or slot.descriptor_set == null) return false;
+        }
+        return true;
+    }
+
+    /// Record the reduction for the current frame pair and return the gates
+    /// for this frame's synthesis passes (`synthesis_groups_*` when not
+    /// gated) and tile classification (`frame_width` x `frame_height` in
+    /// tiles). Returns null (ungated) when detection is not active.
+    pub fn record(
+        self: *SceneChangeDetector,
+        cmd: vk.VkCommandBuffer,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        synthesis_groups_x: u32,
+        synthesis_groups_y: u32,
+        frame_width: u32,
+        frame_height: u32,
+    ) ?Gates {
+        self.frame_index += 1;
+        if (!self.isActive()) return null;
+
+        const d = self.dispatch.?;
+        const layout = self.pipeline_layout.?;
+        const slot = self.slots[self.slotIndex(self.frame_index)];
+
+        const flags: u32 = (if (self.cost_enabled and mv_buffer.cost_view != null) flag_cost else 0) |
+            (if (self.thresholds.use_histogram) flag_histogram else 0) |
+            (if (mv_buffer.backward_view != null) flag_backward else 0);
+
+        // Write-after-read on the shared scratch: the previous frame's
+        // finalize reads partials and histogram, its blends the tile
+        // confidence image, and the indirect dispatches two frames back
+        // this slot's arguments
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | vk.VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT | vk.VK_ACCESS_SHADER_WRITE_BIT,
+        );
+
+        const sets = [_]vk.VkDescriptorSet{slot.descriptor_set.?};
+        if (d.vkCmdBindDescriptorSets) |bind_sets| {
+            bind_sets(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets, 0, null);
+        }
+
+        // Pass 1: per-workgroup partials over the flow grid
+        const reduce = SceneStatsPushConstants{
+            .mv_scale_x = mv_buffer.mvScale(),
+            .mv_scale_y = mv_buffer.mvScale(),
+            .high_cost_threshold = self.thresholds.high_cost,
+            .flags = flags,
+            .cost_scale = self.confidence.cost_scale,
+            .consistency_tolerance = self.confidence.consistency_tolerance,
+        };
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.reduce_pipeline.?);
+        d.vkCmdPushConstants.?(cmd, layout, vk.VK_SHADER_STAGE_COMPUTE_BIT, 0, @sizeOf(SceneStatsPushConstants), &reduce);
+        d.vkCmdDispatch.?(cmd, frame_synthesis.groupCount(mv_buffer.width), frame_synthesis.groupCount(mv_buffer.height), 1);
+
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT,
+        );
+
+        // Pass 2: single workgroup finalize
+        const finalize = SceneFinalizePushConstants{
+            .partial_count = partialCount(mv_buffer.width, mv_buffer.height),
+            .frame_index = @truncate(self.frame_index),
+            .cut_fraction = self.thresholds.cut_fraction,
+            .histogram_threshold = self.thresholds.histogram,
+            .dispatch_x = synthesis_groups_x,
+            .dispatch_y = synthesis_groups_y,
+            .flags = flags,
+            .min_confidence = self.thresholds.min_confidence,
+            .tile_dispatch_x = frame_synthesis.groupCount(frame_width),
+            .tile_dispatch_y = frame_synthesis.groupCount(frame_height),
+        };
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.finalize_pipeline.?);
+        d.vkCmdPushConstants.?(cmd, layout, vk.VK_SHADER_STAGE_COMPUTE_BIT, 0, @sizeOf(SceneFinalizePushConstants), &finalize);
+        d.vkCmdDispatch.?(cmd, 1, 1, 1);
+
+        // Result feeds the synthesis indirect dispatches and the host readback
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | vk.VK_PIPELINE_STAGE_HOST_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_INDIRECT_COMMAND_READ_BIT | vk.VK_ACCESS_HOST_READ_BIT,
+        );
+
+        return .{
+            .synthesis = .{ .buffer = slot.buffer.?, .offset = dispatch_args_offset },
+            .tiles = .{ .buffer = slot.buffer.?, .offset = tile_dispatch_args_offset },
+            .passthrough = .{ .buffer = slot.buffer.?, .offset = passthrough_dispatch_args_offset },
+        };
+    }
+
+    /// Read the previous frame's result without waiting on the GPU.
+    /// Returns null if detection is inactive or the result is not ready.
+    pub fn poll(self: *SceneChangeDetector) ?SceneStats {
+        if (self.frame_index < 2 or !self.isActive()) return null;
+
+        const expected = self.frame_index - 1;
+        const mapped = self.slots[self.slotIndex(expected)].mapped.?;
+        const result: SceneStatsResult = mapped.*;
+
+        if (result.frame_index != @as(u32, @truncate(expected))) {
+            self.stale_reads += 1;
+            return null;
+        }
+
+        const stats = SceneStats.fromResult(result);
+        self.last_stats = stats;
+        if (stats.scene_change) self.cuts_detected += 1;
+        if (self.thresholds.gatesSynthesis(stats)) self.gated_frames += 1;
+        return stats;
+    }
+
+    fn slotIndex(self: *const SceneChangeDetector, frame_index: u64) usize {
+        _ = self;
+        return @intCast(frame_index % readback_depth);
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "SceneStatsResult layout" {
+    try std.testing.expectEqual(@as(usize, 80), @sizeOf(SceneStatsResult));
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 32), dispatch_args_offset);
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 48), tile_dispatch_args_offset);
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 60), passthrough_dispatch_args_offset);
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(SceneStatsPushConstants));
+    try std.testing.expectEqual(@as(usize, 40), @sizeOf(SceneFinalizePushConstants));
+}
+
+test "Thresholds.isSceneChange" {
+    const t = Thresholds{};
+    try std.testing.expect(!t.isSceneChange(.{ .high_cost_fraction = 0.2 }));
+    try std.testing.expect(t.isSceneChange(.{ .high_cost_fraction = 0.8 }));
+
+    // Histogram only counts when enabled
+    try std.testing.expect(!t.isSceneChange(.{ .histogram_diff = 0.9 }));
+    const h = Thresholds{ .use_histogram = true };
+    try std.testing.expect(h.isSceneChange(.{ .histogram_diff = 0.9 }));
+}
+
+test "Thresholds.gatesSynthesis" {
+    const t = Thresholds{ .min_confidence = 0.3 };
+    try std.testing.expect(!t.gatesSynthesis(.{ .confidence = 0.8 }));
+    try std.testing.expect(t.gatesSynthesis(.{ .confidence = 0.1 }));
+    try std.testing.expect(t.gatesSynthesis(.{ .confidence = 0.8, .high_cost_fraction = 0.9 }));
+
+    // Disabled by default
+    try std.testing.expect(!(Thresholds{}).gatesSynthesis(.{ .confidence = 0.0 }));
+}
+
+test "confidence texture extent" {
+    // 1080p at 4x4 grid: one texel per 16x16 pixel tile
+    try std.testing.expectEqual(@as(u32, 120), confidenceExtent(480));
+    try std.testing.expectEqual(@as(u32, 68), confidenceExtent(270));
+}
+
+test "partial buffer sizing" {
+    // 1080p at 4x4 grid: 480x270 -> 30x17 workgroups
+    try std.testing.expectEqual(@as(u32, 510), partialCount(480, 270));
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 510 * 32), partialsBufferSize(480, 270));
+}
+
+test "poll reads one frame late and skips stale slots" {
+    var results: [readback_depth]SceneStatsResult = undefined;
+    var detector = SceneChangeDetector.init(.{}, true, &test_stubs.recording_dispatch);
+    try std.testing.expect(!detector.isActive());
+    try test_stubs.bindDetector(&detector, &results);
+    try std.testing.expect(detector.isActive());
+
+    const mvb = test_stubs.motionVectors(0x1);
+    const cmd: vk.VkCommandBuffer = @ptrFromInt(0x4);
+
+    // Frame 1 recorded; nothing to read yet
+    // 8x8 workgroups: synthesis and classifier grids differ
+    const gates = detector.record(cmd, &mvb, 240, 135, 1920, 1080).?;
+    try std.testing.expectEqual(dispatch_args_offset, gates.synthesis.offset);
+    try std.testing.expectEqual(tile_dispatch_args_offset, gates.tiles.offset);
+    try std.testing.expectEqual(passthrough_dispatch_args_offset, gates.passthrough.offset);
+    try std.testing.expectEqual(gates.synthesis.buffer, gates.tiles.buffer);
+    try std.testing.expect(detector.poll() == null);
+
+    // Frame 2 recorded; frame 1 result not written by the GPU yet
+    _ = detector.record(cmd, &mvb, 240, 135, 1920, 1080);
+    try std.testing.expect(detector.poll() == null);
+    try std.testing.expectEqual(@as(u64, 1), detector.stale_reads);
+
+    // GPU completes frame 2 with a cut; read during frame 3
+    _ = detector.record(cmd, &mvb, 240, 135, 1920, 1080);
+    results[2 % readback_depth].frame_index = 2;
+    results[2 % readback_depth].scene_change = 1;
+    results[2 % readback_depth].high_cost_fraction = 0.9;
+    results[2 % readback_depth].confidence = 0.2;
+    const stats = detector.poll().?;
+    try std.testing.expect(stats.scene_change);
+    try std.testing.expectApproxEqRel(@as(f32, 0.2), stats.confidence, 0.001);
+    try std.testing.expectEqual(@as(u64, 1), detector.cuts_detected);
+    try std.testing.expectEqual(@as(u64, 1), detector.gated_frames);
+}
+
+test "each frame's reduction waits for the previous frame's reads" {
+    var d = test_stubs.recording_dispatch;
+    d.vkCmdDispatch = stubLogDispatch;
+    d.vkCmdPipelineBarrier = stubLogBarrier;
+    var results: [readback_depth]SceneStatsResult = undefined;
+    var detector = SceneChangeDetector.init(.{}, true, &d);
+    try test_stubs.bindDetector(&detector, &results);
+    const mvb = test_stubs.motionVectors(0x1);
+    const cmd: vk.VkCommandBuffer = @ptrFromInt(0x4);
+
+    // Frames 1 and 2 in flight at once
+    test_events_len = 0;
+    const first = detector.record(cmd, &mvb, 240, 135, 1920, 1080).?;
+    const second = detector.record(cmd, &mvb, 240, 135, 1920, 1080).?;
+    try std.testing.expect(first.synthesis.buffer != second.synthesis.buffer);
+
+    // barrier, reduce, barrier, finalize, barrier per frame
+    try std.testing.expectEqual(@as(usize, 10), test_events_len);
+    for ([_]usize{ 0, 5 }) |start| {
+        const wait = test_events[start];
+        try std.testing.expect(wait.barrier);
+        try std.testing.expect(wait.src_stage & vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT != 0);
+        try std.testing.expect(wait.src_stage & vk.VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT != 0);
+        try std.testing.expect(wait.dst_access & vk.VK_ACCESS_SHADER_WRITE_BIT != 0);
+        try std.testing.expect(!test_events[start + 1].barrier);
+    }
+}
+
+const TestEvent = struct {
+    barrier: bool,
+    src_stage: vk.VkPipelineStageFlags = 0,
+    dst_access: vk.VkAccessFlags = 0,
+};
+var test_events: [16]TestEvent = undefined;
+var test_events_len: usize = 0;
+
+fn stubLogDispatch(_: vk.VkCommandBuffer, _: u32, _: u32, _: u32) callconv(.c) void {
+    if (test_events_len == test_events.len) return;
+    test_events[test_events_len] = .{ .barrier = false };
+    test_events_len += 1;
+}
+
+fn stubLogBarrier(_: vk.VkCommandBuffer, src: vk.VkPipelineStageFlags, _: vk.VkPipelineStageFlags, _: u32, _: u32, barriers: ?[*]const vk.VkMemoryBarrier, _: u32, _: ?*const anyopaque, _: u32, _: ?*const anyopaque) callconv(.c) void {
+    if (test_events_len == test_events.len) return;
+    test_events[test_events_len] = .{ .barrier = true, .src_stage = src, .dst_access = barriers.?[0].dstAccessMask };
+    test_events_len += 1;
+}
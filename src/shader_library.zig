@@ -0,0 +1,167 @@
+//! Shader Library
+//!
+//! build.zig embeds the SPIR-V of every shader into libnvvk
+//! (-Dembed-shaders, on by default), so creating pipelines needs no file
+//! I/O and does not depend on the install prefix, which differs inside
+//! Proton containers.
+//!
+//! For shader development an override directory (ShaderLibrary.init, or
+//! NVVK_SHADER_DIR) is searched first. Files missing there, or not valid
+//! SPIR-V, fall back to the embedded copy.
+
+const std = @import("std");
+const embedded_shaders = @import("nvvk_shaders");
+const output_format = @import("output_format.zig");
+
+/// Environment variable naming the override directory
+pub const override_env = "NVVK_SHADER_DIR";
+
+/// First word of every SPIR-V module
+pub const spirv_magic: u32 = 0x07230203;
+
+const embedded_map = std.StaticStringMap([]const u32).initComptime(blk: {
+    var kvs: [embedded_shaders.files.len]struct { []const u8, []const u32 } = undefined;
+    for (embedded_shaders.files, 0..) |file, i| kvs[i] = .{ file.name, file.spirv };
+    break :blk kvs;
+});
+
+// =============================================================================
+// Embedded SPIR-V
+// =============================================================================
+
+/// Embedded SPIR-V of a file name as built by build.zig ("linear_blend.spv")
+pub fn embedded(name: []const u8) ?[]const u32 {
+    return embedded_map.get(name);
+}
+
+/// Number of embedded shaders (0 when built with -Dembed-shaders=false)
+pub fn embeddedCount() usize {
+    return embedded_shaders.files.len;
+}
+
+/// Hash of every embedded shader (keys persistent pipeline caches)
+pub fn embeddedHash() u64 {
+    var hasher = std.hash.Wyhash.init(0);
+    for (embedded_shaders.files) |file| {
+        hasher.update(file.name);
+        hasher.update(std.mem.sliceAsBytes(file.spirv));
+    }
+    return hasher.final();
+}
+
+/// SpirvSource over the embedded SPIR-V only
+pub const embedded_source = output_format.SpirvSource{ .load = loadEmbedded };
+
+fn loadEmbedded(_: ?*anyopaque, name: []const u8) ?[]const u32 {
+    return embedded(name);
+}
+
+/// Check that words look like a SPIR-V module (magic + 5-word header)
+pub fn isSpirv(words: []const u32) bool {
+    return words.len >= 5 and words[0] == spirv_magic;
+}
+
+// =============================================================================
+// Shader Library
+// =============================================================================
+
+/// Embedded SPIR-V with an optional development override directory
+pub const ShaderLibrary = struct {
+    allocator: std.mem.Allocator,
+    override_dir: ?[]const u8 = null,
+    // SPIR-V read from the override directory, by file name (owned)
+    overrides: std.StringHashMapUnmanaged([]u32) = .empty,
+
+    pub fn init(allocator: std.mem.Allocator, override_dir: ?[]const u8) ShaderLibrary {
+        return .{ .allocator = allocator, .override_dir = override_dir };
+    }
+
+    /// Library with the override directory from NVVK_SHADER_DIR, if set
+    pub fn initFromEnv(allocator: std.mem.Allocator) ShaderLibrary {
+        return init(allocator, std.posix.getenv(override_env));
+    }
+
+    pub fn deinit(self: *ShaderLibrary) void {
+        var it = self.overrides.iterator();
+        while (it.next()) |entry| {
+            self.allocator.free(entry.key_ptr.*);
+            self.allocator.free(entry.value_ptr.*);
+        }
+        self.overrides.deinit(self.allocator);
+    }
+
+    /// SPIR-V of a file name: override directory first, then embedded.
+    /// Override files are read once and kept until deinit.
+    pub fn load(self: *ShaderLibrary, name: []const u8) ?[]const u32 {
+        if (self.override_dir) |dir| {
+            if (self.overrides.get(name)) |words| return words;
+            if (self.readOverride(dir, name)) |words| return words else |_| {}
+        }
+        return embedded(name);
+    }
+
+    /// SpirvSource for pipeline creation (output_format.FormatPipelineCache)
+    pub fn source(self: *ShaderLibrary) output_format.SpirvSource {
+        return .{ .context = self, .load = loadFromLibrary };
+    }
+
+    fn loadFromLibrary(context: ?*anyopaque, name: []const u8) ?[]const u32 {
+        const self: *ShaderLibrary = @ptrCast(@alignCast(context.?));
+        return self.load(name);
+    }
+
+    fn readOverride(self: *ShaderLibrary, dir: []const u8, name: []const u8) ![]const u32 {
+        const words = try readSpirvFile(self.allocator, dir, name);
+        errdefer self.allocator.free(words);
+        const key = try self.allocator.dupe(u8, name);
+        errdefer self.allocator.free(key);
+        try self.overrides.put(self.allocator, key, words);
+        return words;
+    }
+};
+
+/// Read {dir}/{name} as SPIR-V (caller frees)
+pub fn readSpirvFile(allocator: std.mem.Allocator, dir: []const u8, name: []const u8) ![]u32 {
+    const path = try std.fs.path.join(allocator, &.{ dir, name });
+    defer allocator.free(path);
+    const file = try std.fs.cwd().openFile(path, .{});
+    defer file.close();
+
+    const size: usize = @intCast(try file.getEndPos());
+    if (size % @sizeOf(u32) != 0) return error.InvalidSpirv;
+    const words = try allocator.alloc(u32, size / @sizeOf(u32));
+    errdefer allocator.free(words);
+    if (try file.readAll(std.mem.sliceAsBytes(words)) != size) return error.InvalidSpirv;
+    if (!isSpirv(words)) return error.InvalidSpirv;
+    return words;
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "embedded SPIR-V" {
+    try std.testing.expect(embedded("no_such_shader.spv") == null);
+    if (embeddedCount() == 0) return error.SkipZigTest;
+
+    const spirv = embedded("linear_blend.spv") orelse return error.TestUnexpectedResult;
+    try std.testing.expect(isSpirv(spirv));
+    try std.testing.expect(embedded("forward_warp_fp16_rgb10a2.spv") != null);
+    try std.testing.expect(embedded_source.load(null, "tile_copy.spv") != null);
+}
+
+test "isSpirv" {
+    try std.testing.expect(!isSpirv(&.{}));
+    try std.testing.expect(!isSpirv(&.{ 0x12345678, 0, 0, 0, 0 }));
+    try std.testing.expect(isSpirv(&.{ spirv_magic, 0x00010500, 0, 16, 0 }));
+}
+
+test "missing override falls back to embedded" {
+    var library = ShaderLibrary.init(std.testing.allocator, "/nonexistent/nvvk/shaders");
+    defer library.deinit();
+    const src = library.source();
+    const from_library = src.load(src.context, "linear_blend.spv");
+    const from_embedded = embedded("linear_blend.spv");
+    try std.testing.expectEqual(from_embedded == null, from_library == null);
+    try std.testing.expectEqual(@as(u32, 0), library.overrides.count());
+}
@@ -0,0 +1,287 @@
+//! Synthesis Shader Variants
+//!
+//! The synthesis kernels (forward/backward warp, linear and confidence
+//! blend, occlusion fill) are built in two precisions and specialized for
+//! their workgroup shape at pipeline creation:
+//! - fp32: shaders/{name}.spv
+//! - fp16: shaders/{name}_fp16.spv, color math in half precision
+//!   (GL_EXT_shader_explicit_arithmetic_types_float16), which runs packed
+//!   at twice the fp32 rate on most GPUs. Needs shaderFloat16.
+//!
+//! Specialization constant 0 is the tile class (see tile_classify.zig),
+//! 1 and 2 the workgroup size, 3 the output transfer function (see
+//! output_format.zig). Tiled pipelines must keep 16x16, one
+//! workgroup per tile; the shape only applies to full-frame pipelines.
+//!
+//! selectVariant picks from queried device properties; nvvk-bench
+//! (src/bench.zig) times every variant, and selectFastest turns its
+//! timings into a choice.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Workgroup shape (local_size_x/y, specialization constants 1 and 2)
+pub const WorkgroupShape = struct {
+    x: u32 = 16,
+    y: u32 = 16,
+
+    /// Shapes worth timing: 256 invocations square, 64 invocations (one
+    /// AMD wave), and 256 invocations along rows (CPU vector width)
+    pub const candidates = [_]WorkgroupShape{
+        .{ .x = 16, .y = 16 },
+        .{ .x = 8, .y = 8 },
+        .{ .x = 32, .y = 8 },
+    };
+
+    /// Workgroups needed to cover a frame width
+    pub fn groupsX(self: WorkgroupShape, width: u32) u32 {
+        return (width + self.x - 1) / self.x;
+    }
+
+    /// Workgroups needed to cover a frame height
+    pub fn groupsY(self: WorkgroupShape, height: u32) u32 {
+        return (height + self.y - 1) / self.y;
+    }
+
+    pub fn invocations(self: WorkgroupShape) u32 {
+        return self.x * self.y;
+    }
+};
+
+/// Arithmetic precision of the synthesis kernels
+pub const Precision = enum {
+    fp32,
+    fp16,
+};
+
+/// One compiled + specialized flavor of the synthesis kernels
+pub const Variant = struct {
+    precision: Precision = .fp32,
+    workgroup: WorkgroupShape = .{},
+
+    /// SPIR-V file name of a synthesis shader in this precision
+    pub fn spirvName(self: Variant, buf: []u8, shader: []const u8) ![]const u8 {
+        return switch (self.precision) {
+            .fp32 => std.fmt.bufPrint(buf, "{s}.spv", .{shader}),
+            .fp16 => std.fmt.bufPrint(buf, "{s}_fp16.spv", .{shader}),
+        };
+    }
+};
+
+/// Synthesis shaders built in both precisions
+pub const synthesis_shaders = [_][]const u8{
+    "forward_warp",
+    "backward_warp",
+    "linear_blend",
+    "confidence_blend",
+    "occlusion_fill",
+};
+
+/// Specialization data for synthesis pipelines
+pub const SpecializationConstants = extern struct {
+    /// TILE_CLASS (0 = full frame)
+    tile_class: u32 = 0,
+    local_size_x: u32 = 16,
+    local_size_y: u32 = 16,
+    /// TRANSFER of stored color (output_format.TransferFunction)
+    transfer: u32 = 0,
+
+    pub const map_entries = [_]vk.VkSpecializationMapEntry{
+        .{ .constantID = 0, .offset = @offsetOf(SpecializationConstants, "tile_class"), .size = @sizeOf(u32) },
+        .{ .constantID = 1, .offset = @offsetOf(SpecializationConstants, "local_size_x"), .size = @sizeOf(u32) },
+        .{ .constantID = 2, .offset = @offsetOf(SpecializationConstants, "local_size_y"), .size = @sizeOf(u32) },
+        .{ .constantID = 3, .offset = @offsetOf(SpecializationConstants, "transfer"), .size = @sizeOf(u32) },
+    };
+
+    /// Constants for a full-frame pipeline of a variant
+    pub fn fullFrame(variant: Variant) SpecializationConstants {
+        return .{ .local_size_x = variant.workgroup.x, .local_size_y = variant.workgroup.y };
+    }
+
+    /// Constants for a tiled pipeline (always 16x16)
+    pub fn tiled(tile_class: u32) SpecializationConstants {
+        return .{ .tile_class = tile_class };
+    }
+
+    pub fn info(self: *const SpecializationConstants) vk.VkSpecializationInfo {
+        return .{
+            .mapEntryCount = map_entries.len,
+            .pMapEntries = &map_entries,
+            .dataSize = @sizeOf(SpecializationConstants),
+            .pData = self,
+        };
+    }
+};
+
+// =============================================================================
+// Variant Selection
+// =============================================================================
+
+/// Device properties that decide the variant
+pub const DeviceCaps = struct {
+    vendor_id: u32 = 0,
+    device_type: u32 = 0,
+    shader_float16: bool = false,
+};
+
+/// Query variant-relevant properties of a physical device
+pub fn queryDeviceCaps(
+    physical_device: vk.VkPhysicalDevice,
+    get_properties: vk.PFN_vkGetPhysicalDeviceProperties,
+    get_features2: ?vk.PFN_vkGetPhysicalDeviceFeatures2,
+) DeviceCaps {
+    var props = vk.VkPhysicalDeviceProperties{};
+    get_properties(physical_device, &props);
+
+    var float16 = vk.VkPhysicalDeviceShaderFloat16Int8Features{};
+    if (get_features2) |features2| {
+        var features = vk.VkPhysicalDeviceFeatures2{ .pNext = &float16 };
+        features2(physical_device, &features);
+    }
+
+    return .{
+        .vendor_id = props.vendorID,
+        .device_type = props.deviceType,
+        .shader_float16 = float16.shaderFloat16 == vk.VK_TRUE,
+    };
+}
+
+/// Pick a variant from device properties. fp16 wherever the device has it
+/// except CPU implementations, which emulate it; the shape follows the
+/// vendor's SIMD width. Benchmark timings (selectFastest) take precedence.
+pub fn selectVariant(caps: DeviceCaps) Variant {
+    if (caps.device_type == vk.VK_PHYSICAL_DEVICE_TYPE_CPU) {
+        return .{ .precision = .fp32, .workgroup = .{ .x = 32, .y = 8 } };
+    }
+    const precision: Precision = if (caps.shader_float16) .fp16 else .fp32;
+    const workgroup: WorkgroupShape = switch (caps.vendor_id) {
+        vk.VK_VENDOR_ID_AMD => .{ .x = 8, .y = 8 },
+        vk.VK_VENDOR_ID_INTEL => .{ .x = 8, .y = 8 },
+        else => .{},
+    };
+    return .{ .precision = precision, .workgroup = workgroup };
+}
+
+/// Measured time of one variant (summed over the synthesis shaders)
+pub const VariantTiming = struct {
+    variant: Variant,
+    time_ns: u64,
+};
+
+/// Fastest measured variant, or null if nothing was measured
+pub fn selectFastest(timings: []const VariantTiming) ?Variant {
+    var best: ?VariantTiming = null;
+    for (timings) |t| {
+        if (t.time_ns == 0) continue;
+        if (best == null or t.time_ns < best.?.time_ns) best = t;
+    }
+    return if (best) |b| b.variant else null;
+}
+
+// =============================================================================
+// Pipeline Creation
+// =============================================================================
+
+/// Create a specialized compute pipeline from SPIR-V. The shader module is
+/// destroyed once the pipeline exists.
+pub fn createComputePipeline(
+    d: *const vk.DeviceDispatch,
+    spirv: []const u32,
+    layout: vk.VkPipelineLayout,
+    spec: SpecializationConstants,
+    cache: ?vk.VkPipelineCache,
+) vk.VulkanError!vk.VkPipeline {
+    return createComputePipelineFlags(d, spirv, layout, spec, cache, 0);
+}
+
+/// Create a compute pipeline with create flags (e.g. for descriptor
+/// buffer layouts, see synthesis_descriptors.zig)
+pub fn createComputePipelineFlags(
+    d: *const vk.DeviceDispatch,
+    spirv: []const u32,
+    layout: vk.VkPipelineLayout,
+    spec: SpecializationConstants,
+    cache: ?vk.VkPipelineCache,
+    flags: u32,
+) vk.VulkanError!vk.VkPipeline {
+    if (!d.hasPipelineCreation()) return vk.VulkanError.FunctionNotFound;
+
+    var module: vk.VkShaderModule = undefined;
+    try vk.check(d.vkCreateShaderModule.?(d.device, &.{
+        .codeSize = spirv.len * @sizeOf(u32),
+        .pCode = spirv.ptr,
+    }, null, &module));
+    defer d.vkDestroyShaderModule.?(d.device, module, null);
+
+    const spec_info = spec.info();
+    const create_info = [_]vk.VkComputePipelineCreateInfo{.{
+        .flags = flags,
+        .stage = .{ .module = module, .pSpecializationInfo = &spec_info },
+        .layout = layout,
+    }};
+    var pipeline: [1]vk.VkPipeline = undefined;
+    try vk.check(d.vkCreateComputePipelines.?(d.device, cache, 1, &create_info, null, &pipeline));
+    return pipeline[0];
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "variant selection" {
+    const cpu = selectVariant(.{ .vendor_id = vk.VK_VENDOR_ID_MESA, .device_type = vk.VK_PHYSICAL_DEVICE_TYPE_CPU, .shader_float16 = true });
+    try std.testing.expectEqual(Precision.fp32, cpu.precision);
+    try std.testing.expectEqual(@as(u32, 32), cpu.workgroup.x);
+
+    const nvidia = selectVariant(.{ .vendor_id = vk.VK_VENDOR_ID_NVIDIA, .device_type = vk.VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, .shader_float16 = true });
+    try std.testing.expectEqual(Precision.fp16, nvidia.precision);
+    try std.testing.expectEqual(@as(u32, 256), nvidia.workgroup.invocations());
+
+    const no_half = selectVariant(.{ .vendor_id = vk.VK_VENDOR_ID_AMD, .device_type = vk.VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU });
+    try std.testing.expectEqual(Precision.fp32, no_half.precision);
+    try std.testing.expectEqual(@as(u32, 64), no_half.workgroup.invocations());
+}
+
+test "selectFastest" {
+    try std.testing.expect(selectFastest(&.{}) == null);
+    const timings = [_]VariantTiming{
+        .{ .variant = .{}, .time_ns = 900 },
+        .{ .variant = .{ .precision = .fp16 }, .time_ns = 600 },
+        .{ .variant = .{ .workgroup = .{ .x = 8, .y = 8 } }, .time_ns = 0 }, // not measured
+    };
+    try std.testing.expectEqual(Precision.fp16, selectFastest(&timings).?.precision);
+}
+
+test "workgroup group counts" {
+    const shape = WorkgroupShape{ .x = 32, .y = 8 };
+    try std.testing.expectEqual(@as(u32, 60), shape.groupsX(1920));
+    try std.testing.expectEqual(@as(u32, 135), shape.groupsY(1080));
+    try std.testing.expectEqual(@as(u32, 68), (WorkgroupShape{}).groupsY(1080));
+}
+
+test "spirv names and specialization layout" {
+    var buf: [64]u8 = undefined;
+    try std.testing.expectEqualStrings("linear_blend.spv", try (Variant{}).spirvName(&buf, "linear_blend"));
+    try std.testing.expectEqualStrings("linear_blend_fp16.spv", try (Variant{ .precision = .fp16 }).spirvName(&buf, "linear_blend"));
+
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(SpecializationConstants));
+    const spec = SpecializationConstants.fullFrame(.{ .workgroup = .{ .x = 8, .y = 8 } });
+    try std.testing.expectEqual(@as(u32, 0), spec.tile_class);
+    try std.testing.expectEqual(@as(u32, 8), spec.local_size_y);
+    const tiled = SpecializationConstants.tiled(2);
+    try std.testing.expectEqual(@as(u32, 16), tiled.local_size_x);
+    try std.testing.expectEqual(@as(u32, 4), spec.info().mapEntryCount);
+}
+
+test "createComputePipeline without pipeline creation" {
+    const dispatch = vk.DeviceDispatch{ .device = @ptrFromInt(0x1000) };
+    const spirv = [_]u32{0x07230203};
+    try std.testing.expectError(
+        vk.VulkanError.FunctionNotFound,
+        createComputePipeline(&dispatch, &spirv, @ptrFromInt(0x2000), .{}, null),
+    );
+}
@@ -0,0 +1,191 @@
+//! Synthesis Pass Constants
+//!
+//! The values the synthesis passes read per frame (interpolation factors,
+//! motion vector scale, quality parameters, the tile confidence flag) live
+//! in a caller-owned uniform buffer rather than in push constants, next to
+//! copies of the scene change gates. The primary command buffer rewrites
+//! it ahead of every batch, so a batch recorded once into a secondary
+//! command buffer (synthesis_replay.zig) still reads the current frame's
+//! values and gates when replayed, and its replay key only has to cover
+//! pipelines and bindings.
+//!
+//! Every pass shader of every output slot reads its own 16-byte block at
+//! binding 9 (blockOffset). Blocks are 256-byte aligned, the largest
+//! minUniformBufferOffsetAlignment allowed. One buffer serves all frames in
+//! flight: the update is ordered after the previous batch's reads, which
+//! requires every batch of a context to be submitted to the same queue.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+
+const PassShader = frame_synthesis.PassShader;
+const DispatchGate = frame_synthesis.DispatchGate;
+const max_batch_frames = frame_synthesis.max_batch_frames;
+const pass_shader_count = frame_synthesis.pass_shader_count;
+
+// =============================================================================
+// Layout
+// =============================================================================
+
+/// Bytes of one pass's block (the std140 PassConstants block)
+pub const block_size: vk.VkDeviceSize = 16;
+
+/// Distance between blocks: every device's minUniformBufferOffsetAlignment
+/// divides it
+pub const block_alignment: vk.VkDeviceSize = 256;
+
+/// Blocks of one output slot, one per pass shader
+pub const slot_size: vk.VkDeviceSize = block_alignment * pass_shader_count;
+
+/// Gate copies follow the blocks of every slot
+pub const gates_offset: vk.VkDeviceSize = slot_size * max_batch_frames;
+
+/// Gates copied from the scene change readback slot of the frame
+pub const Gate = enum {
+    /// Full-frame synthesis passes and the forward splat
+    synthesis,
+    /// Tile classifier and pull-push passes (16x16 tile grid)
+    tiles,
+    /// Passthrough of skipped batches
+    passthrough,
+};
+
+/// Source of each gate this frame (null = ungated)
+pub const Gates = std.EnumArray(Gate, ?DispatchGate);
+
+/// Size the constants buffer must have
+pub const buffer_size: vk.VkDeviceSize = gates_offset + std.meta.fields(Gate).len * @sizeOf(vk.VkDispatchIndirectCommand);
+
+/// Offset of the block a pass shader of an output slot reads
+pub fn blockOffset(slot: u32, shader: PassShader) vk.VkDeviceSize {
+    return @as(vk.VkDeviceSize, slot) * slot_size + @as(vk.VkDeviceSize, @intFromEnum(shader)) * block_alignment;
+}
+
+/// Offset of a gate's copy
+pub fn gateOffset(gate: Gate) vk.VkDeviceSize {
+    return gates_offset + @as(vk.VkDeviceSize, @intFromEnum(gate)) * @sizeOf(vk.VkDispatchIndirectCommand);
+}
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Blocks of a batch, staged on the host
+pub const Blocks = struct {
+    bytes: [gates_offset]u8 align(16) = [_]u8{0} ** gates_offset,
+
+    /// Stage the block of a pass shader of an output slot
+    pub fn set(self: *Blocks, slot: u32, shader: PassShader, block: anytype) void {
+        comptime std.debug.assert(@sizeOf(@TypeOf(block)) == block_size);
+        const offset: usize = @intCast(blockOffset(slot, shader));
+        @memcpy(self.bytes[offset..][0..block_size], std.mem.asBytes(&block));
+    }
+};
+
+/// Caller-owned constants buffer. It needs UNIFORM_BUFFER, INDIRECT_BUFFER
+/// and TRANSFER_DST usage (plus SHADER_DEVICE_ADDRESS with a descriptor
+/// buffer), device-local memory and buffer_size bytes. Scene change
+/// readback buffers need TRANSFER_SRC usage for the gate copies.
+pub const ConstantsBuffer = struct {
+    dispatch: *const vk.DeviceDispatch,
+    buffer: vk.VkBuffer,
+
+    pub fn init(dispatch: *const vk.DeviceDispatch, buffer: vk.VkBuffer) !ConstantsBuffer {
+        if (dispatch.vkCmdUpdateBuffer == null or dispatch.vkCmdCopyBuffer == null) return vk.VulkanError.FunctionNotFound;
+        return .{ .dispatch = dispatch, .buffer = buffer };
+    }
+
+    /// Copy of a gate the passes dispatch from
+    pub fn gate(self: *const ConstantsBuffer, which: Gate) DispatchGate {
+        return .{ .buffer = self.buffer, .offset = gateOffset(which) };
+    }
+
+    /// Record the update of the first `slots` output slots' blocks and the
+    /// copies of the present gates. Into the primary command buffer, ahead
+    /// of the batch (recorded or replayed) that reads them.
+    pub fn record(self: *const ConstantsBuffer, cmd: vk.VkCommandBuffer, blocks: *const Blocks, slots: u32, gates: Gates) void {
+        const d = self.dispatch;
+        // The previous batch is done reading the buffer, and this frame's
+        // gates are written (scene_stats_finalize.comp)
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | vk.VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_TRANSFER_READ_BIT | vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+        );
+        if (slots > 0) d.vkCmdUpdateBuffer.?(cmd, self.buffer, 0, slots * slot_size, &blocks.bytes);
+        for (std.enums.values(Gate)) |which| {
+            const source = gates.get(which) orelse continue;
+            const region = [_]vk.VkBufferCopy{.{
+                .srcOffset = source.offset,
+                .dstOffset = gateOffset(which),
+                .size = @sizeOf(vk.VkDispatchIndirectCommand),
+            }};
+            d.vkCmdCopyBuffer.?(cmd, source.buffer, self.buffer, 1, &region);
+        }
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | vk.VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            vk.VK_ACCESS_UNIFORM_READ_BIT | vk.VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+        );
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+var stub_updated: vk.VkDeviceSize = 0;
+var stub_blend_weight: f32 = 0;
+var stub_copies: [3]vk.VkDeviceSize = .{ 0, 0, 0 };
+var stub_copy_count: usize = 0;
+
+fn stubUpdate(_: vk.VkCommandBuffer, _: vk.VkBuffer, offset: vk.VkDeviceSize, size: vk.VkDeviceSize, data: *const anyopaque) callconv(.c) void {
+    std.debug.assert(offset == 0 and size % 4 == 0 and size <= 65536);
+    stub_updated = size;
+    const bytes: [*]const u8 = @ptrCast(data);
+    stub_blend_weight = std.mem.bytesToValue(f32, bytes[@intCast(blockOffset(1, .linear_blend))..][0..4]);
+}
+
+fn stubCopy(_: vk.VkCommandBuffer, _: vk.VkBuffer, _: vk.VkBuffer, count: u32, regions: [*]const vk.VkBufferCopy) callconv(.c) void {
+    for (regions[0..count]) |region| {
+        stub_copies[stub_copy_count] = region.dstOffset;
+        stub_copy_count += 1;
+    }
+}
+
+test "block layout" {
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 0), blockOffset(0, .forward_warp));
+    try std.testing.expectEqual(slot_size + 2 * block_alignment, blockOffset(1, .linear_blend));
+    try std.testing.expect(blockOffset(max_batch_frames - 1, .tile_copy) + block_size <= gates_offset);
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 0), gateOffset(.tiles) % 4);
+    try std.testing.expectEqual(buffer_size, gateOffset(.passthrough) + @sizeOf(vk.VkDispatchIndirectCommand));
+}
+
+test "ConstantsBuffer updates the batch's slots and copies its gates" {
+    var d = vk.DeviceDispatch{ .device = @ptrFromInt(0x1000) };
+    try std.testing.expectError(vk.VulkanError.FunctionNotFound, ConstantsBuffer.init(&d, @ptrFromInt(0x10)));
+    d.vkCmdUpdateBuffer = stubUpdate;
+    d.vkCmdCopyBuffer = stubCopy;
+    const constants = try ConstantsBuffer.init(&d, @ptrFromInt(0x10));
+
+    var blocks = Blocks{};
+    blocks.set(1, .linear_blend, [4]f32{ 0.75, 0, 0, 0 });
+    var gates = Gates.initFill(null);
+    gates.set(.synthesis, .{ .buffer = @ptrFromInt(0x20), .offset = 32 });
+    gates.set(.passthrough, .{ .buffer = @ptrFromInt(0x20), .offset = 60 });
+    stub_copy_count = 0;
+    constants.record(@ptrFromInt(0x30), &blocks, 2, gates);
+
+    try std.testing.expectEqual(2 * slot_size, stub_updated);
+    try std.testing.expectEqual(@as(f32, 0.75), stub_blend_weight);
+    // Absent gates are not copied
+    try std.testing.expectEqual(@as(usize, 2), stub_copy_count);
+    try std.testing.expectEqual(gateOffset(.synthesis), stub_copies[0]);
+    try std.testing.expectEqual(gateOffset(.passthrough), stub_copies[1]);
+    try std.testing.expectEqual(gateOffset(.passthrough), constants.gate(.passthrough).offset);
+}
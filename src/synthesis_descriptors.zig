@@ -0,0 +1,643 @@
+//! Synthesis Descriptor Models
+//!
+//! Every synthesis shader has its own set layout, built from its binding
+//! table (frame_synthesis.PassShader.bindings): its inputs, the
+//! intermediates earlier passes wrote, its storage output and its block of
+//! the constants buffer (synthesis_constants.zig). PassImages holds the
+//! images of one output slot and feeds every table. With
+//! classic descriptor sets the caller keeps one set per shader per output
+//! target (writeSet) and has to rewrite them as the history rotates (or
+//! keep one per history parity, see
+//! OutputTarget.alternate_descriptor_sets). Two extensions avoid that:
+//!
+//!   push:   VK_KHR_push_descriptor. Every pass pushes its bindings into
+//!           the command buffer: no pool, no sets, no vkUpdateDescriptorSets.
+//!   buffer: VK_EXT_descriptor_buffer. Each batch writes its descriptors
+//!           into a caller-owned, host-visible buffer with vkGetDescriptorEXT
+//!           and passes select them by offset. Regions rotate over
+//!           regions_in_flight batches, as many as can be in flight, so a
+//!           group is never rewritten while its last batch is pending; a
+//!           batch that would is refused (error.DescriptorsBusy), the host
+//!           never waits.
+//!
+//! selectModel prefers the descriptor buffer, then push descriptors, then
+//! classic sets. The synthesis set layouts and the pipelines using them
+//! must be created for the model (layoutFlags, pipelineFlags).
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const mv_ring = @import("mv_ring.zig");
+const synthesis_constants = @import("synthesis_constants.zig");
+const gpu_timing = @import("gpu_timing.zig");
+const async_queue = @import("async_queue.zig");
+const test_stubs = @import("test_stubs.zig");
+
+const PassShader = frame_synthesis.PassShader;
+const PassBinding = frame_synthesis.PassBinding;
+const BindingSource = frame_synthesis.BindingSource;
+const max_pass_bindings = frame_synthesis.max_pass_bindings;
+const pass_shader_count = frame_synthesis.pass_shader_count;
+const max_batch_frames = frame_synthesis.max_batch_frames;
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// How the synthesis bindings reach the shaders
+pub const Model = enum {
+    /// Caller-owned descriptor sets per output target
+    classic,
+    /// VK_KHR_push_descriptor
+    push,
+    /// VK_EXT_descriptor_buffer
+    buffer,
+};
+
+/// Batches whose descriptor buffer regions may be pending at once: the
+/// frames GpuTimer keeps in flight, more than AsyncQueues ever submits
+pub const regions_in_flight: u32 = gpu_timing.frames_in_flight;
+
+comptime {
+    std.debug.assert(regions_in_flight >= async_queue.frames_in_flight);
+}
+
+/// Pick the cheapest model the device supports. `descriptor_buffer` is
+/// whether the descriptorBuffer feature was enabled at device creation.
+pub fn selectModel(dispatch: *const vk.DeviceDispatch, descriptor_buffer: bool) Model {
+    if (descriptor_buffer and dispatch.hasDescriptorBuffer()) return .buffer;
+    if (dispatch.hasPushDescriptors()) return .push;
+    return .classic;
+}
+
+/// Create flags of the synthesis set layout
+pub fn layoutFlags(model: Model) u32 {
+    return switch (model) {
+        .classic => 0,
+        .push => vk.VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
+        .buffer => vk.VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+    };
+}
+
+/// Create flags of pipelines using the synthesis set layout
+pub fn pipelineFlags(model: Model) u32 {
+    return if (model == .buffer) vk.VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT else 0;
+}
+
+/// Images one output slot of a batch binds, by BindingSource
+pub const PassImages = struct {
+    prev: vk.VkImageView,
+    curr: vk.VkImageView,
+    motion: vk.VkImageView,
+    /// Backward motion field (null = the forward field, warped the other
+    /// way)
+    backward_motion: ?vk.VkImageView = null,
+    /// Without a cost map the motion field is bound in its place; the
+    /// shaders only sample it with cost enabled
+    cost: ?vk.VkImageView = null,
+    /// Cost map of the backward flow (null = the forward cost map)
+    backward_cost: ?vk.VkImageView = null,
+    /// Splat cost map while splatting (null = the cost map)
+    fill_cost: ?vk.VkImageView = null,
+    /// Without a tile confidence image the current frame is bound in its
+    /// place; the blends only sample it with tile confidence enabled
+    tile_confidence: ?vk.VkImageView = null,
+    warp_scratch: ?vk.VkImageView = null,
+    backward_warped: ?vk.VkImageView = null,
+    /// Confidence blend target in quality mode (null = the blend writes
+    /// the output)
+    filled_output: ?vk.VkImageView = null,
+    output: vk.VkImageView,
+    /// Tile list buffer and its size (tile_classify.tileListBufferSize).
+    /// Only the tiled variants read it; without a classifier it stays
+    /// unbound.
+    tile_lists: ?vk.VkBuffer = null,
+    tile_lists_size: vk.VkDeviceSize = 0,
+    /// Constants buffer (synthesis_constants.ConstantsBuffer); every pass
+    /// binds the block of its shader for `slot`
+    constants: ?vk.VkBuffer = null,
+    /// Output slot the images are bound for
+    slot: u32 = 0,
+
+    /// Image bound for a source, null if missing (or not an image)
+    pub fn view(self: PassImages, source: BindingSource) ?vk.VkImageView {
+        return switch (source) {
+            .prev => self.prev,
+            .curr => self.curr,
+            .motion => self.motion,
+            .backward_motion => self.backward_motion orelse self.motion,
+            .cost => self.cost orelse self.motion,
+            .backward_cost => self.backward_cost orelse self.cost orelse self.motion,
+            .fill_cost => self.fill_cost orelse self.cost orelse self.motion,
+            .tile_confidence => self.tile_confidence orelse self.curr,
+            .warp_scratch => self.warp_scratch,
+            .backward_warped => self.backward_warped,
+            .filled_output => self.filled_output,
+            .blend_target => self.filled_output orelse self.output,
+            .output => self.output,
+            .tile_lists, .constants => null,
+        };
+    }
+
+    /// Image info of a binding, null if its image is missing (the pass
+    /// cannot run). Inputs are read in `input_layout`, everything a
+    /// synthesis pass writes in GENERAL.
+    pub fn info(self: PassImages, b: PassBinding, sampler: vk.VkSampler, input_layout: u32) ?vk.VkDescriptorImageInfo {
+        const image = self.view(b.source) orelse return null;
+        if (b.written) return .{ .imageView = image, .imageLayout = vk.VK_IMAGE_LAYOUT_GENERAL };
+        const transient = b.source.isTransient() or (b.source == .fill_cost and self.fill_cost != null);
+        return .{
+            .sampler = sampler,
+            .imageView = image,
+            .imageLayout = if (transient) vk.VK_IMAGE_LAYOUT_GENERAL else input_layout,
+        };
+    }
+};
+
+/// Descriptor writes of one pass shader. Bindings whose image or buffer
+/// is missing are left out. Writes point into `infos`, `tile_lists` and
+/// `constants`, so fill in place.
+pub const PassWrites = struct {
+    infos: [max_pass_bindings]vk.VkDescriptorImageInfo = undefined,
+    tile_lists: vk.VkDescriptorBufferInfo = undefined,
+    constants: vk.VkDescriptorBufferInfo = undefined,
+    writes: [max_pass_bindings]vk.VkWriteDescriptorSet = undefined,
+    len: u32 = 0,
+
+    pub fn fill(
+        self: *PassWrites,
+        set: ?vk.VkDescriptorSet,
+        shader: PassShader,
+        images: PassImages,
+        sampler: vk.VkSampler,
+        input_layout: u32,
+    ) void {
+        self.len = 0;
+        for (shader.bindings()) |b| {
+            if (b.source == .tile_lists) {
+                self.tile_lists = .{ .buffer = images.tile_lists orelse continue };
+                self.writes[self.len] = .{
+                    .dstSet = set,
+                    .dstBinding = b.binding,
+                    .descriptorType = b.descriptorType(),
+                    .pBufferInfo = &self.tile_lists,
+                };
+                self.len += 1;
+                continue;
+            }
+            if (b.source == .constants) {
+                self.constants = .{
+                    .buffer = images.constants orelse continue,
+                    .offset = synthesis_constants.blockOffset(images.slot, shader),
+                    .range = synthesis_constants.block_size,
+                };
+                self.writes[self.len] = .{
+                    .dstSet = set,
+                    .dstBinding = b.binding,
+                    .descriptorType = b.descriptorType(),
+                    .pBufferInfo = &self.constants,
+                };
+                self.len += 1;
+                continue;
+            }
+            self.infos[self.len] = images.info(b, sampler, input_layout) orelse continue;
+            self.writes[self.len] = .{
+                .dstSet = set,
+                .dstBinding = b.binding,
+                .descriptorType = b.descriptorType(),
+                .pImageInfo = &self.infos[self.len],
+            };
+            self.len += 1;
+        }
+    }
+
+    pub fn slice(self: *const PassWrites) []const vk.VkWriteDescriptorSet {
+        return self.writes[0..self.len];
+    }
+};
+
+/// Write a caller-owned classic set of a pass shader
+pub fn writeSet(
+    dispatch: *const vk.DeviceDispatch,
+    set: vk.VkDescriptorSet,
+    shader: PassShader,
+    images: PassImages,
+    sampler: vk.VkSampler,
+    input_layout: u32,
+) !void {
+    const update = dispatch.vkUpdateDescriptorSets orelse return vk.VulkanError.FunctionNotFound;
+    var w = PassWrites{};
+    w.fill(set, shader, images, sampler, input_layout);
+    update(dispatch.device, w.len, &w.writes, 0, null);
+}
+
+/// Bindings of one output slot for the context's model
+pub const SlotBinding = union(Model) {
+    classic: frame_synthesis.PassSets,
+    push: PassImages,
+    /// Descriptor buffer region of the slot (DescriptorBuffer.region)
+    buffer: u32,
+};
+
+/// Push descriptor state: the sampler and input layout every push uses
+pub const PushDescriptors = struct {
+    sampler: vk.VkSampler,
+    /// Layout of frames, motion field and cost map while synthesis reads them
+    input_layout: u32 = vk.VK_IMAGE_LAYOUT_GENERAL,
+
+    /// Push the bindings of a pass
+    pub fn record(
+        self: *const PushDescriptors,
+        d: *const vk.DeviceDispatch,
+        cmd: vk.VkCommandBuffer,
+        layout: vk.VkPipelineLayout,
+        shader: PassShader,
+        images: PassImages,
+    ) void {
+        var w = PassWrites{};
+        w.fill(null, shader, images, self.sampler, self.input_layout);
+        d.vkCmdPushDescriptorSetKHR.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, w.len, &w.writes);
+    }
+};
+
+/// Set layout per pass shader
+pub const SetLayouts = std.EnumArray(PassShader, vk.VkDescriptorSetLayout);
+
+/// Caller-owned descriptor buffer for the synthesis set layouts. The
+/// buffer needs SAMPLER_ and RESOURCE_DESCRIPTOR_BUFFER and
+/// SHADER_DEVICE_ADDRESS usage, host-visible coherent memory and at least
+/// requiredSize bytes.
+pub const DescriptorBuffer = struct {
+    dispatch: *const vk.DeviceDispatch,
+    sampler: vk.VkSampler,
+    input_layout: u32 = vk.VK_IMAGE_LAYOUT_GENERAL,
+
+    address: vk.VkDeviceAddress,
+    mapped: []u8,
+    // Bytes per region (largest layout rounded to the offset alignment)
+    stride: vk.VkDeviceSize,
+    // Offset of every binding of a shader's layout, in table order
+    offsets: std.EnumArray(PassShader, [max_pass_bindings]vk.VkDeviceSize),
+    sampler_size: usize,
+    storage_size: usize,
+    buffer_size: usize,
+    uniform_size: usize,
+    // Batches written so far
+    batches: u64 = 0,
+    // Value signalled once each group's last batch is done (null = unused)
+    group_release: [regions_in_flight]?mv_ring.TimelineValue = .{null} ** regions_in_flight,
+    // Batches refused because their group was still pending
+    busy_batches: u64 = 0,
+
+    /// Regions: one per pass shader per output slot per batch in flight
+    pub const region_count = regions_in_flight * max_batch_frames * pass_shader_count;
+
+    pub fn init(
+        dispatch: *const vk.DeviceDispatch,
+        set_layouts: *const SetLayouts,
+        props: *const vk.VkPhysicalDeviceDescriptorBufferPropertiesEXT,
+        buffer: vk.VkBuffer,
+        mapped: []u8,
+        sampler: vk.VkSampler,
+    ) !DescriptorBuffer {
+        if (!dispatch.hasDescriptorBuffer()) return vk.VulkanError.FunctionNotFound;
+        if (dispatch.vkGetSemaphoreCounterValue == null) return vk.VulkanError.FunctionNotFound;
+        const d = dispatch;
+        const stride = regionStride(d, set_layouts, props);
+        if (mapped.len < stride * region_count) return error.BufferTooSmall;
+
+        var offsets = std.EnumArray(PassShader, [max_pass_bindings]vk.VkDeviceSize).initUndefined();
+        for (std.enums.values(PassShader)) |shader| {
+            const shader_offsets = offsets.getPtr(shader);
+            for (shader.bindings(), 0..) |b, i| {
+                d.vkGetDescriptorSetLayoutBindingOffsetEXT.?(d.device, set_layouts.get(shader), b.binding, &shader_offsets[i]);
+            }
+        }
+        return .{
+            .dispatch = dispatch,
+            .sampler = sampler,
+            .address = d.vkGetBufferDeviceAddress.?(d.device, &.{ .buffer = buffer }),
+            .mapped = mapped,
+            .stride = stride,
+            .offsets = offsets,
+            .sampler_size = props.combinedImageSamplerDescriptorSize,
+            .storage_size = props.storageImageDescriptorSize,
+            .buffer_size = props.storageBufferDescriptorSize,
+            .uniform_size = props.uniformBufferDescriptorSize,
+        };
+    }
+
+    /// Bytes the buffer must hold for a set of layouts
+    pub fn requiredSize(
+        dispatch: *const vk.DeviceDispatch,
+        set_layouts: *const SetLayouts,
+        props: *const vk.VkPhysicalDeviceDescriptorBufferPropertiesEXT,
+    ) vk.VkDeviceSize {
+        return regionStride(dispatch, set_layouts, props) * region_count;
+    }
+
+    /// Region group the next batch writes
+    pub fn nextGroup(self: *const DescriptorBuffer) u32 {
+        return @intCast(self.batches % regions_in_flight);
+    }
+
+    /// Write the descriptors of every pass shader of a batch into the next
+    /// region group and return the group. `release` is signalled once the
+    /// GPU is done with the batch (its submission's completion value). If
+    /// the group's previous batch has not reached its value yet, more than
+    /// regions_in_flight batches are pending: nothing is written and
+    /// error.DescriptorsBusy is returned instead of waiting. Bindings whose
+    /// image is missing are skipped; their pass does not run. The tile
+    /// list and constants buffers need SHADER_DEVICE_ADDRESS usage.
+    pub fn writeBatch(self: *DescriptorBuffer, slots: []const PassImages, release: mv_ring.TimelineValue) !u32 {
+        const d = self.dispatch;
+        const group = self.nextGroup();
+        if (self.group_release[group]) |pending| {
+            if (!try self.released(pending)) {
+                self.busy_batches += 1;
+                return error.DescriptorsBusy;
+            }
+        }
+        self.group_release[group] = release;
+        self.batches += 1;
+        for (slots, 0..) |images, slot| {
+            const tile_lists: ?vk.VkDescriptorAddressInfoEXT = if (images.tile_lists) |buffer| .{
+                .address = d.vkGetBufferDeviceAddress.?(d.device, &.{ .buffer = buffer }),
+                .range = images.tile_lists_size,
+            } else null;
+            const constants: ?vk.VkDeviceAddress = if (images.constants) |buffer|
+                d.vkGetBufferDeviceAddress.?(d.device, &.{ .buffer = buffer })
+            else
+                null;
+            for (std.enums.values(PassShader)) |shader| {
+                const base = passRegion(region(group, @intCast(slot)), shader) * self.stride;
+                const table = shader.bindings();
+                for (table, self.offsets.getPtrConst(shader)[0..table.len]) |b, binding_offset| {
+                    const offset: usize = @intCast(base + binding_offset);
+                    if (b.source == .tile_lists) {
+                        const address = tile_lists orelse continue;
+                        d.vkGetDescriptorEXT.?(d.device, &.{ .type = b.descriptorType(), .data = &address }, self.buffer_size, self.mapped[offset..].ptr);
+                        continue;
+                    }
+                    if (b.source == .constants) {
+                        const block = vk.VkDescriptorAddressInfoEXT{
+                            .address = (constants orelse continue) + synthesis_constants.blockOffset(@intCast(slot), shader),
+                            .range = synthesis_constants.block_size,
+                        };
+                        d.vkGetDescriptorEXT.?(d.device, &.{ .type = b.descriptorType(), .data = &block }, self.uniform_size, self.mapped[offset..].ptr);
+                        continue;
+                    }
+                    const info = images.info(b, self.sampler, self.input_layout) orelse continue;
+                    const size = if (b.written) self.storage_size else self.sampler_size;
+                    d.vkGetDescriptorEXT.?(d.device, &.{ .type = b.descriptorType(), .data = &info }, size, self.mapped[offset..].ptr);
+                }
+            }
+        }
+        return group;
+    }
+
+    // Check whether a group's previous batch is done with its descriptors
+    fn released(self: *const DescriptorBuffer, pending: mv_ring.TimelineValue) !bool {
+        const d = self.dispatch;
+        var completed: u64 = 0;
+        try vk.check(d.vkGetSemaphoreCounterValue.?(d.device, pending.semaphore, &completed));
+        return completed >= pending.value;
+    }
+
+    /// Region of an output slot in a group (SlotBinding.buffer)
+    pub fn region(group: u32, slot: u32) u32 {
+        return group * max_batch_frames + slot;
+    }
+
+    /// Region of a pass shader within a slot's region
+    pub fn passRegion(slot_region: u32, shader: PassShader) u32 {
+        return slot_region * pass_shader_count + @intFromEnum(shader);
+    }
+
+    /// Bind the buffer; once per command buffer, before the first select
+    pub fn bind(self: *const DescriptorBuffer, cmd: vk.VkCommandBuffer) void {
+        const info = [_]vk.VkDescriptorBufferBindingInfoEXT{.{
+            .address = self.address,
+            .usage = vk.VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | vk.VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT,
+        }};
+        self.dispatch.vkCmdBindDescriptorBuffersEXT.?(cmd, 1, &info);
+    }
+
+    /// Point set 0 of a pass at its region of a slot
+    pub fn select(self: *const DescriptorBuffer, cmd: vk.VkCommandBuffer, layout: vk.VkPipelineLayout, slot_region: u32, shader: PassShader) void {
+        const buffer_indices = [_]u32{0};
+        const offsets = [_]vk.VkDeviceSize{passRegion(slot_region, shader) * self.stride};
+        self.dispatch.vkCmdSetDescriptorBufferOffsetsEXT.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &buffer_indices, &offsets);
+    }
+
+    fn regionStride(
+        d: *const vk.DeviceDispatch,
+        set_layouts: *const SetLayouts,
+        props: *const vk.VkPhysicalDeviceDescriptorBufferPropertiesEXT,
+    ) vk.VkDeviceSize {
+        var largest: vk.VkDeviceSize = 0;
+        for (set_layouts.values) |layout| {
+            var size: vk.VkDeviceSize = 0;
+            d.vkGetDescriptorSetLayoutSizeEXT.?(d.device, layout, &size);
+            largest = @max(largest, size);
+        }
+        return std.mem.alignForward(vk.VkDeviceSize, largest, @max(props.descriptorBufferOffsetAlignment, 1));
+    }
+};
+
+/// Descriptor state of a synthesis context
+pub const Descriptors = union(Model) {
+    classic,
+    push: PushDescriptors,
+    buffer: DescriptorBuffer,
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+var stub_pushed: u32 = 0;
+var stub_output_type: u32 = 0;
+var stub_tile_list_buffer: ?vk.VkBuffer = null;
+var stub_constants_offset: vk.VkDeviceSize = 0;
+var stub_descriptors_written: u32 = 0;
+var stub_selected_offset: vk.VkDeviceSize = 0;
+
+fn stubPush(_: vk.VkCommandBuffer, _: u32, _: vk.VkPipelineLayout, set: u32, count: u32, writes: [*]const vk.VkWriteDescriptorSet) callconv(.c) void {
+    std.debug.assert(set == 0);
+    stub_pushed += count;
+    for (writes[0..count]) |write| {
+        if (write.descriptorType == vk.VK_DESCRIPTOR_TYPE_STORAGE_IMAGE) stub_output_type = write.dstBinding;
+        if (write.descriptorType == vk.VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) stub_tile_list_buffer = write.pBufferInfo.?.buffer;
+        if (write.descriptorType == vk.VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) stub_constants_offset = write.pBufferInfo.?.offset;
+    }
+}
+
+fn stubAddress(_: vk.VkDevice, _: *const vk.VkBufferDeviceAddressInfo) callconv(.c) vk.VkDeviceAddress {
+    return 0x10000;
+}
+
+fn stubLayoutSize(_: vk.VkDevice, _: vk.VkDescriptorSetLayout, size: *vk.VkDeviceSize) callconv(.c) void {
+    size.* = 200;
+}
+
+fn stubBindingOffset(_: vk.VkDevice, _: vk.VkDescriptorSetLayout, binding: u32, offset: *vk.VkDeviceSize) callconv(.c) void {
+    offset.* = binding * 32;
+}
+
+fn stubGetDescriptor(_: vk.VkDevice, info: *const vk.VkDescriptorGetInfoEXT, size: usize, out: *anyopaque) callconv(.c) void {
+    const image: *const vk.VkDescriptorImageInfo = @ptrCast(@alignCast(info.data.?));
+    const bytes: [*]u8 = @ptrCast(out);
+    @memset(bytes[0..size], @truncate(@intFromPtr(image.imageView.?)));
+    stub_descriptors_written += 1;
+}
+
+fn stubBindBuffers(_: vk.VkCommandBuffer, _: u32, _: [*]const vk.VkDescriptorBufferBindingInfoEXT) callconv(.c) void {}
+
+fn stubSetOffsets(_: vk.VkCommandBuffer, _: u32, _: vk.VkPipelineLayout, _: u32, _: u32, _: [*]const u32, offsets: [*]const vk.VkDeviceSize) callconv(.c) void {
+    stub_selected_offset = offsets[0];
+}
+
+const test_images = PassImages{
+    .prev = @ptrFromInt(0x11),
+    .curr = @ptrFromInt(0x12),
+    .motion = @ptrFromInt(0x13),
+    .warp_scratch = @ptrFromInt(0x14),
+    .output = @ptrFromInt(0x15),
+};
+
+/// Descriptors a slot of test_images writes over every pass shader
+fn testDescriptorCount() u32 {
+    var count: u32 = 0;
+    for (std.enums.values(PassShader)) |shader| {
+        for (shader.bindings()) |b| {
+            if (test_images.view(b.source) != null) count += 1;
+        }
+    }
+    return count;
+}
+
+test "model selection and flags" {
+    const classic = vk.DeviceDispatch{ .device = @ptrFromInt(0x1000) };
+    try std.testing.expectEqual(Model.classic, selectModel(&classic, true));
+
+    const push = vk.DeviceDispatch{ .device = @ptrFromInt(0x1000), .vkCmdPushDescriptorSetKHR = stubPush };
+    try std.testing.expectEqual(Model.push, selectModel(&push, true));
+    try std.testing.expectEqual(vk.VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR, layoutFlags(.push));
+    try std.testing.expectEqual(@as(u32, 0), pipelineFlags(.push));
+    try std.testing.expectEqual(vk.VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, pipelineFlags(.buffer));
+}
+
+test "pass images follow the binding tables" {
+    // Missing cost map: the motion field stands in
+    try std.testing.expectEqual(test_images.motion, test_images.view(.cost).?);
+    try std.testing.expectEqual(test_images.motion, test_images.view(.fill_cost).?);
+    // Balanced blends into the output, quality into the filled output
+    try std.testing.expectEqual(test_images.output, test_images.view(.blend_target).?);
+    var quality = test_images;
+    quality.filled_output = @ptrFromInt(0x16);
+    try std.testing.expectEqual(quality.filled_output.?, quality.view(.blend_target).?);
+    try std.testing.expect(test_images.view(.backward_warped) == null);
+
+    // The blend samples the warp scratch in GENERAL, frames in the input layout
+    const blend = PassShader.linear_blend.bindings();
+    const scratch = test_images.info(blend[0], @ptrFromInt(0x20), vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL).?;
+    try std.testing.expectEqual(vk.VK_IMAGE_LAYOUT_GENERAL, scratch.imageLayout);
+    const curr = test_images.info(blend[1], @ptrFromInt(0x20), vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL).?;
+    try std.testing.expectEqual(vk.VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, curr.imageLayout);
+    try std.testing.expect(test_images.info(blend[2], @ptrFromInt(0x20), vk.VK_IMAGE_LAYOUT_GENERAL).?.sampler == null);
+}
+
+test "push descriptors cover the pass's bindings" {
+    const d = vk.DeviceDispatch{ .device = @ptrFromInt(0x1000), .vkCmdPushDescriptorSetKHR = stubPush };
+    const push = PushDescriptors{ .sampler = @ptrFromInt(0x20) };
+    stub_pushed = 0;
+    push.record(&d, @ptrFromInt(0x30), @ptrFromInt(0x40), .forward_warp, test_images);
+    try std.testing.expectEqual(@as(u32, 3), stub_pushed);
+    try std.testing.expectEqual(@as(u32, 2), stub_output_type);
+
+    stub_pushed = 0;
+    push.record(&d, @ptrFromInt(0x30), @ptrFromInt(0x40), .confidence_blend, test_images);
+    // No backward warp image: its binding is left out
+    try std.testing.expectEqual(@as(u32, 5), stub_pushed);
+    try std.testing.expectEqual(@as(u32, 4), stub_output_type);
+
+    // Tile lists only with a classifier buffer
+    try std.testing.expect(stub_tile_list_buffer == null);
+    var tiled = test_images;
+    tiled.tile_lists = @ptrFromInt(0x70);
+    stub_pushed = 0;
+    push.record(&d, @ptrFromInt(0x30), @ptrFromInt(0x40), .tile_copy, tiled);
+    try std.testing.expectEqual(@as(u32, 4), stub_pushed);
+    try std.testing.expectEqual(tiled.tile_lists, stub_tile_list_buffer);
+
+    // Each pass binds its own block of the slot's constants
+    tiled.constants = @ptrFromInt(0x80);
+    tiled.slot = 2;
+    stub_pushed = 0;
+    push.record(&d, @ptrFromInt(0x30), @ptrFromInt(0x40), .tile_copy, tiled);
+    try std.testing.expectEqual(@as(u32, 5), stub_pushed);
+    try std.testing.expectEqual(synthesis_constants.blockOffset(2, .tile_copy), stub_constants_offset);
+}
+
+test "descriptor buffer regions rotate per batch" {
+    const d = vk.DeviceDispatch{
+        .device = @ptrFromInt(0x1000),
+        .vkGetBufferDeviceAddress = stubAddress,
+        .vkGetDescriptorSetLayoutSizeEXT = stubLayoutSize,
+        .vkGetDescriptorSetLayoutBindingOffsetEXT = stubBindingOffset,
+        .vkGetDescriptorEXT = stubGetDescriptor,
+        .vkCmdBindDescriptorBuffersEXT = stubBindBuffers,
+        .vkCmdSetDescriptorBufferOffsetsEXT = stubSetOffsets,
+        .vkGetSemaphoreCounterValue = test_stubs.counterValue,
+    };
+    const props = vk.VkPhysicalDeviceDescriptorBufferPropertiesEXT{
+        .descriptorBufferOffsetAlignment = 64,
+        .combinedImageSamplerDescriptorSize = 32,
+        .storageImageDescriptorSize = 16,
+    };
+    const layouts = SetLayouts.initFill(@ptrFromInt(0x50));
+    // 200 bytes rounded up to 256 per region
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 256 * DescriptorBuffer.region_count), DescriptorBuffer.requiredSize(&d, &layouts, &props));
+
+    var small: [256]u8 = undefined;
+    try std.testing.expectError(error.BufferTooSmall, DescriptorBuffer.init(&d, &layouts, &props, @ptrFromInt(0x60), &small, @ptrFromInt(0x20)));
+
+    var memory = [_]u8{0} ** (256 * DescriptorBuffer.region_count);
+    var buffer = try DescriptorBuffer.init(&d, &layouts, &props, @ptrFromInt(0x60), &memory, @ptrFromInt(0x20));
+    try std.testing.expectEqual(@as(vk.VkDeviceAddress, 0x10000), buffer.address);
+
+    stub_descriptors_written = 0;
+    test_stubs.timeline_value = 0;
+    const slots = [_]PassImages{ test_images, test_images };
+    const timeline: vk.VkSemaphore = @ptrFromInt(0x70);
+    try std.testing.expectEqual(@as(u32, 0), try buffer.writeBatch(&slots, .{ .semaphore = timeline, .value = 1 }));
+    try std.testing.expectEqual(2 * testDescriptorCount(), stub_descriptors_written);
+    // Linear blend of slot 1 in group 0: warp scratch at binding 0, output at 2
+    const blend = DescriptorBuffer.passRegion(DescriptorBuffer.region(0, 1), .linear_blend) * 256;
+    try std.testing.expectEqual(@as(u8, 0x14), memory[blend]);
+    try std.testing.expectEqual(@as(u8, 0x15), memory[blend + 2 * 32]);
+
+    for (1..regions_in_flight) |group| {
+        try std.testing.expectEqual(@as(u32, @intCast(group)), try buffer.writeBatch(&slots, .{ .semaphore = timeline, .value = group + 1 }));
+    }
+    try std.testing.expectEqual(@as(u32, 0), buffer.nextGroup());
+
+    // Group 0's batch already completed: reused
+    test_stubs.timeline_value = 1;
+    const next = regions_in_flight + 1;
+    try std.testing.expectEqual(@as(u32, 0), try buffer.writeBatch(&slots, .{ .semaphore = timeline, .value = next }));
+    // Group 1's batch (value 2) still pending: refused, nothing written
+    // and the group stays next
+    stub_descriptors_written = 0;
+    try std.testing.expectError(error.DescriptorsBusy, buffer.writeBatch(&slots, .{ .semaphore = timeline, .value = next + 1 }));
+    try std.testing.expectEqual(@as(u32, 0), stub_descriptors_written);
+    try std.testing.expectEqual(@as(u64, 1), buffer.busy_batches);
+    try std.testing.expectEqual(@as(u32, 1), buffer.nextGroup());
+    test_stubs.timeline_value = 2;
+    try std.testing.expectEqual(@as(u32, 1), try buffer.writeBatch(&slots, .{ .semaphore = timeline, .value = next + 1 }));
+
+    buffer.select(@ptrFromInt(0x30), @ptrFromInt(0x40), DescriptorBuffer.region(2, 1), .backward_warp);
+    const expected = ((2 * max_batch_frames + 1) * pass_shader_count + @intFromEnum(PassShader.backward_warp)) * 256;
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, expected), stub_selected_offset);
+}
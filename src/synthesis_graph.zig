@@ -0,0 +1,466 @@
+//! Synthesis Pass Graph
+//!
+//! Transient resources of frame synthesis (warp scratch, quality
+//! intermediates, the splat buffer and cost map, the pull-push pyramid)
+//! live for a few passes of each generated frame. Graph lists the passes
+//! recordInterpolation runs for a configuration with what each reads and
+//! writes, which gives every transient a Lifetime in pass indices.
+//! memory_arena.plan places resources with disjoint lifetimes at the same
+//! offset; AliasMap records which ones ended up sharing memory.
+//!
+//! FrameSynthesisContext derives its full-frame barriers from the graph:
+//! BarrierTracker inserts one before a pass that reads, or writes over, a
+//! resource (or its alias) accessed since the last barrier. With an
+//! AliasMap set it also transitions aliased images from
+//! VK_IMAGE_LAYOUT_UNDEFINED where their lifetime starts.
+//!
+//! The plain intermediates overlap at the blend pass (it reads the warps
+//! and writes the filled output), so aliasing alone saves nothing there.
+//! The savings come from the full-resolution splat buffer (8 bytes per
+//! pixel) and pyramid (rgba16f plus mips), which alias the intermediates.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const forward_splat = @import("forward_splat.zig");
+const hole_fill = @import("hole_fill.zig");
+const memory_arena = @import("memory_arena.zig");
+const output_format = @import("output_format.zig");
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Transient resource of one generated frame
+pub const Resource = enum {
+    /// Forward warp (or splat) result
+    warp_scratch,
+    /// Backward warp result (balanced, quality)
+    backward_warped,
+    /// Confidence blend result occlusion fill reads (quality)
+    filled_output,
+    /// Splat buffer (ForwardSplat.splat_buffer)
+    splat_buffer,
+    /// Splat cost map (ForwardSplat.cost_image)
+    splat_cost,
+    /// Pull-push pyramid (PullPushFill.pyramid_image)
+    pyramid,
+
+    pub fn label(self: Resource) []const u8 {
+        return switch (self) {
+            .warp_scratch => "warp scratch",
+            .backward_warped => "backward warped",
+            .filled_output => "filled output",
+            .splat_buffer => "splat buffer",
+            .splat_cost => "splat cost",
+            .pyramid => "pull-push pyramid",
+        };
+    }
+
+    /// Buffers need no layout transition
+    pub fn isImage(self: Resource) bool {
+        return self != .splat_buffer;
+    }
+};
+
+pub const Resources = std.EnumSet(Resource);
+
+/// Pass recorded for one generated frame. Splat and pull-push record
+/// several dispatches with their own internal barriers.
+pub const Pass = enum {
+    forward_warp,
+    splat,
+    backward_warp,
+    linear_blend,
+    confidence_blend,
+    occlusion_fill,
+    pull_push,
+};
+
+/// Transients a pass reads and writes (outputs are not transient)
+pub const Access = struct {
+    reads: Resources = .initEmpty(),
+    writes: Resources = .initEmpty(),
+};
+
+/// Configuration the passes are recorded with
+pub const GraphConfig = struct {
+    mode: frame_synthesis.QualityMode,
+    /// ForwardSplat active
+    splatting: bool = false,
+    /// PullPushFill active (quality)
+    pull_push: bool = false,
+};
+
+/// Passes per generated frame
+pub const max_passes = 4;
+
+// =============================================================================
+// Graph
+// =============================================================================
+
+/// Pass order of one generated frame
+pub const Graph = struct {
+    config: GraphConfig,
+    passes: [max_passes]Pass = undefined,
+    count: usize = 0,
+
+    pub fn init(config: GraphConfig) Graph {
+        var g = Graph{ .config = config };
+        g.add(if (config.splatting) .splat else .forward_warp);
+        switch (config.mode) {
+            .performance => g.add(.linear_blend),
+            .balanced, .quality => {
+                g.add(.backward_warp);
+                g.add(.confidence_blend);
+                if (config.mode == .quality) g.add(if (config.pull_push) .pull_push else .occlusion_fill);
+            },
+        }
+        return g;
+    }
+
+    fn add(self: *Graph, pass: Pass) void {
+        self.passes[self.count] = pass;
+        self.count += 1;
+    }
+
+    pub fn slice(self: *const Graph) []const Pass {
+        return self.passes[0..self.count];
+    }
+
+    /// Transients a pass touches in this configuration
+    pub fn access(self: *const Graph, pass: Pass) Access {
+        const splat_cost: Resources = if (self.config.splatting) .initOne(.splat_cost) else .initEmpty();
+        return switch (pass) {
+            .forward_warp => .{ .writes = .initOne(.warp_scratch) },
+            .splat => .{ .writes = .initMany(&.{ .splat_buffer, .warp_scratch, .splat_cost }) },
+            .backward_warp => .{ .writes = .initOne(.backward_warped) },
+            .linear_blend => .{ .reads = .initOne(.warp_scratch) },
+            .confidence_blend => .{
+                .reads = .initMany(&.{ .warp_scratch, .backward_warped }),
+                // Balanced writes the output directly
+                .writes = if (self.config.mode == .quality) .initOne(.filled_output) else .initEmpty(),
+            },
+            .occlusion_fill => .{ .reads = splat_cost.unionWith(.initOne(.filled_output)) },
+            .pull_push => .{
+                .reads = splat_cost.unionWith(.initOne(.filled_output)),
+                .writes = .initOne(.pyramid),
+            },
+        };
+    }
+
+    /// Transients this configuration uses
+    pub fn used(self: *const Graph) Resources {
+        var set = Resources.initEmpty();
+        for (self.slice()) |pass| {
+            const a = self.access(pass);
+            set.setUnion(a.reads);
+            set.setUnion(a.writes);
+        }
+        return set;
+    }
+
+    /// Passes a transient is used in (null if unused)
+    pub fn lifetime(self: *const Graph, resource: Resource) ?memory_arena.Lifetime {
+        var result: ?memory_arena.Lifetime = null;
+        for (self.slice(), 0..) |pass, i| {
+            const a = self.access(pass);
+            if (!a.reads.contains(resource) and !a.writes.contains(resource)) continue;
+            const index: u16 = @intCast(i);
+            if (result) |*l| l.last = index else result = .{ .first = index, .last = index };
+        }
+        return result;
+    }
+};
+
+// =============================================================================
+// Aliasing
+// =============================================================================
+
+/// Transients of a configuration with memory requests (images created by
+/// the caller, or estimated)
+pub const TransientSet = struct {
+    resources: [std.meta.fields(Resource).len]Resource = undefined,
+    requests: [std.meta.fields(Resource).len]memory_arena.Request = undefined,
+    count: usize = 0,
+
+    /// Add a resource with the graph's lifetime (requirements from
+    /// memory_arena.imageRequest or vkGetBufferMemoryRequirements)
+    pub fn add(self: *TransientSet, graph: *const Graph, resource: Resource, requirements: vk.VkMemoryRequirements) void {
+        self.resources[self.count] = resource;
+        self.requests[self.count] = .fromRequirements(requirements, graph.lifetime(resource) orelse .whole);
+        self.count += 1;
+    }
+
+    pub fn slice(self: *const TransientSet) []const memory_arena.Request {
+        return self.requests[0..self.count];
+    }
+
+    /// Estimated transients of a configuration (sizes rounded to
+    /// memory_arena.estimated_image_alignment)
+    pub fn estimate(graph: *const Graph, width: u32, height: u32, output: output_format.OutputFormat) TransientSet {
+        var set = TransientSet{};
+        var it = graph.used().iterator();
+        while (it.next()) |resource| {
+            const bytes = estimatedSize(resource, width, height, output);
+            set.add(graph, resource, .{
+                .size = std.mem.alignForward(vk.VkDeviceSize, bytes, memory_arena.estimated_image_alignment),
+                .alignment = memory_arena.estimated_image_alignment,
+                .memoryTypeBits = ~@as(u32, 0),
+            });
+        }
+        return set;
+    }
+};
+
+/// Unpadded size of a transient
+pub fn estimatedSize(resource: Resource, width: u32, height: u32, output: output_format.OutputFormat) vk.VkDeviceSize {
+    const pixels = @as(vk.VkDeviceSize, width) * height;
+    const color_bpp: vk.VkDeviceSize = switch (output) {
+        .rgba8, .rgb10a2 => 4,
+        .rgba16f => 8,
+    };
+    return switch (resource) {
+        .warp_scratch, .backward_warped, .filled_output => pixels * color_bpp,
+        .splat_buffer => forward_splat.splatBufferSize(width, height),
+        // r16f
+        .splat_cost => pixels * 2,
+        // rgba16f mip chain
+        .pyramid => blk: {
+            var total: vk.VkDeviceSize = 0;
+            for (0..hole_fill.levelCount(width, height)) |level| {
+                const e = hole_fill.levelExtent(width, height, @intCast(level));
+                total += @as(vk.VkDeviceSize, e.width) * e.height * 8;
+            }
+            break :blk total;
+        },
+    };
+}
+
+/// Which transients share memory in a plan
+pub const AliasMap = struct {
+    /// Configuration the plan was made for
+    config: GraphConfig,
+    /// Resources overlapping each resource's memory
+    partners: std.EnumArray(Resource, Resources) = .initFill(.initEmpty()),
+
+    /// Aliases of a plan made from a TransientSet
+    pub fn init(graph: *const Graph, set: *const TransientSet, plan: *const memory_arena.Plan) AliasMap {
+        var map = AliasMap{ .config = graph.config };
+        for (0..set.count) |i| {
+            for (0..set.count) |j| {
+                if (i == j or plan.placements[i].block != plan.placements[j].block) continue;
+                const a = plan.placements[i].offset;
+                const b = plan.placements[j].offset;
+                if (a < b + set.requests[j].size and b < a + set.requests[i].size) {
+                    map.partners.getPtr(set.resources[i]).insert(set.resources[j]);
+                }
+            }
+        }
+        return map;
+    }
+
+    pub fn isAliased(self: *const AliasMap, resource: Resource) bool {
+        return self.partners.get(resource).count() > 0;
+    }
+
+    /// Resources plus everything sharing their memory
+    pub fn expand(self: *const AliasMap, set: Resources) Resources {
+        var result = set;
+        var it = set.iterator();
+        while (it.next()) |r| result.setUnion(self.partners.get(r));
+        return result;
+    }
+
+    /// Check that no aliased resources are alive at once in a graph. A
+    /// plan only holds for the configuration it was made for (mode,
+    /// splatting and pull-push as recorded).
+    pub fn fits(self: *const AliasMap, graph: *const Graph) bool {
+        for (std.enums.values(Resource)) |r| {
+            const lr = graph.lifetime(r) orelse continue;
+            var it = self.partners.get(r).iterator();
+            while (it.next()) |p| {
+                const lp = graph.lifetime(p) orelse continue;
+                if (lr.overlaps(lp)) return false;
+            }
+        }
+        return true;
+    }
+};
+
+// =============================================================================
+// Barriers
+// =============================================================================
+
+/// What to record before a pass
+pub const Step = struct {
+    barrier: bool = false,
+    /// Aliased images to transition from VK_IMAGE_LAYOUT_UNDEFINED
+    discards: Resources = .initEmpty(),
+};
+
+/// Hazards since the last barrier, across the generated frames of a batch
+pub const BarrierTracker = struct {
+    aliases: AliasMap,
+    read: Resources = .initEmpty(),
+    written: Resources = .initEmpty(),
+
+    /// Tracker for a new batch. Aliased memory was last used by the
+    /// previous batch, so with aliasing the first pass waits for it.
+    pub fn init(config: GraphConfig, aliases: ?AliasMap) BarrierTracker {
+        const map = aliases orelse return .{ .aliases = .{ .config = config } };
+        return .{ .aliases = map, .written = .initFull() };
+    }
+
+    /// Step before passes recorded with fixed barriers (tiled): waits for
+    /// the previous batch and discards every aliased image the graph uses.
+    /// Empty without aliasing.
+    pub fn enter(self: *BarrierTracker, graph: *const Graph) Step {
+        var result = Step{ .barrier = self.written.count() > 0 };
+        var it = graph.used().iterator();
+        while (it.next()) |r| {
+            if (r.isImage() and self.aliases.isAliased(r)) result.discards.insert(r);
+        }
+        self.read = .initEmpty();
+        self.written = .initEmpty();
+        return result;
+    }
+
+    /// Step before pass index i of a graph; records the pass's access
+    pub fn step(self: *BarrierTracker, graph: *const Graph, i: usize) Step {
+        const a = graph.access(graph.passes[i]);
+        const reads = self.aliases.expand(a.reads);
+        const writes = self.aliases.expand(a.writes);
+
+        var result = Step{};
+        // Read after write, write after read or write
+        result.barrier = reads.intersectWith(self.written).count() > 0 or
+            writes.intersectWith(self.written.unionWith(self.read)).count() > 0;
+        if (result.barrier) {
+            self.read = .initEmpty();
+            self.written = .initEmpty();
+        }
+        self.read.setUnion(a.reads);
+        self.written.setUnion(a.writes);
+
+        var it = a.writes.iterator();
+        while (it.next()) |r| {
+            const l = graph.lifetime(r) orelse continue;
+            if (l.first == i and r.isImage() and self.aliases.isAliased(r)) result.discards.insert(r);
+        }
+        return result;
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "graph matches the recorded pass chain" {
+    const perf = Graph.init(.{ .mode = .performance });
+    try std.testing.expectEqualSlices(Pass, &.{ .forward_warp, .linear_blend }, perf.slice());
+
+    const quality = Graph.init(.{ .mode = .quality, .splatting = true, .pull_push = true });
+    try std.testing.expectEqualSlices(Pass, &.{ .splat, .backward_warp, .confidence_blend, .pull_push }, quality.slice());
+    try std.testing.expectEqual(memory_arena.Lifetime{ .first = 0, .last = 0 }, quality.lifetime(.splat_buffer).?);
+    try std.testing.expectEqual(memory_arena.Lifetime{ .first = 0, .last = 3 }, quality.lifetime(.splat_cost).?);
+    try std.testing.expectEqual(memory_arena.Lifetime{ .first = 2, .last = 3 }, quality.lifetime(.filled_output).?);
+    try std.testing.expectEqual(memory_arena.Lifetime{ .first = 3, .last = 3 }, quality.lifetime(.pyramid).?);
+
+    const balanced = Graph.init(.{ .mode = .balanced, .pull_push = true });
+    try std.testing.expect(balanced.lifetime(.filled_output) == null);
+    try std.testing.expect(balanced.lifetime(.pyramid) == null);
+}
+
+test "barriers without aliasing match the fixed chain" {
+    const graph = Graph.init(.{ .mode = .quality });
+    var tracker = BarrierTracker.init(graph.config, null);
+    // warp, backward warp | confidence blend | occlusion fill
+    const expected = [_]bool{ false, false, true, true };
+    for (expected, 0..) |barrier, i| {
+        const s = tracker.step(&graph, i);
+        try std.testing.expectEqual(barrier, s.barrier);
+        try std.testing.expectEqual(@as(usize, 0), s.discards.count());
+    }
+    // The fill barrier already orders the blend's scratch reads before the
+    // next slot's warp
+    try std.testing.expect(!tracker.step(&graph, 0).barrier);
+
+    // Performance: the next slot overwrites the scratch the blend read
+    const perf = Graph.init(.{ .mode = .performance });
+    var perf_tracker = BarrierTracker.init(perf.config, null);
+    try std.testing.expect(!perf_tracker.step(&perf, 0).barrier);
+    try std.testing.expect(perf_tracker.step(&perf, 1).barrier);
+    try std.testing.expect(perf_tracker.step(&perf, 0).barrier);
+}
+
+test "splat and pull-push alias the intermediates" {
+    const graph = Graph.init(.{ .mode = .quality, .splatting = true, .pull_push = true });
+    const set = TransientSet.estimate(&graph, 3840, 2160, .rgba8);
+    try std.testing.expectEqual(@as(usize, 6), set.count);
+
+    const plan = try memory_arena.plan(set.slice(), .{});
+    const aliases = AliasMap.init(&graph, &set, &plan);
+    try std.testing.expect(aliases.fits(&graph));
+    try std.testing.expect(aliases.partners.get(.pyramid).contains(.splat_buffer));
+    try std.testing.expect(!aliases.isAliased(.splat_cost));
+
+    var tracker = BarrierTracker.init(graph.config, aliases);
+    // Waits for the previous batch, then the backward warp overwrites
+    // splat buffer memory the splat pass used
+    const first = tracker.step(&graph, 0);
+    try std.testing.expect(first.barrier);
+    try std.testing.expect(first.discards.contains(.warp_scratch));
+    const second = tracker.step(&graph, 1);
+    try std.testing.expect(second.barrier);
+    try std.testing.expect(second.discards.contains(.backward_warped));
+    _ = tracker.step(&graph, 2);
+    const fill = tracker.step(&graph, 3);
+    try std.testing.expect(fill.barrier);
+    try std.testing.expect(fill.discards.contains(.pyramid));
+}
+
+test "tiled batches discard aliased images once" {
+    const full = Graph.init(.{ .mode = .quality, .splatting = true, .pull_push = true });
+    const set = TransientSet.estimate(&full, 1920, 1080, .rgba8);
+    const plan = try memory_arena.plan(set.slice(), .{});
+    const aliases = AliasMap.init(&full, &set, &plan);
+
+    const tiled = Graph.init(.{ .mode = .quality });
+    try std.testing.expect(aliases.fits(&tiled));
+    var tracker = BarrierTracker.init(tiled.config, aliases);
+    const s = tracker.enter(&tiled);
+    try std.testing.expect(s.barrier);
+    try std.testing.expect(s.discards.contains(.warp_scratch));
+    try std.testing.expect(!s.discards.contains(.pyramid));
+
+    var plain = BarrierTracker.init(tiled.config, null);
+    const none = plain.enter(&tiled);
+    try std.testing.expect(!none.barrier);
+    try std.testing.expectEqual(@as(usize, 0), none.discards.count());
+}
+
+test "plan must fit the recorded configuration" {
+    const graph = Graph.init(.{ .mode = .quality });
+    var aliases = AliasMap{ .config = graph.config };
+    try std.testing.expect(aliases.fits(&graph));
+    aliases.partners.getPtr(.warp_scratch).insert(.backward_warped);
+    aliases.partners.getPtr(.backward_warped).insert(.warp_scratch);
+    try std.testing.expect(!aliases.fits(&graph));
+}
+
+test "aliasing cuts 4K quality memory by a third" {
+    const config = memory_arena.FootprintConfig{
+        .width = 3840,
+        .height = 2160,
+        .mode = .quality,
+        .splatting = true,
+        .pull_push = true,
+    };
+    const f = try memory_arena.footprint(config);
+    try std.testing.expect(f.aliased_bytes * 3 <= f.arena_bytes * 2);
+
+    // Plain intermediates are all alive at the blend pass
+    const plain = try memory_arena.footprint(.{ .width = 3840, .height = 2160, .mode = .quality });
+    try std.testing.expectEqual(plain.arena_bytes, plain.aliased_bytes);
+}
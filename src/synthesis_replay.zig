@@ -0,0 +1,368 @@
+//! Synthesis Command Replay
+//!
+//! A synthesis batch records the same binds, barriers and dispatches frame
+//! after frame. Interpolation factors, quality parameters and the scene
+//! change gates are read from the constants buffer the primary command
+//! buffer updates ahead of each batch (synthesis_constants.zig), so a
+//! recording only depends on what it binds: the output set of the ring,
+//! the history slot parity, the pipelines of the mode and format (and the
+//! input views or descriptor buffer regions without descriptor sets). The
+//! ReplayCache records each combination once into a secondary command
+//! buffer (SIMULTANEOUS_USE, so frames in flight may share it) and replays
+//! it with a single vkCmdExecuteCommands. The tile classifier, forward
+//! splat and pull-push passes still push their values, which the key then
+//! covers; timed batches are recorded directly.
+//!
+//! Recorded buffers bind descriptor sets and pipelines by handle. Whatever
+//! the key does not cover (pipelines, classifier/splat/pull-push
+//! resources, descriptor set contents) must not change while replay is
+//! enabled without invalidate(), and invalidate() requires that no
+//! replayed batch is still pending on the GPU.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const test_stubs = @import("test_stubs.zig");
+
+const max_batch_frames = frame_synthesis.max_batch_frames;
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Recorded batches per cache. Once full, further combinations are
+/// recorded directly each frame (counted in stats.overflow).
+pub const max_entries = 64;
+
+/// Pass chain of a recorded batch
+pub const Kind = enum(u8) {
+    interpolate,
+    extrapolate,
+};
+
+/// Values the tile classifier, forward splat and pull-push passes push
+/// (all zero when none of them runs)
+pub const Pushed = struct {
+    mv_scale: f32 = 0,
+    occlusion_threshold: f32 = 0,
+    cost: bool = false,
+    /// Factors k/N of the batch (only while splatting)
+    factors: [max_batch_frames]f32 = .{0} ** max_batch_frames,
+};
+
+/// Everything a recorded batch binds or pushes that may vary between frames
+pub const Key = struct {
+    kind: Kind,
+    count: u32,
+    /// Output ring set (0 without a ring)
+    output_set: u32 = 0,
+    /// History slot parity selecting the slot descriptor sets
+    history_slot: u32 = 0,
+    /// Gates the passes dispatch from, one bit per synthesis_constants.Gate
+    gates: u8 = 0,
+    mode: frame_synthesis.QualityMode = .performance,
+    format: u32 = 0,
+    splatting: bool = false,
+    /// Pull-push fill active, one bit per slot
+    pull_push: u8 = 0,
+    pushed: Pushed = .{},
+    /// Previous and current frame, forward and backward motion (push
+    /// descriptors record them by view)
+    views: [4]?vk.VkImageView = .{null} ** 4,
+    /// Descriptor buffer region group (synthesis_descriptors.zig)
+    descriptor_group: u32 = 0,
+    /// Resource generation (frame_resize.zig): batches of an earlier one
+    /// bind resources that were swapped out
+    generation: u32 = 0,
+
+    fn eql(a: Key, b: Key) bool {
+        return std.meta.eql(a, b);
+    }
+};
+
+/// Replay statistics
+pub const ReplayStats = struct {
+    /// Batches replayed from a recorded buffer
+    hits: u64 = 0,
+    /// Batches recorded into a new buffer
+    recorded: u64 = 0,
+    /// Batches recorded directly because the cache was full
+    overflow: u64 = 0,
+};
+
+/// Secondary command buffers recorded per synthesis batch key
+pub const ReplayCache = struct {
+    dispatch: *const vk.DeviceDispatch,
+    // Created with RESET_COMMAND_BUFFER: beginning a buffer again after
+    // invalidate() resets it implicitly
+    pool: vk.VkCommandPool,
+    keys: [max_entries]Key = undefined,
+    cmds: [max_entries]?vk.VkCommandBuffer = .{null} ** max_entries,
+    // Recorded entries; buffers past len are allocated but stale
+    len: u32 = 0,
+    stats: ReplayStats = .{},
+
+    /// Create the pool on the queue family of the command buffers
+    /// synthesis is recorded into (graphics, or the async compute family)
+    pub fn init(dispatch: *const vk.DeviceDispatch, queue_family: u32) !ReplayCache {
+        if (!dispatch.hasCommandReplay()) return vk.VulkanError.FunctionNotFound;
+        var pool: vk.VkCommandPool = undefined;
+        try vk.check(dispatch.vkCreateCommandPool.?(dispatch.device, &.{ .queueFamilyIndex = queue_family }, null, &pool));
+        return .{ .dispatch = dispatch, .pool = pool };
+    }
+
+    /// Destroy the pool and its buffers. No replayed batch may be pending.
+    pub fn deinit(self: *ReplayCache) void {
+        self.dispatch.vkDestroyCommandPool.?(self.dispatch.device, self.pool, null);
+    }
+
+    /// Recorded buffer of a key
+    pub fn find(self: *ReplayCache, key: Key) ?vk.VkCommandBuffer {
+        for (self.keys[0..self.len], self.cmds[0..self.len]) |k, cmd| {
+            if (k.eql(key)) {
+                self.stats.hits += 1;
+                return cmd.?;
+            }
+        }
+        return null;
+    }
+
+    /// Start recording the buffer of a new key. Returns null once the cache
+    /// is full; the batch is then recorded into the primary buffer.
+    pub fn begin(self: *ReplayCache) !?vk.VkCommandBuffer {
+        if (self.len == max_entries) {
+            self.stats.overflow += 1;
+            return null;
+        }
+        const d = self.dispatch;
+        const slot = &self.cmds[self.len];
+        if (slot.* == null) {
+            var cmds: [1]vk.VkCommandBuffer = undefined;
+            try vk.check(d.vkAllocateCommandBuffers.?(d.device, &.{
+                .commandPool = self.pool,
+                .level = vk.VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            }, &cmds));
+            slot.* = cmds[0];
+        }
+
+        // Compute only: nothing inherited from a render pass
+        const inheritance = vk.VkCommandBufferInheritanceInfo{};
+        try vk.check(d.vkBeginCommandBuffer.?(slot.*.?, &.{
+            .flags = vk.VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+            .pInheritanceInfo = &inheritance,
+        }));
+        return slot.*.?;
+    }
+
+    /// Finish the buffer returned by begin and store it under `key`
+    pub fn end(self: *ReplayCache, key: Key) !vk.VkCommandBuffer {
+        const cmd = self.cmds[self.len].?;
+        try vk.check(self.dispatch.vkEndCommandBuffer.?(cmd));
+        self.keys[self.len] = key;
+        self.len += 1;
+        self.stats.recorded += 1;
+        return cmd;
+    }
+
+    /// Drop the buffer returned by begin after a failed recording
+    pub fn cancel(self: *ReplayCache) void {
+        _ = self.dispatch.vkEndCommandBuffer.?(self.cmds[self.len].?);
+    }
+
+    /// Replay a recorded buffer into a primary command buffer
+    pub fn execute(self: *const ReplayCache, cmd: vk.VkCommandBuffer, recorded: vk.VkCommandBuffer) void {
+        const cmds = [_]vk.VkCommandBuffer{recorded};
+        self.dispatch.vkCmdExecuteCommands.?(cmd, 1, &cmds);
+    }
+
+    /// Forget every recorded batch; they are recorded again on next use.
+    /// No replayed batch may be pending.
+    pub fn invalidate(self: *ReplayCache) void {
+        self.len = 0;
+    }
+
+    /// Forget the batches recorded before `generation`, none of which may
+    /// be pending. Later ones stay.
+    pub fn retire(self: *ReplayCache, generation: u32) void {
+        var i: u32 = 0;
+        while (i < self.len) {
+            if (self.keys[i].generation >= generation) {
+                i += 1;
+                continue;
+            }
+            // Keep the stale buffer allocated past len for reuse
+            self.len -= 1;
+            std.mem.swap(Key, &self.keys[i], &self.keys[self.len]);
+            std.mem.swap(?vk.VkCommandBuffer, &self.cmds[i], &self.cmds[self.len]);
+        }
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+var stub_allocated: usize = 0;
+var stub_executed: usize = 0;
+var stub_updates: usize = 0;
+
+fn stubCreatePool(_: vk.VkDevice, info: *const vk.VkCommandPoolCreateInfo, _: ?*const vk.VkAllocationCallbacks, pool: *vk.VkCommandPool) callconv(.c) vk.VkResult {
+    std.debug.assert(info.flags & vk.VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT != 0);
+    pool.* = @ptrFromInt(0x7000);
+    return .success;
+}
+
+fn stubDestroyPool(_: vk.VkDevice, _: vk.VkCommandPool, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {}
+
+fn stubAllocate(_: vk.VkDevice, info: *const vk.VkCommandBufferAllocateInfo, cmds: [*]vk.VkCommandBuffer) callconv(.c) vk.VkResult {
+    std.debug.assert(info.level == vk.VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    stub_allocated += 1;
+    cmds[0] = @ptrFromInt(0x8000 + stub_allocated);
+    return .success;
+}
+
+fn stubBegin(_: vk.VkCommandBuffer, info: *const vk.VkCommandBufferBeginInfo) callconv(.c) vk.VkResult {
+    std.debug.assert(info.pInheritanceInfo != null);
+    return .success;
+}
+
+fn stubEnd(_: vk.VkCommandBuffer) callconv(.c) vk.VkResult {
+    return .success;
+}
+
+fn stubExecute(_: vk.VkCommandBuffer, count: u32, _: [*]const vk.VkCommandBuffer) callconv(.c) void {
+    stub_executed += count;
+}
+
+fn stubUpdate(cmd: vk.VkCommandBuffer, _: vk.VkBuffer, _: vk.VkDeviceSize, _: vk.VkDeviceSize, _: *const anyopaque) callconv(.c) void {
+    // Constants are updated in the primary command buffer only
+    std.debug.assert(cmd == @as(vk.VkCommandBuffer, @ptrFromInt(0x40)));
+    stub_updates += 1;
+}
+
+test "ReplayCache records each key once" {
+    const dispatch = vk.DeviceDispatch{
+        .device = @ptrFromInt(0x1000),
+        .vkCreateCommandPool = stubCreatePool,
+        .vkDestroyCommandPool = stubDestroyPool,
+        .vkAllocateCommandBuffers = stubAllocate,
+        .vkBeginCommandBuffer = stubBegin,
+        .vkEndCommandBuffer = stubEnd,
+        .vkCmdExecuteCommands = stubExecute,
+    };
+    stub_allocated = 0;
+    stub_executed = 0;
+    var cache = try ReplayCache.init(&dispatch, 0);
+    defer cache.deinit();
+
+    const a = Key{ .kind = .interpolate, .count = 1 };
+    const b = Key{ .kind = .interpolate, .count = 1, .output_set = 1 };
+    try std.testing.expect(cache.find(a) == null);
+    _ = (try cache.begin()).?;
+    const recorded = try cache.end(a);
+    cache.execute(@ptrFromInt(0x10), recorded);
+
+    try std.testing.expectEqual(recorded, cache.find(a).?);
+    try std.testing.expect(cache.find(b) == null);
+    _ = (try cache.begin()).?;
+    try std.testing.expect((try cache.end(b)) != recorded);
+    try std.testing.expectEqual(@as(u64, 1), cache.stats.hits);
+    try std.testing.expectEqual(@as(u64, 2), cache.stats.recorded);
+    try std.testing.expectEqual(@as(usize, 1), stub_executed);
+
+    // Invalidated buffers are recorded again without new allocations
+    cache.invalidate();
+    try std.testing.expect(cache.find(a) == null);
+    _ = (try cache.begin()).?;
+    _ = try cache.end(a);
+    try std.testing.expectEqual(@as(usize, 2), stub_allocated);
+
+    // Full cache: record directly
+    cache.len = max_entries;
+    try std.testing.expect((try cache.begin()) == null);
+    try std.testing.expectEqual(@as(u64, 1), cache.stats.overflow);
+}
+
+test "ReplayCache retires older generations" {
+    const dispatch = vk.DeviceDispatch{
+        .device = @ptrFromInt(0x1000),
+        .vkCreateCommandPool = stubCreatePool,
+        .vkDestroyCommandPool = stubDestroyPool,
+        .vkAllocateCommandBuffers = stubAllocate,
+        .vkBeginCommandBuffer = stubBegin,
+        .vkEndCommandBuffer = stubEnd,
+        .vkCmdExecuteCommands = stubExecute,
+    };
+    var cache = try ReplayCache.init(&dispatch, 0);
+    defer cache.deinit();
+
+    const old = Key{ .kind = .interpolate, .count = 1 };
+    const current = Key{ .kind = .interpolate, .count = 1, .generation = 1 };
+    _ = (try cache.begin()).?;
+    _ = try cache.end(old);
+    _ = (try cache.begin()).?;
+    const recorded = try cache.end(current);
+
+    cache.retire(1);
+    try std.testing.expectEqual(@as(u32, 1), cache.len);
+    try std.testing.expect(cache.find(old) == null);
+    try std.testing.expectEqual(recorded, cache.find(current).?);
+}
+
+test "FrameSynthesisContext replays batches per history slot" {
+    const dispatch = vk.DeviceDispatch{
+        .device = @ptrFromInt(0x1000),
+        .vkCreateCommandPool = stubCreatePool,
+        .vkDestroyCommandPool = stubDestroyPool,
+        .vkAllocateCommandBuffers = stubAllocate,
+        .vkBeginCommandBuffer = stubBegin,
+        .vkEndCommandBuffer = stubEnd,
+        .vkCmdExecuteCommands = stubExecute,
+        .vkCmdUpdateBuffer = stubUpdate,
+        .vkCmdCopyBuffer = test_stubs.copyBuffer,
+    };
+    stub_allocated = 0;
+    stub_executed = 0;
+    stub_updates = 0;
+    var ctx = frame_synthesis.FrameSynthesisContext.init(null, 1920, 1080, .performance, &dispatch, std.testing.allocator);
+    ctx.replay = try ReplayCache.init(&dispatch, 0);
+    defer ctx.deinit();
+    try ctx.setConstantsBuffer(@ptrFromInt(0x60));
+    try ctx.setOutputTarget(0, .{
+        .view = @ptrFromInt(0x10),
+        .descriptor_sets = .initFill(@ptrFromInt(0x20)),
+        .alternate_descriptor_sets = .initFill(@ptrFromInt(0x21)),
+    });
+
+    var mvb = test_stubs.motionVectors(0x30);
+    var views: [1]vk.VkImageView = undefined;
+    const cmd: vk.VkCommandBuffer = @ptrFromInt(0x40);
+    const frame_view: vk.VkImageView = @ptrFromInt(0x50);
+    for (0..4) |frame| {
+        ctx.history_slot = @intCast(frame % 2);
+        // Factors, parameters, motion scale and the gates' readback slot
+        // change every frame; they reach the passes through the constants
+        const factors = [_]f32{0.25 + 0.1 * @as(f32, @floatFromInt(frame))};
+        ctx.occlusion_threshold = 100 + @as(f32, @floatFromInt(frame));
+        mvb.vector_scale = if (frame < 2) 1 else 2;
+        ctx.dispatch_gate = .{ .buffer = @ptrFromInt(0x70 + frame), .offset = 32 };
+        try std.testing.expectEqual(@as(usize, 1), try ctx.replayBatch(cmd, .interpolate, frame_view, frame_view, &mvb, &factors, &views));
+        try std.testing.expectEqual(@as(vk.VkImageView, @ptrFromInt(0x10)), views[0]);
+    }
+    // One recording per history slot, every batch executed after its
+    // constants update
+    const cache = &ctx.replay.?;
+    try std.testing.expectEqual(@as(u64, 2), cache.stats.recorded);
+    try std.testing.expectEqual(@as(u64, 2), cache.stats.hits);
+    try std.testing.expectEqual(@as(usize, 4), stub_executed);
+    try std.testing.expectEqual(@as(usize, 4), stub_updates);
+
+    // An ungated batch dispatches directly: recorded again
+    ctx.dispatch_gate = null;
+    _ = try ctx.replayBatch(cmd, .interpolate, frame_view, frame_view, &mvb, &[_]f32{0.5}, &views);
+    try std.testing.expectEqual(@as(u64, 3), cache.stats.recorded);
+
+    // A new target invalidates the recordings
+    try ctx.setOutputTarget(0, .{ .view = @ptrFromInt(0x11), .descriptor_sets = .initFill(@ptrFromInt(0x22)) });
+    try std.testing.expectEqual(@as(u32, 0), cache.len);
+}
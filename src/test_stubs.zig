@@ -0,0 +1,196 @@
+//! Test Stubs
+//!
+//! Stub Vulkan entry points and fixtures shared by the module tests. The
+//! stubs record nothing unless a counter below says otherwise; tests that
+//! read a counter reset it first. Tests that need to observe a call (a
+//! dispatch log, a submit) keep their own stub and override the field of a
+//! copy of the dispatch tables here.
+//!
+//! Only referenced from tests.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const motion_vectors = @import("motion_vectors.zig");
+const scene_change = @import("scene_change.zig");
+
+/// Device handle of every stub dispatch
+pub const device: vk.VkDevice = @ptrFromInt(0x1000);
+
+// =============================================================================
+// Command recording
+// =============================================================================
+
+pub fn bindPipeline(_: vk.VkCommandBuffer, _: u32, _: vk.VkPipeline) callconv(.c) void {}
+pub fn bindDescriptorSets(_: vk.VkCommandBuffer, _: u32, _: vk.VkPipelineLayout, _: u32, _: u32, _: [*]const vk.VkDescriptorSet, _: u32, _: ?[*]const u32) callconv(.c) void {}
+pub fn pushConstants(_: vk.VkCommandBuffer, _: vk.VkPipelineLayout, _: u32, _: u32, _: u32, _: *const anyopaque) callconv(.c) void {}
+pub fn dispatch(_: vk.VkCommandBuffer, _: u32, _: u32, _: u32) callconv(.c) void {}
+pub fn dispatchIndirect(_: vk.VkCommandBuffer, _: vk.VkBuffer, _: vk.VkDeviceSize) callconv(.c) void {}
+pub fn pipelineBarrier(_: vk.VkCommandBuffer, _: vk.VkPipelineStageFlags, _: vk.VkPipelineStageFlags, _: u32, _: u32, _: ?[*]const vk.VkMemoryBarrier, _: u32, _: ?*const anyopaque, _: u32, _: ?*const anyopaque) callconv(.c) void {}
+pub fn pushDescriptorSet(_: vk.VkCommandBuffer, _: u32, _: vk.VkPipelineLayout, _: u32, _: u32, _: [*]const vk.VkWriteDescriptorSet) callconv(.c) void {}
+pub fn updateBuffer(_: vk.VkCommandBuffer, _: vk.VkBuffer, _: vk.VkDeviceSize, _: vk.VkDeviceSize, _: *const anyopaque) callconv(.c) void {}
+pub fn copyBuffer(_: vk.VkCommandBuffer, _: vk.VkBuffer, _: vk.VkBuffer, _: u32, _: [*]const vk.VkBufferCopy) callconv(.c) void {}
+pub fn copyImage(_: vk.VkCommandBuffer, _: vk.VkImage, _: u32, _: vk.VkImage, _: u32, _: u32, _: [*]const vk.VkImageCopy) callconv(.c) void {}
+
+/// Records compute passes (pipelines, classic sets, push constants,
+/// constants buffer updates, direct and indirect dispatches, barriers)
+/// into nothing
+pub const recording_dispatch = vk.DeviceDispatch{
+    .device = device,
+    .vkCmdBindPipeline = bindPipeline,
+    .vkCmdBindDescriptorSets = bindDescriptorSets,
+    .vkCmdPushConstants = pushConstants,
+    .vkCmdDispatch = dispatch,
+    .vkCmdDispatchIndirect = dispatchIndirect,
+    .vkCmdPipelineBarrier = pipelineBarrier,
+    .vkCmdUpdateBuffer = updateBuffer,
+    .vkCmdCopyBuffer = copyBuffer,
+};
+
+// =============================================================================
+// Pipeline creation
+// =============================================================================
+
+/// SPIR-V magic number; enough for the stub shader modules
+pub const spirv = [_]u32{0x07230203};
+
+/// Pipelines created and destroyed, and shaders loaded
+pub var pipelines_created: u32 = 0;
+pub var pipelines_destroyed: u32 = 0;
+pub var spirv_loads: u32 = 0;
+
+/// ShaderLibrary load callback returning `spirv` for every name
+pub fn loadSpirv(_: ?*anyopaque, _: []const u8) ?[]const u32 {
+    spirv_loads += 1;
+    return &spirv;
+}
+
+pub fn createShaderModule(_: vk.VkDevice, _: *const vk.VkShaderModuleCreateInfo, _: ?*const vk.VkAllocationCallbacks, module: *vk.VkShaderModule) callconv(.c) vk.VkResult {
+    module.* = @ptrFromInt(0x3000);
+    return .success;
+}
+
+pub fn destroyShaderModule(_: vk.VkDevice, _: vk.VkShaderModule, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {}
+
+pub fn createComputePipelines(_: vk.VkDevice, _: ?vk.VkPipelineCache, _: u32, _: [*]const vk.VkComputePipelineCreateInfo, _: ?*const vk.VkAllocationCallbacks, pipelines: [*]vk.VkPipeline) callconv(.c) vk.VkResult {
+    pipelines_created += 1;
+    pipelines[0] = @ptrFromInt(0x4000);
+    return .success;
+}
+
+pub fn destroyPipeline(_: vk.VkDevice, _: vk.VkPipeline, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {
+    pipelines_destroyed += 1;
+}
+
+/// A dispatch that can also create and destroy compute pipelines
+pub fn withPipelines(base: vk.DeviceDispatch) vk.DeviceDispatch {
+    var d = base;
+    d.vkCreateShaderModule = createShaderModule;
+    d.vkDestroyShaderModule = destroyShaderModule;
+    d.vkCreateComputePipelines = createComputePipelines;
+    d.vkDestroyPipeline = destroyPipeline;
+    return d;
+}
+
+// =============================================================================
+// Timeline semaphores
+// =============================================================================
+
+/// Value every timeline semaphore reports as reached
+pub var timeline_value: u64 = 0;
+var semaphores: usize = 0x5000;
+
+/// Hands out a distinct handle per call; the library only creates
+/// timeline semaphores
+pub fn createSemaphore(_: vk.VkDevice, info: *const vk.VkSemaphoreCreateInfo, _: ?*const vk.VkAllocationCallbacks, semaphore: *vk.VkSemaphore) callconv(.c) vk.VkResult {
+    const type_info: *const vk.VkSemaphoreTypeCreateInfo = @ptrCast(@alignCast(info.pNext orelse return .error_initialization_failed));
+    if (type_info.semaphoreType != vk.VK_SEMAPHORE_TYPE_TIMELINE) return .error_initialization_failed;
+    semaphores += 0x10;
+    semaphore.* = @ptrFromInt(semaphores);
+    return .success;
+}
+
+pub fn destroySemaphore(_: vk.VkDevice, _: vk.VkSemaphore, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {}
+
+pub fn counterValue(_: vk.VkDevice, _: vk.VkSemaphore, value: *u64) callconv(.c) vk.VkResult {
+    value.* = timeline_value;
+    return .success;
+}
+
+/// Creates, destroys and queries timeline semaphores
+pub const timeline_dispatch = vk.DeviceDispatch{
+    .device = device,
+    .vkCreateSemaphore = createSemaphore,
+    .vkDestroySemaphore = destroySemaphore,
+    .vkGetSemaphoreCounterValue = counterValue,
+};
+
+// =============================================================================
+// Device memory
+// =============================================================================
+
+/// Allocations not freed yet
+pub var allocations: u32 = 0;
+
+/// Memory handles are 0x4000 + memory type index
+pub fn allocateMemory(_: vk.VkDevice, info: *const vk.VkMemoryAllocateInfo, _: ?*const vk.VkAllocationCallbacks, memory: *vk.VkDeviceMemory) callconv(.c) vk.VkResult {
+    allocations += 1;
+    memory.* = @ptrFromInt(0x4000 + info.memoryTypeIndex);
+    return .success;
+}
+
+pub fn freeMemory(_: vk.VkDevice, _: vk.VkDeviceMemory, _: ?*const vk.VkAllocationCallbacks) callconv(.c) void {
+    allocations -= 1;
+}
+
+pub fn bindImageMemory(_: vk.VkDevice, _: vk.VkImage, _: vk.VkDeviceMemory, _: vk.VkDeviceSize) callconv(.c) vk.VkResult {
+    return .success;
+}
+
+pub fn bindBufferMemory(_: vk.VkDevice, _: vk.VkBuffer, _: vk.VkDeviceMemory, _: vk.VkDeviceSize) callconv(.c) vk.VkResult {
+    return .success;
+}
+
+/// Allocates, frees and binds device memory
+pub const memory_dispatch = vk.DeviceDispatch{
+    .device = device,
+    .vkAllocateMemory = allocateMemory,
+    .vkFreeMemory = freeMemory,
+    .vkBindImageMemory = bindImageMemory,
+    .vkBindBufferMemory = bindBufferMemory,
+};
+
+// =============================================================================
+// Fixtures
+// =============================================================================
+
+/// 480x270 forward flow grid (1920x1080 at 4x4) whose image, view and
+/// memory are base, base + 1 and base + 2
+pub fn motionVectors(base: usize) motion_vectors.MotionVectorBuffer {
+    return .{
+        .forward = @ptrFromInt(base),
+        .forward_view = @ptrFromInt(base + 1),
+        .forward_memory = @ptrFromInt(base + 2),
+        .width = 480,
+        .height = 270,
+        .grid_size = .@"4x4",
+    };
+}
+
+/// Give a detector stub pipelines and bind every readback slot to
+/// `results`, which the test fills in as the GPU would
+pub fn bindDetector(
+    detector: *scene_change.SceneChangeDetector,
+    results: *[scene_change.readback_depth]scene_change.SceneStatsResult,
+) !void {
+    detector.reduce_pipeline = @ptrFromInt(0x10);
+    detector.finalize_pipeline = @ptrFromInt(0x20);
+    detector.pipeline_layout = @ptrFromInt(0x30);
+    for (results, 0..) |*result, i| {
+        result.* = std.mem.zeroes(scene_change.SceneStatsResult);
+        try detector.bindReadbackSlot(@intCast(i), .{
+            .buffer = @ptrFromInt(0x100 + i * 0x10),
+            .mapped = result,
+            .descriptor_set = @ptrFromInt(0x200 + i * 0x10),
+        });
+    }
+}
@@ -0,0 +1,280 @@
+//! Tile Classification
+//!
+//! Bins 16x16 pixel tiles by the motion field and cost map they cover, so
+//! synthesis only runs expensive kernels where they are needed:
+//! - static: near-zero motion and low cost, copied straight through
+//! - simple: coherent motion and low cost, forward warp + linear blend
+//! - fill: high cost or divergent motion, the mode's full pass chain
+//!
+//! tile_classify.comp appends every tile to the list of its class. Each
+//! list header is a VkDispatchIndirectCommand with one workgroup per listed
+//! tile, so the kernels of a class are dispatched indirectly without a CPU
+//! round trip. Synthesis kernels pick their list through specialization
+//! constant 0 (TILE_CLASS, see shaders/tiles.glsl).
+//!
+//! In menus and slow scenes most tiles are static, and synthesis cost
+//! drops to roughly that of a copy.
+
+const std = @import("std");
+const vk = @import("vulkan.zig");
+const frame_synthesis = @import("frame_synthesis.zig");
+const motion_vectors = @import("motion_vectors.zig");
+
+// =============================================================================
+// Types
+// =============================================================================
+
+/// Tile class (list index, and TILE_CLASS specialization value of the
+/// synthesis kernels for simple and fill)
+pub const TileClass = enum(u32) {
+    static = 0,
+    simple = 1,
+    fill = 2,
+};
+
+/// Number of tile classes
+pub const class_count: u32 = 3;
+
+/// Tile edge length in pixels (one synthesis workgroup)
+pub const tile_size: u32 = frame_synthesis.workgroup_size;
+
+/// Specialization constant ID of TILE_CLASS in the synthesis shaders
+pub const tile_class_constant_id: u32 = 0;
+
+/// List header entry for one class (std430 uvec4)
+pub const ClassHeader = extern struct {
+    /// Indirect dispatch arguments (x = tiles in the list)
+    dispatch: vk.VkDispatchIndirectCommand,
+    /// Tiles each list can hold
+    capacity: u32,
+};
+
+/// GPU tile list header, followed by class_count lists of packed
+/// (x | y << 16) tile coordinates
+pub const TileListHeader = extern struct {
+    classes: [class_count]ClassHeader,
+};
+
+/// Byte offset of a class's indirect dispatch arguments
+pub fn dispatchArgsOffset(class: TileClass) vk.VkDeviceSize {
+    return @as(vk.VkDeviceSize, @intFromEnum(class)) * @sizeOf(ClassHeader);
+}
+
+/// Tiles covering a frame (capacity of each list)
+pub fn tileCapacity(width: u32, height: u32) u32 {
+    return frame_synthesis.groupCount(width) * frame_synthesis.groupCount(height);
+}
+
+/// Size of the tile list storage buffer for a frame
+pub fn tileListBufferSize(width: u32, height: u32) vk.VkDeviceSize {
+    return @sizeOf(TileListHeader) + @as(vk.VkDeviceSize, tileCapacity(width, height)) * class_count * 4;
+}
+
+/// Push constants for tile_classify.comp
+pub const TileClassifyPushConstants = extern struct {
+    mv_scale_x: f32,
+    mv_scale_y: f32,
+    /// Motion (pixels) below which a tile is static
+    static_motion: f32,
+    /// Cost that needs occlusion fill
+    occlusion_threshold: f32,
+    /// Motion spread within a tile (pixels) that needs occlusion fill
+    divergence: f32,
+    /// Bit 0: cost map valid
+    flags: u32,
+    /// Tiles per list
+    capacity: u32,
+    /// Frame width | height << 16
+    frame_extent: u32,
+};
+
+/// Constants block of tile_copy.comp
+pub const TileCopyConstants = extern struct {
+    /// Interpolation factor (0.0 = prev, 1.0 = curr)
+    interpolation: f32,
+    _reserved: [3]f32 = .{ 0, 0, 0 },
+};
+
+/// Synthesis pipelines specialized per tile class, built from the "_tiled"
+/// SPIR-V variants (PassShader.variantName). Layouts are shared with the
+/// full-frame pipelines of FrameSynthesisContext.
+pub const TiledPipelines = struct {
+    /// tile_copy.comp (static tiles)
+    copy_pipeline: ?vk.VkPipeline = null,
+
+    /// TILE_CLASS = simple: forward_warp.comp, linear_blend.comp
+    simple_warp_pipeline: ?vk.VkPipeline = null,
+    simple_blend_pipeline: ?vk.VkPipeline = null,
+
+    /// TILE_CLASS = fill: the mode's chain
+    fill_warp_pipeline: ?vk.VkPipeline = null,
+    /// linear_blend.comp (performance mode)
+    fill_blend_pipeline: ?vk.VkPipeline = null,
+    /// backward_warp.comp, confidence_blend.comp, occlusion_fill.comp
+    fill_quality: frame_synthesis.QualityPipeline = .{},
+
+    /// Check that every pipeline a mode records is present
+    pub fn isComplete(self: TiledPipelines, mode: frame_synthesis.QualityMode) bool {
+        if (self.copy_pipeline == null or self.simple_warp_pipeline == null or
+            self.simple_blend_pipeline == null or self.fill_warp_pipeline == null) return false;
+        return switch (mode) {
+            .performance => self.fill_blend_pipeline != null,
+            .balanced => self.fill_quality.backward_warp_pipeline != null and
+                self.fill_quality.confidence_blend_pipeline != null,
+            .quality => self.fill_quality.backward_warp_pipeline != null and
+                self.fill_quality.confidence_blend_pipeline != null and
+                self.fill_quality.occlusion_fill_pipeline != null,
+        };
+    }
+};
+
+/// Tile classifier
+pub const TileClassifier = struct {
+    // Classification pipeline (optional until created)
+    pipeline: ?vk.VkPipeline = null,
+    pipeline_layout: ?vk.VkPipelineLayout = null,
+    /// Flow, cost map and tile lists (binding 8)
+    descriptor_set: ?vk.VkDescriptorSet = null,
+
+    /// Tile list buffer (tileListBufferSize), also bound at binding 8 of
+    /// the tiled synthesis kernels (PassShader.bindings). Needs
+    /// SHADER_DEVICE_ADDRESS usage with a descriptor buffer.
+    tile_buffer: ?vk.VkBuffer = null,
+
+    pipelines: TiledPipelines = .{},
+
+    // Classification thresholds
+    static_motion: f32 = 0.25,
+    divergence: f32 = 2.0,
+
+    // Dispatch table
+    dispatch: ?*const vk.DeviceDispatch,
+
+    /// Initialize tile classifier
+    pub fn init(dispatch: ?*const vk.DeviceDispatch) TileClassifier {
+        return .{ .dispatch = dispatch };
+    }
+
+    /// Check if tiled synthesis can run for a mode
+    pub fn isActive(self: *const TileClassifier, mode: frame_synthesis.QualityMode) bool {
+        const d = self.dispatch orelse return false;
+        if (!d.hasComputeRecording() or d.vkCmdDispatchIndirect == null or d.vkCmdFillBuffer == null) return false;
+        if (self.pipeline == null or self.pipeline_layout == null or self.descriptor_set == null) return false;
+        if (self.tile_buffer == null) return false;
+        return self.pipelines.isComplete(mode);
+    }
+
+    /// Indirect dispatch arguments for the kernels of one class
+    pub fn classArgs(self: *const TileClassifier, class: TileClass) ?frame_synthesis.DispatchGate {
+        const buffer = self.tile_buffer orelse return null;
+        return .{ .buffer = buffer, .offset = dispatchArgsOffset(class) };
+    }
+
+    /// Record classification for one frame pair. With a gate (scene change,
+    /// low confidence) a skipped classification leaves every list empty, so
+    /// all tiled kernels are skipped too. Returns false if not active.
+    pub fn record(
+        self: *const TileClassifier,
+        cmd: vk.VkCommandBuffer,
+        mode: frame_synthesis.QualityMode,
+        width: u32,
+        height: u32,
+        mv_buffer: *const motion_vectors.MotionVectorBuffer,
+        occlusion_threshold: f32,
+        gate: ?frame_synthesis.DispatchGate,
+    ) bool {
+        if (!self.isActive(mode)) return false;
+        const d = self.dispatch.?;
+        const layout = self.pipeline_layout.?;
+        const cost_enabled = mv_buffer.cost_view != null;
+
+        // Reset list counts
+        d.vkCmdFillBuffer.?(cmd, self.tile_buffer.?, 0, @sizeOf(TileListHeader), 0);
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_TRANSFER_BIT,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_TRANSFER_WRITE_BIT,
+            vk.VK_ACCESS_SHADER_READ_BIT | vk.VK_ACCESS_SHADER_WRITE_BIT,
+        );
+
+        const push = TileClassifyPushConstants{
+            .mv_scale_x = mv_buffer.mvScale(),
+            .mv_scale_y = mv_buffer.mvScale(),
+            .static_motion = self.static_motion,
+            // Without a cost map only motion spread selects fill tiles
+            .occlusion_threshold = if (cost_enabled) occlusion_threshold else std.math.floatMax(f32),
+            .divergence = self.divergence,
+            .flags = if (cost_enabled) 1 else 0,
+            .capacity = tileCapacity(width, height),
+            .frame_extent = (width & 0xFFFF) | (height << 16),
+        };
+        const sets = [_]vk.VkDescriptorSet{self.descriptor_set.?};
+        d.vkCmdBindPipeline.?(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, self.pipeline.?);
+        if (d.vkCmdBindDescriptorSets) |bind_sets| {
+            bind_sets(cmd, vk.VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets, 0, null);
+        }
+        d.vkCmdPushConstants.?(cmd, layout, vk.VK_SHADER_STAGE_COMPUTE_BIT, 0, @sizeOf(TileClassifyPushConstants), &push);
+
+        // One workgroup per tile: the gate is scene_change.Gates.tiles, which
+        // carries this grid (not the synthesis workgroup grid)
+        if (gate) |g| {
+            d.vkCmdDispatchIndirect.?(cmd, g.buffer, g.offset);
+        } else {
+            d.vkCmdDispatch.?(cmd, frame_synthesis.groupCount(width), frame_synthesis.groupCount(height), 1);
+        }
+
+        // Lists feed the indirect dispatches and the kernels' tile lookups
+        d.cmdMemoryBarrier(
+            cmd,
+            vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | vk.VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            vk.VK_ACCESS_SHADER_WRITE_BIT,
+            vk.VK_ACCESS_INDIRECT_COMMAND_READ_BIT | vk.VK_ACCESS_SHADER_READ_BIT,
+        );
+        return true;
+    }
+};
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+test "tile list layout" {
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(ClassHeader));
+    try std.testing.expectEqual(@as(usize, 48), @sizeOf(TileListHeader));
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 0), dispatchArgsOffset(.static));
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 32), dispatchArgsOffset(.fill));
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(TileClassifyPushConstants));
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(TileCopyConstants));
+}
+
+test "tile list sizing" {
+    // 1080p: 120x68 tiles
+    try std.testing.expectEqual(@as(u32, 8160), tileCapacity(1920, 1080));
+    try std.testing.expectEqual(@as(vk.VkDeviceSize, 48 + 8160 * 3 * 4), tileListBufferSize(1920, 1080));
+}
+
+test "TiledPipelines.isComplete" {
+    const p: vk.VkPipeline = @ptrFromInt(0x10);
+    var t = TiledPipelines{
+        .copy_pipeline = p,
+        .simple_warp_pipeline = p,
+        .simple_blend_pipeline = p,
+        .fill_warp_pipeline = p,
+    };
+    try std.testing.expect(!t.isComplete(.performance));
+    t.fill_blend_pipeline = p;
+    try std.testing.expect(t.isComplete(.performance));
+    try std.testing.expect(!t.isComplete(.balanced));
+
+    t.fill_quality = .{ .backward_warp_pipeline = p, .confidence_blend_pipeline = p };
+    try std.testing.expect(t.isComplete(.balanced));
+    try std.testing.expect(!t.isComplete(.quality));
+}
+
+test "TileClassifier inactive without resources" {
+    const c = TileClassifier.init(null);
+    try std.testing.expect(!c.isActive(.performance));
+    try std.testing.expect(c.classArgs(.simple) == null);
+}
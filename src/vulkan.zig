@@ -113,6 +113,11 @@ pub const VkDescriptorSet = *opaque {};
 pub const VkSampler = *opaque {};
 pub const VkBuffer = *opaque {};
 pub const VkCommandBuffer = *opaque {};
+pub const VkShaderModule = *opaque {};
+pub const VkPipelineCache = *opaque {};
+pub const VkQueryPool = *opaque {};
+pub const VkCommandPool = *opaque {};
+pub const VkFence = *opaque {};
 
 // Basic Vulkan structures
 pub const VkOffset2D = extern struct {
@@ -130,6 +135,18 @@ pub const VkRect2D = extern struct {
     extent: VkExtent2D = .{},
 };
 
+pub const VkOffset3D = extern struct {
+    x: i32 = 0,
+    y: i32 = 0,
+    z: i32 = 0,
+};
+
+pub const VkExtent3D = extern struct {
+    width: u32 = 0,
+    height: u32 = 0,
+    depth: u32 = 1,
+};
+
 // Callback function types for allocators
 pub const PFN_vkAllocationFunction = ?*const fn (
     pUserData: ?*anyopaque,
@@ -338,6 +355,8 @@ pub const VK_PIPELINE_STAGE_VERTEX_INPUT_BIT: VkPipelineStageFlags = 0x00000004;
 pub const VK_PIPELINE_STAGE_VERTEX_SHADER_BIT: VkPipelineStageFlags = 0x00000008;
 pub const VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT: VkPipelineStageFlags = 0x00000080;
 pub const VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT: VkPipelineStageFlags = 0x00000800;
+pub const VK_PIPELINE_STAGE_TRANSFER_BIT: VkPipelineStageFlags = 0x00001000;
+pub const VK_PIPELINE_STAGE_HOST_BIT: VkPipelineStageFlags = 0x00004000;
 pub const VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT: VkPipelineStageFlags = 0x00008000;
 pub const VK_PIPELINE_STAGE_ALL_COMMANDS_BIT: VkPipelineStageFlags = 0x00010000;
 
@@ -365,19 +384,94 @@ pub const VkStructureType = enum(i32) {
     _,
 };
 
+// Pipeline bind points
+pub const VK_PIPELINE_BIND_POINT_COMPUTE: u32 = 1;
+
+// Access flags
+pub const VkAccessFlags = u32;
+pub const VK_ACCESS_INDIRECT_COMMAND_READ_BIT: VkAccessFlags = 0x00000001;
+pub const VK_ACCESS_UNIFORM_READ_BIT: VkAccessFlags = 0x00000008;
+pub const VK_ACCESS_SHADER_READ_BIT: VkAccessFlags = 0x00000020;
+pub const VK_ACCESS_SHADER_WRITE_BIT: VkAccessFlags = 0x00000040;
+pub const VK_ACCESS_TRANSFER_READ_BIT: VkAccessFlags = 0x00000800;
+pub const VK_ACCESS_TRANSFER_WRITE_BIT: VkAccessFlags = 0x00001000;
+pub const VK_ACCESS_HOST_READ_BIT: VkAccessFlags = 0x00002000;
+pub const VK_ACCESS_MEMORY_READ_BIT: VkAccessFlags = 0x00008000;
+pub const VK_ACCESS_MEMORY_WRITE_BIT: VkAccessFlags = 0x00010000;
+
+pub const VkDeviceSize = u64;
+
 // Descriptor types
 pub const VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: u32 = 1;
 pub const VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: u32 = 3;
+pub const VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: u32 = 6;
+pub const VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: u32 = 7;
 
 // Shader stage flags
 pub const VK_SHADER_STAGE_COMPUTE_BIT: u32 = 0x00000020;
 
 // Image layouts
+pub const VK_IMAGE_LAYOUT_UNDEFINED: u32 = 0;
 pub const VK_IMAGE_LAYOUT_GENERAL: u32 = 1;
 pub const VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL: u32 = 5;
+pub const VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL: u32 = 6;
+pub const VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL: u32 = 7;
+
+// Image aspect flags
+pub const VK_IMAGE_ASPECT_COLOR_BIT: u32 = 0x00000001;
+
+/// Image subresource layers (copies)
+pub const VkImageSubresourceLayers = extern struct {
+    aspectMask: u32 = VK_IMAGE_ASPECT_COLOR_BIT,
+    mipLevel: u32 = 0,
+    baseArrayLayer: u32 = 0,
+    layerCount: u32 = 1,
+};
+
+/// Image subresource range (barriers)
+pub const VkImageSubresourceRange = extern struct {
+    aspectMask: u32 = VK_IMAGE_ASPECT_COLOR_BIT,
+    baseMipLevel: u32 = 0,
+    levelCount: u32 = VK_REMAINING_MIP_LEVELS,
+    baseArrayLayer: u32 = 0,
+    layerCount: u32 = VK_REMAINING_ARRAY_LAYERS,
+};
+
+pub const VK_REMAINING_MIP_LEVELS: u32 = ~@as(u32, 0);
+pub const VK_REMAINING_ARRAY_LAYERS: u32 = ~@as(u32, 0);
+pub const VK_QUEUE_FAMILY_IGNORED: u32 = ~@as(u32, 0);
+pub const VK_WHOLE_SIZE: VkDeviceSize = ~@as(VkDeviceSize, 0);
+
+/// Image copy region
+pub const VkImageCopy = extern struct {
+    srcSubresource: VkImageSubresourceLayers = .{},
+    srcOffset: VkOffset3D = .{},
+    dstSubresource: VkImageSubresourceLayers = .{},
+    dstOffset: VkOffset3D = .{},
+    extent: VkExtent3D = .{},
+};
+
+/// Buffer copy region (vkCmdCopyBuffer)
+pub const VkBufferCopy = extern struct {
+    srcOffset: VkDeviceSize = 0,
+    dstOffset: VkDeviceSize = 0,
+    size: VkDeviceSize,
+};
+
+/// Scaled copy region (vkCmdBlitImage)
+pub const VkImageBlit = extern struct {
+    srcSubresource: VkImageSubresourceLayers = .{},
+    srcOffsets: [2]VkOffset3D = .{ .{}, .{} },
+    dstSubresource: VkImageSubresourceLayers = .{},
+    dstOffsets: [2]VkOffset3D = .{ .{}, .{} },
+};
+
+pub const VK_FILTER_LINEAR: u32 = 1;
 
 // Structure type constants
 pub const VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO: u32 = 32;
+pub const VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER: u32 = 45;
+pub const VK_STRUCTURE_TYPE_MEMORY_BARRIER: u32 = 46;
 
 /// Descriptor set layout binding
 pub const VkDescriptorSetLayoutBinding = extern struct {
@@ -397,6 +491,449 @@ pub const VkDescriptorSetLayoutCreateInfo = extern struct {
     pBindings: ?[*]const VkDescriptorSetLayoutBinding,
 };
 
+/// Global memory barrier (used between dependent compute passes)
+pub const VkMemoryBarrier = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+    pNext: ?*const anyopaque = null,
+    srcAccessMask: VkAccessFlags = 0,
+    dstAccessMask: VkAccessFlags = 0,
+};
+
+/// Image memory barrier (layout transitions)
+pub const VkImageMemoryBarrier = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+    pNext: ?*const anyopaque = null,
+    srcAccessMask: VkAccessFlags = 0,
+    dstAccessMask: VkAccessFlags = 0,
+    oldLayout: u32 = VK_IMAGE_LAYOUT_UNDEFINED,
+    newLayout: u32 = VK_IMAGE_LAYOUT_GENERAL,
+    srcQueueFamilyIndex: u32 = VK_QUEUE_FAMILY_IGNORED,
+    dstQueueFamilyIndex: u32 = VK_QUEUE_FAMILY_IGNORED,
+    image: VkImage,
+    subresourceRange: VkImageSubresourceRange = .{},
+};
+
+/// Indirect dispatch arguments (VkDispatchIndirectCommand)
+pub const VkDispatchIndirectCommand = extern struct {
+    x: u32 = 0,
+    y: u32 = 0,
+    z: u32 = 0,
+};
+
+// =============================================================================
+// Device Memory
+// =============================================================================
+
+pub const VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO: u32 = 5;
+
+/// Memory requirements of an image or buffer
+pub const VkMemoryRequirements = extern struct {
+    size: VkDeviceSize = 0,
+    alignment: VkDeviceSize = 1,
+    memoryTypeBits: u32 = 0,
+};
+
+/// Memory allocate info
+pub const VkMemoryAllocateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+    pNext: ?*const anyopaque = null,
+    allocationSize: VkDeviceSize,
+    memoryTypeIndex: u32,
+};
+
+// =============================================================================
+// Timeline Semaphores
+// =============================================================================
+
+pub const VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO: u32 = 9;
+pub const VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO: u32 = 1000207002;
+pub const VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO: u32 = 1000207003;
+pub const VK_SEMAPHORE_TYPE_TIMELINE: u32 = 1;
+
+/// Semaphore type (chained to VkSemaphoreCreateInfo)
+pub const VkSemaphoreTypeCreateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+    pNext: ?*const anyopaque = null,
+    semaphoreType: u32 = VK_SEMAPHORE_TYPE_TIMELINE,
+    initialValue: u64 = 0,
+};
+
+/// Semaphore create info
+pub const VkSemaphoreCreateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+};
+
+/// Timeline values of a submission (chained to VkSubmitInfo by the caller)
+pub const VkTimelineSemaphoreSubmitInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+    pNext: ?*const anyopaque = null,
+    waitSemaphoreValueCount: u32 = 0,
+    pWaitSemaphoreValues: ?[*]const u64 = null,
+    signalSemaphoreValueCount: u32 = 0,
+    pSignalSemaphoreValues: ?[*]const u64 = null,
+};
+
+// =============================================================================
+// Timestamp Queries
+// =============================================================================
+
+pub const VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO: u32 = 11;
+pub const VK_QUERY_TYPE_TIMESTAMP: u32 = 2;
+pub const VK_QUERY_RESULT_64_BIT: u32 = 0x00000001;
+pub const VK_QUERY_RESULT_WITH_AVAILABILITY_BIT: u32 = 0x00000004;
+pub const VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT: VkPipelineStageFlags = 0x00002000;
+
+/// Query pool create info
+pub const VkQueryPoolCreateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    queryType: u32 = VK_QUERY_TYPE_TIMESTAMP,
+    queryCount: u32,
+    pipelineStatistics: u32 = 0,
+};
+
+// =============================================================================
+// Command Submission
+// =============================================================================
+
+pub const VK_STRUCTURE_TYPE_SUBMIT_INFO: u32 = 4;
+pub const VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO: u32 = 39;
+pub const VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO: u32 = 40;
+pub const VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO: u32 = 41;
+pub const VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO: u32 = 42;
+pub const VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO: u32 = 1000207004;
+pub const VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT: u32 = 0x00000002;
+pub const VK_COMMAND_BUFFER_LEVEL_PRIMARY: u32 = 0;
+pub const VK_COMMAND_BUFFER_LEVEL_SECONDARY: u32 = 1;
+pub const VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT: u32 = 0x00000001;
+pub const VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT: u32 = 0x00000004;
+
+/// Command pool create info
+pub const VkCommandPoolCreateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+    queueFamilyIndex: u32,
+};
+
+/// Command buffer allocate info
+pub const VkCommandBufferAllocateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+    pNext: ?*const anyopaque = null,
+    commandPool: VkCommandPool,
+    level: u32 = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+    commandBufferCount: u32 = 1,
+};
+
+/// Secondary command buffer inheritance (no render pass: compute only)
+pub const VkCommandBufferInheritanceInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+    pNext: ?*const anyopaque = null,
+    renderPass: ?*anyopaque = null,
+    subpass: u32 = 0,
+    framebuffer: ?*anyopaque = null,
+    occlusionQueryEnable: u32 = 0,
+    queryFlags: u32 = 0,
+    pipelineStatistics: u32 = 0,
+};
+
+/// Command buffer begin info
+pub const VkCommandBufferBeginInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    pInheritanceInfo: ?*const VkCommandBufferInheritanceInfo = null,
+};
+
+/// Queue submission (timeline values chained through pNext)
+pub const VkSubmitInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+    pNext: ?*const anyopaque = null,
+    waitSemaphoreCount: u32 = 0,
+    pWaitSemaphores: ?[*]const VkSemaphore = null,
+    pWaitDstStageMask: ?[*]const VkPipelineStageFlags = null,
+    commandBufferCount: u32 = 0,
+    pCommandBuffers: ?[*]const VkCommandBuffer = null,
+    signalSemaphoreCount: u32 = 0,
+    pSignalSemaphores: ?[*]const VkSemaphore = null,
+};
+
+/// Host wait on timeline semaphore values
+pub const VkSemaphoreWaitInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    semaphoreCount: u32,
+    pSemaphores: [*]const VkSemaphore,
+    pValues: [*]const u64,
+};
+
+// =============================================================================
+// Descriptor Updates (VK_KHR_push_descriptor, VK_EXT_descriptor_buffer)
+// =============================================================================
+
+pub const VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET: u32 = 35;
+pub const VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO: u32 = 1000244001;
+pub const VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT: u32 = 1000316000;
+pub const VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT: u32 = 1000316003;
+pub const VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT: u32 = 1000316004;
+pub const VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT: u32 = 1000316011;
+pub const VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR: u32 = 0x00000001;
+pub const VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT: u32 = 0x00000010;
+pub const VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT: u32 = 0x20000000;
+pub const VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT: u32 = 0x00020000;
+pub const VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT: u32 = 0x00200000;
+pub const VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT: u32 = 0x00400000;
+
+pub const VkDeviceAddress = u64;
+
+/// Image descriptor (sampler ignored for storage images)
+pub const VkDescriptorImageInfo = extern struct {
+    sampler: ?VkSampler = null,
+    imageView: ?VkImageView = null,
+    imageLayout: u32 = VK_IMAGE_LAYOUT_GENERAL,
+};
+
+/// Buffer descriptor
+pub const VkDescriptorBufferInfo = extern struct {
+    buffer: VkBuffer,
+    offset: VkDeviceSize = 0,
+    range: VkDeviceSize = VK_WHOLE_SIZE,
+};
+
+/// Descriptor write (image and buffer descriptors)
+pub const VkWriteDescriptorSet = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+    pNext: ?*const anyopaque = null,
+    // Ignored for push descriptors
+    dstSet: ?VkDescriptorSet = null,
+    dstBinding: u32,
+    dstArrayElement: u32 = 0,
+    descriptorCount: u32 = 1,
+    descriptorType: u32,
+    pImageInfo: ?*const VkDescriptorImageInfo = null,
+    pBufferInfo: ?*const VkDescriptorBufferInfo = null,
+    pTexelBufferView: ?*const anyopaque = null,
+};
+
+pub const VkBufferDeviceAddressInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+    pNext: ?*const anyopaque = null,
+    buffer: VkBuffer,
+};
+
+/// Buffer range of a storage or uniform buffer descriptor fetched with
+/// vkGetDescriptorEXT
+pub const VkDescriptorAddressInfoEXT = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+    pNext: ?*const anyopaque = null,
+    address: VkDeviceAddress,
+    range: VkDeviceSize,
+    format: u32 = 0,
+};
+
+/// Descriptor to fetch with vkGetDescriptorEXT. `data` is the
+/// VkDescriptorDataEXT union; image descriptors point at a
+/// VkDescriptorImageInfo, buffers at a VkDescriptorAddressInfoEXT.
+pub const VkDescriptorGetInfoEXT = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+    pNext: ?*const anyopaque = null,
+    type: u32,
+    data: ?*const anyopaque,
+};
+
+/// Descriptor buffer bound with vkCmdBindDescriptorBuffersEXT
+pub const VkDescriptorBufferBindingInfoEXT = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+    pNext: ?*const anyopaque = null,
+    address: VkDeviceAddress,
+    usage: u32,
+};
+
+/// Descriptor buffer limits and descriptor sizes (chain into
+/// VkPhysicalDeviceProperties2)
+pub const VkPhysicalDeviceDescriptorBufferPropertiesEXT = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT,
+    pNext: ?*anyopaque = null,
+    combinedImageSamplerDescriptorSingleArray: VkBool32 = 0,
+    bufferlessPushDescriptors: VkBool32 = 0,
+    allowSamplerImageViewPostSubmitCreation: VkBool32 = 0,
+    descriptorBufferOffsetAlignment: VkDeviceSize = 0,
+    maxDescriptorBufferBindings: u32 = 0,
+    maxResourceDescriptorBufferBindings: u32 = 0,
+    maxSamplerDescriptorBufferBindings: u32 = 0,
+    maxEmbeddedImmutableSamplerBindings: u32 = 0,
+    maxEmbeddedImmutableSamplers: u32 = 0,
+    bufferCaptureReplayDescriptorDataSize: usize = 0,
+    imageCaptureReplayDescriptorDataSize: usize = 0,
+    imageViewCaptureReplayDescriptorDataSize: usize = 0,
+    samplerCaptureReplayDescriptorDataSize: usize = 0,
+    accelerationStructureCaptureReplayDescriptorDataSize: usize = 0,
+    samplerDescriptorSize: usize = 0,
+    combinedImageSamplerDescriptorSize: usize = 0,
+    sampledImageDescriptorSize: usize = 0,
+    storageImageDescriptorSize: usize = 0,
+    uniformTexelBufferDescriptorSize: usize = 0,
+    robustUniformTexelBufferDescriptorSize: usize = 0,
+    storageTexelBufferDescriptorSize: usize = 0,
+    robustStorageTexelBufferDescriptorSize: usize = 0,
+    uniformBufferDescriptorSize: usize = 0,
+    robustUniformBufferDescriptorSize: usize = 0,
+    storageBufferDescriptorSize: usize = 0,
+    robustStorageBufferDescriptorSize: usize = 0,
+    inputAttachmentDescriptorSize: usize = 0,
+    accelerationStructureDescriptorSize: usize = 0,
+    maxSamplerDescriptorBufferRange: VkDeviceSize = 0,
+    maxResourceDescriptorBufferRange: VkDeviceSize = 0,
+    samplerDescriptorBufferAddressSpaceSize: VkDeviceSize = 0,
+    resourceDescriptorBufferAddressSpaceSize: VkDeviceSize = 0,
+    descriptorBufferAddressSpaceSize: VkDeviceSize = 0,
+};
+
+// =============================================================================
+// Compute Pipeline Creation
+// =============================================================================
+
+pub const VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO: u32 = 16;
+pub const VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO: u32 = 17;
+pub const VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO: u32 = 18;
+pub const VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO: u32 = 29;
+
+/// Shader module create info (code size in bytes)
+pub const VkShaderModuleCreateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    codeSize: usize,
+    pCode: [*]const u32,
+};
+
+/// Specialization constant map entry
+pub const VkSpecializationMapEntry = extern struct {
+    constantID: u32,
+    offset: u32,
+    size: usize,
+};
+
+/// Specialization constants of a shader stage
+pub const VkSpecializationInfo = extern struct {
+    mapEntryCount: u32,
+    pMapEntries: [*]const VkSpecializationMapEntry,
+    dataSize: usize,
+    pData: *const anyopaque,
+};
+
+/// Pipeline shader stage create info
+pub const VkPipelineShaderStageCreateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    stage: u32 = VK_SHADER_STAGE_COMPUTE_BIT,
+    module: VkShaderModule,
+    pName: [*:0]const u8 = "main",
+    pSpecializationInfo: ?*const VkSpecializationInfo = null,
+};
+
+/// Compute pipeline create info
+pub const VkComputePipelineCreateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    stage: VkPipelineShaderStageCreateInfo,
+    layout: VkPipelineLayout,
+    basePipelineHandle: ?VkPipeline = null,
+    basePipelineIndex: i32 = -1,
+};
+
+/// Pipeline cache create info
+pub const VkPipelineCacheCreateInfo = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+    pNext: ?*const anyopaque = null,
+    flags: u32 = 0,
+    initialDataSize: usize = 0,
+    pInitialData: ?*const anyopaque = null,
+};
+
+pub const VK_PIPELINE_CACHE_HEADER_VERSION_ONE: u32 = 1;
+
+/// Header at the start of vkGetPipelineCacheData output
+pub const VkPipelineCacheHeaderVersionOne = extern struct {
+    headerSize: u32,
+    headerVersion: u32,
+    vendorID: u32,
+    deviceID: u32,
+    pipelineCacheUUID: [VK_UUID_SIZE]u8,
+};
+
+// =============================================================================
+// Physical Device Queries
+// =============================================================================
+
+pub const VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2: u32 = 1000059000;
+pub const VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES: u32 = 1000082000;
+
+pub const VK_UUID_SIZE: usize = 16;
+
+// Vendor IDs (VkPhysicalDeviceProperties.vendorID)
+pub const VK_VENDOR_ID_NVIDIA: u32 = 0x10DE;
+pub const VK_VENDOR_ID_AMD: u32 = 0x1002;
+pub const VK_VENDOR_ID_INTEL: u32 = 0x8086;
+pub const VK_VENDOR_ID_MESA: u32 = 0x10005;
+
+// Physical device types
+pub const VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: u32 = 1;
+pub const VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: u32 = 2;
+pub const VK_PHYSICAL_DEVICE_TYPE_CPU: u32 = 4;
+
+/// Physical device properties. Limits and sparse properties are kept as
+/// raw storage; only the identity fields and timestampPeriod are read.
+pub const VkPhysicalDeviceProperties = extern struct {
+    apiVersion: u32 = 0,
+    driverVersion: u32 = 0,
+    vendorID: u32 = 0,
+    deviceID: u32 = 0,
+    deviceType: u32 = 0,
+    deviceName: [256]u8 = [_]u8{0} ** 256,
+    pipelineCacheUUID: [VK_UUID_SIZE]u8 = [_]u8{0} ** VK_UUID_SIZE,
+    limits: [504]u8 align(8) = [_]u8{0} ** 504,
+    sparseProperties: [5]u32 = [_]u32{0} ** 5,
+
+    pub fn name(self: *const VkPhysicalDeviceProperties) []const u8 {
+        return std.mem.sliceTo(&self.deviceName, 0);
+    }
+
+    /// Nanoseconds per timestamp tick (VkPhysicalDeviceLimits.timestampPeriod)
+    pub fn timestampPeriod(self: *const VkPhysicalDeviceProperties) f32 {
+        return @bitCast(std.mem.readInt(u32, self.limits[timestamp_period_offset..][0..4], native_endian));
+    }
+
+    const timestamp_period_offset = 424;
+    const native_endian = @import("builtin").cpu.arch.endian();
+};
+
+/// Physical device features (VkPhysicalDeviceFeatures, 55 VkBool32)
+pub const VkPhysicalDeviceFeatures = extern struct {
+    bools: [55]VkBool32 = [_]VkBool32{VK_FALSE} ** 55,
+};
+
+/// Physical device features with extension chain
+pub const VkPhysicalDeviceFeatures2 = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+    pNext: ?*anyopaque = null,
+    features: VkPhysicalDeviceFeatures = .{},
+};
+
+/// Half-precision and 8-bit integer shader arithmetic
+pub const VkPhysicalDeviceShaderFloat16Int8Features = extern struct {
+    sType: u32 = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES,
+    pNext: ?*anyopaque = null,
+    shaderFloat16: VkBool32 = VK_FALSE,
+    shaderInt8: VkBool32 = VK_FALSE,
+};
+
 // =============================================================================
 // Function Pointer Types (use .c for Zig 0.16+)
 // =============================================================================
@@ -417,7 +954,78 @@ pub const PFN_vkCmdSetCheckpointNV = *const fn (VkCommandBuffer, ?*const anyopaq
 pub const PFN_vkGetQueueCheckpointDataNV = *const fn (VkQueue, *u32, ?[*]VkCheckpointDataNV) callconv(.c) void;
 
 // Core Vulkan functions
-pub const PFN_vkCreateDescriptorSetLayout = *const fn (VkDevice, *const VkDescriptorSetLayoutCreateInfo, ?*const VkAllocationCallbacks, *VkDescriptorSetLayout) callconv(.c) i32;
+pub const PFN_vkCreateDescriptorSetLayout = *const fn (VkDevice, *const VkDescriptorSetLayoutCreateInfo, ?*const VkAllocationCallbacks, *VkDescriptorSetLayout) callconv(.c) VkResult;
+pub const PFN_vkUpdateDescriptorSets = *const fn (VkDevice, u32, [*]const VkWriteDescriptorSet, u32, ?*const anyopaque) callconv(.c) void;
+
+// VK_KHR_push_descriptor
+pub const PFN_vkCmdPushDescriptorSetKHR = *const fn (VkCommandBuffer, u32, VkPipelineLayout, u32, u32, [*]const VkWriteDescriptorSet) callconv(.c) void;
+
+// VK_EXT_descriptor_buffer (+ core 1.2 buffer device address)
+pub const PFN_vkGetBufferDeviceAddress = *const fn (VkDevice, *const VkBufferDeviceAddressInfo) callconv(.c) VkDeviceAddress;
+pub const PFN_vkGetDescriptorSetLayoutSizeEXT = *const fn (VkDevice, VkDescriptorSetLayout, *VkDeviceSize) callconv(.c) void;
+pub const PFN_vkGetDescriptorSetLayoutBindingOffsetEXT = *const fn (VkDevice, VkDescriptorSetLayout, u32, *VkDeviceSize) callconv(.c) void;
+pub const PFN_vkGetDescriptorEXT = *const fn (VkDevice, *const VkDescriptorGetInfoEXT, usize, *anyopaque) callconv(.c) void;
+pub const PFN_vkCmdBindDescriptorBuffersEXT = *const fn (VkCommandBuffer, u32, [*]const VkDescriptorBufferBindingInfoEXT) callconv(.c) void;
+pub const PFN_vkCmdSetDescriptorBufferOffsetsEXT = *const fn (VkCommandBuffer, u32, VkPipelineLayout, u32, u32, [*]const u32, [*]const VkDeviceSize) callconv(.c) void;
+
+// Core Vulkan compute recording
+pub const PFN_vkCmdBindPipeline = *const fn (VkCommandBuffer, u32, VkPipeline) callconv(.c) void;
+pub const PFN_vkCmdBindDescriptorSets = *const fn (VkCommandBuffer, u32, VkPipelineLayout, u32, u32, [*]const VkDescriptorSet, u32, ?[*]const u32) callconv(.c) void;
+pub const PFN_vkCmdPushConstants = *const fn (VkCommandBuffer, VkPipelineLayout, u32, u32, u32, *const anyopaque) callconv(.c) void;
+pub const PFN_vkCmdDispatch = *const fn (VkCommandBuffer, u32, u32, u32) callconv(.c) void;
+pub const PFN_vkCmdDispatchIndirect = *const fn (VkCommandBuffer, VkBuffer, VkDeviceSize) callconv(.c) void;
+pub const PFN_vkCmdCopyImage = *const fn (VkCommandBuffer, VkImage, u32, VkImage, u32, u32, [*]const VkImageCopy) callconv(.c) void;
+pub const PFN_vkCmdBlitImage = *const fn (VkCommandBuffer, VkImage, u32, VkImage, u32, u32, [*]const VkImageBlit, u32) callconv(.c) void;
+pub const PFN_vkCmdFillBuffer = *const fn (VkCommandBuffer, VkBuffer, VkDeviceSize, VkDeviceSize, u32) callconv(.c) void;
+pub const PFN_vkCmdUpdateBuffer = *const fn (VkCommandBuffer, VkBuffer, VkDeviceSize, VkDeviceSize, *const anyopaque) callconv(.c) void;
+pub const PFN_vkCmdCopyBuffer = *const fn (VkCommandBuffer, VkBuffer, VkBuffer, u32, [*]const VkBufferCopy) callconv(.c) void;
+pub const PFN_vkCmdPipelineBarrier = *const fn (VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, u32, u32, ?[*]const VkMemoryBarrier, u32, ?*const anyopaque, u32, ?*const anyopaque) callconv(.c) void;
+
+// Core Vulkan pipeline creation
+pub const PFN_vkCreateShaderModule = *const fn (VkDevice, *const VkShaderModuleCreateInfo, ?*const VkAllocationCallbacks, *VkShaderModule) callconv(.c) VkResult;
+pub const PFN_vkDestroyShaderModule = *const fn (VkDevice, VkShaderModule, ?*const VkAllocationCallbacks) callconv(.c) void;
+pub const PFN_vkCreateComputePipelines = *const fn (VkDevice, ?VkPipelineCache, u32, [*]const VkComputePipelineCreateInfo, ?*const VkAllocationCallbacks, [*]VkPipeline) callconv(.c) VkResult;
+pub const PFN_vkDestroyPipeline = *const fn (VkDevice, VkPipeline, ?*const VkAllocationCallbacks) callconv(.c) void;
+pub const PFN_vkCreatePipelineCache = *const fn (VkDevice, *const VkPipelineCacheCreateInfo, ?*const VkAllocationCallbacks, *VkPipelineCache) callconv(.c) VkResult;
+pub const PFN_vkDestroyPipelineCache = *const fn (VkDevice, VkPipelineCache, ?*const VkAllocationCallbacks) callconv(.c) void;
+pub const PFN_vkGetPipelineCacheData = *const fn (VkDevice, VkPipelineCache, *usize, ?*anyopaque) callconv(.c) VkResult;
+pub const PFN_vkMergePipelineCaches = *const fn (VkDevice, VkPipelineCache, u32, [*]const VkPipelineCache) callconv(.c) VkResult;
+
+// Core Vulkan device memory
+pub const PFN_vkAllocateMemory = *const fn (VkDevice, *const VkMemoryAllocateInfo, ?*const VkAllocationCallbacks, *VkDeviceMemory) callconv(.c) VkResult;
+pub const PFN_vkFreeMemory = *const fn (VkDevice, VkDeviceMemory, ?*const VkAllocationCallbacks) callconv(.c) void;
+pub const PFN_vkGetImageMemoryRequirements = *const fn (VkDevice, VkImage, *VkMemoryRequirements) callconv(.c) void;
+pub const PFN_vkGetBufferMemoryRequirements = *const fn (VkDevice, VkBuffer, *VkMemoryRequirements) callconv(.c) void;
+pub const PFN_vkBindImageMemory = *const fn (VkDevice, VkImage, VkDeviceMemory, VkDeviceSize) callconv(.c) VkResult;
+pub const PFN_vkBindBufferMemory = *const fn (VkDevice, VkBuffer, VkDeviceMemory, VkDeviceSize) callconv(.c) VkResult;
+
+// Core Vulkan timeline semaphores (1.2)
+pub const PFN_vkCreateSemaphore = *const fn (VkDevice, *const VkSemaphoreCreateInfo, ?*const VkAllocationCallbacks, *VkSemaphore) callconv(.c) VkResult;
+pub const PFN_vkDestroySemaphore = *const fn (VkDevice, VkSemaphore, ?*const VkAllocationCallbacks) callconv(.c) void;
+pub const PFN_vkGetSemaphoreCounterValue = *const fn (VkDevice, VkSemaphore, *u64) callconv(.c) VkResult;
+pub const PFN_vkWaitSemaphores = *const fn (VkDevice, *const VkSemaphoreWaitInfo, u64) callconv(.c) VkResult;
+
+// Core Vulkan command pools and submission
+pub const PFN_vkGetDeviceQueue = *const fn (VkDevice, u32, u32, *VkQueue) callconv(.c) void;
+pub const PFN_vkCreateCommandPool = *const fn (VkDevice, *const VkCommandPoolCreateInfo, ?*const VkAllocationCallbacks, *VkCommandPool) callconv(.c) VkResult;
+pub const PFN_vkDestroyCommandPool = *const fn (VkDevice, VkCommandPool, ?*const VkAllocationCallbacks) callconv(.c) void;
+pub const PFN_vkAllocateCommandBuffers = *const fn (VkDevice, *const VkCommandBufferAllocateInfo, [*]VkCommandBuffer) callconv(.c) VkResult;
+pub const PFN_vkResetCommandBuffer = *const fn (VkCommandBuffer, u32) callconv(.c) VkResult;
+pub const PFN_vkBeginCommandBuffer = *const fn (VkCommandBuffer, *const VkCommandBufferBeginInfo) callconv(.c) VkResult;
+pub const PFN_vkEndCommandBuffer = *const fn (VkCommandBuffer) callconv(.c) VkResult;
+pub const PFN_vkQueueSubmit = *const fn (VkQueue, u32, [*]const VkSubmitInfo, ?VkFence) callconv(.c) VkResult;
+pub const PFN_vkCmdExecuteCommands = *const fn (VkCommandBuffer, u32, [*]const VkCommandBuffer) callconv(.c) void;
+
+// Core Vulkan timestamp queries
+pub const PFN_vkCreateQueryPool = *const fn (VkDevice, *const VkQueryPoolCreateInfo, ?*const VkAllocationCallbacks, *VkQueryPool) callconv(.c) VkResult;
+pub const PFN_vkDestroyQueryPool = *const fn (VkDevice, VkQueryPool, ?*const VkAllocationCallbacks) callconv(.c) void;
+pub const PFN_vkCmdResetQueryPool = *const fn (VkCommandBuffer, VkQueryPool, u32, u32) callconv(.c) void;
+pub const PFN_vkCmdWriteTimestamp = *const fn (VkCommandBuffer, VkPipelineStageFlags, VkQueryPool, u32) callconv(.c) void;
+pub const PFN_vkGetQueryPoolResults = *const fn (VkDevice, VkQueryPool, u32, u32, usize, *anyopaque, VkDeviceSize, u32) callconv(.c) VkResult;
+
+// Core Vulkan physical device queries (instance level)
+pub const PFN_vkGetPhysicalDeviceProperties = *const fn (VkPhysicalDevice, *VkPhysicalDeviceProperties) callconv(.c) void;
+pub const PFN_vkGetPhysicalDeviceFeatures2 = *const fn (VkPhysicalDevice, *VkPhysicalDeviceFeatures2) callconv(.c) void;
 
 // =============================================================================
 // Dynamic Loader
@@ -470,6 +1078,66 @@ pub const DeviceDispatch = struct {
     vkGetQueueCheckpointDataNV: ?PFN_vkGetQueueCheckpointDataNV = null,
     // Core Vulkan functions
     vkCreateDescriptorSetLayout: ?PFN_vkCreateDescriptorSetLayout = null,
+    vkUpdateDescriptorSets: ?PFN_vkUpdateDescriptorSets = null,
+    // VK_KHR_push_descriptor
+    vkCmdPushDescriptorSetKHR: ?PFN_vkCmdPushDescriptorSetKHR = null,
+    // VK_EXT_descriptor_buffer
+    vkGetBufferDeviceAddress: ?PFN_vkGetBufferDeviceAddress = null,
+    vkGetDescriptorSetLayoutSizeEXT: ?PFN_vkGetDescriptorSetLayoutSizeEXT = null,
+    vkGetDescriptorSetLayoutBindingOffsetEXT: ?PFN_vkGetDescriptorSetLayoutBindingOffsetEXT = null,
+    vkGetDescriptorEXT: ?PFN_vkGetDescriptorEXT = null,
+    vkCmdBindDescriptorBuffersEXT: ?PFN_vkCmdBindDescriptorBuffersEXT = null,
+    vkCmdSetDescriptorBufferOffsetsEXT: ?PFN_vkCmdSetDescriptorBufferOffsetsEXT = null,
+    // Core Vulkan compute recording
+    vkCmdBindPipeline: ?PFN_vkCmdBindPipeline = null,
+    vkCmdBindDescriptorSets: ?PFN_vkCmdBindDescriptorSets = null,
+    vkCmdPushConstants: ?PFN_vkCmdPushConstants = null,
+    vkCmdDispatch: ?PFN_vkCmdDispatch = null,
+    vkCmdDispatchIndirect: ?PFN_vkCmdDispatchIndirect = null,
+    vkCmdPipelineBarrier: ?PFN_vkCmdPipelineBarrier = null,
+    vkCmdFillBuffer: ?PFN_vkCmdFillBuffer = null,
+    vkCmdUpdateBuffer: ?PFN_vkCmdUpdateBuffer = null,
+    vkCmdCopyBuffer: ?PFN_vkCmdCopyBuffer = null,
+    vkCmdCopyImage: ?PFN_vkCmdCopyImage = null,
+    vkCmdBlitImage: ?PFN_vkCmdBlitImage = null,
+    // Core Vulkan pipeline creation
+    vkCreateShaderModule: ?PFN_vkCreateShaderModule = null,
+    vkDestroyShaderModule: ?PFN_vkDestroyShaderModule = null,
+    vkCreateComputePipelines: ?PFN_vkCreateComputePipelines = null,
+    vkDestroyPipeline: ?PFN_vkDestroyPipeline = null,
+    // Core Vulkan pipeline caches
+    vkCreatePipelineCache: ?PFN_vkCreatePipelineCache = null,
+    vkDestroyPipelineCache: ?PFN_vkDestroyPipelineCache = null,
+    vkGetPipelineCacheData: ?PFN_vkGetPipelineCacheData = null,
+    vkMergePipelineCaches: ?PFN_vkMergePipelineCaches = null,
+    // Core Vulkan device memory
+    vkAllocateMemory: ?PFN_vkAllocateMemory = null,
+    vkFreeMemory: ?PFN_vkFreeMemory = null,
+    vkGetImageMemoryRequirements: ?PFN_vkGetImageMemoryRequirements = null,
+    vkGetBufferMemoryRequirements: ?PFN_vkGetBufferMemoryRequirements = null,
+    vkBindImageMemory: ?PFN_vkBindImageMemory = null,
+    vkBindBufferMemory: ?PFN_vkBindBufferMemory = null,
+    // Core Vulkan timeline semaphores
+    vkCreateSemaphore: ?PFN_vkCreateSemaphore = null,
+    vkDestroySemaphore: ?PFN_vkDestroySemaphore = null,
+    vkGetSemaphoreCounterValue: ?PFN_vkGetSemaphoreCounterValue = null,
+    vkWaitSemaphores: ?PFN_vkWaitSemaphores = null,
+    // Core Vulkan command pools and submission
+    vkGetDeviceQueue: ?PFN_vkGetDeviceQueue = null,
+    vkCreateCommandPool: ?PFN_vkCreateCommandPool = null,
+    vkDestroyCommandPool: ?PFN_vkDestroyCommandPool = null,
+    vkAllocateCommandBuffers: ?PFN_vkAllocateCommandBuffers = null,
+    vkResetCommandBuffer: ?PFN_vkResetCommandBuffer = null,
+    vkBeginCommandBuffer: ?PFN_vkBeginCommandBuffer = null,
+    vkEndCommandBuffer: ?PFN_vkEndCommandBuffer = null,
+    vkQueueSubmit: ?PFN_vkQueueSubmit = null,
+    vkCmdExecuteCommands: ?PFN_vkCmdExecuteCommands = null,
+    // Core Vulkan timestamp queries
+    vkCreateQueryPool: ?PFN_vkCreateQueryPool = null,
+    vkDestroyQueryPool: ?PFN_vkDestroyQueryPool = null,
+    vkCmdResetQueryPool: ?PFN_vkCmdResetQueryPool = null,
+    vkCmdWriteTimestamp: ?PFN_vkCmdWriteTimestamp = null,
+    vkGetQueryPoolResults: ?PFN_vkGetQueryPoolResults = null,
 
     pub fn init(device: VkDevice, getDeviceProcAddr: PFN_vkGetDeviceProcAddr) DeviceDispatch {
         return .{
@@ -482,6 +1150,57 @@ pub const DeviceDispatch = struct {
             .vkCmdSetCheckpointNV = @ptrCast(getDeviceProcAddr(device, "vkCmdSetCheckpointNV")),
             .vkGetQueueCheckpointDataNV = @ptrCast(getDeviceProcAddr(device, "vkGetQueueCheckpointDataNV")),
             .vkCreateDescriptorSetLayout = @ptrCast(getDeviceProcAddr(device, "vkCreateDescriptorSetLayout")),
+            .vkUpdateDescriptorSets = @ptrCast(getDeviceProcAddr(device, "vkUpdateDescriptorSets")),
+            .vkCmdPushDescriptorSetKHR = @ptrCast(getDeviceProcAddr(device, "vkCmdPushDescriptorSetKHR")),
+            .vkGetBufferDeviceAddress = @ptrCast(getDeviceProcAddr(device, "vkGetBufferDeviceAddress")),
+            .vkGetDescriptorSetLayoutSizeEXT = @ptrCast(getDeviceProcAddr(device, "vkGetDescriptorSetLayoutSizeEXT")),
+            .vkGetDescriptorSetLayoutBindingOffsetEXT = @ptrCast(getDeviceProcAddr(device, "vkGetDescriptorSetLayoutBindingOffsetEXT")),
+            .vkGetDescriptorEXT = @ptrCast(getDeviceProcAddr(device, "vkGetDescriptorEXT")),
+            .vkCmdBindDescriptorBuffersEXT = @ptrCast(getDeviceProcAddr(device, "vkCmdBindDescriptorBuffersEXT")),
+            .vkCmdSetDescriptorBufferOffsetsEXT = @ptrCast(getDeviceProcAddr(device, "vkCmdSetDescriptorBufferOffsetsEXT")),
+            .vkCmdBindPipeline = @ptrCast(getDeviceProcAddr(device, "vkCmdBindPipeline")),
+            .vkCmdBindDescriptorSets = @ptrCast(getDeviceProcAddr(device, "vkCmdBindDescriptorSets")),
+            .vkCmdPushConstants = @ptrCast(getDeviceProcAddr(device, "vkCmdPushConstants")),
+            .vkCmdDispatch = @ptrCast(getDeviceProcAddr(device, "vkCmdDispatch")),
+            .vkCmdDispatchIndirect = @ptrCast(getDeviceProcAddr(device, "vkCmdDispatchIndirect")),
+            .vkCmdPipelineBarrier = @ptrCast(getDeviceProcAddr(device, "vkCmdPipelineBarrier")),
+            .vkCmdFillBuffer = @ptrCast(getDeviceProcAddr(device, "vkCmdFillBuffer")),
+            .vkCmdUpdateBuffer = @ptrCast(getDeviceProcAddr(device, "vkCmdUpdateBuffer")),
+            .vkCmdCopyBuffer = @ptrCast(getDeviceProcAddr(device, "vkCmdCopyBuffer")),
+            .vkCmdCopyImage = @ptrCast(getDeviceProcAddr(device, "vkCmdCopyImage")),
+            .vkCmdBlitImage = @ptrCast(getDeviceProcAddr(device, "vkCmdBlitImage")),
+            .vkCreateShaderModule = @ptrCast(getDeviceProcAddr(device, "vkCreateShaderModule")),
+            .vkDestroyShaderModule = @ptrCast(getDeviceProcAddr(device, "vkDestroyShaderModule")),
+            .vkCreateComputePipelines = @ptrCast(getDeviceProcAddr(device, "vkCreateComputePipelines")),
+            .vkDestroyPipeline = @ptrCast(getDeviceProcAddr(device, "vkDestroyPipeline")),
+            .vkCreatePipelineCache = @ptrCast(getDeviceProcAddr(device, "vkCreatePipelineCache")),
+            .vkDestroyPipelineCache = @ptrCast(getDeviceProcAddr(device, "vkDestroyPipelineCache")),
+            .vkGetPipelineCacheData = @ptrCast(getDeviceProcAddr(device, "vkGetPipelineCacheData")),
+            .vkMergePipelineCaches = @ptrCast(getDeviceProcAddr(device, "vkMergePipelineCaches")),
+            .vkAllocateMemory = @ptrCast(getDeviceProcAddr(device, "vkAllocateMemory")),
+            .vkFreeMemory = @ptrCast(getDeviceProcAddr(device, "vkFreeMemory")),
+            .vkGetImageMemoryRequirements = @ptrCast(getDeviceProcAddr(device, "vkGetImageMemoryRequirements")),
+            .vkGetBufferMemoryRequirements = @ptrCast(getDeviceProcAddr(device, "vkGetBufferMemoryRequirements")),
+            .vkBindImageMemory = @ptrCast(getDeviceProcAddr(device, "vkBindImageMemory")),
+            .vkBindBufferMemory = @ptrCast(getDeviceProcAddr(device, "vkBindBufferMemory")),
+            .vkCreateSemaphore = @ptrCast(getDeviceProcAddr(device, "vkCreateSemaphore")),
+            .vkDestroySemaphore = @ptrCast(getDeviceProcAddr(device, "vkDestroySemaphore")),
+            .vkGetSemaphoreCounterValue = @ptrCast(getDeviceProcAddr(device, "vkGetSemaphoreCounterValue")),
+            .vkWaitSemaphores = @ptrCast(getDeviceProcAddr(device, "vkWaitSemaphores")),
+            .vkGetDeviceQueue = @ptrCast(getDeviceProcAddr(device, "vkGetDeviceQueue")),
+            .vkCreateCommandPool = @ptrCast(getDeviceProcAddr(device, "vkCreateCommandPool")),
+            .vkDestroyCommandPool = @ptrCast(getDeviceProcAddr(device, "vkDestroyCommandPool")),
+            .vkAllocateCommandBuffers = @ptrCast(getDeviceProcAddr(device, "vkAllocateCommandBuffers")),
+            .vkResetCommandBuffer = @ptrCast(getDeviceProcAddr(device, "vkResetCommandBuffer")),
+            .vkBeginCommandBuffer = @ptrCast(getDeviceProcAddr(device, "vkBeginCommandBuffer")),
+            .vkEndCommandBuffer = @ptrCast(getDeviceProcAddr(device, "vkEndCommandBuffer")),
+            .vkQueueSubmit = @ptrCast(getDeviceProcAddr(device, "vkQueueSubmit")),
+            .vkCmdExecuteCommands = @ptrCast(getDeviceProcAddr(device, "vkCmdExecuteCommands")),
+            .vkCreateQueryPool = @ptrCast(getDeviceProcAddr(device, "vkCreateQueryPool")),
+            .vkDestroyQueryPool = @ptrCast(getDeviceProcAddr(device, "vkDestroyQueryPool")),
+            .vkCmdResetQueryPool = @ptrCast(getDeviceProcAddr(device, "vkCmdResetQueryPool")),
+            .vkCmdWriteTimestamp = @ptrCast(getDeviceProcAddr(device, "vkCmdWriteTimestamp")),
+            .vkGetQueryPoolResults = @ptrCast(getDeviceProcAddr(device, "vkGetQueryPoolResults")),
         };
     }
 
@@ -496,6 +1215,113 @@ pub const DeviceDispatch = struct {
         return self.vkCmdSetCheckpointNV != null and
             self.vkGetQueueCheckpointDataNV != null;
     }
+
+    pub fn hasComputeRecording(self: *const DeviceDispatch) bool {
+        return self.vkCmdBindPipeline != null and
+            self.vkCmdPushConstants != null and
+            self.vkCmdDispatch != null and
+            self.vkCmdPipelineBarrier != null;
+    }
+
+    pub fn hasPushDescriptors(self: *const DeviceDispatch) bool {
+        return self.vkCmdPushDescriptorSetKHR != null;
+    }
+
+    pub fn hasDescriptorBuffer(self: *const DeviceDispatch) bool {
+        return self.vkGetBufferDeviceAddress != null and
+            self.vkGetDescriptorSetLayoutSizeEXT != null and
+            self.vkGetDescriptorSetLayoutBindingOffsetEXT != null and
+            self.vkGetDescriptorEXT != null and
+            self.vkCmdBindDescriptorBuffersEXT != null and
+            self.vkCmdSetDescriptorBufferOffsetsEXT != null;
+    }
+
+    pub fn hasPipelineCreation(self: *const DeviceDispatch) bool {
+        return self.vkCreateShaderModule != null and
+            self.vkDestroyShaderModule != null and
+            self.vkCreateComputePipelines != null;
+    }
+
+    pub fn hasMemoryAllocation(self: *const DeviceDispatch) bool {
+        return self.vkAllocateMemory != null and
+            self.vkFreeMemory != null and
+            self.vkBindImageMemory != null and
+            self.vkBindBufferMemory != null;
+    }
+
+    pub fn hasPipelineCache(self: *const DeviceDispatch) bool {
+        return self.vkCreatePipelineCache != null and
+            self.vkDestroyPipelineCache != null and
+            self.vkGetPipelineCacheData != null and
+            self.vkMergePipelineCaches != null;
+    }
+
+    pub fn hasTimelineSemaphores(self: *const DeviceDispatch) bool {
+        return self.vkCreateSemaphore != null and
+            self.vkDestroySemaphore != null and
+            self.vkGetSemaphoreCounterValue != null;
+    }
+
+    pub fn hasQueueSubmission(self: *const DeviceDispatch) bool {
+        return self.vkGetDeviceQueue != null and
+            self.vkCreateCommandPool != null and
+            self.vkDestroyCommandPool != null and
+            self.vkAllocateCommandBuffers != null and
+            self.vkResetCommandBuffer != null and
+            self.vkBeginCommandBuffer != null and
+            self.vkEndCommandBuffer != null and
+            self.vkQueueSubmit != null and
+            self.vkWaitSemaphores != null;
+    }
+
+    pub fn hasCommandReplay(self: *const DeviceDispatch) bool {
+        return self.vkCreateCommandPool != null and
+            self.vkDestroyCommandPool != null and
+            self.vkAllocateCommandBuffers != null and
+            self.vkBeginCommandBuffer != null and
+            self.vkEndCommandBuffer != null and
+            self.vkCmdExecuteCommands != null;
+    }
+
+    pub fn hasTimestampQueries(self: *const DeviceDispatch) bool {
+        return self.vkCreateQueryPool != null and
+            self.vkDestroyQueryPool != null and
+            self.vkCmdResetQueryPool != null and
+            self.vkCmdWriteTimestamp != null and
+            self.vkGetQueryPoolResults != null;
+    }
+
+    /// Record a global memory barrier. No-op if vkCmdPipelineBarrier is missing.
+    pub fn cmdMemoryBarrier(
+        self: *const DeviceDispatch,
+        cmd: VkCommandBuffer,
+        src_stage: VkPipelineStageFlags,
+        dst_stage: VkPipelineStageFlags,
+        src_access: VkAccessFlags,
+        dst_access: VkAccessFlags,
+    ) void {
+        const barrier_fn = self.vkCmdPipelineBarrier orelse return;
+        const barriers = [_]VkMemoryBarrier{.{
+            .srcAccessMask = src_access,
+            .dstAccessMask = dst_access,
+        }};
+        barrier_fn(cmd, src_stage, dst_stage, 0, 1, &barriers, 0, null, 0, null);
+    }
+
+    /// Record a global memory barrier plus image barriers in one
+    /// vkCmdPipelineBarrier. No-op if vkCmdPipelineBarrier is missing.
+    pub fn cmdImageBarriers(
+        self: *const DeviceDispatch,
+        cmd: VkCommandBuffer,
+        src_stage: VkPipelineStageFlags,
+        dst_stage: VkPipelineStageFlags,
+        memory: VkMemoryBarrier,
+        images: []const VkImageMemoryBarrier,
+    ) void {
+        const barrier_fn = self.vkCmdPipelineBarrier orelse return;
+        const barriers = [_]VkMemoryBarrier{memory};
+        barrier_fn(cmd, src_stage, dst_stage, 0, 1, &barriers, 0, null, @intCast(images.len), if (images.len > 0) images.ptr else null);
+    }
 };
 
 // =============================================================================
@@ -517,4 +1343,31 @@ test "structure sizes" {
     try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkLatencySleepModeInfoNV));
     try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkLatencySleepInfoNV));
     try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkSetLatencyMarkerInfoNV));
+    try std.testing.expectEqual(@as(usize, 24), @sizeOf(VkMemoryBarrier));
+    try std.testing.expectEqual(@as(usize, 12), @sizeOf(VkDispatchIndirectCommand));
+    try std.testing.expectEqual(@as(usize, 68), @sizeOf(VkImageCopy));
+    try std.testing.expectEqual(@as(usize, 80), @sizeOf(VkImageBlit));
+    try std.testing.expectEqual(@as(usize, 824), @sizeOf(VkPhysicalDeviceProperties));
+    try std.testing.expectEqual(@as(usize, 296), @offsetOf(VkPhysicalDeviceProperties, "limits"));
+    try std.testing.expectEqual(@as(usize, 240), @sizeOf(VkPhysicalDeviceFeatures2));
+    try std.testing.expectEqual(@as(usize, 16), @sizeOf(VkSpecializationMapEntry));
+    try std.testing.expectEqual(@as(usize, 48), @sizeOf(VkPipelineShaderStageCreateInfo));
+    try std.testing.expectEqual(@as(usize, 96), @sizeOf(VkComputePipelineCreateInfo));
+    try std.testing.expectEqual(@as(usize, 40), @sizeOf(VkPipelineCacheCreateInfo));
+    try std.testing.expectEqual(@as(usize, 24), @sizeOf(VkMemoryRequirements));
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkMemoryAllocateInfo));
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkPipelineCacheHeaderVersionOne));
+    try std.testing.expectEqual(@as(usize, 72), @sizeOf(VkImageMemoryBarrier));
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkSemaphoreTypeCreateInfo));
+    try std.testing.expectEqual(@as(usize, 48), @sizeOf(VkTimelineSemaphoreSubmitInfo));
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkQueryPoolCreateInfo));
+    try std.testing.expectEqual(@as(usize, 72), @sizeOf(VkSubmitInfo));
+    try std.testing.expectEqual(@as(usize, 40), @sizeOf(VkSemaphoreWaitInfo));
+    try std.testing.expectEqual(@as(usize, 56), @sizeOf(VkCommandBufferInheritanceInfo));
+    try std.testing.expectEqual(@as(usize, 24), @sizeOf(VkDescriptorImageInfo));
+    try std.testing.expectEqual(@as(usize, 64), @sizeOf(VkWriteDescriptorSet));
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkDescriptorGetInfoEXT));
+    try std.testing.expectEqual(@as(usize, 32), @sizeOf(VkDescriptorBufferBindingInfoEXT));
+    try std.testing.expectEqual(@as(usize, 256), @sizeOf(VkPhysicalDeviceDescriptorBufferPropertiesEXT));
+    try std.testing.expectEqual(@as(usize, 112), @offsetOf(VkPhysicalDeviceDescriptorBufferPropertiesEXT, "combinedImageSamplerDescriptorSize"));
 }